@@ -41,6 +41,7 @@ from psi4.driver.p4util.testing import *
 from psi4.driver.p4util.fcidump import *
 from psi4.driver.p4util.fchk import *
 from psi4.driver.p4util.text import *
+from psi4.driver.p4util.benchmark_suite import benchmark_suite, compare_benchmarks
 from psi4.driver.qmmm import QMMM
 from psi4.driver.pluginutil import *
 
@@ -39,4 +39,5 @@ from .python_helpers import *
 from .solvers import *
 from .prop_util import *
 from .spectrum import spectrum
+from .benchmark_suite import benchmark_suite, compare_benchmarks
 from . import writer
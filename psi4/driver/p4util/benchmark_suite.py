@@ -0,0 +1,428 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2021 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""Module with a benchmark suite timing end-to-end kernels on reference systems."""
+
+import datetime
+import json
+import platform
+import time
+
+from psi4 import core
+from psi4.metadata import __version__
+from psi4.driver.p4util import optproc
+from psi4.driver.p4util.exceptions import ValidationError
+
+__all__ = ["benchmark_suite", "compare_benchmarks"]
+
+_reference_molecules = {
+    "water": """
+0 1
+O   0.000000   0.000000   0.117790
+H   0.000000   0.755453  -0.471161
+H   0.000000  -0.755453  -0.471161
+symmetry c1
+no_reorient
+no_com
+""",
+    "water_dimer": """
+0 1
+O  -1.551007  -0.114520   0.000000
+H  -1.934259   0.762503   0.000000
+H  -0.599677   0.040712   0.000000
+O   1.350625   0.111469   0.000000
+H   1.680398  -0.373741  -0.758561
+H   1.680398  -0.373741   0.758561
+symmetry c1
+no_reorient
+no_com
+""",
+    "benzene": """
+0 1
+C   0.000000   1.396792   0.000000
+C   1.209657   0.698396   0.000000
+C   1.209657  -0.698396   0.000000
+C   0.000000  -1.396792   0.000000
+C  -1.209657  -0.698396   0.000000
+C  -1.209657   0.698396   0.000000
+H   0.000000   2.484212   0.000000
+H   2.151390   1.242106   0.000000
+H   2.151390  -1.242106   0.000000
+H   0.000000  -2.484212   0.000000
+H  -2.151390  -1.242106   0.000000
+H  -2.151390   1.242106   0.000000
+symmetry c1
+no_reorient
+no_com
+""",
+}
+
+_all_kernels = ["JK", "DFHELPER", "XC", "DFMP2", "DPD", "TENSOR_SORT", "PSIO"]
+_jk_types = ["DIRECT", "MEM_DF", "DISK_DF", "PK"]
+
+
+def _time_kernel(func, min_time):
+    """Calls *func* until at least *min_time* [s] have passed and returns the time per call.
+    One untimed call is made first, so that setup costs are not counted."""
+    func()
+    rounds = 0
+    start = time.perf_counter()
+    elapsed = 0.0
+    while elapsed < min_time or rounds == 0:
+        func()
+        rounds += 1
+        elapsed = time.perf_counter() - start
+    return elapsed / rounds
+
+
+def _record(kernel, variant, system, nthreads, seconds, flops=None, nbytes=None, **extra):
+    record = {
+        "kernel": kernel,
+        "variant": variant,
+        "system": system,
+        "nthreads": nthreads,
+        "time": seconds,
+        "flops": flops,
+        "gflops_per_s": flops / seconds * 1.e-9 if flops else None,
+        "bytes": nbytes,
+        "gbytes_per_s": nbytes / seconds * 1.e-9 if nbytes else None,
+    }
+    record.update(extra)
+    return record
+
+
+def _jk_records(basis, aux, Cocc, system, nthreads, min_time):
+    records = []
+    nbf = basis.nbf()
+    naux = aux.nbf()
+    nocc = Cocc.colspi()[0]
+    npair = nbf * (nbf + 1) // 2
+    for jk_type in _jk_types:
+        jk = core.JK.build(basis, aux=aux, jk_type=jk_type, do_wK=False, memory=int(core.get_memory() * 0.8 / 8))
+        jk.set_print(0)
+        jk.set_omp_nthread(nthreads)
+        start = time.perf_counter()
+        jk.initialize()
+        init_time = time.perf_counter() - start
+        jk.C_left_add(Cocc)
+
+        # Model counts for DF: J is two (Q|mn) contractions, K a half transform and a (Q|mi)(Q|ni) product
+        if jk_type in ["MEM_DF", "DISK_DF"]:
+            flops = 4.0 * naux * nbf * nbf * (1.0 + nocc)
+            nbytes = 8.0 * naux * npair
+        elif jk_type == "PK":
+            flops = None
+            nbytes = 8.0 * npair * (npair + 1) / 2
+        else:
+            flops = None
+            nbytes = None
+
+        seconds = _time_kernel(jk.compute, min_time)
+        records.append(_record("JK", jk_type, system, nthreads, seconds, flops, nbytes, initialize_time=init_time))
+        jk.finalize()
+    return records
+
+
+def _dfhelper_records(basis, aux, Cocc, Cvir, system, nthreads, min_time):
+    nbf = basis.nbf()
+    naux = aux.nbf()
+    nocc = Cocc.colspi()[0]
+    nvir = Cvir.colspi()[0]
+
+    dfh = core.DFHelper(basis, aux)
+    dfh.set_memory(int(core.get_memory() * 0.8 / 8))
+    dfh.set_nthreads(nthreads)
+    dfh.set_MO_core(True)
+    dfh.initialize()
+    dfh.add_space("i", Cocc)
+    dfh.add_space("a", Cvir)
+    dfh.add_transformation("iaQ", "i", "a", "pqQ")
+
+    flops = 2.0 * naux * nbf * nbf * nocc + 2.0 * naux * nbf * nocc * nvir
+    nbytes = 8.0 * naux * (nbf * (nbf + 1) / 2 + nocc * nvir)
+    seconds = _time_kernel(dfh.transform, min_time)
+    dfh.clear_all()
+    return [_record("DFHELPER", "transform (mn|Q) -> (ia|Q)", system, nthreads, seconds, flops, nbytes)]
+
+
+def _xc_records(basis, Da, system, nthreads, min_time, functional):
+    from psi4.driver.procrouting.dft import build_superfunctional
+
+    sup = build_superfunctional(functional, True)[0]
+    Vpot = core.VBase.build(basis, sup, "RV")
+    Vpot.initialize()
+    Vpot.set_D([Da])
+    V = core.Matrix("V", basis.nbf(), basis.nbf())
+
+    seconds = _time_kernel(lambda: Vpot.compute_V([V]), min_time)
+    npoints = Vpot.grid().npoints()
+    Vpot.finalize()
+    return [_record("XC", functional.upper(), system, nthreads, seconds, npoints=npoints,
+                    points_per_s=npoints / seconds)]
+
+
+def _dfmp2_records(wfn, nocc, nvir, system, nthreads, min_time):
+    aux = core.BasisSet.build(wfn.molecule(), "DF_BASIS_MP2", core.get_option("DFMP2", "DF_BASIS_MP2"), "RIFIT",
+                              core.get_global_option("BASIS"))
+    wfn.set_basisset("DF_BASIS_MP2", aux)
+    naux = aux.nbf()
+
+    # The (ia|jb) = (ia|Q)(Q|jb) assembly dominates
+    flops = 2.0 * nocc * nocc * nvir * nvir * naux
+    nbytes = 8.0 * naux * nocc * nvir
+    seconds = _time_kernel(lambda: core.dfmp2(wfn).compute_energy(), min_time)
+    return [_record("DFMP2", "energy", system, nthreads, seconds, flops, nbytes)]
+
+
+def _dpd_records(nocc, nvir, system, nthreads, min_time):
+    records = []
+    for op, data in core.benchmark_dpd(nocc, nvir, min_time).items():
+        records.append(_record("DPD", op, system, nthreads, data["time"], data["flops"] or None, data["bytes"]))
+    return records
+
+
+def _tensor_sort_records(nocc, nvir, naux, system, nthreads, min_time):
+    records = []
+    for op, data in core.benchmark_dfocc_sort(nocc, nvir, naux, min_time).items():
+        records.append(_record("TENSOR_SORT", op, system, nthreads, data["time"], None, data["bytes"]))
+    return records
+
+
+def _psio_records(psio_dim, nthreads, min_time):
+    records = []
+    for op, data in core.benchmark_psio(psio_dim, min_time).items():
+        records.append(_record("PSIO", op, "2^{0} x 2^{0}".format(psio_dim), nthreads, data["time"], None,
+                               data["bytes"]))
+    return records
+
+
+def _add_scaling(records):
+    """Adds the speedup and parallel efficiency of each record relative to the smallest thread count."""
+    base = {}
+    for rec in records:
+        key = (rec["kernel"], rec["variant"], rec["system"])
+        if key not in base or rec["nthreads"] < base[key]["nthreads"]:
+            base[key] = rec
+    for rec in records:
+        ref = base[(rec["kernel"], rec["variant"], rec["system"])]
+        rec["speedup"] = ref["time"] / rec["time"]
+        rec["efficiency"] = rec["speedup"] * ref["nthreads"] / rec["nthreads"]
+
+
+def compare_benchmarks(results, reference, tolerance=0.10):
+    """Compares two benchmark_suite results and lists the kernels that got slower.
+
+    Parameters
+    ----------
+    results : dict or str
+        Result of :py:func:`~psi4.benchmark_suite` or the JSON file it wrote.
+    reference : dict or str
+        Older result to compare against, or the JSON file it was written to.
+    tolerance : float
+        Relative slowdown tolerated before a kernel is reported.
+
+    Returns
+    -------
+    list of dict
+        One entry per (kernel, variant, system, nthreads) that is slower than
+        the reference by more than *tolerance*, with both timings and their ratio.
+
+    """
+    if isinstance(results, str):
+        with open(results) as fp:
+            results = json.load(fp)
+    if isinstance(reference, str):
+        with open(reference) as fp:
+            reference = json.load(fp)
+
+    def keyed(res):
+        return {(r["kernel"], r["variant"], r["system"], r["nthreads"]): r for r in res["results"]}
+
+    new = keyed(results)
+    old = keyed(reference)
+
+    regressions = []
+    for key in sorted(set(new) & set(old)):
+        ratio = new[key]["time"] / old[key]["time"]
+        if ratio > 1.0 + tolerance:
+            regressions.append({
+                "kernel": key[0],
+                "variant": key[1],
+                "system": key[2],
+                "nthreads": key[3],
+                "time": new[key]["time"],
+                "reference_time": old[key]["time"],
+                "ratio": ratio,
+            })
+    return regressions
+
+
+def benchmark_suite(systems=None, basis="cc-pvdz", kernels=None, threads=None, min_time=1.0, functional="b3lyp",
+                    psio_dim=11, output_file="benchmark.json", reference=None, tolerance=0.10):
+    """Times end-to-end kernels on reference molecules and writes machine-readable results.
+
+    For each system an SCF is run once to provide orbitals and densities (not timed),
+    then every requested kernel is timed at every requested thread count:
+
+    - ``JK``: one J/K build per backend (DIRECT, MEM_DF, DISK_DF, PK)
+    - ``DFHELPER``: the (mn|Q) -> (ia|Q) transformation
+    - ``XC``: one V build with *functional*
+    - ``DFMP2``: a DF-MP2 energy
+    - ``DPD``: buf4 sort and contract444 on buffers with the system's occupied/virtual sizes
+    - ``TENSOR_SORT``: DF-CC (dfocc) tensor permutations, with an element-by-element reference
+    - ``PSIO``: reads and writes of a 2^psio_dim x 2^psio_dim matrix (once, on one thread)
+
+    Each record holds the time per call and, where a model count is meaningful, the
+    flops and bytes moved with the derived GFLOP/s and GB/s, plus the speedup and
+    parallel efficiency relative to the smallest thread count.
+
+    Parameters
+    ----------
+    systems : list of str or dict of {str: core.Molecule}, optional
+        Names of built-in reference molecules (water, water_dimer, benzene) or
+        molecules keyed by name. Defaults to all built-in molecules.
+    basis : str
+        Orbital basis set; the auxiliary sets are the matching JKFIT and RIFIT sets.
+    kernels : list of str, optional
+        Subset of JK, DFHELPER, XC, DFMP2, DPD, TENSOR_SORT, PSIO. Defaults to all.
+    threads : list of int, optional
+        Thread counts to scan. Defaults to 1 and the current number of threads.
+    min_time : float
+        Minimum time [s] each kernel is repeated for.
+    functional : str
+        Functional for the XC kernel.
+    psio_dim : int
+        Dimension exponent of the PSIO matrix.
+    output_file : str, optional
+        JSON file to write the results to. Nothing is written if None.
+    reference : dict or str, optional
+        Earlier result (or its JSON file) to check for regressions against,
+        see :py:func:`~psi4.driver.p4util.compare_benchmarks`.
+    tolerance : float
+        Relative slowdown tolerated when comparing with *reference*.
+
+    Returns
+    -------
+    dict
+        ``{"metadata": {...}, "results": [...], "regressions": [...]}``
+
+    """
+    kernels = [k.upper() for k in (kernels or _all_kernels)]
+    for k in kernels:
+        if k not in _all_kernels:
+            raise ValidationError("benchmark_suite: unknown kernel {}, choose from {}".format(k, _all_kernels))
+
+    if systems is None:
+        systems = list(_reference_molecules)
+    if not isinstance(systems, dict):
+        systems = {name: core.Molecule.from_string(_reference_molecules[name], name=name) for name in systems}
+
+    max_threads = core.get_num_threads()
+    if threads is None:
+        threads = sorted({1, max_threads})
+
+    optstash = optproc.OptionsState(["BASIS"], ["SCF_TYPE"], ["SCF", "PRINT"])
+
+    records = []
+    try:
+        core.set_global_option("BASIS", basis)
+        core.set_global_option("SCF_TYPE", "DF")
+        core.set_local_option("SCF", "PRINT", 0)
+
+        for name, mol in systems.items():
+            from psi4.driver import energy
+            core.set_num_threads(max_threads)
+            wfn = energy("scf", molecule=mol, return_wfn=True)[1]
+            mol = wfn.molecule()
+            primary = wfn.basisset()
+            jkfit = core.BasisSet.build(mol, "DF_BASIS_SCF", "", "JKFIT", basis)
+            Cocc = wfn.Ca_subset("AO", "OCC")
+            Cvir = wfn.Ca_subset("AO", "VIR")
+            Da = wfn.Da_subset("AO")
+            nocc = Cocc.colspi()[0]
+            nvir = Cvir.colspi()[0]
+            system = "{}/{}".format(name, basis)
+
+            for nthreads in threads:
+                core.set_num_threads(nthreads)
+                if "JK" in kernels:
+                    records += _jk_records(primary, jkfit, Cocc, system, nthreads, min_time)
+                if "DFHELPER" in kernels:
+                    rifit = core.BasisSet.build(mol, "DF_BASIS_MP2", "", "RIFIT", basis)
+                    records += _dfhelper_records(primary, rifit, Cocc, Cvir, system, nthreads, min_time)
+                if "XC" in kernels:
+                    records += _xc_records(primary, Da, system, nthreads, min_time, functional)
+                if "DFMP2" in kernels:
+                    records += _dfmp2_records(wfn, nocc, nvir, system, nthreads, min_time)
+                if "DPD" in kernels:
+                    records += _dpd_records(nocc, nvir, system, nthreads, min_time)
+                if "TENSOR_SORT" in kernels:
+                    records += _tensor_sort_records(nocc, nvir, jkfit.nbf(), system, nthreads, min_time)
+
+        if "PSIO" in kernels:
+            core.set_num_threads(1)
+            records += _psio_records(psio_dim, 1, min_time)
+    finally:
+        core.set_num_threads(max_threads)
+        optstash.restore()
+
+    _add_scaling(records)
+
+    results = {
+        "metadata": {
+            "psi4_version": __version__,
+            "hostname": platform.node(),
+            "platform": platform.platform(),
+            "date": datetime.datetime.now().isoformat(),
+            "max_threads": max_threads,
+            "memory": core.get_memory(),
+            "min_time": min_time,
+        },
+        "results": records,
+        "regressions": [],
+    }
+
+    if reference is not None:
+        results["regressions"] = compare_benchmarks(results, reference, tolerance)
+
+    core.print_out("\n  ==> Benchmark Suite <==\n\n")
+    core.print_out("    {:<10} {:<32} {:<24} {:>4} {:>12} {:>10} {:>10}\n".format(
+        "Kernel", "Variant", "System", "Thr", "Time [s]", "GFLOP/s", "GB/s"))
+    for rec in records:
+        core.print_out("    {:<10} {:<32} {:<24} {:>4} {:>12.6f} {:>10} {:>10}\n".format(
+            rec["kernel"], rec["variant"][:32], rec["system"], rec["nthreads"], rec["time"],
+            "{:.2f}".format(rec["gflops_per_s"]) if rec["gflops_per_s"] else "-",
+            "{:.2f}".format(rec["gbytes_per_s"]) if rec["gbytes_per_s"] else "-"))
+    for reg in results["regressions"]:
+        core.print_out("    Regression: {} {} {} @{} threads is {:.2f}x slower than the reference\n".format(
+            reg["kernel"], reg["variant"], reg["system"], reg["nthreads"], reg["ratio"]))
+
+    if output_file is not None:
+        with open(output_file, "w") as fp:
+            json.dump(results, fp, indent=2)
+
+    return results
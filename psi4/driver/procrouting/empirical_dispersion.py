@@ -148,6 +148,7 @@ class EmpiricalDispersion(object):
 
         if self.engine == 'libdisp':
             self.disp = core.Dispersion.build(self.dashlevel, **resolved['dashparams'])
+            self.disp.set_cutoff(core.get_option('SCF', 'DFT_DISPERSION_CUTOFF'))
 
     def print_out(self):
         """Format dispersion parameters of `self` for output file."""
@@ -163,6 +164,8 @@ class EmpiricalDispersion(object):
         text.append('')
         for op in self.ordered_params:
             text.append("    %6s = %14.6f" % (op, self.dashparams[op]))
+        if self.engine == 'libdisp' and self.disp.cutoff() > 0.0:
+            text.append("    %6s = %14.6f [a0]" % ('cutoff', self.disp.cutoff()))
         text.append('\n')
 
         core.print_out('\n'.join(text))
@@ -307,7 +310,7 @@ class EmpiricalDispersion(object):
                         molecule: core.Molecule,
                         wfn: core.Wavefunction = None) -> core.Matrix:
         """Compute dispersion Hessian based on engine, dispersion level, and parameters in `self`.
-        Uses finite difference, as no dispersion engine has analytic second derivatives.
+        Analytic for libdisp; other engines use finite difference, as they have no analytic second derivatives.
 
         Parameters
         ----------
@@ -322,6 +325,12 @@ class EmpiricalDispersion(object):
             (3*nat, 3*nat) dispersion Hessian [Eh/a0/a0].
 
         """
+        if self.engine == 'libdisp':
+            H = self.disp.compute_hessian(molecule)
+            if wfn is not None:
+                wfn.set_variable('DISPERSION CORRECTION HESSIAN', H)
+            return H
+
         optstash = p4util.OptionsState(['PRINT'], ['PARENT_SYMMETRY'])
         core.set_global_option('PRINT', 0)
 
@@ -1784,7 +1784,16 @@ def run_dfocc(name, **kwargs):
     def set_cholesky_from(corl_type):
         if corl_type == 'DF':
             core.set_local_option('DFOCC', 'CHOLESKY', 'FALSE')
-            proc_util.check_disk_df(name.upper(), optstash)
+            if core.get_option('DFOCC', 'DF_INTS_IN_CORE'):
+                # DFOCC takes the in-core integrals of a MEM_DF SCF, so keep its JK object
+                optstash.add_option(['SCF_TYPE'])
+                optstash.add_option(['SCF', 'SAVE_JK'])
+                if not core.has_global_option_changed('SCF_TYPE') or core.get_global_option('SCF_TYPE') == 'DF':
+                    core.set_global_option('SCF_TYPE', 'MEM_DF')
+                    core.print_out(f"""    For method '{name.upper()}', SCF Algorithm Type (re)set to MEM_DF.\n""")
+                core.set_local_option('SCF', 'SAVE_JK', True)
+            else:
+                proc_util.check_disk_df(name.upper(), optstash)
 
         elif corl_type == 'CD':
             core.set_local_option('DFOCC', 'CHOLESKY', 'TRUE')
@@ -4063,12 +4072,23 @@ def run_dmrgci(name, **kwargs):
     return dmrg_wfn
 
 
+def _psimrcc_aux_basis(ref_wfn):
+    """Attach the DF_BASIS_CC fitting basis to *ref_wfn* when PSIMRCC runs on
+    density-fitted integrals (CC_TYPE DF)."""
+    if core.get_global_option('CC_TYPE') == 'DF':
+        aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_CC",
+                                        core.get_global_option("DF_BASIS_CC"),
+                                        "RIFIT", core.get_global_option("BASIS"))
+        ref_wfn.set_basisset("DF_BASIS_CC", aux_basis)
+
+
 def run_psimrcc(name, **kwargs):
     """Function encoding sequence of PSI module calls for a PSIMRCC computation
      using a reference from the MCSCF module
 
     """
     mcscf_wfn = run_mcscf(name, **kwargs)
+    _psimrcc_aux_basis(mcscf_wfn)
     psimrcc_wfn = core.psimrcc(mcscf_wfn)
 
     # Shove variables into global space
@@ -4088,6 +4108,7 @@ def run_psimrcc_scf(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = scf_helper(name, **kwargs)
 
+    _psimrcc_aux_basis(ref_wfn)
     psimrcc_wfn = core.psimrcc(ref_wfn)
 
     # Shove variables into global space
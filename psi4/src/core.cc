@@ -38,6 +38,8 @@
 
 #include "psi4/cc/cclambda/cclambda.h"
 #include "psi4/cc/ccwave.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libfock/cubature.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/molecule.h"
@@ -519,7 +521,10 @@ SharedWavefunction py_psi_adc(SharedWavefunction ref_wfn) {
     return adc_wfn;
 }
 
-void py_psi_clean() { PSIOManager::shared_object()->psiclean(); }
+void py_psi_clean() {
+    PSIOManager::shared_object()->psiclean();
+    DFTGrid::clear_reusable_grids();
+}
 
 void py_psi_print_options() { Process::environment.options.print(); }
 
@@ -1144,7 +1149,7 @@ PYBIND11_MODULE(core, core) {
 
     core.def("version", []() { PyErr_SetString(PyExc_AttributeError, "psi4.core.version removed since hasn't been working as intended."); }, ".. deprecated:: 1.4");
     core.def("git_version", []() { PyErr_SetString(PyExc_AttributeError, "psi4.core.git_version removed since hasn't been working as intended."); }, ".. deprecated:: 1.4");
-    core.def("clean", py_psi_clean, "Remove scratch files. Call between independent jobs.");
+    core.def("clean", py_psi_clean, "Remove scratch files and grids kept for DFT_GRID_REUSE. Call between independent jobs.");
     core.def("clean_options", py_psi_clean_options, "Reset options to clean state.");
 
     core.def("get_writer_file_prefix", get_writer_file_prefix, "molecule_name"_a,
@@ -1201,6 +1206,13 @@ PYBIND11_MODULE(core, core) {
     core.def("set_memory_bytes", py_psi_set_memory, "memory"_a, "quiet"_a = false,
              "Sets the memory available to Psi (in bytes); prefer :func:`psi4.set_memory`.");
     core.def("get_memory", py_psi_get_memory, "Returns the amount of memory available to Psi (in bytes).");
+    core.def("set_matrix_pool_limit", pool_set_limit, "bytes"_a,
+             "Sets how many bytes of freed matrix storage are cached for reuse; zero disables caching.");
+    core.def("get_matrix_pool_limit", pool_get_limit,
+             "Returns how many bytes of freed matrix storage may be cached for reuse.");
+    core.def("trim_matrix_pool", pool_trim, "Returns all cached matrix storage to the system.");
+    core.def("print_matrix_pool_statistics", pool_print_statistics,
+             "Prints the allocation statistics of the matrix memory pool to the output file.");
 
     core.def("set_datadir", [](const std::string& pdd) { Process::environment.set_datadir(pdd); }, "psidatadir"_a,
              "Sets the path to shared text resources, :envvar:`PSIDATADIR`.");
@@ -26,9 +26,13 @@
  * @END LICENSE
  */
 
+#include "psi4/dfocc/tensors.h"
 #include "psi4/libmints/benchmark.h"
 #include "psi4/pybind11.h"
 
+#include <map>
+#include <string>
+
 namespace py = pybind11;
 using namespace pybind11::literals;
 
@@ -45,4 +49,10 @@ using namespace pybind11::literals;
           "Perform benchmark of common double floating point operations including most of cmath. For each routine run at least *min_time* [s].");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "max_am"_a, "min_time"_a,
           "Perform benchmark of psi integrals (of libmints type). Benchmark integrals called from different centers. For up to *max_am* with each shell combination run at least *min_time* [s].");
+    m.def("benchmark_dpd", &psi::benchmark_dpd, "nocc"_a, "nvir"_a, "min_time"_a,
+          "Time DPD buf4 sorts and contractions for *nocc* occupied and *nvir* virtual orbitals, each run at least *min_time* [s]. Returns {operation: {time, flops, bytes}}.");
+    m.def("benchmark_dfocc_sort", &psi::dfoccwave::benchmark_sort, "nocc"_a, "nvir"_a, "naux"_a, "min_time"_a,
+          "Time the DF-CC tensor permutations for *nocc* occupied, *nvir* virtual and *naux* auxiliary functions next to an element-by-element reference, each run at least *min_time* [s]. Returns {operation: {time, flops, bytes}}.");
+    m.def("benchmark_psio", &psi::benchmark_psio, "max_dim"_a, "min_time"_a,
+          "Time PSIO reads and writes of a 2^*max_dim* x 2^*max_dim* matrix, each run at least *min_time* [s]. Returns {operation: {time, bytes}}.");
 }
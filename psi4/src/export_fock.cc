@@ -31,6 +31,7 @@
 
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/soscf.h"
+#include "psi4/lib3index/cholesky.h"
 #include "psi4/lib3index/denominator.h"
 #include "psi4/lib3index/dftensor.h"
 #include "psi4/lib3index/dfhelper.h"
@@ -110,6 +111,15 @@ void export_fock(py::module &m) {
         .def("Imo", &DFTensor::Imo, "doctsring")
         .def("Idfmo", &DFTensor::Idfmo, "doctsring");
 
+    py::class_<CholeskyMatrix, std::shared_ptr<CholeskyMatrix>>(m, "CholeskyMatrix",
+                                                                "Pivoted partial Cholesky decomposition of a matrix")
+        .def(py::init<SharedMatrix, double, size_t>(), "A"_a, "delta"_a, "memory"_a)
+        .def("set_block_size", &CholeskyMatrix::set_block_size,
+             "Maximum number of pivots selected per pass (1 recovers the single-pivot algorithm)", "block_size"_a)
+        .def("choleskify", &CholeskyMatrix::choleskify, "Perform the decomposition")
+        .def("L", &CholeskyMatrix::L, "The Cholesky vectors (Q x N)")
+        .def("Q", &CholeskyMatrix::Q, "Number of Cholesky vectors");
+
     py::class_<FittingMetric, std::shared_ptr<FittingMetric>>(m, "FittingMetric", "docstring")
         .def(py::init<std::shared_ptr<BasisSet>, bool>())
         .def("get_algorithm", &FittingMetric::get_algorithm, "docstring")
@@ -305,6 +305,8 @@ void export_functional(py::module &m) {
         .def("s8", &Dispersion::get_s8, "docstring")
         .def("a1", &Dispersion::get_a1, "docstring")
         .def("a2", &Dispersion::get_a2, "docstring")
+        .def("cutoff", &Dispersion::get_cutoff, "Pair cutoff [a0]; zero includes all pairs.")
+        .def("set_cutoff", &Dispersion::set_cutoff, "Set the pair cutoff [a0]; zero includes all pairs.")
         .def("print_out", &Dispersion::py_print, "docstring");
 
     py::class_<sapt::FDDS_Dispersion, std::shared_ptr<sapt::FDDS_Dispersion>>(m, "FDDS_Dispersion", "docstring")
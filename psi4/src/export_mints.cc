@@ -39,6 +39,7 @@
 #include "psi4/libmints/integralparameters.h"
 #include "psi4/libmints/orbitalspace.h"
 #include "psi4/libmints/local.h"
+#include "psi4/libmints/matrix_product.h"
 #include "psi4/libmints/vector3.h"
 #include "psi4/libmints/pointgrp.h"
 #include "psi4/libmints/extern.h"
@@ -668,6 +669,46 @@ void export_mints(py::module& m) {
             * ``(AB)C`` vs. ``A(BC)`` selected by cost analysis of overall (not per-irrep) dimensions.
             * If A, B, C not of the the same symmetry, always computed as ``(AB)C``.
             )pbdoc");
+    m.def("chain_product",
+          [](const std::vector<SharedMatrix>& mats, std::vector<bool> trans, std::vector<bool> symmetric,
+             SharedMatrix result, double alpha, double beta) {
+              trans.resize(mats.size(), false);
+              symmetric.resize(mats.size(), false);
+              linalg::MatrixProduct product;
+              for (size_t i = 0; i < mats.size(); ++i) product.append(mats[i], trans[i], symmetric[i]);
+              if (!result) return product.evaluate();
+              product.evaluate(*result, alpha, beta);
+              return result;
+          },
+          "mats"_a, "trans"_a = std::vector<bool>(), "symmetric"_a = std::vector<bool>(), "result"_a = nullptr,
+          "alpha"_a = 1.0, "beta"_a = 0.0, R"pbdoc(
+            Returns the product of a chain of matrices, evaluated in the cheapest order.
+
+            Parameters
+            ----------
+            mats
+                Matrices to multiply, left to right.
+            trans
+                Transpose flags, one per matrix; missing entries are False.
+            symmetric
+                Flags matrices known to be symmetric, which are then multiplied with DSYMM; missing entries are False.
+            result
+                If given, receives ``alpha * product + beta * result`` and is returned.
+            alpha
+                Scale of the product when accumulating into *result*.
+            beta
+                Scale of the existing *result*.
+
+            Returns
+            -------
+            Matrix
+                New matrix holding the product, or *result*.
+
+            Notes
+            -----
+            * The parenthesization minimizes the multiply-add count summed over the irrep blocks.
+            * ``X^T X`` and ``X X^T`` pairs of totally symmetric matrices are formed with DSYRK.
+            )pbdoc");
 
     py::enum_<DerivCalcType>(m, "DerivCalcType")
         .value("Default", DerivCalcType::Default, "Use internal logic.")
@@ -1229,6 +1270,11 @@ void export_mints(py::module& m) {
                                                                            "Two body integral base class");
     pyTwoBodyAOInt.def("compute_shell", compute_shell_ints(&TwoBodyAOInt::compute_shell),
                        "Compute ERIs between 4 shells")
+        .def("compute_shell_batch", &TwoBodyAOInt::compute_shell_batch, "quartets"_a,
+             "Compute ERIs for a list of (P, Q, R, S) shell quartets of one angular momentum class")
+        .def("batch_buffer", &TwoBodyAOInt::batch_buffer, "Integrals from the last compute_shell_batch call")
+        .def("batch_offsets", &TwoBodyAOInt::batch_offsets,
+             "Offset of each quartet of the last compute_shell_batch call into batch_buffer")
         .def("shell_significant", compute_shell_significant(&TwoBodyAOInt::shell_significant),
                        "Determines if the P,Q,R,S shell combination is significant");
 
@@ -40,5 +40,8 @@ void export_misc(py::module &m) {
     m.def("timer_off", timer_off, "label"_a, "Stop timer with *label*.");
     m.def("tstart", tstart, "Start module-level timer. Only one active at once.");
     m.def("tstop", tstop, "Stop module-level timer. Prints user, system, and total times to outfile.");
+    m.def("start_trace_timers", start_trace_timers, "Record a per-thread timeline of timers, written to ``timer.json`` at exit or by :func:`psi4.core.write_timer_trace`.");
+    m.def("stop_trace_timers", stop_trace_timers, "Stop recording the timeline of timers.");
+    m.def("write_timer_trace", write_timer_trace, "filename"_a, "Write the recorded timeline of timers in Chrome trace format, along with the nested timers, to *filename*.");
     m.def("clean_timers", clean_timers, "Reinitialize timers for independent ``timer.dat`` entries. Vital when earlier independent calc finished improperly.");
 }
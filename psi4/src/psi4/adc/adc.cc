@@ -70,6 +70,9 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) : Wavefunction(opti
 
     nopen_ = 0;
     for (int h = 0; h < nirrep_; h++) nopen_ += soccpi_[h];
+    sigma_cached_ = false;
+    sigma_irrep_ = -1;
+    sigma_batch_ = 0;
     if (!psio_) {
         throw PSIEXCEPTION("The wavefunction passed in lacks a PSIO object, crashing ADC. See GitHub issue #1851.");
     }
@@ -35,6 +35,8 @@
 #include "psi4/libdpd/dpd.h"
 #include "psi4/psifiles.h"
 
+#include <vector>
+
 #define ID(x) _ints->DPD_ID(x)
 
 #define DEBUG_ false
@@ -77,7 +79,12 @@ class ADCWfn : public Wavefunction {
     double rhf_init_tensors();
     double rhf_differentiate_omega(int irrep, int root);
     void rhf_diagonalize(int irrep, int num_root, bool first, double omega_in, double *eps);
-    void rhf_construct_sigma(int irrep, int root);
+    void rhf_prepare_sigma(int irrep);
+    void rhf_release_sigma(int irrep);
+    void rhf_construct_sigma(int irrep, int first, int last, double omega, SharedMatrix B, SharedMatrix S);
+    void rhf_construct_sigma_2h2p(int first, int last, double omega, double **Bp, double **Sp);
+    void pack_ov(dpdfile2 *F, double *v);
+    void unpack_ov(const double *v, dpdfile2 *F);
     void shift_denom2(int root, int irrep, double omega);
     void shift_denom4(int irrep, double omega);
 
@@ -127,6 +134,23 @@ class ADCWfn : public Wavefunction {
     IntegralTransform *_ints;
     // Guesses for the correlated excitation energies, which are given as CIS/ADC(1) energies
     SharedVector omega_guess_;
+    // Singles-singles blocks of the response matrix for the irrep being diagonalized, in pack_ov() order
+    SharedMatrix Aovov_;
+    SharedMatrix Vovov_;
+    SharedMatrix Kovov_;
+    // <jc|ab> as (jab,c) and <ji|ak> as (ija,k), dense over the active orbitals, for the blocked 2h-2p terms
+    SharedMatrix Wovvv_;
+    SharedMatrix Wooov_;
+    // Dense (i*nvir+a) index of each packed OV element, and the irreps of the active orbitals
+    std::vector<int> ov_dense_;
+    std::vector<int> occ_sym_;
+    std::vector<int> vir_sym_;
+    // Irrep being diagonalized and the number of trial vectors whose 2h-2p terms are built at once
+    // (0 when they are built one at a time through DPD)
+    int sigma_irrep_;
+    int sigma_batch_;
+    // Are the 2h-2p integrals of the per-vector sigma construction held in the DPD cache?
+    bool sigma_cached_;
 };
 }
 }
@@ -83,6 +83,7 @@ double ADCWfn::compute_energy() {
     for (int irrep = 0; irrep < nirrep_; irrep++) {
         if (rpi_[irrep]) {
             omega = init_array(rpi_[irrep]);
+            rhf_prepare_sigma(irrep);
             for (int root = 0; root < rpi_[irrep]; root++) {
                 omega_o = omega_guess_->get(irrep, root);
                 first = true;
@@ -274,6 +275,7 @@ double ADCWfn::compute_energy() {
                         omega_o -= omega_diff;
                 }
             }
+            rhf_release_sigma(irrep);
             free(omega);
         }
     }
@@ -31,6 +31,12 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libtrans/integraltransform.h"
 #include "psi4/liboptions/liboptions.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace psi {
 namespace adc {
@@ -45,99 +51,405 @@ namespace adc {
 //  BOOVV : A 2h-2p intermediate.
 //
 
-void ADCWfn::rhf_construct_sigma(int irrep, int root) {
-    bool do_pr = options_.get_bool("PR");
-    char lbl[32], ampname[32];
-    dpdfile2 B, S, D, E, Bt, C;
-    dpdbuf4 A, V, K, Z, BT, XT;
+void ADCWfn::pack_ov(dpdfile2 *F, double *v) {
+    global_dpd_->file2_mat_init(F);
+    global_dpd_->file2_mat_rd(F);
+    size_t n = 0;
+    for (int h = 0; h < nirrep_; h++)
+        for (int i = 0; i < F->params->rowtot[h]; i++)
+            for (int a = 0; a < F->params->coltot[h ^ F->my_irrep]; a++) v[n++] = F->matrix[h][i][a];
+    global_dpd_->file2_mat_close(F);
+}
 
-    sprintf(lbl, "S^(%d)_[%d]12", root, irrep);
-    global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-    sprintf(lbl, "B^(%d)_[%d]12", root, irrep);
-    global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+void ADCWfn::unpack_ov(const double *v, dpdfile2 *F) {
+    global_dpd_->file2_mat_init(F);
+    size_t n = 0;
+    for (int h = 0; h < nirrep_; h++)
+        for (int i = 0; i < F->params->rowtot[h]; i++)
+            for (int a = 0; a < F->params->coltot[h ^ F->my_irrep]; a++) F->matrix[h][i][a] = v[n++];
+    global_dpd_->file2_mat_wrt(F);
+    global_dpd_->file2_mat_close(F);
+}
 
-    // CIS term and the two 3h-3p diagrams are summed into the sigma vector.
-    global_dpd_->buf4_init(&A, PSIF_ADC_SEM, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0, "A3h3p1234");
-    global_dpd_->contract422(&A, &B, &S, 0, 0, 1, 0);
-    global_dpd_->buf4_close(&A);
+//
+//  The singles-singles terms (the CIS term and the two 3h-3p diagrams) only involve [OV,OV]
+//  matrices, so their irrep block is held in core in the packed order of pack_ov() and applied
+//  to all new trial vectors at once. The 2h-2p terms are built for a batch of trial vectors at
+//  once, with one GEMM per diagram over blocks that are dense in the active orbitals.
+//  These in-core blocks are given at most half of the memory, the rest is left to DPD; whatever
+//  does not fit is built one trial vector at a time through DPD instead.
+//
+
+void ADCWfn::rhf_prepare_sigma(int irrep) {
+    char lbl[32];
+    int nov = nxspi_[irrep];
+    int nroot = rpi_[irrep];
+    dpdfile2 D;
+    dpdbuf4 A, V, K;
+
+    sigma_irrep_ = irrep;
+    long int avail = memory_ / (2 * sizeof(double));
 
-    // Evaluation of the remaining one 3h-3p diagram
-    if (do_pr)
-        strcpy(ampname, "tilde 2 K1234 - K1243");
-    else
-        strcpy(ampname, "2 K1234 - K1243");
-    global_dpd_->buf4_init(&K, PSIF_ADC, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, ampname);
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "MO Ints 2 V1234 - V1243");
+    // The Ritz space, sigma and correction vectors and the Davidson scratch of rhf_diagonalize
+    long int maxdim = 10L * nroot;
+    long int davidson = (2 * maxdim + nroot + 2) * nov + 3 * maxdim * maxdim;
+    if (davidson > avail) throw PSIEXCEPTION("ADC: not enough memory for the Davidson subspace.");
+    avail -= davidson;
 
-    sprintf(lbl, "DOV_[%d]12", irrep);
+    // Packed OV index -> [O,V] pair index within the irrep, and -> dense OV index
+    std::vector<int> pair(nov);
+    sprintf(lbl, "D_[%d]12", irrep);
     global_dpd_->file2_init(&D, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-    // D_{ia} <-- \sum_{jb} (2 <ij|ab> - <ij|ba>) b_{jb}
-    global_dpd_->dot24(&B, &V, &D, 0, 0, 1, 0);
-    // \sigma_{ia} <-- 0.5 \sum_{jb} (2 K_{ijab} - K_{ijba}) D_{jb}
-    global_dpd_->dot24(&D, &K, &S, 0, 0, 0.5, 1);
+    int nocc = 0, nvir = 0;
+    for (int h = 0; h < nirrep_; h++) {
+        nocc += D.params->ppi[h];
+        nvir += D.params->qpi[h];
+    }
+    occ_sym_.assign(D.params->psym, D.params->psym + nocc);
+    vir_sym_.assign(D.params->qsym, D.params->qsym + nvir);
+    ov_dense_.resize(nov);
+    global_dpd_->buf4_init(&A, PSIF_ADC_SEM, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0, "A3h3p1234");
+    size_t n = 0;
+    for (int h = 0; h < nirrep_; h++) {
+        for (int i = 0; i < D.params->rowtot[h]; i++) {
+            for (int a = 0; a < D.params->coltot[h ^ irrep]; a++) {
+                int I = D.params->poff[h] + i;
+                int B = D.params->qoff[h ^ irrep] + a;
+                pair[n] = A.params->rowidx[I][B];
+                ov_dense_[n++] = I * nvir + B;
+            }
+        }
+    }
     global_dpd_->file2_close(&D);
 
-    sprintf(lbl, "EOV_[%d]12", irrep);
-    global_dpd_->file2_init(&E, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-    // E_{ia} <-- \sum_{jb} (2 K_{ijab} - K_{ijba}) b_{jb}
-    global_dpd_->dot24(&B, &K, &E, 0, 0, 1, 0);
-    // \sigma_{ia} <-- \sum_{jb} (2 <ij|ab> - <ij|ba>) E_{jb}
-    global_dpd_->dot24(&E, &V, &S, 0, 0, 0.5, 1);
-    global_dpd_->file2_close(&E);
-
-#if DEBUG_
-    outfile->Printf(">> In construction of sigma <<\n");
-    global_dpd_->buf4_print(&K, outfile, 1);
-// abort();
-#endif
-
-    global_dpd_->buf4_close(&K);
-    global_dpd_->buf4_close(&V);
-
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
-                           "MO Ints <OV|VV>");
-    sprintf(lbl, "ZOOVV_[%d]1234", irrep);
-    global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
-    // ZOVOV_{jiab} <--  \sum_{c} <jc|ab> b_{ic}
-    global_dpd_->contract424(&V, &B, &Z, 1, 1, 1, 1, 0);
-    global_dpd_->buf4_close(&V);
-
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
-                           "MO Ints <OO|VO>");
-    // ZOVOV_{ijab} <-- - \sum_{k} <ij|ak> b_{kb}
-    global_dpd_->contract424(&V, &B, &Z, 3, 0, 0, -1, 1);
-    global_dpd_->buf4_close(&V);
-
-    // B_{iajb} <-- (2Z_{ijab}-Z_{ijba}+2Z_{jiab}-Z_{jiba}) / (\omega+e_i-e_a+e_j-e_b)
-    sprintf(lbl, "BOOVV_[%d]1234", irrep);
-    global_dpd_->buf4_scmcopy(&Z, PSIF_ADC_SEM, lbl, 2.0);
-    global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, pqsr, ID("[O,O]"), ID("[V,V]"), lbl, -1.0);
-    global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, qprs, ID("[O,O]"), ID("[V,V]"), lbl, -1.0);
-    global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, qpsr, ID("[O,O]"), ID("[V,V]"), lbl, 2.0);
-    global_dpd_->buf4_close(&Z);
-
-    global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
-    sprintf(lbl, "D_[%d]1234", irrep);
-    global_dpd_->buf4_init(&A, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
-    global_dpd_->buf4_dirprd(&A, &Z);
+    auto load_block = [&](dpdbuf4 *X, const std::string &name) {
+        auto M = std::make_shared<Matrix>(name, nov, nov);
+        double **Mp = M->pointer();
+        global_dpd_->buf4_mat_irrep_init(X, irrep);
+        global_dpd_->buf4_mat_irrep_rd(X, irrep);
+        for (int p = 0; p < nov; p++)
+            for (int q = 0; q < nov; q++) Mp[p][q] = X->matrix[irrep][pair[p]][pair[q]];
+        global_dpd_->buf4_mat_irrep_close(X, irrep);
+        return M;
+    };
+
+    // Three nov x nov blocks, plus the [OV,OV] irrep block each is read from
+    long int nov2 = (long int)nov * nov;
+    long int ovov = A.params->rowtot[irrep] * (long int)A.params->coltot[irrep];
+    if (3 * nov2 + ovov <= avail) {
+        Aovov_ = load_block(&A, "A3h3p (ia,jb)");
+
+        global_dpd_->buf4_init(&V, PSIF_ADC_SEM, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                               "2 V1234 - V1243 (ia,jb)");
+        Vovov_ = load_block(&V, "2 V1234 - V1243 (ia,jb)");
+        global_dpd_->buf4_close(&V);
+
+        global_dpd_->buf4_init(&K, PSIF_ADC_SEM, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                               "2 K1234 - K1243 (ia,jb)");
+        Kovov_ = load_block(&K, "2 K1234 - K1243 (ia,jb)");
+        global_dpd_->buf4_close(&K);
+        avail -= 3 * nov2;
+    }
     global_dpd_->buf4_close(&A);
 
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
-                           "MO Ints <OV|VV>");
-    // \sigma_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
-    global_dpd_->contract442(&Z, &V, &S, 1, 1, 1, 1);
-    global_dpd_->buf4_close(&V);
-
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
-                           "MO Ints <OO|VO>");
-    // \sigma_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}
-    global_dpd_->contract442(&V, &Z, &S, 3, 3, -1, 1);  // This is genuine
-    global_dpd_->buf4_close(&V);
-    global_dpd_->buf4_close(&Z);
-
-    global_dpd_->file2_close(&S);
-    global_dpd_->file2_close(&B);
+    // The 2h-2p terms in batches: the two integral blocks, and per trial vector two OOVV blocks
+    long int ov = (long int)nocc * nvir;
+    long int ints = ov * nvir * nvir + ov * nocc * nocc;
+    long int pervec = 2 * ov * ov + 4 * ov;
+    sigma_batch_ = (avail > ints) ? (int)std::min<long int>(nroot, (avail - ints) / pervec) : 0;
+    if (sigma_batch_) {
+        Wovvv_ = std::make_shared<Matrix>("<OV|VV> (jab,c)", nocc * nvir * nvir, nvir);
+        Wooov_ = std::make_shared<Matrix>("<OO|VO> (ija,k)", nocc * nocc * nvir, nocc);
+        double **W1 = Wovvv_->pointer();
+        double **W2 = Wooov_->pointer();
+
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
+                               "MO Ints <OV|VV>");
+        for (int h = 0; h < nirrep_; h++) {
+            global_dpd_->buf4_mat_irrep_row_init(&V, h);
+            for (int jc = 0; jc < V.params->rowtot[h]; jc++) {
+                global_dpd_->buf4_mat_irrep_row_rd(&V, h, jc);
+                int j = V.params->roworb[h][jc][0];
+                int c = V.params->roworb[h][jc][1];
+                for (int ab = 0; ab < V.params->coltot[h]; ab++) {
+                    int a = V.params->colorb[h][ab][0];
+                    int b = V.params->colorb[h][ab][1];
+                    W1[(j * nvir + a) * nvir + b][c] = V.matrix[h][0][ab];
+                }
+            }
+            global_dpd_->buf4_mat_irrep_row_close(&V, h);
+        }
+        global_dpd_->buf4_close(&V);
+
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
+                               "MO Ints <OO|VO>");
+        for (int h = 0; h < nirrep_; h++) {
+            global_dpd_->buf4_mat_irrep_row_init(&V, h);
+            for (int ji = 0; ji < V.params->rowtot[h]; ji++) {
+                global_dpd_->buf4_mat_irrep_row_rd(&V, h, ji);
+                int j = V.params->roworb[h][ji][0];
+                int i = V.params->roworb[h][ji][1];
+                for (int ak = 0; ak < V.params->coltot[h]; ak++) {
+                    int a = V.params->colorb[h][ak][0];
+                    int k = V.params->colorb[h][ak][1];
+                    W2[(i * nocc + j) * nvir + a][k] = V.matrix[h][0][ak];
+                }
+            }
+            global_dpd_->buf4_mat_irrep_row_close(&V, h);
+        }
+        global_dpd_->buf4_close(&V);
+        return;
+    }
+
+    // Otherwise cache the 2h-2p integrals of the per-vector path if they fit in half of what is left
+    dpdfile4 F[2];
+    global_dpd_->file4_init(&F[0], PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
+    global_dpd_->file4_init(&F[1], PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), "MO Ints <OO|VO>");
+    long int size = 0;
+    for (int f = 0; f < 2; f++)
+        for (int h = 0; h < nirrep_; h++) size += (long int)F[f].params->rowtot[h] * F[f].params->coltot[h];
+    sigma_cached_ = (size < std::min(avail, dpd_memfree()) / 2);
+    for (int f = 0; f < 2; f++) {
+        if (sigma_cached_ && !F[f].incore) global_dpd_->file4_cache_add(&F[f], 0);
+        global_dpd_->file4_close(&F[f]);
+    }
+}
+
+void ADCWfn::rhf_release_sigma(int irrep) {
+    Aovov_.reset();
+    Vovov_.reset();
+    Kovov_.reset();
+    Wovvv_.reset();
+    Wooov_.reset();
+    sigma_batch_ = 0;
+    sigma_irrep_ = -1;
+
+    if (!sigma_cached_) return;
+    dpdfile4 F[2];
+    global_dpd_->file4_init(&F[0], PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
+    global_dpd_->file4_init(&F[1], PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), "MO Ints <OO|VO>");
+    for (int f = 0; f < 2; f++) {
+        // Entries may already have been evicted under memory pressure
+        if (F[f].incore) global_dpd_->file4_cache_del(&F[f]);
+        global_dpd_->file4_close(&F[f]);
+    }
+    sigma_cached_ = false;
+}
+
+void ADCWfn::rhf_construct_sigma(int irrep, int first, int last, double omega, SharedMatrix Bmat,
+                                 SharedMatrix Smat) {
+    bool do_pr = options_.get_bool("PR");
+    char lbl[32], ampname[32];
+    int nov = nxspi_[irrep];
+    int nvec = last - first;
+    double **Bp = Bmat->pointer();
+    double **Sp = Smat->pointer();
+    dpdfile2 B, S, D, E;
+    dpdbuf4 A, V, K, Z;
+
+    if (!nvec || !nov) return;
+
+    if (Aovov_) {
+        // CIS term and the 3h-3p diagrams for all new trial vectors, which are the rows of Bmat:
+        // \sigma <-- A b + 0.5 (2 K - K) [(2 V - V) b] + 0.5 (2 V - V) [(2 K - K) b]
+        auto T = std::make_shared<Matrix>("DOV/EOV", nvec, nov);
+        double **Tp = T->pointer();
+        C_DGEMM('N', 'T', nvec, nov, nov, 1.0, Bp[first], nov, Aovov_->pointer()[0], nov, 0.0, Sp[first], nov);
+        // D_{ia} <-- \sum_{jb} (2 <ij|ab> - <ij|ba>) b_{jb}
+        C_DGEMM('N', 'T', nvec, nov, nov, 1.0, Bp[first], nov, Vovov_->pointer()[0], nov, 0.0, Tp[0], nov);
+        // \sigma_{ia} <-- 0.5 \sum_{jb} (2 K_{ijab} - K_{ijba}) D_{jb}
+        C_DGEMM('N', 'T', nvec, nov, nov, 0.5, Tp[0], nov, Kovov_->pointer()[0], nov, 1.0, Sp[first], nov);
+        // E_{ia} <-- \sum_{jb} (2 K_{ijab} - K_{ijba}) b_{jb}
+        C_DGEMM('N', 'T', nvec, nov, nov, 1.0, Bp[first], nov, Kovov_->pointer()[0], nov, 0.0, Tp[0], nov);
+        // \sigma_{ia} <-- 0.5 \sum_{jb} (2 <ij|ab> - <ij|ba>) E_{jb}
+        C_DGEMM('N', 'T', nvec, nov, nov, 0.5, Tp[0], nov, Vovov_->pointer()[0], nov, 1.0, Sp[first], nov);
+    }
+
+    // What did not fit in core, one trial vector at a time through the DPD scratch vectors
+    if (!Aovov_ || !sigma_batch_) {
+        sprintf(lbl, "Bsig_[%d]12", irrep);
+        global_dpd_->file2_init(&B, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+        sprintf(lbl, "Ssig_[%d]12", irrep);
+        global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+
+        for (int I = first; I < last; I++) {
+            unpack_ov(Bp[I], &B);
+            if (Aovov_) {
+                unpack_ov(Sp[I], &S);
+            } else {
+                // CIS term and the two 3h-3p diagrams are summed into the sigma vector.
+                global_dpd_->buf4_init(&A, PSIF_ADC_SEM, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                                       "A3h3p1234");
+                global_dpd_->contract422(&A, &B, &S, 0, 0, 1, 0);
+                global_dpd_->buf4_close(&A);
+
+                if (do_pr)
+                    strcpy(ampname, "tilde 2 K1234 - K1243");
+                else
+                    strcpy(ampname, "2 K1234 - K1243");
+                global_dpd_->buf4_init(&K, PSIF_ADC, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                                       ampname);
+                global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"),
+                                       0, "MO Ints 2 V1234 - V1243");
+
+                sprintf(lbl, "DOV_[%d]12", irrep);
+                global_dpd_->file2_init(&D, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+                // D_{ia} <-- \sum_{jb} (2 <ij|ab> - <ij|ba>) b_{jb}
+                global_dpd_->dot24(&B, &V, &D, 0, 0, 1, 0);
+                // \sigma_{ia} <-- 0.5 \sum_{jb} (2 K_{ijab} - K_{ijba}) D_{jb}
+                global_dpd_->dot24(&D, &K, &S, 0, 0, 0.5, 1);
+                global_dpd_->file2_close(&D);
+
+                sprintf(lbl, "EOV_[%d]12", irrep);
+                global_dpd_->file2_init(&E, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+                // E_{ia} <-- \sum_{jb} (2 K_{ijab} - K_{ijba}) b_{jb}
+                global_dpd_->dot24(&B, &K, &E, 0, 0, 1, 0);
+                // \sigma_{ia} <-- \sum_{jb} (2 <ij|ab> - <ij|ba>) E_{jb}
+                global_dpd_->dot24(&E, &V, &S, 0, 0, 0.5, 1);
+                global_dpd_->file2_close(&E);
+
+                global_dpd_->buf4_close(&K);
+                global_dpd_->buf4_close(&V);
+            }
+
+            if (!sigma_batch_) {
+                global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
+                                       "MO Ints <OV|VV>");
+                sprintf(lbl, "ZOOVV_[%d]1234", irrep);
+                global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                                       lbl);
+                // ZOVOV_{jiab} <--  \sum_{c} <jc|ab> b_{ic}
+                global_dpd_->contract424(&V, &B, &Z, 1, 1, 1, 1, 0);
+                global_dpd_->buf4_close(&V);
+
+                global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
+                                       "MO Ints <OO|VO>");
+                // ZOVOV_{ijab} <-- - \sum_{k} <ij|ak> b_{kb}
+                global_dpd_->contract424(&V, &B, &Z, 3, 0, 0, -1, 1);
+                global_dpd_->buf4_close(&V);
+
+                // B_{iajb} <-- (2Z_{ijab}-Z_{ijba}+2Z_{jiab}-Z_{jiba}) / (\omega+e_i-e_a+e_j-e_b)
+                sprintf(lbl, "BOOVV_[%d]1234", irrep);
+                global_dpd_->buf4_scmcopy(&Z, PSIF_ADC_SEM, lbl, 2.0);
+                global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, pqsr, ID("[O,O]"), ID("[V,V]"), lbl, -1.0);
+                global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, qprs, ID("[O,O]"), ID("[V,V]"), lbl, -1.0);
+                global_dpd_->buf4_sort_axpy(&Z, PSIF_ADC_SEM, qpsr, ID("[O,O]"), ID("[V,V]"), lbl, 2.0);
+                global_dpd_->buf4_close(&Z);
+
+                global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                                       lbl);
+                sprintf(lbl, "D_[%d]1234", irrep);
+                global_dpd_->buf4_init(&A, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                                       lbl);
+                global_dpd_->buf4_dirprd(&A, &Z);
+                global_dpd_->buf4_close(&A);
+
+                global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
+                                       "MO Ints <OV|VV>");
+                // \sigma_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
+                global_dpd_->contract442(&Z, &V, &S, 1, 1, 1, 1);
+                global_dpd_->buf4_close(&V);
+
+                global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
+                                       "MO Ints <OO|VO>");
+                // \sigma_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}
+                global_dpd_->contract442(&V, &Z, &S, 3, 3, -1, 1);  // This is genuine
+                global_dpd_->buf4_close(&V);
+                global_dpd_->buf4_close(&Z);
+            }
+
+            pack_ov(&S, Sp[I]);
+        }
+
+        global_dpd_->file2_close(&S);
+        global_dpd_->file2_close(&B);
+    }
+
+    if (sigma_batch_) rhf_construct_sigma_2h2p(first, last, omega, Bp, Sp);
+}
+
+//
+//  The 2h-2p terms for the trial vectors first..last-1, sigma_batch_ of them at a time. With
+//  Y^I_{ijab} = Z^I_{jiab} and the vector index I outermost, every diagram is a single GEMM over
+//  the whole batch. Elements of the dense blocks that are forbidden by symmetry stay zero.
+//
+
+void ADCWfn::rhf_construct_sigma_2h2p(int first, int last, double omega, double **Bp, double **Sp) {
+    int irrep = sigma_irrep_;
+    int nov = nxspi_[irrep];
+    int nocc = occ_sym_.size();
+    int nvir = vir_sym_.size();
+    size_t ov = (size_t)nocc * nvir;
+    size_t vv = (size_t)nvir * nvir;
+    size_t oov = (size_t)nocc * nocc * nvir;
+    size_t oovv = ov * ov;
+    double **W1 = Wovvv_->pointer();
+    double **W2 = Wooov_->pointer();
+
+    for (int I0 = first; I0 < last; I0 += sigma_batch_) {
+        int nb = std::min(sigma_batch_, last - I0);
+        std::vector<double> Bd(nb * ov, 0.0), B2(nb * ov), Sd(nb * ov), St(nb * ov);
+        std::vector<double> Y(nb * oovv), T(nb * oovv);
+
+        // The trial vectors, dense as b^I_{ia} and as b_{k,(I,b)}
+        for (int I = 0; I < nb; I++)
+            for (int n = 0; n < nov; n++) Bd[I * ov + ov_dense_[n]] = Bp[I0 + I][n];
+        for (int I = 0; I < nb; I++)
+            for (int k = 0; k < nocc; k++)
+                for (int b = 0; b < nvir; b++) B2[(k * nb + I) * nvir + b] = Bd[I * ov + k * nvir + b];
+
+        // Y^I_{ijab} <-- \sum_{c} b_{ic} <jc|ab>
+        C_DGEMM('N', 'T', nb * nocc, nocc * vv, nvir, 1.0, Bd.data(), nvir, W1[0], nvir, 0.0, Y.data(), nocc * vv);
+        // Y^I_{ijab} <-- - \sum_{k} <ji|ak> b_{kb}, formed as T_{ija,Ib}
+        C_DGEMM('N', 'N', oov, nb * nvir, nocc, 1.0, W2[0], nocc, B2.data(), nb * nvir, 0.0, T.data(), nb * nvir);
+        for (size_t ija = 0; ija < oov; ija++)
+            for (int I = 0; I < nb; I++)
+                for (int b = 0; b < nvir; b++) Y[I * oovv + ija * nvir + b] -= T[(ija * nb + I) * nvir + b];
+
+        // T^I_{ijcb} = B_{jicb} <-- (2Y_{ijcb}-Y_{ijbc}-Y_{jicb}+2Y_{jibc}) / (\omega+e_i-e_c+e_j-e_b)
+        for (int I = 0; I < nb; I++) {
+            for (int i = 0; i < nocc; i++) {
+                for (int j = 0; j < nocc; j++) {
+                    int hcb = occ_sym_[i] ^ occ_sym_[j] ^ irrep;
+                    double eij = omega + aocce_[i] + aocce_[j];
+                    const double *Yij = &Y[I * oovv + (i * nocc + j) * vv];
+                    const double *Yji = &Y[I * oovv + (j * nocc + i) * vv];
+                    double *Tij = &T[I * oovv + (i * nocc + j) * vv];
+                    for (int c = 0; c < nvir; c++) {
+                        for (int b = 0; b < nvir; b++) {
+                            if ((vir_sym_[c] ^ vir_sym_[b]) != hcb) {
+                                Tij[c * nvir + b] = 0.0;
+                                continue;
+                            }
+                            Tij[c * nvir + b] = (2.0 * Yij[c * nvir + b] - Yij[b * nvir + c] - Yji[c * nvir + b] +
+                                                 2.0 * Yji[b * nvir + c]) /
+                                                (eij - avire_[c] - avire_[b]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // \sigma_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
+        C_DGEMM('N', 'N', nb * nocc, nvir, nocc * vv, 1.0, T.data(), nocc * vv, W1[0], nvir, 0.0, Sd.data(), nvir);
+
+        // Y^I_{ajkb} <-- B_{jkab} = T^I_{kjab}
+        for (int I = 0; I < nb; I++)
+            for (int k = 0; k < nocc; k++)
+                for (int j = 0; j < nocc; j++)
+                    for (int a = 0; a < nvir; a++)
+                        C_DCOPY(nvir, &T[I * oovv + ((k * nocc + j) * nvir + a) * nvir], 1,
+                                &Y[I * oovv + ((a * nocc + j) * nocc + k) * nvir], 1);
+
+        // \sigma_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}, formed as (Ia,i)
+        C_DGEMM('N', 'N', nb * nvir, nocc, oov, 1.0, Y.data(), oov, W2[0], nocc, 0.0, St.data(), nocc);
+        for (int I = 0; I < nb; I++)
+            for (int i = 0; i < nocc; i++)
+                for (int a = 0; a < nvir; a++) Sd[I * ov + i * nvir + a] -= St[(I * nvir + a) * nocc + i];
+
+        for (int I = 0; I < nb; I++)
+            for (int n = 0; n < nov; n++) Sp[I0 + I][n] += Sd[I * ov + ov_dense_[n]];
+    }
 }
 }
 }  // End Namespaces
@@ -34,6 +34,7 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
 #include <cmath>
+#include <vector>
 #include "adc.h"
 
 namespace psi {
@@ -43,6 +44,11 @@ namespace adc {
 //  This block-Davidson code is based on the in-core version put in lib/libqt/david.cc
 //  but written by utilizind DPD algorithm.
 //
+//  The Ritz space and its sigma vectors are held in core as rows of packed OV vectors
+//  (see pack_ov), so that the sigma vectors of all new trial vectors are built at once and the
+//  Rayleigh matrix, the correction vectors and the collapse are matrix products.
+//  The trial vectors B^(I) are read from and written back to PSIF_ADC at either end.
+//
 //  S: Sigma vector for the response matrix with OV indices.
 //  F: The correction vectors for the basis of Ritz space.
 //  V: Converged eigenvectors.
@@ -52,160 +58,138 @@ void ADCWfn::rhf_diagonalize(int irrep, int num_root, bool first, double omega_i
     char lbl[32];
     int iter, converged, prev_length, length, *conv, skip_check, maxdim, *residual_ok;
     double **Alpha, **G, *lambda, *lambda_o, *residual_norm, cutoff;
-    dpdfile2 B, S, Bp, Bn, F, L, V;
-    dpdfile4 A;
+    dpdfile2 B, L, V;
 
-    maxdim = 10 * rpi_[irrep];
+    int nroot = rpi_[irrep];
+    int nov = nxspi_[irrep];
+    maxdim = 10 * nroot;
     iter = 0;
     converged = 0;
     cutoff = conv_;
-    length = rpi_[irrep];
+    length = nroot;
     prev_length = 0;
 
-    residual_ok = init_int_array(rpi_[irrep]);
-    residual_norm = init_array(rpi_[irrep]);
-    conv = init_int_array(rpi_[irrep]);
+    residual_ok = init_int_array(nroot);
+    residual_norm = init_array(nroot);
+    conv = init_int_array(nroot);
 
     G = block_matrix(maxdim, maxdim);
     Alpha = block_matrix(maxdim, maxdim);
     lambda = init_array(maxdim);
     lambda_o = init_array(maxdim);
 
-    for (int I = 0; I < rpi_[irrep]; I++) lambda_o[I] = omega_guess_->get(irrep, I);
+    auto Bmat = std::make_shared<Matrix>("Ritz space", maxdim, nov);
+    auto Smat = std::make_shared<Matrix>("Sigma vectors", maxdim, nov);
+    auto Fmat = std::make_shared<Matrix>("Correction vectors", nroot, nov);
+    auto Wmat = std::make_shared<Matrix>("Davidson scratch", maxdim, maxdim);
+    double **Bp = Bmat->pointer();
+    double **Sp = Smat->pointer();
+    double **Fp = Fmat->pointer();
+    double **Wp = Wmat->pointer();
+    std::vector<double> Bpp(nov), denom(nov);
+
+    for (int I = 0; I < nroot; I++) {
+        sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
+        global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+        pack_ov(&B, Bp[I]);
+        global_dpd_->file2_close(&B);
+    }
+
+    for (int I = 0; I < nroot; I++) lambda_o[I] = omega_guess_->get(irrep, I);
     shift_denom4(irrep, omega_in);
 
     auto mode = std::ostream::app;
     auto printer = std::make_shared<PsiOutStream>("iter.dat", mode);
 
     timer_on("SEM");
-    while (converged < rpi_[irrep] && iter < sem_max_) {
+    while (converged < nroot && iter < sem_max_) {
         skip_check = 0;
         printer->Printf("\niter = %d, dim = %d\n", iter, length);
 
         // Evaluating the sigma vectors
         timer_on("Sigma construction");
-        for (int I = prev_length; I < length; I++)
-            if (!nopen_) rhf_construct_sigma(irrep, I);
+        if (!nopen_) rhf_construct_sigma(irrep, prev_length, length, omega_in, Bmat, Smat);
         timer_off("Sigma construction");
 
         // Making so called Davidson mini-Hamiltonian, or Rayleigh matrix
+        int nnew = length - prev_length;
+        if (nnew && nov) {
+            C_DGEMM('N', 'T', nnew, length, nov, 1.0, Sp[prev_length], nov, Bp[0], nov, 0.0, Wp[0], maxdim);
+        }
         for (int I = prev_length; I < length; I++) {
-            sprintf(lbl, "S^(%d)_[%d]12", I, irrep);
-            global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
             for (int J = 0; J <= I; J++) {
-                sprintf(lbl, "B^(%d)_[%d]12", J, irrep);
-                global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                double sum = global_dpd_->file2_dot(&B, &S);
+                double sum = (nov ? Wp[I - prev_length][J] : 0.0);
                 if (I != J)
                     G[I][J] = G[J][I] = sum;
                 else
                     G[I][J] = sum;
-                global_dpd_->file2_close(&B);
             }
-            global_dpd_->file2_close(&S);
         }
         if (first && !iter) poles_[irrep][num_root - 1].ps_value = G[num_root - 1][num_root - 1];
         sq_rsp(length, length, G, lambda, 1, Alpha, 1e-12);
 
-        // Constructing the corretion vectors
-        for (int k = 0; k < rpi_[irrep]; k++) {
-            sprintf(lbl, "F^(%d)_[%d]12", k, irrep);
-            global_dpd_->file2_init(&F, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-            global_dpd_->file2_scm(&F, 0.0);
-            for (int I = 0; I < length; I++) {
-                sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
-                global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                global_dpd_->file2_axpy(&B, &F, -Alpha[I][k] * lambda[k], 0);
-                global_dpd_->file2_close(&B);
-                sprintf(lbl, "S^(%d)_[%d]12", I, irrep);
-                global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-                global_dpd_->file2_axpy(&S, &F, Alpha[I][k], 0);
-                global_dpd_->file2_close(&S);
-            }
+        // Constructing the corretion vectors, F_k = \sum_I \alpha_{Ik} (S_I - \lambda_k B_I)
+        for (int I = 0; I < length; I++)
+            for (int k = 0; k < nroot; k++) Wp[I][k] = -Alpha[I][k] * lambda[k];
+        if (nov) {
+            C_DGEMM('T', 'N', nroot, nov, length, 1.0, Alpha[0], maxdim, Sp[0], nov, 0.0, Fp[0], nov);
+            C_DGEMM('T', 'N', nroot, nov, length, 1.0, Wp[0], maxdim, Bp[0], nov, 1.0, Fp[0], nov);
+        }
+        for (int k = 0; k < nroot; k++) {
             shift_denom2(k, irrep, lambda[k]);
             sprintf(lbl, "L^(%d)_[%d]12", k, irrep);
             global_dpd_->file2_init(&L, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-            global_dpd_->file2_dirprd(&L, &F);
+            pack_ov(&L, denom.data());
             global_dpd_->file2_close(&L);
+            for (int n = 0; n < nov; n++) Fp[k][n] *= denom[n];
 
-            double norm = global_dpd_->file2_dot_self(&F);
+            double norm = C_DDOT(nov, Fp[k], 1, Fp[k], 1);
             residual_norm[k] = sqrt(norm);
             if (residual_norm[k] > norm_tol_)
-                global_dpd_->file2_scm(&F, 1 / residual_norm[k]);
+                C_DSCAL(nov, 1 / residual_norm[k], Fp[k], 1);
             else {
-                global_dpd_->file2_scm(&F, 0.0);
+                C_DSCAL(nov, 0.0, Fp[k], 1);
                 residual_ok[k] = 1;
             }
-            global_dpd_->file2_close(&F);
         }
 
         prev_length = length;
 
         // Expand the Ritz space by orthogonalizing {F} to {B} according to Gram-Schmidt procedure
-        for (int k = 0; k < rpi_[irrep]; k++) {
-            sprintf(lbl, "F^(%d)_[%d]12", k, irrep);
-            global_dpd_->file2_init(&F, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-            sprintf(lbl, "Bpp_[%d]12", irrep);
-            global_dpd_->file2_copy(&F, PSIF_ADC_SEM, lbl);
+        for (int k = 0; k < nroot; k++) {
+            C_DCOPY(nov, Fp[k], 1, Bpp.data(), 1);
             for (int I = 0; I < length; I++) {
-                sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
-                global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                double coeff = -global_dpd_->file2_dot(&F, &B);
-                sprintf(lbl, "Bpp_[%d]12", irrep);
-                global_dpd_->file2_init(&Bp, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-                global_dpd_->file2_axpy(&B, &Bp, coeff, 0.0);
-                global_dpd_->file2_close(&B);
-                global_dpd_->file2_close(&Bp);
+                double coeff = -C_DDOT(nov, Fp[k], 1, Bp[I], 1);
+                C_DAXPY(nov, coeff, Bp[I], 1, Bpp.data(), 1);
             }
-            global_dpd_->file2_close(&F);
-            sprintf(lbl, "Bpp_[%d]12", irrep);
-            global_dpd_->file2_init(&B, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-            double norm = global_dpd_->file2_dot_self(&B);
+            double norm = C_DDOT(nov, Bpp.data(), 1, Bpp.data(), 1);
             norm = sqrt(norm);
 
             if (norm > norm_tol_) {
-                global_dpd_->file2_scm(&B, 1 / norm);
-                sprintf(lbl, "B^(%d)_[%d]12", length, irrep);
-                global_dpd_->file2_copy(&B, PSIF_ADC, lbl);
+                for (int n = 0; n < nov; n++) Bp[length][n] = Bpp[n] / norm;
                 length++;
             }
-            global_dpd_->file2_close(&B);
         }
 
-        if (maxdim - length < rpi_[irrep] || (nxspi_[irrep] - length) < rpi_[irrep]) {
+        if (maxdim - length < nroot || (nov - length) < nroot) {
             printer->Printf("Subspace too large:maxdim = %d, L = %d\n", maxdim, length);
             printer->Printf("Collapsing eigenvectors.\n");
 
-            for (int k = 0; k < rpi_[irrep]; k++) {
-                sprintf(lbl, "Bn^(%d)_[%d]12", k, irrep);
-                global_dpd_->file2_init(&Bn, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-                global_dpd_->file2_scm(&Bn, 0.0);
-                for (int I = 0; I < prev_length; I++) {
-                    sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
-                    global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                    global_dpd_->file2_axpy(&B, &Bn, Alpha[I][k], 0);
-                    global_dpd_->file2_close(&B);
-                }
-                global_dpd_->file2_close(&Bn);
-            }
-            for (int k = 0; k < rpi_[irrep]; k++) {
-                sprintf(lbl, "Bn^(%d)_[%d]12", k, irrep);
-                global_dpd_->file2_init(&Bn, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
-                sprintf(lbl, "B^(%d)_[%d]12", k, irrep);
-                global_dpd_->file2_copy(&Bn, PSIF_ADC, lbl);
-                global_dpd_->file2_close(&Bn);
+            if (nov) {
+                C_DGEMM('T', 'N', nroot, nov, prev_length, 1.0, Alpha[0], maxdim, Bp[0], nov, 0.0, Fp[0], nov);
+                C_DCOPY(nroot * (size_t)nov, Fp[0], 1, Bp[0], 1);
             }
             skip_check = 1;
-            length = rpi_[irrep];
+            length = nroot;
             prev_length = 0;
         }
 
         if (!skip_check) {
-            zero_int_array(conv, rpi_[irrep]);
+            zero_int_array(conv, nroot);
             printer->Printf("Root          Eigenvalue   Delta     Res_Norm     Conv?\n");
             printer->Printf("----     ---------------- -------    --------- ----------\n");
 
-            for (int k = 0; k < rpi_[irrep]; k++) {
+            for (int k = 0; k < nroot; k++) {
                 double diff = std::fabs(lambda[k] - lambda_o[k]);
                 if (diff < cutoff && residual_ok[k]) {
                     conv[k] = 1;
@@ -222,17 +206,12 @@ void ADCWfn::rhf_diagonalize(int irrep, int num_root, bool first, double omega_i
 
         if (all_conv == num_root && converged >= num_root) {
             printer->Printf("Davidson algorithm converged in %d iterations for %dth root.\n", iter, num_root - 1);
+            if (nov) C_DGEMM('T', 'N', num_root, nov, length, 1.0, Alpha[0], maxdim, Bp[0], nov, 0.0, Fp[0], nov);
             for (int I = 0; I < num_root; I++) {
                 eps[I] = lambda[I];
                 sprintf(lbl, "V^(%d)_[%d]12", I, irrep);
                 global_dpd_->file2_init(&V, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                global_dpd_->file2_scm(&V, 0.0);
-                for (int k = 0; k < length; k++) {
-                    sprintf(lbl, "B^(%d)_[%d]12", k, irrep);
-                    global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
-                    global_dpd_->file2_axpy(&B, &V, Alpha[k][I], 0);
-                    global_dpd_->file2_close(&B);
-                }
+                unpack_ov(Fp[I], &V);
                 global_dpd_->file2_close(&V);
             }
             break;
@@ -241,6 +220,14 @@ void ADCWfn::rhf_diagonalize(int irrep, int num_root, bool first, double omega_i
     }
     timer_off("SEM");
 
+    // Leave the Ritz space on disk, where the next call starts from
+    for (int I = 0; I < length; I++) {
+        sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
+        global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+        unpack_ov(Bp[I], &B);
+        global_dpd_->file2_close(&B);
+    }
+
     free(residual_ok);
     free(residual_norm);
     free(conv);
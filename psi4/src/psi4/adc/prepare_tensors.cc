@@ -233,6 +233,19 @@ void ADCWfn::rhf_prepare_tensors() {
     }
     global_dpd_->buf4_close(&Aovov);
 
+    // (ia,jb)-sorted copies of the 3h-3p integrals and amplitudes, loaded per irrep by rhf_prepare_sigma
+    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints 2 V1234 - V1243");
+    global_dpd_->buf4_sort(&V, PSIF_ADC_SEM, prqs, ID("[O,V]"), ID("[O,V]"), "2 V1234 - V1243 (ia,jb)");
+    global_dpd_->buf4_close(&V);
+    if (do_pr)
+        strcpy(ampname, "tilde 2 K1234 - K1243");
+    else
+        strcpy(ampname, "2 K1234 - K1243");
+    global_dpd_->buf4_init(&K, PSIF_ADC, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, ampname);
+    global_dpd_->buf4_sort(&K, PSIF_ADC_SEM, prqs, ID("[O,V]"), ID("[O,V]"), "2 K1234 - K1243 (ia,jb)");
+    global_dpd_->buf4_close(&K);
+
     psio_->close(PSIF_ADC, 1);
     psio_->close(PSIF_ADC_SEM, 1);
     psio_->close(PSIF_LIBTRANS_DPD, 1);
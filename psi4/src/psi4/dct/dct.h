@@ -551,8 +551,9 @@ class DCTSolver : public Wavefunction {
     void form_df_g_vooo();
     /// Form density-fitted MO-basis TEI g(OV|VV) in chemists' notation
     void form_df_g_ovvv();
-    /// Form density-fitted MO-basis TEI g<VV|VV> in physists' notation
-    void form_df_g_vvvv();
+    /// Add the density-fitted (VV|VV) x Gamma_VVVV terms to the VV Lagrangian, never forming g(VV|VV)
+    void df_lagrangian_VVVV(dpdbuf4* G, int target, bool antisymmetrize, double alpha, const Matrix& bQx,
+                            const Matrix& bQo, const Dimension& virx, const Dimension& viro, dpdfile2* X);
     /// Form MO-based Gbar*Gamma
     void build_gbarGamma_RHF();
     void build_gbarGamma_UHF();
@@ -49,6 +49,7 @@
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <cstdio>
@@ -1021,70 +1022,164 @@ void DCTSolver::form_df_g_ovvv() {
 }
 
 /**
- * Form density-fitted MO-basis TEI g(VV|VV)
+ * Add a (VV|VV) contribution to a virtual-virtual block of the MO Lagrangian without forming the integrals
+ *     target = 0:  X_Ep += alpha * Sum_qrs (Er|qs) G_pq,rs
+ *     target = 1:  X_Eq += alpha * Sum_prs (pr|Es) G_pq,rs
+ * where (pq|rs) = Sum_Q b(Q|pq) b(Q|rs). With antisymmetrize, G_pq,rs - G_pq,sr is contracted instead, which
+ * gives the <..||..> contractions. bQx holds b(Q|ab) for the spin of the target index, bQo for the other one.
+ * G is read in row batches that fit into the free DPD memory left by Y and the partial X of every thread, and
+ * the auxiliary index is split over the threads.
+ * Memory required: O(Q V^2)
  */
-void DCTSolver::form_df_g_vvvv() {
-    dct_timer_on("DCTSolver::DF Transform_VVVV");
+void DCTSolver::df_lagrangian_VVVV(dpdbuf4* G, int target, bool antisymmetrize, double alpha, const Matrix& bQx,
+                                   const Matrix& bQo, const Dimension& virx, const Dimension& viro, dpdfile2* X) {
+    dct_timer_on("DCTSolver::DF g_VVVV Gamma_VVVV");
 
     int nthreads = 1;
 #ifdef _OPENMP
     nthreads = Process::environment.get_n_threads();
 #endif
+    nthreads = std::max(1, std::min(nthreads, nQ_));
 
-    dpdbuf4 I;
+    // Offset of the (a,b) pairs with a in irrep ha inside block hab of b(Q|ab)
+    auto pair_offsets = [&](const Dimension& vir) {
+        std::vector<std::vector<size_t>> offset(nirrep_, std::vector<size_t>(nirrep_, 0));
+        for (int hab = 0; hab < nirrep_; ++hab) {
+            size_t entrance = 0;
+            for (int ha = 0; ha < nirrep_; ++ha) {
+                offset[hab][ha] = entrance;
+                entrance += (size_t)vir[ha] * vir[ha ^ hab];
+            }
+        }
+        return offset;
+    };
+    auto offx = pair_offsets(virx);
+    auto offo = pair_offsets(viro);
+
+    // Y(Q|xy) = Sum_oz b(Q|oz) G, stored like b(Q|ab) of the target spin.
+    // Target 0: the row is (x,o) and the column (y,z); target 1: the row is (o,x) and the column (z,y).
+    Matrix Y("Y (Q|VV)", bQx.rowspi(), bQx.colspi());
+    dpdparams4* params = G->params;
+
+    // Y and the partial X of every thread are held next to the G batches
+    long int scratch = 0;
+    for (int h = 0; h < nirrep_; ++h)
+        scratch += (long int)bQx.rowdim(h) * bQx.coldim(h) + (long int)nthreads * virx[h] * virx[h];
 
-    // g(ab|cd) = Sum_Q b(ab|Q) b(Q|cd)
-    // Alpha-Alpha
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V>=V]+"), ID("[V>=V]+"), 0,
-                           "MO Ints (VV|VV)");
     for (int h = 0; h < nirrep_; ++h) {
-        if (I.params->rowtot[h] > 0 && I.params->coltot[h] > 0) {
-            double** bQabA_mo_p = bQabA_mo_.pointer(h);
-            global_dpd_->buf4_mat_irrep_init(&I, h);
-            C_DGEMM('T', 'N', I.params->rowtot[h], I.params->coltot[h], nQ_, 1.0, bQabA_mo_p[0], bQabA_mo_.coldim(h),
-                    bQabA_mo_p[0], bQabA_mo_.coldim(h), 0.0, I.matrix[h][0], I.params->coltot[h]);
-            global_dpd_->buf4_mat_irrep_wrt(&I, h);
-            global_dpd_->buf4_mat_irrep_close(&I, h);
-        }
-    }
-    global_dpd_->buf4_close(&I);
+        int nrow = params->rowtot[h];
+        int ncol = params->coltot[h];
+        if (nrow == 0 || ncol == 0) continue;
+
+        long int rows_per_batch = std::max(0L, dpd_memfree() - scratch) / 2 / ncol;
+        if (rows_per_batch < 1) throw PSIEXCEPTION("DCT: not enough memory to hold one row of the VVVV density.");
+        if (rows_per_batch > nrow) rows_per_batch = nrow;
+
+        global_dpd_->buf4_mat_irrep_init_block(G, h, rows_per_batch);
+        for (int start = 0; start < nrow; start += rows_per_batch) {
+            int nbatch = std::min((int)rows_per_batch, nrow - start);
+            global_dpd_->buf4_mat_irrep_rd_block(G, h, start, nbatch);
+            double** Gp = G->matrix[h];
+
+            if (antisymmetrize) {
+#pragma omp parallel for num_threads(nthreads)
+                for (int row = 0; row < nbatch; ++row) {
+                    for (int rs = 0; rs < ncol; ++rs) {
+                        int r = params->colorb[h][rs][0];
+                        int s = params->colorb[h][rs][1];
+                        int sr = params->colidx[s][r];
+                        if (sr < rs) continue;
+                        double g_rs = Gp[row][rs];
+                        double g_sr = Gp[row][sr];
+                        Gp[row][rs] = g_rs - g_sr;
+                        Gp[row][sr] = g_sr - g_rs;
+                    }
+                }
+            }
 
-    if (options_.get_str("REFERENCE") != "RHF") {
-        // Alpha-Beta
-        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[v,v]"), ID("[V>=V]+"), ID("[v>=v]+"), 0,
-                               "MO Ints (VV|vv)");
-        for (int h = 0; h < nirrep_; ++h) {
-            if (I.params->rowtot[h] > 0 && I.params->coltot[h] > 0) {
-                double** bQabA_mo_p = bQabA_mo_.pointer(h);
-                double** bQabB_mo_p = bQabB_mo_.pointer(h);
-                global_dpd_->buf4_mat_irrep_init(&I, h);
-                C_DGEMM('T', 'N', I.params->rowtot[h], I.params->coltot[h], nQ_, 1.0, bQabA_mo_p[0],
-                        bQabA_mo_.coldim(h), bQabB_mo_p[0], bQabB_mo_.coldim(h), 0.0, I.matrix[h][0],
-                        I.params->coltot[h]);
-                global_dpd_->buf4_mat_irrep_wrt(&I, h);
-                global_dpd_->buf4_mat_irrep_close(&I, h);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+            for (int thread = 0; thread < nthreads; ++thread) {
+                int Q0 = thread * nQ_ / nthreads;
+                int nQt = (thread + 1) * nQ_ / nthreads - Q0;
+                if (nQt == 0) continue;
+
+                for (int row = 0; row < nbatch; ++row) {
+                    int p = params->roworb[h][start + row][0];
+                    int q = params->roworb[h][start + row][1];
+                    int hp = params->psym[p];
+                    int hq = params->qsym[q];
+                    int hx = target == 0 ? hp : hq;
+                    int ho = target == 0 ? hq : hp;
+                    int x = target == 0 ? p - params->poff[hp] : q - params->qoff[hq];
+                    int o = target == 0 ? q - params->qoff[hq] : p - params->poff[hp];
+
+                    size_t coloff = 0;
+                    for (int hr = 0; hr < nirrep_; ++hr) {
+                        int hs = h ^ hr;
+                        int nr = params->rpi[hr];
+                        int ns = params->spi[hs];
+                        if (nr == 0 || ns == 0) continue;
+                        double* Gsub = &Gp[row][coloff];
+                        coloff += (size_t)nr * ns;
+
+                        if (target == 0) {
+                            // Y(Q|x r) += Sum_s b(Q|o s) G_xo,rs
+                            int hoz = ho ^ hs;
+                            int hxy = hx ^ hr;
+                            double* bo = &bQo.pointer(hoz)[Q0][offo[hoz][ho] + (size_t)o * ns];
+                            double* y = &Y.pointer(hxy)[Q0][offx[hxy][hx] + (size_t)x * nr];
+                            C_DGEMM('N', 'T', nQt, nr, ns, 1.0, bo, bQo.coldim(hoz), Gsub, ns, 1.0, y, Y.coldim(hxy));
+                        } else {
+                            // Y(Q|x s) += Sum_r b(Q|o r) G_ox,rs
+                            int hoz = ho ^ hr;
+                            int hxy = hx ^ hs;
+                            double* bo = &bQo.pointer(hoz)[Q0][offo[hoz][ho] + (size_t)o * nr];
+                            double* y = &Y.pointer(hxy)[Q0][offx[hxy][hx] + (size_t)x * ns];
+                            C_DGEMM('N', 'N', nQt, ns, nr, 1.0, bo, bQo.coldim(hoz), Gsub, ns, 1.0, y, Y.coldim(hxy));
+                        }
+                    }
+                }
             }
         }
-        global_dpd_->buf4_close(&I);
-
-        // Beta-Beta
-        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[v,v]"), ID("[v,v]"), ID("[v>=v]+"), ID("[v>=v]+"), 0,
-                               "MO Ints (vv|vv)");
-        for (int h = 0; h < nirrep_; ++h) {
-            if (I.params->rowtot[h] > 0 && I.params->coltot[h] > 0) {
-                double** bQabB_mo_p = bQabB_mo_.pointer(h);
-                global_dpd_->buf4_mat_irrep_init(&I, h);
-                C_DGEMM('T', 'N', I.params->rowtot[h], I.params->coltot[h], nQ_, 1.0, bQabB_mo_p[0],
-                        bQabB_mo_.coldim(h), bQabB_mo_p[0], bQabB_mo_.coldim(h), 0.0, I.matrix[h][0],
-                        I.params->coltot[h]);
-                global_dpd_->buf4_mat_irrep_wrt(&I, h);
-                global_dpd_->buf4_mat_irrep_close(&I, h);
+        global_dpd_->buf4_mat_irrep_close_block(G, h, rows_per_batch);
+    }
+
+    // X_Ex += alpha * Sum_Qy b(Q|Ey) Y(Q|xy), one partial X per slice of the auxiliary index
+    std::vector<Matrix> Xt;
+    for (int thread = 0; thread < nthreads; ++thread) Xt.push_back(Matrix("X (partial)", virx, virx));
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int thread = 0; thread < nthreads; ++thread) {
+        int Q0 = thread * nQ_ / nthreads;
+        int Q1 = (thread + 1) * nQ_ / nthreads;
+        for (int hxy = 0; hxy < nirrep_; ++hxy) {
+            for (int hx = 0; hx < nirrep_; ++hx) {
+                int nx = virx[hx];
+                int ny = virx[hx ^ hxy];
+                if (nx == 0 || ny == 0) continue;
+                double** bp = bQx.pointer(hxy);
+                double** Yp = Y.pointer(hxy);
+                double** Xp = Xt[thread].pointer(hx);
+                for (int Q = Q0; Q < Q1; ++Q) {
+                    C_DGEMM('N', 'T', nx, nx, ny, alpha, &bp[Q][offx[hxy][hx]], ny, &Yp[Q][offx[hxy][hx]], ny, 1.0,
+                            Xp[0], nx);
+                }
             }
         }
-        global_dpd_->buf4_close(&I);
     }
 
-    dct_timer_off("DCTSolver::DF Transform_VVVV");
+    global_dpd_->file2_mat_init(X);
+    global_dpd_->file2_mat_rd(X);
+    for (int h = 0; h < nirrep_; ++h) {
+        for (int thread = 0; thread < nthreads; ++thread) {
+            double** Xp = Xt[thread].pointer(h);
+            for (int e = 0; e < virx[h]; ++e)
+                for (int a = 0; a < virx[h]; ++a) X->matrix[h][e][a] += Xp[e][a];
+        }
+    }
+    global_dpd_->file2_mat_wrt(X);
+    global_dpd_->file2_mat_close(X);
+
+    dct_timer_off("DCTSolver::DF g_VVVV Gamma_VVVV");
 }
 
 /**
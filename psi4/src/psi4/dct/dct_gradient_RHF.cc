@@ -263,31 +263,45 @@ void DCTSolver::compute_lagrangian_VV_RHF(bool separate_gbargamma) {
     // 2 * <VV||VV> Г_VVVV
     //
 
-    // X_EA += 2 * <EB||CD> Г_ABCD
-    dct_timer_on("DCTSolver::2 * g_EBCD Gamma_ABCD");
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 1,
-                           "MO Ints <VV|VV>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
-                           varname("<VV|VV>"));
-
-    global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
-    dct_timer_off("DCTSolver::2 * g_EBCD Gamma_ABCD");
-
-    // X_EA += 4 * <Eb|Cd> Г_AbCd
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
-                           "MO Ints <VV|VV>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
-                           varname("SF <VV|VV>"));
+    if (options_.get_str("DCT_TYPE") == "DF") {
+        // The same two terms straight from b(Q|ab); the <VV|VV> integrals are never formed
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
+                               varname("<VV|VV>"));
+        df_lagrangian_VVVV(&G, 0, true, 2.0, bQabA_mo_, bQabA_mo_, navirpi_, navirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
+                               varname("SF <VV|VV>"));
+        df_lagrangian_VVVV(&G, 0, false, 4.0, bQabA_mo_, bQabA_mo_, navirpi_, navirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->file2_close(&X);
+    } else {
+        // X_EA += 2 * <EB||CD> Г_ABCD
+        dct_timer_on("DCTSolver::2 * g_EBCD Gamma_ABCD");
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 1,
+                               "MO Ints <VV|VV>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
+                               varname("<VV|VV>"));
+
+        global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+        dct_timer_off("DCTSolver::2 * g_EBCD Gamma_ABCD");
 
-    global_dpd_->contract442(&I, &G, &X, 0, 0, 4.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+        // X_EA += 4 * <Eb|Cd> Г_AbCd
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
+                               "MO Ints <VV|VV>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 0,
+                               varname("SF <VV|VV>"));
+
+        global_dpd_->contract442(&I, &G, &X, 0, 0, 4.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+    }
 
     //
     // <OO||VV> Г_OOVV
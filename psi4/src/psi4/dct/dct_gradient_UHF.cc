@@ -320,11 +320,8 @@ void DCTSolver::oo_gradient_init() {
     // gradients
     if (options_.get_str("AO_BASIS") == "DISK" && options_.get_str("DCT_TYPE") == "CONV") {
         _ints->transform_tei(MOSpace::vir, MOSpace::vir, MOSpace::vir, MOSpace::vir);
-    } else if (options_.get_str("DCT_TYPE") == "DF") {
-        psio_->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
-        form_df_g_vvvv();
-        psio_->close(PSIF_LIBTRANS_DPD, 1);
     } else {
+        // Density-fitted gradients contract b(Q|ab) with the VVVV density directly, see df_lagrangian_VVVV
         return;
     }
     // Hack for now. TODO: Implement AO_BASIS=DISK algorithm for gradients
@@ -3369,53 +3366,78 @@ void DCTSolver::compute_lagrangian_VV(bool separate_gbargamma) {
     // 2 * <VV||VV> Г_VVVV
     //
 
-    // X_EA += 2 * <EB||CD> Г_ABCD
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 1,
-                           "MO Ints <VV|VV>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V>V]-"), ID("[V>V]-"), 0,
-                           varname("<VV|VV>"));
+    if (options_.get_str("DCT_TYPE") == "DF") {
+        // The same four terms straight from b(Q|ab); the <VV|VV>, <Vv|Vv> and <vv|vv> integrals are never formed
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V>V]-"), ID("[V>V]-"), 0,
+                               varname("<VV|VV>"));
+        df_lagrangian_VVVV(&G, 0, true, 2.0, bQabA_mo_, bQabA_mo_, navirpi_, navirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               varname("<Vv|Vv>"));
+        df_lagrangian_VVVV(&G, 0, false, 4.0, bQabA_mo_, bQabB_mo_, navirpi_, nbvirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->file2_close(&X);
 
-    global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('v'), ID('v'), "X <v|v>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[v,v]"), ID("[v,v]"), ID("[v>v]-"), ID("[v>v]-"), 0,
+                               varname("<vv|vv>"));
+        df_lagrangian_VVVV(&G, 0, true, 2.0, bQabB_mo_, bQabB_mo_, nbvirpi_, nbvirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               varname("<Vv|Vv>"));
+        df_lagrangian_VVVV(&G, 1, false, 4.0, bQabB_mo_, bQabA_mo_, nbvirpi_, navirpi_, &X);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->file2_close(&X);
+    } else {
+        // X_EA += 2 * <EB||CD> Г_ABCD
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), ID("[V,V]"), 1,
+                               "MO Ints <VV|VV>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,V]"), ID("[V,V]"), ID("[V>V]-"), ID("[V>V]-"), 0,
+                               varname("<VV|VV>"));
 
-    // X_EA += 4 * <Eb|Cd> Г_AbCd
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
-                           "MO Ints <Vv|Vv>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
-                           varname("<Vv|Vv>"));
+        global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
 
-    global_dpd_->contract442(&I, &G, &X, 0, 0, 4.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+        // X_EA += 4 * <Eb|Cd> Г_AbCd
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('V'), ID('V'), "X <V|V>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               "MO Ints <Vv|Vv>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               varname("<Vv|Vv>"));
 
-    // X_ea += 2 * <ib||cd> Г_abcd
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('v'), ID('v'), "X <v|v>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[v,v]"), ID("[v,v]"), ID("[v,v]"), ID("[v,v]"), 1,
-                           "MO Ints <vv|vv>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[v,v]"), ID("[v,v]"), ID("[v>v]-"), ID("[v>v]-"), 0,
-                           varname("<vv|vv>"));
+        global_dpd_->contract442(&I, &G, &X, 0, 0, 4.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
 
-    global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+        // X_ea += 2 * <ib||cd> Г_abcd
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('v'), ID('v'), "X <v|v>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[v,v]"), ID("[v,v]"), ID("[v,v]"), ID("[v,v]"), 1,
+                               "MO Ints <vv|vv>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[v,v]"), ID("[v,v]"), ID("[v>v]-"), ID("[v>v]-"), 0,
+                               varname("<vv|vv>"));
 
-    // X_ea += 4 * <eB|cD> Г_AbCd
-    global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('v'), ID('v'), "X <v|v>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
-                           "MO Ints <Vv|Vv>");
-    global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
-                           varname("<Vv|Vv>"));
+        global_dpd_->contract442(&I, &G, &X, 0, 0, 2.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
 
-    global_dpd_->contract442(&I, &G, &X, 1, 1, 4.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+        // X_ea += 4 * <eB|cD> Г_AbCd
+        global_dpd_->file2_init(&X, PSIF_DCT_DPD, 0, ID('v'), ID('v'), "X <v|v>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               "MO Ints <Vv|Vv>");
+        global_dpd_->buf4_init(&G, PSIF_DCT_DENSITY, 0, ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), ID("[V,v]"), 0,
+                               varname("<Vv|Vv>"));
+
+        global_dpd_->contract442(&I, &G, &X, 1, 1, 4.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+    }
 
     //
     // <OO||VV> Г_OOVV
@@ -26,11 +26,23 @@
  * @END LICENSE
  */
 
+#include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
 #include "psi4/libqt/qt.h"
 
 #include "defines.h"
@@ -39,531 +51,246 @@
 namespace psi {
 namespace dfoccwave {
 
-void DFOCC::ccsd_canonic_triples() {
-    // defs
-    SharedTensor2d K, L, M, I, J, T, U, Tau, W, X, Y, Z;
-    SharedTensor2d V, J1, J2, J3, Jt;
-    SharedTensor1d Eijk;
-    long int Nijk;
+// (T) checkpoint: the energy of every finished ij task, so that an interrupted run can be continued
+static void write_triples_checkpoint(const std::string &fname, long int nocc, long int nvir, long int naux,
+                                     double eccsd, const std::vector<char> &done, const std::vector<double> &Eij) {
+    // Write a new file and rename it, so that a preempted job never leaves a half-written checkpoint
+    std::string tmpname = fname + ".tmp";
+    std::ofstream out(tmpname.c_str());
+    out << "DFOCC (T) checkpoint\n";
+    out << nocc << " " << nvir << " " << naux << " " << done.size() << "\n";
+    out << std::setprecision(17) << eccsd << "\n";
+    for (size_t t = 0; t < done.size(); ++t)
+        if (done[t]) out << t << " " << Eij[t] << "\n";
+    out.close();
+    if (!out || std::rename(tmpname.c_str(), fname.c_str()) != 0)
+        outfile->Printf("\tWarning: could not write the (T) checkpoint file %s.\n", fname.c_str());
+}
 
-    // Find number of unique ijk combinations (i>=j>=k)
-    /*
-    Nijk = 0;
-    for(long int i = 0 ; i < naoccA; ++i){
-        for(long int j = 0 ; j <= i; ++j){
-            for(long int k = 0 ; k <= j; ++k){
-                Nijk++;
-            }
-        }
+static bool read_triples_checkpoint(const std::string &fname, long int nocc, long int nvir, long int naux,
+                                    double eccsd, std::vector<char> &done, std::vector<double> &Eij) {
+    std::ifstream in(fname.c_str());
+    if (!in) {
+        outfile->Printf("\tNo (T) checkpoint file %s, starting from scratch.\n", fname.c_str());
+        return false;
     }
-    */
-    Nijk = naoccA * (naoccA + 1) * (naoccA + 2) / 6;
-    outfile->Printf("\tNumber of ijk combinations: %i \n", Nijk);
-
-    // Malloc Eijk
-    // Eijk = SharedTensor1d(new Tensor1d("Eijk", Nijk));
-
-    // Memory: 2*O^2V^2 + 5*V^3 + O^3V + V^2N + V^3/2
-
-    // Read t2 amps
-    t2 = SharedTensor2d(new Tensor2d("T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
-    t2->read_symm(psio_, PSIF_DFOCC_AMPS);
-    T = SharedTensor2d(new Tensor2d("T2 <IJ|AB>", naoccA, naoccA, navirA, navirA));
-    T->sort(1324, t2, 1.0, 0.0);
-    t2.reset();
-
-    // Form (ij|ka)
-    M = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA, navirA));
-    M->read(psio_, PSIF_DFOCC_INTS);
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IJ)", nQ, naoccA, naoccA));
-    K->read(psio_, PSIF_DFOCC_INTS);
-    J = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IJ|KA)", naoccA, naoccA, naoccA, navirA));
-    J->gemm(true, false, K, M, 1.0, 0.0);
-    K.reset();
-    I = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints <IJ|KA>", naoccA, naoccA, naoccA, navirA));
-    I->sort(1324, J, 1.0, 0.0);
-    J.reset();
-
-    // Form (ia|jb)
-    J = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|JB)", naoccA, navirA, naoccA, navirA));
-    J->gemm(true, false, M, M, 1.0, 0.0);
-
-    // B(iaQ)
-    L = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (IA|Q)", naoccA * navirA, nQ));
-    L = M->transpose();
-    M.reset();
-
-    // malloc W[ijk](abc)
-    W = SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA));
-    V = SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA));
-    J1 = SharedTensor2d(new Tensor2d("J[I] <AB|E>", navirA * navirA, navirA));
-    J2 = SharedTensor2d(new Tensor2d("J[J] <AB|E>", navirA * navirA, navirA));
-    J3 = SharedTensor2d(new Tensor2d("J[K] <AB|E>", navirA * navirA, navirA));
-
-    // B(Q,ab)
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
-    K->read(psio_, PSIF_DFOCC_INTS);
-    Jt = SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA));
-
-    // main loop
-    E_t = 0.0;
-    double sum = 0.0;
-    for (long int i = 0; i < naoccA; ++i) {
-        double Di = FockA->get(i + nfrzc, i + nfrzc);
-
-        // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
-        Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i * navirA * nQ, 0, 1.0, 0.0);
-        J1->expand23(navirA, navirA, navirA, Jt);
-
-        for (long int j = 0; j <= i; ++j) {
-            double Dij = Di + FockA->get(j + nfrzc, j + nfrzc);
-
-            // Compute J[j](a,bc) = (ja|bc) = \sum(Q) B[j](aQ) * B(Q,bc)
-            Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, j * navirA * nQ, 0, 1.0, 0.0);
-            J2->expand23(navirA, navirA, navirA, Jt);
-
-            for (long int k = 0; k <= j; ++k) {
-                // Compute J[k](a,bc) = (ka|bc) = \sum(Q) B[k](aQ) * B(Q,bc)
-                Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, k * navirA * nQ, 0, 1.0, 0.0);
-                J3->expand23(navirA, navirA, navirA, Jt);
-
-                // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
-                // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
-                W->contract(false, false, navirA * navirA, navirA, navirA, J1, T, 0,
-                            (j * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
-                // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
-                W->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
-
-                // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
-                // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, 0,
-                            (k * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
-                // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA * navirA + b, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
-                // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, 0,
-                            (i * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
-                // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a * navirA, 1, V,
-                                a * navirA * navirA + b * navirA, 1, 1.0);
-                    }
-                }
-
-                // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
-                // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, 0,
-                            (k * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
-                // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
-                // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, 0,
-                            (i * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
-                // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA + b, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
-                // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, 0,
-                            (j * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
-                // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA + a, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // V[ijk](ab,c) = W[ijk](ab,c)
-                V->copy(W);
-
-// V[ijk](ab,c) += t_i^a (jb|kc) + t_j^b (ia|kc) + t_k^c (ia|jb)
-// Vt[ijk](ab,c) = V[ijk](ab,c) / (1 + \delta(abc))
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    long int ia = ia_idxAA->get(i, a);
-                    for (long int b = 0; b < navirA; ++b) {
-                        long int jb = ia_idxAA->get(j, b);
-                        long int ab = ab_idxAA->get(a, b);
-                        for (long int c = 0; c < navirA; ++c) {
-                            long int kc = ia_idxAA->get(k, c);
-                            double value = V->get(ab, c) + (t1A->get(i, a) * J->get(jb, kc)) +
-                                           (t1A->get(j, b) * J->get(ia, kc)) + (t1A->get(k, c) * J->get(ia, jb));
-                            double denom = 1 + ((a == b) + (b == c) + (a == c));
-                            V->set(ab, c, value / denom);
-                        }
-                    }
-                }
-
-                // Denom
-                double Dijk = Dij + FockA->get(k + nfrzc, k + nfrzc);
-                double factor = 2 - ((i == j) + (j == k) + (i == k));
-
-                // Compute energy
-                double Xvalue, Yvalue, Zvalue;
-#pragma omp parallel for private(Xvalue, Yvalue, Zvalue) reduction(+ : sum)
-                for (long int a = 0; a < navirA; ++a) {
-                    double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
-                    for (long int b = 0; b <= a; ++b) {
-                        double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
-                        long int ab = ab_idxAA->get(a, b);
-                        long int ba = ab_idxAA->get(b, a);
-                        for (long int c = 0; c <= b; ++c) {
-                            long int ac = ab_idxAA->get(a, c);
-                            long int bc = ab_idxAA->get(b, c);
-                            long int ca = ab_idxAA->get(c, a);
-                            long int cb = ab_idxAA->get(c, b);
-
-                            // X_ijk^abc
-                            Xvalue = (W->get(ab, c) * V->get(ab, c)) + (W->get(ac, b) * V->get(ac, b)) +
-                                     (W->get(ba, c) * V->get(ba, c)) + (W->get(bc, a) * V->get(bc, a)) +
-                                     (W->get(ca, b) * V->get(ca, b)) + (W->get(cb, a) * V->get(cb, a));
-
-                            // Y_ijk^abc
-                            Yvalue = V->get(ab, c) + V->get(bc, a) + V->get(ca, b);
-
-                            // Z_ijk^abc
-                            Zvalue = V->get(ac, b) + V->get(ba, c) + V->get(cb, a);
-
-                            // contributions to energy
-                            double value = (Yvalue - (2.0 * Zvalue)) * (W->get(ab, c) + W->get(bc, a) + W->get(ca, b));
-                            value += (Zvalue - (2.0 * Yvalue)) * (W->get(ac, b) + W->get(ba, c) + W->get(cb, a));
-                            value += 3.0 * Xvalue;
-                            double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
-                            sum += (value * factor) / Dijkabc;
-                        }
-                    }
-                }
-
-            }  // k
-        }      // j
-    }          // i
-    T.reset();
-    J.reset();
-    W.reset();
-    V.reset();
-    J1.reset();
-    J2.reset();
-    J3.reset();
-    K.reset();
-    Jt.reset();
-    L.reset();
-    I.reset();
-
-    // set energy
-    E_t = sum;
-    Eccsd_t = Eccsd + E_t;
-
-}  // end ccsd_canonic_triples
+    std::string title;
+    std::getline(in, title);
+    long int no, nv, nq;
+    size_t ntasks;
+    double ecc;
+    in >> no >> nv >> nq >> ntasks >> ecc;
+    if (!in || title != "DFOCC (T) checkpoint" || no != nocc || nv != nvir || nq != naux || ntasks != done.size() ||
+        std::fabs(ecc - eccsd) > 1.0e-6) {
+        outfile->Printf("\tThe (T) checkpoint file %s belongs to another computation, starting from scratch.\n",
+                        fname.c_str());
+        return false;
+    }
+    size_t t;
+    double value;
+    while (in >> t >> value) {
+        if (t >= ntasks) break;
+        done[t] = 1;
+        Eij[t] = value;
+    }
+    return true;
+}
 
 //======================================================================
-//       (T): incore
+//       (T): one ijk triple
 //======================================================================
-void DFOCC::ccsd_canonic_triples_hm() {
-    // defs
-    SharedTensor2d K, L, M, I, J, T, U, Tau, W, X, Y, Z;
-    SharedTensor2d V, J1, J2, J3, Jt;
-    SharedTensor1d Eijk;
-    long int Nijk;
-
-    // Find number of unique ijk combinations (i>=j>=k)
-    Nijk = naoccA * (naoccA + 1) * (naoccA + 2) / 6;
-    outfile->Printf("\tNumber of ijk combinations: %i \n", Nijk);
-
-    // Memory: OV^3 + 2*O^2V^2 + 2*V^3 + O^3V + V^2N
-
-    // Read t2 amps
-    t2 = SharedTensor2d(new Tensor2d("T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
-    t2->read_symm(psio_, PSIF_DFOCC_AMPS);
-    T = SharedTensor2d(new Tensor2d("T2 <IJ|AB>", naoccA, naoccA, navirA, navirA));
-    T->sort(1324, t2, 1.0, 0.0);
-    t2.reset();
-
-    // Form (ij|ka)
-    M = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA, navirA));
-    M->read(psio_, PSIF_DFOCC_INTS);
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IJ)", nQ, naoccA, naoccA));
-    K->read(psio_, PSIF_DFOCC_INTS);
-    J = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IJ|KA)", naoccA, naoccA, naoccA, navirA));
-    J->gemm(true, false, K, M, 1.0, 0.0);
-    K.reset();
-    I = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints <IJ|KA>", naoccA, naoccA, naoccA, navirA));
-    I->sort(1324, J, 1.0, 0.0);
-    J.reset();
-
-    // Form (ia|jb)
-    J = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|JB)", naoccA, navirA, naoccA, navirA));
-    J->gemm(true, false, M, M, 1.0, 0.0);
-
-    // B(iaQ)
-    L = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (IA|Q)", naoccA * navirA, nQ));
-    L = M->transpose();
-    M.reset();
-
-    // B(Q,ab)
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, navirA, navirA));
-    K->read(psio_, PSIF_DFOCC_INTS, true, true);
-
-    // Form (ia|bc)
-    J1 = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|BC)", naoccA, navirA, navirA, navirA));
-    J1->gemm(false, false, L, K, 1.0, 0.0);
-    K.reset();
-    L.reset();
-
-    // malloc W[ijk](abc)
-    W = SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA));
-    V = SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA));
-
-    // B(Q,a>=b)
-    // K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
-    // K->read(psio_, PSIF_DFOCC_INTS);
-
-    // main loop
-    E_t = 0.0;
-    double sum = 0.0;
-    for (long int i = 0; i < naoccA; ++i) {
-        double Di = FockA->get(i + nfrzc, i + nfrzc);
-        for (long int j = 0; j <= i; ++j) {
-            double Dij = Di + FockA->get(j + nfrzc, j + nfrzc);
-            for (long int k = 0; k <= j; ++k) {
-                // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
-                // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
-                W->contract(false, false, navirA * navirA, navirA, navirA, J1, T, i * navirA * navirA * navirA,
-                            (j * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
-                // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
-                W->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
-
-                // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
-                // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, i * navirA * navirA * navirA,
-                            (k * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
-                // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
+// Energy of the ijk triple (i >= j >= k), weighted by its permutational factor.
+// J1, J2 and J3 hold (ia|bc), (ja|bc) and (ka|bc) starting at off1, off2 and off3; W and V are scratch.
+double DFOCC::ccsd_canonic_triples_ijk(long int i, long int j, long int k, const SharedTensor2d &T,
+                                       const SharedTensor2d &I, const SharedTensor2d &J, const SharedTensor2d &J1,
+                                       long int off1, const SharedTensor2d &J2, long int off2,
+                                       const SharedTensor2d &J3, long int off3, SharedTensor2d &W,
+                                       SharedTensor2d &V) {
+    // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
+    // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
+    W->contract(false, false, navirA * navirA, navirA, navirA, J1, T, off1,
+                (j * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
+
+    // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
+    // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
+    W->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
+                (j * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
+
+    // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
+    // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
+    V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, off1,
+                (k * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
+
+    // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
+    // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
+    V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
+                (k * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA * navirA + b, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        for (long int b = 0; b < navirA; ++b) {
+            W->axpy((size_t)navirA, a * navirA * navirA + b, navirA, V, a * navirA * navirA + b * navirA, 1, 1.0);
+        }
+    }
 
-                // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
-                // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, j * navirA * navirA * navirA,
-                            (i * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
+    // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
+    // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
+    V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, off2,
+                (i * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
 
-                // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
-                // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
+    // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
+    // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
+    V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
+                (i * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a * navirA, 1, V,
-                                a * navirA * navirA + b * navirA, 1, 1.0);
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        for (long int b = 0; b < navirA; ++b) {
+            W->axpy((size_t)navirA, b * navirA * navirA + a * navirA, 1, V, a * navirA * navirA + b * navirA, 1,
+                    1.0);
+        }
+    }
 
-                // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
-                // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, j * navirA * navirA * navirA,
-                            (k * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
+    // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
+    // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
+    V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, off2,
+                (k * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
 
-                // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
-                // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
+    // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
+    // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
+    V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
+                (k * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        for (long int b = 0; b < navirA; ++b) {
+            W->axpy((size_t)navirA, b * navirA * navirA + a, navirA, V, a * navirA * navirA + b * navirA, 1, 1.0);
+        }
+    }
 
-                // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
-                // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, k * navirA * navirA * navirA,
-                            (i * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
+    // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
+    // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
+    V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, off3,
+                (i * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
 
-                // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
-                // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
+    // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
+    // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
+    V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
+                (i * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA + b, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        for (long int b = 0; b < navirA; ++b) {
+            W->axpy((size_t)navirA, a * navirA + b, navirA * navirA, V, a * navirA * navirA + b * navirA, 1, 1.0);
+        }
+    }
 
-                // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
-                // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, k * navirA * navirA * navirA,
-                            (j * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
+    // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
+    // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
+    V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, off3,
+                (j * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
 
-                // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
-                // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
+    // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
+    // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
+    V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
+                (j * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA + a, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        for (long int b = 0; b < navirA; ++b) {
+            W->axpy((size_t)navirA, b * navirA + a, navirA * navirA, V, a * navirA * navirA + b * navirA, 1, 1.0);
+        }
+    }
 
-                // V[ijk](ab,c) = W[ijk](ab,c)
-                V->copy(W);
+    // V[ijk](ab,c) = W[ijk](ab,c)
+    V->copy(W);
 
 // V[ijk](ab,c) += t_i^a (jb|kc) + t_j^b (ia|kc) + t_k^c (ia|jb)
 // Vt[ijk](ab,c) = V[ijk](ab,c) / (1 + \delta(abc))
 #pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    long int ia = ia_idxAA->get(i, a);
-                    for (long int b = 0; b < navirA; ++b) {
-                        long int jb = ia_idxAA->get(j, b);
-                        long int ab = ab_idxAA->get(a, b);
-                        for (long int c = 0; c < navirA; ++c) {
-                            long int kc = ia_idxAA->get(k, c);
-                            double value = V->get(ab, c) + (t1A->get(i, a) * J->get(jb, kc)) +
-                                           (t1A->get(j, b) * J->get(ia, kc)) + (t1A->get(k, c) * J->get(ia, jb));
-                            double denom = 1 + ((a == b) + (b == c) + (a == c));
-                            V->set(ab, c, value / denom);
-                        }
-                    }
-                }
+    for (long int a = 0; a < navirA; ++a) {
+        long int ia = ia_idxAA->get(i, a);
+        for (long int b = 0; b < navirA; ++b) {
+            long int jb = ia_idxAA->get(j, b);
+            long int ab = ab_idxAA->get(a, b);
+            for (long int c = 0; c < navirA; ++c) {
+                long int kc = ia_idxAA->get(k, c);
+                double value = V->get(ab, c) + (t1A->get(i, a) * J->get(jb, kc)) + (t1A->get(j, b) * J->get(ia, kc)) +
+                               (t1A->get(k, c) * J->get(ia, jb));
+                double denom = 1 + ((a == b) + (b == c) + (a == c));
+                V->set(ab, c, value / denom);
+            }
+        }
+    }
 
-                // Denom
-                double Dijk = Dij + FockA->get(k + nfrzc, k + nfrzc);
-                double factor = 2 - ((i == j) + (j == k) + (i == k));
+    // Denom
+    double Dijk = FockA->get(i + nfrzc, i + nfrzc) + FockA->get(j + nfrzc, j + nfrzc) +
+                  FockA->get(k + nfrzc, k + nfrzc);
+    double factor = 2 - ((i == j) + (j == k) + (i == k));
 
-                // Compute energy
-                double Xvalue, Yvalue, Zvalue;
+    // Compute energy
+    double sum = 0.0;
+    double Xvalue, Yvalue, Zvalue;
 #pragma omp parallel for private(Xvalue, Yvalue, Zvalue) reduction(+ : sum)
-                for (long int a = 0; a < navirA; ++a) {
-                    double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
-                    for (long int b = 0; b <= a; ++b) {
-                        double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
-                        long int ab = ab_idxAA->get(a, b);
-                        long int ba = ab_idxAA->get(b, a);
-                        for (long int c = 0; c <= b; ++c) {
-                            long int ac = ab_idxAA->get(a, c);
-                            long int bc = ab_idxAA->get(b, c);
-                            long int ca = ab_idxAA->get(c, a);
-                            long int cb = ab_idxAA->get(c, b);
-
-                            // X_ijk^abc
-                            Xvalue = (W->get(ab, c) * V->get(ab, c)) + (W->get(ac, b) * V->get(ac, b)) +
-                                     (W->get(ba, c) * V->get(ba, c)) + (W->get(bc, a) * V->get(bc, a)) +
-                                     (W->get(ca, b) * V->get(ca, b)) + (W->get(cb, a) * V->get(cb, a));
-
-                            // Y_ijk^abc
-                            Yvalue = V->get(ab, c) + V->get(bc, a) + V->get(ca, b);
-
-                            // Z_ijk^abc
-                            Zvalue = V->get(ac, b) + V->get(ba, c) + V->get(cb, a);
-
-                            // contributions to energy
-                            double value = (Yvalue - (2.0 * Zvalue)) * (W->get(ab, c) + W->get(bc, a) + W->get(ca, b));
-                            value += (Zvalue - (2.0 * Yvalue)) * (W->get(ac, b) + W->get(ba, c) + W->get(cb, a));
-                            value += 3.0 * Xvalue;
-                            double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
-                            sum += (value * factor) / Dijkabc;
-                        }
-                    }
-                }
-
-            }  // k
-        }      // j
-    }          // i
-    J1.reset();
-    T.reset();
-    J.reset();
-    W.reset();
-    V.reset();
-    I.reset();
-
-    // set energy
-    E_t = sum;
-    Eccsd_t = Eccsd + E_t;
+    for (long int a = 0; a < navirA; ++a) {
+        double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
+        for (long int b = 0; b <= a; ++b) {
+            double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
+            long int ab = ab_idxAA->get(a, b);
+            long int ba = ab_idxAA->get(b, a);
+            for (long int c = 0; c <= b; ++c) {
+                long int ac = ab_idxAA->get(a, c);
+                long int bc = ab_idxAA->get(b, c);
+                long int ca = ab_idxAA->get(c, a);
+                long int cb = ab_idxAA->get(c, b);
+
+                // X_ijk^abc
+                Xvalue = (W->get(ab, c) * V->get(ab, c)) + (W->get(ac, b) * V->get(ac, b)) +
+                         (W->get(ba, c) * V->get(ba, c)) + (W->get(bc, a) * V->get(bc, a)) +
+                         (W->get(ca, b) * V->get(ca, b)) + (W->get(cb, a) * V->get(cb, a));
+
+                // Y_ijk^abc
+                Yvalue = V->get(ab, c) + V->get(bc, a) + V->get(ca, b);
+
+                // Z_ijk^abc
+                Zvalue = V->get(ac, b) + V->get(ba, c) + V->get(cb, a);
+
+                // contributions to energy
+                double value = (Yvalue - (2.0 * Zvalue)) * (W->get(ab, c) + W->get(bc, a) + W->get(ca, b));
+                value += (Zvalue - (2.0 * Yvalue)) * (W->get(ac, b) + W->get(ba, c) + W->get(cb, a));
+                value += 3.0 * Xvalue;
+                double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
+                sum += (value * factor) / Dijkabc;
+            }
+        }
+    }
 
-}  // end ccsd_canonic_triples_hm
+    return sum;
+}  // end ccsd_canonic_triples_ijk
 
 //======================================================================
-//       (T): disk
+//       (T): driver
 //======================================================================
-void DFOCC::ccsd_canonic_triples_disk() {
+/*
+ * The ij pairs (i >= j) are independent tasks; each runs over k <= j and is handed
+ * to the next free thread, the largest tasks first. (ia|bc) is
+ *   INCORE: formed once and shared by all threads (OV^3),
+ *   DISK:   formed once, written to disk and read back by every task,
+ *   DIRECT: formed for every i, j and k from B(ia|Q) and B(Q|a>=b).
+ * Every thread owns its W, V and (for DISK/DIRECT) J buffers, so the number of tasks
+ * run at once is what fits in the memory left after the shared tensors and the in-core
+ * DF integrals. Threads no task can use are shared out among the tasks (nested OpenMP
+ * and MKL). Every task needs at least 5 v^3 (2 v^3 for INCORE); (ab|c) is not batched.
+ * With TRIPLES_CHECKPOINT_TIME the energies of the finished tasks are written to a
+ * file every so often, and TRIPLES_RESTART picks them up again after an interrupted run.
+ */
+void DFOCC::ccsd_canonic_triples() {
     // defs
-    SharedTensor2d K, L, M, I, J, T, U, Tau, W, X, Y, Z;
-    SharedTensor2d V, J1, J2, J3, Jt;
-    SharedTensor1d Eijk;
+    SharedTensor2d K, L, M, I, J, T, Jiabc, Jt;
     long int Nijk;
 
     // Find number of unique ijk combinations (i>=j>=k)
     Nijk = naoccA * (naoccA + 1) * (naoccA + 2) / 6;
-    outfile->Printf("\tNumber of ijk combinations: %i \n", Nijk);
-
-    // Malloc Eijk
-    // Eijk = SharedTensor1d(new Tensor1d("Eijk", Nijk));
+    outfile->Printf("\tNumber of ijk combinations: %li \n", Nijk);
 
-    // Memory: 2*O^2V^2 + 5*V^3 + O^3V + V^2N + V^3/2
+    // How (ia|bc) is handled
+    std::string iabc = triples_iabc_type_;
+    if (iabc == "AUTO") iabc = do_triples_hm ? "INCORE" : "DIRECT";
 
     // Read t2 amps
     t2 = SharedTensor2d(new Tensor2d("T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
@@ -589,251 +316,196 @@ void DFOCC::ccsd_canonic_triples_disk() {
     J->gemm(true, false, M, M, 1.0, 0.0);
 
     // B(iaQ)
-    L = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (IA|Q)", naoccA * navirA, nQ));
     L = M->transpose();
     M.reset();
 
-    // malloc W[ijk](abc)
-    W = SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA));
-    V = SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA));
-    J1 = SharedTensor2d(new Tensor2d("J[I] (A|BC)", navirA * navirA, navirA));
-    J2 = SharedTensor2d(new Tensor2d("J[I] (A|BC)", navirA * navirA, navirA));
-    J3 = SharedTensor2d(new Tensor2d("J[I] (A|BC)", navirA * navirA, navirA));
+    if (iabc == "INCORE") {
+        // B(Q,ab)
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, navirA, navirA));
+        K->read(psio_, PSIF_DFOCC_INTS, true, true);
+
+        // Form (ia|bc)
+        Jiabc = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|BC)", naoccA, navirA, navirA, navirA));
+        Jiabc->gemm(false, false, L, K, 1.0, 0.0);
+        K.reset();
+        L.reset();
+    } else {
+        // B(Q,a>=b)
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
+        K->read(psio_, PSIF_DFOCC_INTS);
+
+        if (iabc == "DISK") {
+            // Form (ia|bc) one i at a time and write it
+            Jt = SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA));
+            Jiabc = SharedTensor2d(new Tensor2d("J[I] (A|BC)", navirA * navirA, navirA));
+            for (long int i = 0; i < naoccA; ++i) {
+                // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
+                Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i * navirA * nQ, 0, 1.0, 0.0);
+                Jiabc->expand23(navirA, navirA, navirA, Jt);
+                Jiabc->mywrite(PSIF_DFOCC_IABC, i > 0);
+            }
+            Jiabc.reset();
+            Jt.reset();
+            K.reset();
+            L.reset();
+        }
+    }
 
-    // B(Q,ab)
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
-    K->read(psio_, PSIF_DFOCC_INTS);
+    // Memory of the shared tensors and of every thread, in doubles
+    double v3 = (double)navirA * navirA * navirA;
+    double mem_shared = 2.0 * naoccA * naoccA * navirA * navirA + (double)naoccA * naoccA * naoccA * navirA;
+    double mem_thread = 2.0 * v3;
+    if (iabc == "INCORE") {
+        mem_shared += naoccA * v3;
+    } else if (iabc == "DISK") {
+        mem_thread += 3.0 * v3;
+    } else {
+        mem_shared += (double)naoccA * navirA * nQ + (double)nQ * ntri_abAA;
+        mem_thread += 3.0 * v3 + (double)navirA * ntri_abAA;
+    }
 
-    // Form (ia|bc)
-    Jt = SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA));
-    /*
-    //psio_address addr = PSIO_ZERO;
-    for(long int i = 0 ; i < naoccA; ++i){
-        // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
-        Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i*navirA*nQ, 0, 1.0, 0.0);
-        J1->expand23(navirA, navirA, navirA, Jt);
+    long int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+    // memory_after_ints leaves out the TensorCoreStore budget (memory/2 with DF_INTS_IN_CORE)
+    double mem_left = (double)memory_after_ints() / sizeof(double) - mem_shared;
+    long int nfit = (mem_left > 0.0) ? (long int)(mem_left / mem_thread) : 0;
+    if (nfit == 0) {
+        outfile->Printf("\n\tAvailable memory for (T) tasks         : %9.2lf MB \n",
+                        MAX0(mem_left, 0.0) * sizeof(double) / (1024.0 * 1024.0));
+        outfile->Printf("\tMinimum required memory for one task   : %9.2lf MB \n",
+                        mem_thread * sizeof(double) / (1024.0 * 1024.0));
+        throw PSIEXCEPTION("There is NOT enough memory for (T)!");
+    }
+    long int nthreads = MIN0(nfit, max_threads);
 
-        // write
-        psio_address addr = psio_get_address(PSIO_ZERO,(size_t)(i*navirA*navirA*navirA)*sizeof(double));
-        J1->write(psio_, PSIF_DFOCC_INTS, addr, &addr);
+    // Threads left over when fewer tasks than threads fit go to the BLAS and loops inside every task
+    int inner_threads = 1;
+    if (nthreads > 1 && nthreads < max_threads) inner_threads = max_threads / nthreads;
+#ifdef _OPENMP
+    int max_levels = omp_get_max_active_levels();
+    if (inner_threads > 1) omp_set_max_active_levels(2);
+#endif
+    outfile->Printf("\t(T) runs %li ij tasks at a time on %d threads each, %9.2lf MB each.\n", nthreads,
+                    inner_threads, mem_thread * sizeof(double) / (1024.0 * 1024.0));
+
+    // Scratch of every thread
+    std::vector<SharedTensor2d> W, V, J1, J2, J3, Jtri;
+    for (long int t = 0; t < nthreads; ++t) {
+        W.push_back(SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA)));
+        V.push_back(SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA)));
+        if (iabc != "INCORE") {
+            J1.push_back(SharedTensor2d(new Tensor2d("J[I] <AB|E>", navirA * navirA, navirA)));
+            J2.push_back(SharedTensor2d(new Tensor2d("J[J] <AB|E>", navirA * navirA, navirA)));
+            J3.push_back(SharedTensor2d(new Tensor2d("J[K] <AB|E>", navirA * navirA, navirA)));
+        }
+        if (iabc == "DIRECT") Jtri.push_back(SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA)));
     }
-    */
-    Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, 0, 0, 1.0, 0.0);
-    J1->expand23(navirA, navirA, navirA, Jt);
-    J1->mywrite(PSIF_DFOCC_IABC, false);
-    for (long int i = 1; i < naoccA; ++i) {
-        // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
-        Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i * navirA * nQ, 0, 1.0, 0.0);
-        J1->expand23(navirA, navirA, navirA, Jt);
 
-        // write
-        J1->mywrite(PSIF_DFOCC_IABC, true);
+    // ij tasks, largest (most k) first
+    std::vector<std::pair<long int, long int> > tasks;
+    for (long int j = naoccA - 1; j >= 0; --j)
+        for (long int i = naoccA - 1; i >= j; --i) tasks.push_back(std::make_pair(i, j));
+    long int ntasks = tasks.size();
+
+    // Energies of the finished tasks
+    std::vector<double> Eij(ntasks, 0.0);
+    std::vector<char> done(ntasks, 0);
+    std::string chkname = get_writer_file_prefix(molecule_->name()) + ".dfocc_t.chk";
+    if (triples_restart_ && read_triples_checkpoint(chkname, naoccA, navirA, nQ, Eccsd, done, Eij)) {
+        long int nread = 0;
+        for (long int t = 0; t < ntasks; ++t) nread += done[t];
+        outfile->Printf("\tRestarting (T) from %s: %li of %li ij tasks done.\n", chkname.c_str(), nread, ntasks);
     }
-    K.reset();
-    Jt.reset();
-    L.reset();
+    double checkpoint_seconds = 60.0 * triples_checkpoint_time_;
+    std::time_t last_checkpoint = std::time(nullptr);
 
     // main loop
-    E_t = 0.0;
-    double sum = 0.0;
-    for (long int i = 0; i < naoccA; ++i) {
-        double Di = FockA->get(i + nfrzc, i + nfrzc);
-
-        // Read J[i](a,bc)
-        // psio_address addr1 = psio_get_address(PSIO_ZERO,(size_t)(i*navirA*navirA*navirA)*sizeof(double));
-        // J1->read(psio_, PSIF_DFOCC_INTS, addr1, &addr1);
-        J1->myread(PSIF_DFOCC_IABC, (size_t)(i * navirA * navirA * navirA) * sizeof(double));
-
-        for (long int j = 0; j <= i; ++j) {
-            double Dij = Di + FockA->get(j + nfrzc, j + nfrzc);
-
-            // Read J[j](a,bc)
-            // psio_address addr2 = psio_get_address(PSIO_ZERO,(size_t)(j*navirA*navirA*navirA)*sizeof(double));
-            // J2->read(psio_, PSIF_DFOCC_INTS, addr2, &addr2);
-            J2->myread(PSIF_DFOCC_IABC, (size_t)(j * navirA * navirA * navirA) * sizeof(double));
-
-            for (long int k = 0; k <= j; ++k) {
-                // Read J[k](a,bc)
-                // psio_address addr3 = psio_get_address(PSIO_ZERO,(size_t)(k*navirA*navirA*navirA)*sizeof(double));
-                // J3->read(psio_, PSIF_DFOCC_INTS, addr3, &addr3);
-                J3->myread(PSIF_DFOCC_IABC, (size_t)(k * navirA * navirA * navirA) * sizeof(double));
-
-                // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
-                // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
-                W->contract(false, false, navirA * navirA, navirA, navirA, J1, T, 0,
-                            (j * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
-                // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
-                W->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
-
-                // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
-                // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J1, T, 0,
-                            (k * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
-                // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, i * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA * navirA + b, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
-                // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, 0,
-                            (i * naoccA * navirA * navirA) + (k * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
-                // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (k * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a * navirA, 1, V,
-                                a * navirA * navirA + b * navirA, 1, 1.0);
-                    }
-                }
-
-                // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
-                // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J2, T, 0,
-                            (k * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
-                // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, j * naoccA * navirA * navirA,
-                            (k * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA * navirA + a, navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
-                // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, 0,
-                            (i * naoccA * navirA * navirA) + (j * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
-                // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (i * naoccA * naoccA * navirA) + (j * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, a * navirA + b, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
-                // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
-                V->contract(false, false, navirA * navirA, navirA, navirA, J3, T, 0,
-                            (j * naoccA * navirA * navirA) + (i * navirA * navirA), 1.0, 0.0);
-
-                // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
-                // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
-                V->contract(true, false, navirA * navirA, navirA, naoccA, T, I, k * naoccA * navirA * navirA,
-                            (j * naoccA * naoccA * navirA) + (i * naoccA * navirA), -1.0, 1.0);
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    for (long int b = 0; b < navirA; ++b) {
-                        W->axpy((size_t)navirA, b * navirA + a, navirA * navirA, V, a * navirA * navirA + b * navirA, 1,
-                                1.0);
-                    }
-                }
-
-                // V[ijk](ab,c) = W[ijk](ab,c)
-                V->copy(W);
-
-// V[ijk](ab,c) += t_i^a (jb|kc) + t_j^b (ia|kc) + t_k^c (ia|jb)
-// Vt[ijk](ab,c) = V[ijk](ab,c) / (1 + \delta(abc))
-#pragma omp parallel for
-                for (long int a = 0; a < navirA; ++a) {
-                    long int ia = ia_idxAA->get(i, a);
-                    for (long int b = 0; b < navirA; ++b) {
-                        long int jb = ia_idxAA->get(j, b);
-                        long int ab = ab_idxAA->get(a, b);
-                        for (long int c = 0; c < navirA; ++c) {
-                            long int kc = ia_idxAA->get(k, c);
-                            double value = V->get(ab, c) + (t1A->get(i, a) * J->get(jb, kc)) +
-                                           (t1A->get(j, b) * J->get(ia, kc)) + (t1A->get(k, c) * J->get(ia, jb));
-                            double denom = 1 + ((a == b) + (b == c) + (a == c));
-                            V->set(ab, c, value / denom);
-                        }
-                    }
-                }
-
-                // Denom
-                double Dijk = Dij + FockA->get(k + nfrzc, k + nfrzc);
-                double factor = 2 - ((i == j) + (j == k) + (i == k));
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (long int t = 0; t < ntasks; ++t) {
+        if (done[t]) continue;
+        long int i = tasks[t].first;
+        long int j = tasks[t].second;
 
-                // Compute energy
-                double Xvalue, Yvalue, Zvalue;
-#pragma omp parallel for private(Xvalue, Yvalue, Zvalue) reduction(+ : sum)
-                for (long int a = 0; a < navirA; ++a) {
-                    double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
-                    for (long int b = 0; b <= a; ++b) {
-                        double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
-                        long int ab = ab_idxAA->get(a, b);
-                        long int ba = ab_idxAA->get(b, a);
-                        for (long int c = 0; c <= b; ++c) {
-                            long int ac = ab_idxAA->get(a, c);
-                            long int bc = ab_idxAA->get(b, c);
-                            long int ca = ab_idxAA->get(c, a);
-                            long int cb = ab_idxAA->get(c, b);
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+        if (inner_threads > 1) omp_set_num_threads(inner_threads);
+#endif
+#ifdef USING_LAPACK_MKL
+        int mkl_threads = 0;
+        if (inner_threads > 1) mkl_threads = mkl_set_num_threads_local(inner_threads);
+#endif
 
-                            // X_ijk^abc
-                            Xvalue = (W->get(ab, c) * V->get(ab, c)) + (W->get(ac, b) * V->get(ac, b)) +
-                                     (W->get(ba, c) * V->get(ba, c)) + (W->get(bc, a) * V->get(bc, a)) +
-                                     (W->get(ca, b) * V->get(ca, b)) + (W->get(cb, a) * V->get(cb, a));
+        if (iabc == "DIRECT") {
+            // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
+            Jtri[thread]->contract(false, false, navirA, ntri_abAA, nQ, L, K, i * navirA * nQ, 0, 1.0, 0.0);
+            J1[thread]->expand23(navirA, navirA, navirA, Jtri[thread]);
+            Jtri[thread]->contract(false, false, navirA, ntri_abAA, nQ, L, K, j * navirA * nQ, 0, 1.0, 0.0);
+            J2[thread]->expand23(navirA, navirA, navirA, Jtri[thread]);
+        } else if (iabc == "DISK") {
+            J1[thread]->myread(PSIF_DFOCC_IABC, (size_t)(i * navirA * navirA * navirA) * sizeof(double));
+            J2[thread]->myread(PSIF_DFOCC_IABC, (size_t)(j * navirA * navirA * navirA) * sizeof(double));
+        }
 
-                            // Y_ijk^abc
-                            Yvalue = V->get(ab, c) + V->get(bc, a) + V->get(ca, b);
+        double sum = 0.0;
+        for (long int k = 0; k <= j; ++k) {
+            if (iabc == "INCORE") {
+                sum += ccsd_canonic_triples_ijk(i, j, k, T, I, J, Jiabc, i * navirA * navirA * navirA, Jiabc,
+                                                j * navirA * navirA * navirA, Jiabc, k * navirA * navirA * navirA,
+                                                W[thread], V[thread]);
+                continue;
+            }
+            if (iabc == "DIRECT") {
+                Jtri[thread]->contract(false, false, navirA, ntri_abAA, nQ, L, K, k * navirA * nQ, 0, 1.0, 0.0);
+                J3[thread]->expand23(navirA, navirA, navirA, Jtri[thread]);
+            } else {
+                J3[thread]->myread(PSIF_DFOCC_IABC, (size_t)(k * navirA * navirA * navirA) * sizeof(double));
+            }
+            sum += ccsd_canonic_triples_ijk(i, j, k, T, I, J, J1[thread], 0, J2[thread], 0, J3[thread], 0, W[thread],
+                                            V[thread]);
+        }
+        Eij[t] = sum;
+#ifdef USING_LAPACK_MKL
+        if (inner_threads > 1) mkl_set_num_threads_local(mkl_threads);
+#endif
 
-                            // Z_ijk^abc
-                            Zvalue = V->get(ac, b) + V->get(ba, c) + V->get(cb, a);
+#pragma omp critical(dfocc_triples_checkpoint)
+        {
+            done[t] = 1;
+            if (checkpoint_seconds > 0.0 && std::difftime(std::time(nullptr), last_checkpoint) >= checkpoint_seconds) {
+                write_triples_checkpoint(chkname, naoccA, navirA, nQ, Eccsd, done, Eij);
+                last_checkpoint = std::time(nullptr);
+            }
+        }
+    }
 
-                            // contributions to energy
-                            double value = (Yvalue - (2.0 * Zvalue)) * (W->get(ab, c) + W->get(bc, a) + W->get(ca, b));
-                            value += (Zvalue - (2.0 * Yvalue)) * (W->get(ac, b) + W->get(ba, c) + W->get(cb, a));
-                            value += 3.0 * Xvalue;
-                            double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
-                            sum += (value * factor) / Dijkabc;
-                        }
-                    }
-                }
+#ifdef _OPENMP
+    if (inner_threads > 1) omp_set_max_active_levels(max_levels);
+#endif
 
-            }  // k
-        }      // j
-    }          // i
     T.reset();
     J.reset();
-    W.reset();
-    V.reset();
-    J1.reset();
-    J2.reset();
-    J3.reset();
     I.reset();
-
-    // set energy
-    E_t = sum;
+    K.reset();
+    L.reset();
+    Jiabc.reset();
+    W.clear();
+    V.clear();
+    J1.clear();
+    J2.clear();
+    J3.clear();
+    Jtri.clear();
+    if (iabc == "DISK") remove_binary_file(PSIF_DFOCC_IABC);
+    if (checkpoint_seconds > 0.0) std::remove(chkname.c_str());
+
+    // set energy; the tasks are summed in a fixed order, whatever thread ran them
+    E_t = 0.0;
+    for (long int t = 0; t < ntasks; ++t) E_t += Eij[t];
     Eccsd_t = Eccsd + E_t;
 
-    // Delete the (IA|BC) file
-    remove_binary_file(PSIF_DFOCC_IABC);
-
-}  // end ccsd_canonic_triples_disk
+}  // end ccsd_canonic_triples
 
 //======================================================================
 //       (T): grad
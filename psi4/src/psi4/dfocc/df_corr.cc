@@ -133,9 +133,12 @@ void DFOCC::df_corr() {
     formJ(auxiliary_, zero);
     timer_off("Form J");
 
-    // Form B(Q,mu nu)
+    // Form B(Q,mu nu), or take it from the SCF if DF_BASIS_CC is its auxiliary basis
     timer_on("Form B(Q,munu)");
-    b_so(primary_, auxiliary_, zero);
+    if (df_ints_in_core_ && b_so_from_jk(auxiliary_, nQ, "DF_BASIS_CC B (Q|mn)"))
+        free_block(J_mhalf);
+    else
+        b_so(primary_, auxiliary_, zero);
     timer_off("Form B(Q,munu)");
 
 }  // end df_corr
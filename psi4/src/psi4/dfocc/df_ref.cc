@@ -26,6 +26,8 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/basisset.h"
@@ -39,6 +41,10 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 
+#include "psi4/libscf_solver/hf.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/lib3index/dfhelper.h"
+
 #include "defines.h"
 #include "dfocc.h"
 #include "tensors.h"
@@ -100,8 +106,20 @@ void DFOCC::df_ref() {
     const std::vector<std::pair<int, int> >& function_pairs = eri->function_pairs();
     long int ntri_cd = function_pairs.size();
 
+    // reuse the in-core integrals of a MEM_DF SCF
+    if (df_ints_in_core_ && b_so_from_jk(auxiliary, auxiliary->nbf(), "DF_BASIS_SCF B (Q|mn)")) {
+        nQ_ref = auxiliary->nbf();
+
+        if (dertype == "FIRST") {
+            // Form J^-1/2
+            timer_on("Form J");
+            formJ_ref(auxiliary, zero);
+            timer_off("Form J");
+        }  // end if (dertype == "FIRST")
+    }
+
     // read integrals from disk if they were generated in the SCF
-    if (options_.get_str("SCF_TYPE") == "DISK_DF") {
+    else if (options_.get_str("SCF_TYPE") == "DISK_DF") {
         outfile->Printf("\tReading DF integrals from disk ...\n");
         nQ_ref = auxiliary->nbf();
 
@@ -452,6 +470,52 @@ void DFOCC::b_so_ref(std::shared_ptr<BasisSet> primary_, std::shared_ptr<BasisSe
 
 }  // end b_so
 
+//=======================================================
+//          B(Q, mu nu) from the SCF's in-core DFHelper
+//=======================================================
+bool DFOCC::b_so_from_jk(std::shared_ptr<BasisSet> auxiliary_, long int naux, const std::string &label) {
+    // The JK object only survives the SCF with SAVE_JK
+    auto scf = std::dynamic_pointer_cast<scf::HF>(reference_wavefunction_);
+    if (!scf) return false;
+    auto jk = std::dynamic_pointer_cast<MemDFJK>(scf->jk());
+    if (!jk) return false;
+    std::shared_ptr<DFHelper> dfh = jk->dfh();
+    if (!dfh) return false;
+
+    // Same auxiliary basis, same orbital basis
+    std::shared_ptr<BasisSet> jk_aux = dfh->get_aux_basis();
+    if (dfh->get_naux() != (size_t)naux || jk_aux->name() != auxiliary_->name() ||
+        jk_aux->nshell() != auxiliary_->nshell() || basisset_->nbf() != nso_)
+        return false;
+
+    bQso = SharedTensor2d(new Tensor2d(label, naux, nso_, nso_));
+    if (!dfh->fill_AO_core(bQso->A2d_[0])) {
+        bQso.reset();
+        return false;
+    }
+    outfile->Printf("\tUsing the DF integrals of the SCF (%s) ...\n", auxiliary_->name().c_str());
+
+    bQso->write(psio_, PSIF_DFOCC_INTS, true, true);
+    if (print_ > 3) bQso->print();
+    bQso.reset();
+    return true;
+}  // end b_so_from_jk
+
+//=======================================================
+//          Memory left once the DF integrals are built
+//=======================================================
+size_t DFOCC::memory_after_ints() {
+    if (!df_ints_in_core_) return Process::environment.get_memory();
+
+    // B(Q|mn) is on PSIF_DFOCC_INTS by now; the SCF only kept its JK object for us (SAVE_JK)
+    auto scf = std::dynamic_pointer_cast<scf::HF>(reference_wavefunction_);
+    if (scf && std::dynamic_pointer_cast<MemDFJK>(scf->jk())) scf->reset_jk();
+
+    // the in-core DF integrals may grow to their budget
+    size_t memory = Process::environment.get_memory();
+    return memory - std::min(memory, TensorCoreStore::capacity());
+}  // end memory_after_ints
+
 //=======================================================
 //          form b(Q,ij) : all
 //=======================================================
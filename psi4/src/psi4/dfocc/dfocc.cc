@@ -32,6 +32,7 @@
 #include "dfocc.h"
 #include "defines.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 
 using namespace psi;
@@ -45,7 +46,7 @@ DFOCC::DFOCC(SharedWavefunction ref_wfn, Options &options) : Wavefunction(option
     common_init();
 }  //
 
-DFOCC::~DFOCC() {}  //
+DFOCC::~DFOCC() { TensorCoreStore::disable(); }  //
 
 void DFOCC::common_init() {
     print_ = options_.get_int("PRINT");
@@ -106,6 +107,9 @@ void DFOCC::common_init() {
     Wabef_type_ = options_.get_str("PPL_TYPE");
     triples_iabc_type_ = options_.get_str("TRIPLES_IABC_TYPE");
     do_cd = options_.get_str("CHOLESKY");
+    df_ints_in_core_ = options_.get_bool("DF_INTS_IN_CORE");
+    triples_restart_ = options_.get_bool("TRIPLES_RESTART");
+    triples_checkpoint_time_ = options_.get_double("TRIPLES_CHECKPOINT_TIME");
 
     if (!psio_) {
         throw PSIEXCEPTION("The wavefunction passed in lacks a PSIO object, crashing DFOCC. See GitHub issue #1851.");
@@ -501,6 +505,15 @@ double DFOCC::compute_energy() {
     // Call the appropriate manager
     // do_cd = "FALSE";
     nincore_amp = 3;
+
+    // Keep the DF integrals in core; whatever does not fit in half of the memory goes to disk
+    if (df_ints_in_core_) {
+        size_t budget = Process::environment.get_memory() / (2 * sizeof(double));
+        TensorCoreStore::enable(PSIF_DFOCC_INTS, budget);
+        outfile->Printf("\tDF integrals are kept in core, up to %9.2lf MB.\n",
+                        (double)budget * sizeof(double) / (1024.0 * 1024.0));
+    }
+
     if (wfn_type_ == "DF-OMP2" && orb_opt_ == "TRUE" && do_cd == "FALSE")
         omp2_manager();
     else if (wfn_type_ == "DF-OMP2" && orb_opt_ == "FALSE" && do_cd == "FALSE")
@@ -575,6 +588,8 @@ double DFOCC::compute_energy() {
     else if (wfn_type_ == "QCHF")
         Etotal = Eref;
 
+    TensorCoreStore::disable();
+
     return Etotal;
 
 }  // end of compute_energy
@@ -340,6 +340,8 @@ class DFOCC : public Wavefunction {
     void b_so(std::shared_ptr<BasisSet> primary_, std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero);
     void b_so_ref(std::shared_ptr<BasisSet> primary_, std::shared_ptr<BasisSet> auxiliary_,
                   std::shared_ptr<BasisSet> zero);
+    bool b_so_from_jk(std::shared_ptr<BasisSet> auxiliary_, long int naux, const std::string &label);
+    size_t memory_after_ints();
     void b_oo();
     void b_ov();
     void b_vv();
@@ -512,8 +514,10 @@ class DFOCC : public Wavefunction {
 
     // CCSD(T)
     void ccsd_canonic_triples();
-    void ccsd_canonic_triples_hm();
-    void ccsd_canonic_triples_disk();
+    double ccsd_canonic_triples_ijk(long int i, long int j, long int k, const SharedTensor2d &T,
+                                    const SharedTensor2d &I, const SharedTensor2d &J, const SharedTensor2d &J1,
+                                    long int off1, const SharedTensor2d &J2, long int off2, const SharedTensor2d &J3,
+                                    long int off3, SharedTensor2d &W, SharedTensor2d &V);
     void ccsd_t_manager();
     void ccsd_t_manager_cd();
     void ccsd_canonic_triples_grad();
@@ -841,6 +845,9 @@ class DFOCC : public Wavefunction {
     std::string regularization;
     std::string do_cd;
     std::string read_scf_3index;
+    bool df_ints_in_core_;  // keep PSIF_DFOCC_INTS in core (DF_INTS_IN_CORE)
+    bool triples_restart_;            // continue (T) from its checkpoint file (TRIPLES_RESTART)
+    double triples_checkpoint_time_;  // minutes between (T) checkpoints, 0 for none (TRIPLES_CHECKPOINT_TIME)
     std::string freeze_core_;
     std::string oeprop_;
     std::string comput_s2_;
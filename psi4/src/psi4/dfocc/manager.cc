@@ -68,7 +68,7 @@ void DFOCC::omp2_manager() {
         cost_ampAA /= 1024.0 * 1024.0;
         cost_ampAA *= sizeof(double);
         cost_amp = 3.0 * cost_ampAA;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -136,7 +136,7 @@ void DFOCC::omp2_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -385,7 +385,7 @@ void DFOCC::mp2_manager() {
         cost_ampAA /= 1024.0 * 1024.0;
         cost_ampAA *= sizeof(double);
         cost_amp = 3.0 * cost_ampAA;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -455,7 +455,7 @@ void DFOCC::mp2_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -585,7 +585,7 @@ void DFOCC::ccsd_manager() {
         FtabA = SharedTensor2d(new Tensor2d("Ftilde <A|B>", navirA, navirA));
 
         // avaliable mem
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -735,7 +735,7 @@ void DFOCC::ccsd_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -923,7 +923,7 @@ void DFOCC::ccsd_t_manager() {
         FtabA = SharedTensor2d(new Tensor2d("Ftilde <A|B>", navirA, navirA));
 
         // avaliable mem
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -1103,7 +1103,7 @@ void DFOCC::ccsd_t_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -1220,19 +1220,7 @@ void DFOCC::ccsd_t_manager() {
         // ccsd_canonic_triples_grad();
         ccsd_canonic_triples_grad2();
     } else {
-        if (triples_iabc_type_ == "DISK")
-            ccsd_canonic_triples_disk();
-        else if (triples_iabc_type_ == "AUTO") {
-            if (do_triples_hm)
-                ccsd_canonic_triples_hm();
-            else
-                ccsd_canonic_triples();
-        } else if (triples_iabc_type_ == "INCORE")
-            ccsd_canonic_triples_hm();
-        else if (triples_iabc_type_ == "DIRECT")
-            ccsd_canonic_triples();
-        else if (triples_iabc_type_ == "DISK")
-            ccsd_canonic_triples_disk();
+        ccsd_canonic_triples();
     }
     timer_off("(T)");
     outfile->Printf("\t(T) Correction (a.u.)              : %20.14f\n", E_t);
@@ -1331,7 +1319,7 @@ void DFOCC::ccsdl_t_manager() {
         FtabA = SharedTensor2d(new Tensor2d("Ftilde <A|B>", navirA, navirA));
 
         // avaliable mem
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -1528,7 +1516,7 @@ void DFOCC::ccsdl_t_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -1704,7 +1692,7 @@ void DFOCC::ccd_manager() {
 
     if (reference_ == "RESTRICTED") {
         // avaliable mem
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -1830,7 +1818,7 @@ void DFOCC::ccd_manager() {
         cost_amp = MAX0(cost_ampAA, cost_ampBB);
         cost_amp = MAX0(cost_amp, cost_ampAB);
         cost_amp = 3.0 * cost_amp;
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
         outfile->Printf("\tMinimum required memory for amplitudes: %9.2lf MB \n", cost_amp);
@@ -1996,7 +1984,7 @@ void DFOCC::omp3_manager() {
     g1Qt2 = SharedTensor1d(new Tensor1d("DF_BASIS_CC G1t_Q", nQ));
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -2294,7 +2282,7 @@ void DFOCC::mp3_manager() {
     }
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -2559,7 +2547,7 @@ void DFOCC::omp2_5_manager() {
     g1Qt2 = SharedTensor1d(new Tensor1d("DF_BASIS_CC G1t_Q", nQ));
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -2856,7 +2844,7 @@ void DFOCC::mp2_5_manager() {
     }
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -3103,7 +3091,7 @@ void DFOCC::olccd_manager() {
     g1Qt2 = SharedTensor1d(new Tensor1d("DF_BASIS_CC G1t_Q", nQ));
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -3372,7 +3360,7 @@ void DFOCC::lccd_manager() {
     }
 
     // avaliable mem
-    memory = Process::environment.get_memory();
+    memory = memory_after_ints();
     memory_mb = (double)memory / (1024.0 * 1024.0);
     outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
 
@@ -3635,7 +3623,7 @@ void DFOCC::qchf_manager() {
 
     else if (reference_ == "UNRESTRICTED") {
         // memory requirements
-        memory = Process::environment.get_memory();
+        memory = memory_after_ints();
         memory_mb = (double)memory / (1024.0 * 1024.0);
         outfile->Printf("\n\tAvailable memory                      : %9.2lf MB \n", memory_mb);
     }  // end else if (reference_ == "UNRESTRICTED")
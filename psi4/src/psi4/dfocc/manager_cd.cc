@@ -984,19 +984,7 @@ void DFOCC::ccsd_t_manager_cd() {
     if (dertype == "FIRST") {
         ccsd_canonic_triples_grad();
     } else {
-        if (triples_iabc_type_ == "DISK")
-            ccsd_canonic_triples_disk();
-        else if (triples_iabc_type_ == "AUTO") {
-            if (do_triples_hm)
-                ccsd_canonic_triples_hm();
-            else
-                ccsd_canonic_triples();
-        } else if (triples_iabc_type_ == "INCORE")
-            ccsd_canonic_triples_hm();
-        else if (triples_iabc_type_ == "DIRECT")
-            ccsd_canonic_triples();
-        else if (triples_iabc_type_ == "DISK")
-            ccsd_canonic_triples_disk();
+        ccsd_canonic_triples();
     }
     timer_off("(T)");
     outfile->Printf("\t(T) Correction (a.u.)              : %20.14f\n", E_t);
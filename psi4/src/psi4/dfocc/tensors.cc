@@ -28,8 +28,11 @@
 
 // Latest revision on April 38, 2013.
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.hpp"
@@ -37,6 +40,8 @@
 #include "psi4/libiwl/iwl.hpp"
 #include "tensors.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
 
@@ -1836,50 +1841,69 @@ double Tensor2d::vector_dot(const SharedTensor2d &rhs) {
     return value;
 }  //
 
-void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
+// Disk addresses become byte offsets into the in-core copy of an entry
+static size_t psio_address_bytes(psio_address address) { return address.page * PSIO_PAGELEN + address.offset; }
+
+static void put_entry(psi::PSIO *psio, size_t fileno, const std::string &label, const char *buffer, size_t nbytes,
+                      psio_address start, psio_address *end) {
+    if (TensorCoreStore::write(psio, fileno, label, buffer, nbytes, psio_address_bytes(start))) {
+        *end = psio_get_address(start, nbytes);
+        return;
+    }
+
     // Check to see if the file is open
     bool already_open = false;
     if (psio->open_check(fileno))
         already_open = true;
     else
         psio->open(fileno, PSIO_OPEN_OLD);
-    psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
+    psio->write(fileno, label.c_str(), const_cast<char *>(buffer), nbytes, start, end);
     if (!already_open) psio->close(fileno, 1);  // Close and keep
-}  //
+}
+
+static void put_entry(psi::PSIO *psio, size_t fileno, const std::string &label, const char *buffer, size_t nbytes) {
+    psio_address end;
+    put_entry(psio, fileno, label, buffer, nbytes, PSIO_ZERO, &end);
+}
+
+static void get_entry(psi::PSIO *psio, size_t fileno, const std::string &label, char *buffer, size_t nbytes,
+                      psio_address start, psio_address *end) {
+    if (TensorCoreStore::read(fileno, label, buffer, nbytes, psio_address_bytes(start))) {
+        *end = psio_get_address(start, nbytes);
+        return;
+    }
 
-void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno, psio_address start, psio_address *end) {
     // Check to see if the file is open
     bool already_open = false;
     if (psio->open_check(fileno))
         already_open = true;
     else
         psio->open(fileno, PSIO_OPEN_OLD);
-    size_t size_ = (size_t)dim1_ * dim2_ * sizeof(double);
-    psio->write(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], size_, start, end);
+    psio->read(fileno, label.c_str(), buffer, nbytes, start, end);
     if (!already_open) psio->close(fileno, 1);  // Close and keep
+}
+
+static void get_entry(psi::PSIO *psio, size_t fileno, const std::string &label, char *buffer, size_t nbytes) {
+    psio_address end;
+    get_entry(psio, fileno, label, buffer, nbytes, PSIO_ZERO, &end);
+}
+
+void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
+    put_entry(psio.get(), fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
+}  //
+
+void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno, psio_address start, psio_address *end) {
+    size_t size_ = (size_t)dim1_ * dim2_ * sizeof(double);
+    put_entry(psio.get(), fileno, name_, (char *)A2d_[0], size_, start, end);
 }  //
 
 void Tensor2d::write(psi::PSIO *const psio, size_t fileno) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    put_entry(psio, fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
 }  //
 
 void Tensor2d::write(psi::PSIO *const psio, size_t fileno, psio_address start, psio_address *end) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
     size_t size_ = (size_t)dim1_ * dim2_ * sizeof(double);
-    psio->write(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], size_, start, end);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    put_entry(psio, fileno, name_, (char *)A2d_[0], size_, start, end);
 }  //
 
 void Tensor2d::write(psi::PSIO &psio, size_t fileno) { write(&psio, fileno); }  //
@@ -1889,14 +1913,7 @@ void Tensor2d::write(psi::PSIO &psio, size_t fileno, psio_address start, psio_ad
 }  //
 
 void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, const std::string &filename, size_t fileno) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->write_entry(fileno, const_cast<char *>(filename.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    put_entry(psio.get(), fileno, filename, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
 }  //
 
 void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_index, bool symm) {
@@ -1915,27 +1932,12 @@ void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_
             }
         }
 
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)temp->A2d_[0],
-                          sizeof(double) * dim1_ * ntri_col);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        put_entry(psio.get(), fileno, name_, (char *)temp->A2d_[0], sizeof(double) * dim1_ * ntri_col);
         temp.reset();
     }
 
     else {
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        put_entry(psio.get(), fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
     }
 
 }  //
@@ -1957,28 +1959,12 @@ void Tensor2d::write(std::shared_ptr<psi::PSIO> psio, const std::string &filenam
             }
         }
 
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->write_entry(fileno, const_cast<char *>(filename.c_str()), (char *)temp->A2d_[0],
-                          sizeof(double) * dim1_ * ntri_col);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        put_entry(psio.get(), fileno, filename, (char *)temp->A2d_[0], sizeof(double) * dim1_ * ntri_col);
         temp.reset();
     }
 
     else {
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->write_entry(fileno, const_cast<char *>(filename.c_str()), (char *)A2d_[0],
-                          sizeof(double) * dim1_ * dim2_);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        put_entry(psio.get(), fileno, filename, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
     }
 
 }  //
@@ -1995,14 +1981,7 @@ void Tensor2d::write_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
         }
     }
 
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)&(temp->A1d_[0]), sizeof(double) * ntri_col);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    put_entry(psio.get(), fileno, name_, (char *)&(temp->A1d_[0]), sizeof(double) * ntri_col);
     temp.reset();
 
 }  //
@@ -2036,63 +2015,27 @@ void Tensor2d::write_anti_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
         }
     }
 
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->write_entry(fileno, const_cast<char *>(name_.c_str()), (char *)temp->A2d_[0],
-                      sizeof(double) * ntri_row * ntri_col);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    put_entry(psio.get(), fileno, name_, (char *)temp->A2d_[0], sizeof(double) * ntri_row * ntri_col);
     temp.reset();
 
 }  //
 
 void Tensor2d::read(psi::PSIO *psio, size_t fileno) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio, fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
 }
 
 void Tensor2d::read(psi::PSIO *psio, size_t fileno, psio_address start, psio_address *end) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
     size_t size_ = (size_t)dim1_ * dim2_ * sizeof(double);
-    psio->read(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], size_, start, end);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio, fileno, name_, (char *)A2d_[0], size_, start, end);
 }
 
 void Tensor2d::read(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio.get(), fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
 }
 
 void Tensor2d::read(std::shared_ptr<psi::PSIO> psio, size_t fileno, psio_address start, psio_address *end) {
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
     size_t size_ = (size_t)dim1_ * dim2_ * sizeof(double);
-    psio->read(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], size_, start, end);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio.get(), fileno, name_, (char *)A2d_[0], size_, start, end);
 }
 
 void Tensor2d::read(psi::PSIO &psio, size_t fileno) { read(&psio, fileno); }  //
@@ -2107,15 +2050,7 @@ void Tensor2d::read(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_i
         int ntri_col = 0.5 * d2_ * (d2_ + 1);
         SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", d1_, ntri_col));
 
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)temp->A2d_[0],
-                         sizeof(double) * dim1_ * ntri_col);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        get_entry(psio.get(), fileno, name_, (char *)temp->A2d_[0], sizeof(double) * dim1_ * ntri_col);
 
 #pragma omp parallel for
         for (int R = 0; R < d1_; R++) {
@@ -2131,14 +2066,7 @@ void Tensor2d::read(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_i
     }
 
     else {
-        // Check to see if the file is open
-        bool already_open = false;
-        if (psio->open_check(fileno))
-            already_open = true;
-        else
-            psio->open(fileno, PSIO_OPEN_OLD);
-        psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
-        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        get_entry(psio.get(), fileno, name_, (char *)A2d_[0], sizeof(double) * dim1_ * dim2_);
     }
 
 }  //
@@ -2148,14 +2076,7 @@ void Tensor2d::read_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
     int ntri_col = 0.5 * dim1_ * (dim1_ + 1);
     SharedTensor1d temp = SharedTensor1d(new Tensor1d("temp", ntri_col));
 
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)&(temp->A1d_[0]), sizeof(double) * ntri_col);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio.get(), fileno, name_, (char *)&(temp->A1d_[0]), sizeof(double) * ntri_col);
 
 #pragma omp parallel for
     for (int p = 0; p < dim1_; p++) {
@@ -2184,15 +2105,7 @@ void Tensor2d::read_anti_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
 
     SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", ntri_row, ntri_col));
 
-    // Check to see if the file is open
-    bool already_open = false;
-    if (psio->open_check(fileno))
-        already_open = true;
-    else
-        psio->open(fileno, PSIO_OPEN_OLD);
-    psio->read_entry(fileno, const_cast<char *>(name_.c_str()), (char *)temp->A2d_[0],
-                     sizeof(double) * ntri_row * ntri_col);
-    if (!already_open) psio->close(fileno, 1);  // Close and keep
+    get_entry(psio.get(), fileno, name_, (char *)temp->A2d_[0], sizeof(double) * ntri_row * ntri_col);
 
 #pragma omp parallel for
     for (int p = 1; p < d1_; p++) {
@@ -2480,497 +2393,303 @@ double *Tensor2d::column_vector(int n) {
     return temp;
 }  //
 
-void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double beta) {
-    int d1 = A->d1_;
-    int d2 = A->d2_;
-    int d3 = A->d3_;
-    int d4 = A->d4_;
+// Edge of the square tiles of the blocked permutations; two 32 x 32 tiles of doubles fit in L1
+static const long int sort_tile = 32;
 
-    if (sort_type == 1243) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = col_idx_[s][r];
-                        A2d_[pq][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pq][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1324) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int qs = col_idx_[q][s];
-                        A2d_[pr][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1342) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int sq = col_idx_[s][q];
-                        A2d_[pr][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1423) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        int qr = col_idx_[q][r];
-                        A2d_[ps][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][qr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1432) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = col_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        A2d_[ps][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][rq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2134) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        A2d_[qp][rs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][rs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2143) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        int sr = col_idx_[s][r];
-                        A2d_[qp][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2314) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int ps = col_idx_[p][s];
-                        A2d_[qr][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][ps]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2341) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int sp = col_idx_[s][p];
-                        A2d_[qr][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2413) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int pr = col_idx_[p][r];
-                        A2d_[qs][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][pr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2431) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int rp = col_idx_[r][p];
-                        A2d_[qs][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][rp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3124) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int qs = col_idx_[q][s];
-                        A2d_[rp][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3142) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int sq = col_idx_[s][q];
-                        A2d_[rp][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3214) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = row_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = col_idx_[p][s];
-                        A2d_[rq][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][ps]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3241) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rq = row_idx_[r][q];
-                        int sp = col_idx_[s][p];
-                        A2d_[rq][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3412) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        A2d_[rs][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][pq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3421) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = col_idx_[q][p];
-                        A2d_[rs][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][qp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4123) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int qr = col_idx_[q][r];
-                        A2d_[sp][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][qr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int rq = col_idx_[r][q];
-                        A2d_[sp][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][rq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int pr = col_idx_[p][r];
-                        A2d_[sq][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][pr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int rp = col_idx_[r][p];
-                        A2d_[sq][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][rp]);
-                    }
-                }
+/*
+ * T(i0,i1,i2,i3) = alpha * S(i0,i1,i2,i3) + beta * T(i0,i1,i2,i3), where n are the extents of the
+ * four indices and ss, ts their strides in S and T. The index that runs fastest in T and the one that
+ * runs fastest in S are tiled together, so both the reads and the writes of a tile stay in cache and
+ * the inner loop has unit stride on the written side. Threads take (outer indices, tile) pairs.
+ */
+static void permute4(const double *S, double *T, const long int *n, const long int *ss, const long int *ts,
+                     double alpha, double beta) {
+    if (n[0] * n[1] * n[2] * n[3] == 0) return;
+
+    // Fastest index of T (a) and of S (b)
+    int a = -1, b = -1;
+    for (int i = 0; i < 4; i++) {
+        if (ts[i] == 1 && (a < 0 || n[i] > n[a])) a = i;
+        if (ss[i] == 1 && (b < 0 || n[i] > n[b])) b = i;
+    }
+    if (a < 0 || b < 0) throw PSIEXCEPTION("Tensor2d::sort: neither tensor is stored contiguously!");
+
+    int o[4];
+    int no = 0;
+    for (int i = 0; i < 4; i++)
+        if (i != a && i != b) o[no++] = i;
+
+    // Same fastest index: whole contiguous rows
+    if (a == b) {
+        long int n0 = n[o[0]], n1 = n[o[1]], n2 = n[o[2]], na = n[a];
+#pragma omp parallel for schedule(static)
+        for (long int x = 0; x < n0 * n1 * n2; x++) {
+            long int i2 = x % n2;
+            long int i1 = (x / n2) % n1;
+            long int i0 = x / (n2 * n1);
+            const double *sx = S + i0 * ss[o[0]] + i1 * ss[o[1]] + i2 * ss[o[2]];
+            double *tx = T + i0 * ts[o[0]] + i1 * ts[o[1]] + i2 * ts[o[2]];
+            if (beta == 0.0) {
+                for (long int y = 0; y < na; y++) tx[y] = alpha * sx[y];
+            } else {
+                for (long int y = 0; y < na; y++) tx[y] = alpha * sx[y] + beta * tx[y];
             }
         }
-    }
-
-    else if (sort_type == 4312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        A2d_[sr][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][pq]);
-                    }
-                }
+        return;
+    }
+
+    // Tiled transpose of (b, a) for every value of the two outer indices
+    long int n0 = n[o[0]], n1 = n[o[1]];
+    long int sa = ss[a], tb = ts[b];
+    long int nta = (n[a] + sort_tile - 1) / sort_tile;
+    long int ntb = (n[b] + sort_tile - 1) / sort_tile;
+#pragma omp parallel for schedule(static)
+    for (long int x = 0; x < n0 * n1 * nta * ntb; x++) {
+        long int jb = x % ntb;
+        long int ja = (x / ntb) % nta;
+        long int i1 = (x / (ntb * nta)) % n1;
+        long int i0 = x / (ntb * nta * n1);
+        const double *sx = S + i0 * ss[o[0]] + i1 * ss[o[1]];
+        double *tx = T + i0 * ts[o[0]] + i1 * ts[o[1]];
+        long int a0 = ja * sort_tile;
+        long int a1 = MIN0(a0 + sort_tile, n[a]);
+        long int b0 = jb * sort_tile;
+        long int b1 = MIN0(b0 + sort_tile, n[b]);
+        for (long int ib = b0; ib < b1; ib++) {
+            const double *sb = sx + ib;
+            double *t = tx + ib * tb;
+            if (beta == 0.0) {
+                for (long int ia = a0; ia < a1; ia++) t[ia] = alpha * sb[ia * sa];
+            } else {
+                for (long int ia = a0; ia < a1; ia++) t[ia] = alpha * sb[ia * sa] + beta * t[ia];
             }
         }
     }
+}
 
-    else if (sort_type == 4321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        int qp = col_idx_[q][p];
-                        A2d_[sr][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][qp]);
-                    }
-                }
-            }
-        }
+// Digits of a sort type, e.g. 1432 -> {0, 3, 2, 1}; false unless they are a permutation of 1..nidx
+static bool sort_digits(int sort_type, int nidx, int *perm) {
+    int seen = 0;
+    for (int k = nidx - 1; k >= 0; k--) {
+        perm[k] = sort_type % 10 - 1;
+        sort_type /= 10;
+        if (perm[k] < 0 || perm[k] >= nidx || (seen & (1 << perm[k]))) return false;
+        seen |= (1 << perm[k]);
     }
+    return sort_type == 0;
+}
 
-    else {
+void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double beta) {
+    // The k-th index of the target is index perm[k] of A, e.g. 1432: A2d_(ps,rq) = A(pq,rs)
+    int perm[4];
+    if (!sort_digits(sort_type, 4, perm)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
+    long int n[4] = {A->d1_, A->d2_, A->d3_, A->d4_};
+    long int ss[4] = {(long int)A->d2_ * A->dim2_, A->dim2_, A->d4_, 1};
+    long int tk[4] = {(long int)d2_ * dim2_, dim2_, d4_, 1};
+    long int ts[4];
+    for (int k = 0; k < 4; k++) ts[perm[k]] = tk[k];
+
+    if (n[0] * n[1] * n[2] * n[3] == 0) return;
+    permute4(A->A2d_[0], A2d_[0], n, ss, ts, alpha, beta);
 }  //
 
 void Tensor2d::sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    int qr = r + (q * d3);
-                    A2d_[p][rq] = (alpha * A->A2d_[p][qr]) + (beta * A2d_[p][rq]);
-                }
-            }
-        }
-    }
-
-    else {
+    // A2d_[p][..] = A[p][qr], e.g. 132: A2d_[p][rq] = A[p][qr]
+    int perm[3];
+    if (!sort_digits(sort_type, 3, perm)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
+    long int dims[3] = {d1, d2, d3};
+    long int n[4] = {1, d1, d2, d3};
+    long int ss[4] = {0, A->dim2_, d3, 1};
+    long int tk[3] = {dim2_, dims[perm[2]], 1};
+    long int ts[4] = {0, 0, 0, 0};
+    for (int k = 0; k < 3; k++) ts[perm[k] + 1] = tk[k];
+
+    if (n[1] * n[2] * n[3] == 0) return;
+    permute4(A->A2d_[0], A2d_[0], n, ss, ts, alpha, beta);
 }  //
 
 void Tensor2d::sort3b(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int pr = r + (p * d3);
-                    A2d_[pr][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[pr][q]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                int qp = p + (q * d1);
-                for (int r = 0; r < d3; r++) {
-                    A2d_[qp][r] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qp][r]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rp = p + (r * d1);
-                    A2d_[rp][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rp][q]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int qr = r + (q * d3);
-                    A2d_[qr][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qr][p]);
-                }
-            }
-        }
+    // A2d_[..][.] = A[pq][r], e.g. 312: A2d_[rp][q] = A[pq][r]
+    int perm[3];
+    if (!sort_digits(sort_type, 3, perm)) {
+        outfile->Printf("\tUnrecognized sort type!\n");
+        throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
-    else if (sort_type == 321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    A2d_[rq][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rq][p]);
+    long int dims[3] = {d1, d2, d3};
+    long int n[4] = {1, d1, d2, d3};
+    long int ss[4] = {0, (long int)d2 * A->dim2_, A->dim2_, 1};
+    long int tk[3] = {dims[perm[1]] * dim2_, dim2_, 1};
+    long int ts[4] = {0, 0, 0, 0};
+    for (int k = 0; k < 3; k++) ts[perm[k] + 1] = tk[k];
+
+    if (n[1] * n[2] * n[3] == 0) return;
+    permute4(A->A2d_[0], A2d_[0], n, ss, ts, alpha, beta);
+}  //
+
+// Element-by-element permutation with index tables, threaded over the first index; reference for benchmark_sort
+static void sort_reference(const int *perm, const int *d, double **A, double **T) {
+    int td[4];
+    for (int k = 0; k < 4; k++) td[k] = d[perm[k]];
+    int **row = init_int_matrix(td[0], td[1]);
+    int **col = init_int_matrix(td[2], td[3]);
+    for (int i = 0; i < td[0]; i++)
+        for (int j = 0; j < td[1]; j++) row[i][j] = j + i * td[1];
+    for (int i = 0; i < td[2]; i++)
+        for (int j = 0; j < td[3]; j++) col[i][j] = j + i * td[3];
+
+#pragma omp parallel for
+    for (int p = 0; p < d[0]; p++) {
+        int idx[4];
+        idx[0] = p;
+        for (idx[1] = 0; idx[1] < d[1]; idx[1]++) {
+            int pq = idx[1] + p * d[1];
+            for (idx[2] = 0; idx[2] < d[2]; idx[2]++) {
+                for (idx[3] = 0; idx[3] < d[3]; idx[3]++) {
+                    int rs = idx[3] + idx[2] * d[3];
+                    T[row[idx[perm[0]]][idx[perm[1]]]][col[idx[perm[2]]][idx[perm[3]]]] = A[pq][rs];
                 }
             }
         }
     }
+    free_int_matrix(row);
+    free_int_matrix(col);
+}
 
-    else {
-        outfile->Printf("\tUnrecognized sort type!\n");
-        throw PSIEXCEPTION("Unrecognized sort type!");
-    }
+// The blocked kernels only move elements, so they must reproduce the reference bit for bit
+static void check_sort(const std::string &label, const SharedTensor2d &T, double **Tp) {
+    double **Tc = T->to_block_matrix();
+    double maxdiff = 0.0;
+    for (long int i = 0; i < (long int)T->dim1() * T->dim2(); i++)
+        maxdiff = std::max(maxdiff, std::fabs(Tc[0][i] - Tp[0][i]));
+    free_block(Tc);
+    if (maxdiff != 0.0)
+        throw PSIEXCEPTION("benchmark_sort: " + label + " differs from the reference by " + std::to_string(maxdiff));
+}
 
-}  //
+std::map<std::string, std::map<std::string, double>> benchmark_sort(int nocc, int nvir, int naux, double min_time) {
+    std::map<std::string, std::map<std::string, double>> results;
+    double T_elapsed;
+    size_t rounds;
+    Timer *qq;
+
+    // 4-index sorts of (oo|vv) and (ov|ov) shaped amplitudes
+    const std::vector<std::pair<int, std::vector<int>>> sorts = {
+        {1324, {nocc, nocc, nvir, nvir}}, {1432, {nocc, nvir, nocc, nvir}}, {2413, {nocc, nvir, nocc, nvir}},
+        {1243, {nocc, nocc, nvir, nvir}}, {1423, {nocc, nvir, nocc, nvir}}, {3142, {nocc, nvir, nocc, nvir}},
+        {2134, {nocc, nocc, nvir, nvir}}};
+    for (const auto &entry : sorts) {
+        int code = entry.first;
+        const int *d = entry.second.data();
+        int perm[4];
+        sort_digits(code, 4, perm);
+        double bytes = 8.0 * 2.0 * d[0] * d[1] * d[2] * d[3];
+        std::string label = "SORT " + std::to_string(code);
+
+        SharedTensor2d A = SharedTensor2d(new Tensor2d("A", d[0], d[1], d[2], d[3]));
+        SharedTensor2d T = SharedTensor2d(new Tensor2d("T", d[perm[0]], d[perm[1]], d[perm[2]], d[perm[3]]));
+        double **Ap = block_matrix(d[0] * d[1], d[2] * d[3]);
+        double **Tp = block_matrix(d[perm[0]] * d[perm[1]], d[perm[2]] * d[perm[3]]);
+        for (long int i = 0; i < (long int)d[0] * d[1] * d[2] * d[3]; i++) Ap[0][i] = (double)std::rand() / RAND_MAX;
+        A->set(Ap);
+
+        T_elapsed = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T_elapsed < min_time || rounds == 0) {
+            T->sort(code, A, 1.0, 0.0);
+            T_elapsed = qq->get();
+            rounds++;
+        }
+        delete qq;
+        results[label]["time"] = T_elapsed / (double)rounds;
+        results[label]["flops"] = 0.0;
+        results[label]["bytes"] = bytes;
+
+        T_elapsed = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T_elapsed < min_time || rounds == 0) {
+            sort_reference(perm, d, Ap, Tp);
+            T_elapsed = qq->get();
+            rounds++;
+        }
+        delete qq;
+        results[label + " (reference)"]["time"] = T_elapsed / (double)rounds;
+        results[label + " (reference)"]["flops"] = 0.0;
+        results[label + " (reference)"]["bytes"] = bytes;
+        check_sort(label, T, Tp);
+
+        free_block(Ap);
+        free_block(Tp);
+    }
+
+    // B(Q,ia) -> B(Q,ai) and B(ia,Q) -> B(iQ,a)
+    double bytes = 8.0 * 2.0 * naux * nocc * nvir;
+    SharedTensor2d B = SharedTensor2d(new Tensor2d("B (Q|ia)", naux, nocc, nvir));
+    SharedTensor2d Bt = SharedTensor2d(new Tensor2d("B (Q|ai)", naux, nvir, nocc));
+    double **Bp = block_matrix(naux, nocc * nvir);
+    for (long int i = 0; i < (long int)naux * nocc * nvir; i++) Bp[0][i] = (double)std::rand() / RAND_MAX;
+    B->set(Bp);
+    T_elapsed = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T_elapsed < min_time || rounds == 0) {
+        Bt->sort3a(132, naux, nocc, nvir, B, 1.0, 0.0);
+        T_elapsed = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["SORT3A 132"]["time"] = T_elapsed / (double)rounds;
+    results["SORT3A 132"]["flops"] = 0.0;
+    results["SORT3A 132"]["bytes"] = bytes;
+
+    // B(Q,ia) is A(pq,rs) with p = 0, q = Q, r = i, s = a
+    int d3a[4] = {1, naux, nocc, nvir};
+    int perm3a[4] = {0, 1, 3, 2};
+    double **Tp = block_matrix(naux, nvir * nocc);
+    sort_reference(perm3a, d3a, Bp, Tp);
+    check_sort("SORT3A 132", Bt, Tp);
+    free_block(Tp);
+
+    B = SharedTensor2d(new Tensor2d("B (ia|Q)", nocc * nvir, naux));
+    Bt = SharedTensor2d(new Tensor2d("B (iQ|a)", nocc * naux, nvir));
+    B->set(Bp[0]);
+    T_elapsed = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T_elapsed < min_time || rounds == 0) {
+        Bt->sort3b(132, nocc, nvir, naux, B, 1.0, 0.0);
+        T_elapsed = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["SORT3B 132"]["time"] = T_elapsed / (double)rounds;
+    results["SORT3B 132"]["flops"] = 0.0;
+    results["SORT3B 132"]["bytes"] = bytes;
+
+    // B(ia,Q) is A(pq,rs) with p = i, q = a, r = Q, s = 0
+    int d3b[4] = {nocc, nvir, naux, 1};
+    int perm3b[4] = {0, 2, 1, 3};
+    double **B3p = block_matrix(nocc * nvir, naux);
+    C_DCOPY((size_t)nocc * nvir * naux, Bp[0], 1, B3p[0], 1);
+    Tp = block_matrix(nocc * naux, nvir);
+    sort_reference(perm3b, d3b, B3p, Tp);
+    check_sort("SORT3B 132", Bt, Tp);
+    free_block(Tp);
+    free_block(B3p);
+    free_block(Bp);
+
+    return results;
+}
 
 void Tensor2d::apply_denom(int frzc, int occ, const SharedTensor2d &fock) {
     int aocc = d1_;
@@ -4190,7 +3909,6 @@ void Tensor2d::cont444(int t_a1, int t_a2, int f_a1, int f_a2, const SharedTenso
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int dim_t, dim_u;
 
     // C(pq,rs) = \sum_{tu} A(pq,tu) B(tu,rs)
@@ -4260,58 +3978,7 @@ void Tensor2d::cont444(int t_a1, int t_a2, int f_a1, int f_a2, const SharedTenso
 
         // Sort A(..,..) to A(pq,tu)
         SharedTensor2d temp1 = SharedTensor2d(new Tensor2d("temp1", d1_, d2_, dim_t, dim_u));
-#pragma omp parallel for
-        for (int p = 0; p < d1_; p++) {
-            for (int q = 0; q < d2_; q++) {
-                int pq = temp1->row_idx_[p][q];
-                for (int t = 0; t < dim_t; t++) {
-                    for (int u = 0; u < dim_u; u++) {
-                        int tu = temp1->col_idx_[t][u];
-
-                        if (r1 == f_a1)
-                            rr1 = p;
-                        else if (r1 == f_a2)
-                            rr1 = q;
-                        else if (r1 == t_a1)
-                            rr1 = t;
-                        else if (r1 == t_a2)
-                            rr1 = u;
-
-                        if (r2 == f_a1)
-                            rr2 = p;
-                        else if (r2 == f_a2)
-                            rr2 = q;
-                        else if (r2 == t_a1)
-                            rr2 = t;
-                        else if (r2 == t_a2)
-                            rr2 = u;
-
-                        if (c1 == f_a1)
-                            cc1 = p;
-                        else if (c1 == f_a2)
-                            cc1 = q;
-                        else if (c1 == t_a1)
-                            cc1 = t;
-                        else if (c1 == t_a2)
-                            cc1 = u;
-
-                        if (c2 == f_a1)
-                            cc2 = p;
-                        else if (c2 == f_a2)
-                            cc2 = q;
-                        else if (c2 == t_a1)
-                            cc2 = t;
-                        else if (c2 == t_a2)
-                            cc2 = u;
-
-                        int row = rr2 + (rr1 * A->d2_);
-                        int col = cc2 + (cc1 * A->d4_);
-
-                        temp1->A2d_[pq][tu] = A->A2d_[row][col];
-                    }
-                }
-            }
-        }
+        temp1->sort(1000 * f_a1 + 100 * f_a2 + 10 * t_a1 + t_a2, A, 1.0, 0.0);
         // temp1->print();
 
         // r1
@@ -4358,58 +4025,7 @@ void Tensor2d::cont444(int t_a1, int t_a2, int f_a1, int f_a2, const SharedTenso
 
         // Sort B(..,..) to B(tu,rs)
         SharedTensor2d temp2 = SharedTensor2d(new Tensor2d("temp2", dim_t, dim_u, d3_, d4_));
-#pragma omp parallel for
-        for (int t = 0; t < dim_t; t++) {
-            for (int u = 0; u < dim_u; u++) {
-                int tu = temp2->row_idx_[t][u];
-                for (int r = 0; r < d3_; r++) {
-                    for (int s = 0; s < d4_; s++) {
-                        int rs = temp2->col_idx_[r][s];
-
-                        if (r1 == f_b1)
-                            rr1 = r;
-                        else if (r1 == f_b2)
-                            rr1 = s;
-                        else if (r1 == t_b1)
-                            rr1 = t;
-                        else if (r1 == t_b2)
-                            rr1 = u;
-
-                        if (r2 == f_b1)
-                            rr2 = r;
-                        else if (r2 == f_b2)
-                            rr2 = s;
-                        else if (r2 == t_b1)
-                            rr2 = t;
-                        else if (r2 == t_b2)
-                            rr2 = u;
-
-                        if (c1 == f_b1)
-                            cc1 = r;
-                        else if (c1 == f_b2)
-                            cc1 = s;
-                        else if (c1 == t_b1)
-                            cc1 = t;
-                        else if (c1 == t_b2)
-                            cc1 = u;
-
-                        if (c2 == f_b1)
-                            cc2 = r;
-                        else if (c2 == f_b2)
-                            cc2 = s;
-                        else if (c2 == t_b1)
-                            cc2 = t;
-                        else if (c2 == t_b2)
-                            cc2 = u;
-
-                        int row = rr2 + (rr1 * B->d2_);
-                        int col = cc2 + (cc1 * B->d4_);
-
-                        temp2->A2d_[tu][rs] = B->A2d_[row][col];
-                    }
-                }
-            }
-        }
+        temp2->sort(1000 * t_b1 + 100 * t_b2 + 10 * f_b1 + f_b2, B, 1.0, 0.0);
         // temp2->print();
 
         ta = 'n';
@@ -4435,7 +4051,6 @@ void Tensor2d::cont444(bool delete_a, int t_a1, int t_a2, int f_a1, int f_a2, Sh
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int dim_t, dim_u;
 
     // C(pq,rs) = \sum_{tu} A(pq,tu) B(tu,rs)
@@ -4505,58 +4120,7 @@ void Tensor2d::cont444(bool delete_a, int t_a1, int t_a2, int f_a1, int f_a2, Sh
 
         // Sort A(..,..) to A(pq,tu)
         SharedTensor2d temp1 = SharedTensor2d(new Tensor2d("temp1", d1_, d2_, dim_t, dim_u));
-#pragma omp parallel for
-        for (int p = 0; p < d1_; p++) {
-            for (int q = 0; q < d2_; q++) {
-                int pq = temp1->row_idx_[p][q];
-                for (int t = 0; t < dim_t; t++) {
-                    for (int u = 0; u < dim_u; u++) {
-                        int tu = temp1->col_idx_[t][u];
-
-                        if (r1 == f_a1)
-                            rr1 = p;
-                        else if (r1 == f_a2)
-                            rr1 = q;
-                        else if (r1 == t_a1)
-                            rr1 = t;
-                        else if (r1 == t_a2)
-                            rr1 = u;
-
-                        if (r2 == f_a1)
-                            rr2 = p;
-                        else if (r2 == f_a2)
-                            rr2 = q;
-                        else if (r2 == t_a1)
-                            rr2 = t;
-                        else if (r2 == t_a2)
-                            rr2 = u;
-
-                        if (c1 == f_a1)
-                            cc1 = p;
-                        else if (c1 == f_a2)
-                            cc1 = q;
-                        else if (c1 == t_a1)
-                            cc1 = t;
-                        else if (c1 == t_a2)
-                            cc1 = u;
-
-                        if (c2 == f_a1)
-                            cc2 = p;
-                        else if (c2 == f_a2)
-                            cc2 = q;
-                        else if (c2 == t_a1)
-                            cc2 = t;
-                        else if (c2 == t_a2)
-                            cc2 = u;
-
-                        int row = rr2 + (rr1 * A->d2_);
-                        int col = cc2 + (cc1 * A->d4_);
-
-                        temp1->A2d_[pq][tu] = A->A2d_[row][col];
-                    }
-                }
-            }
-        }
+        temp1->sort(1000 * f_a1 + 100 * f_a2 + 10 * t_a1 + t_a2, A, 1.0, 0.0);
         // temp1->print();
         if (delete_a) A.reset();
 
@@ -4604,58 +4168,7 @@ void Tensor2d::cont444(bool delete_a, int t_a1, int t_a2, int f_a1, int f_a2, Sh
 
         // Sort B(..,..) to B(tu,rs)
         SharedTensor2d temp2 = SharedTensor2d(new Tensor2d("temp2", dim_t, dim_u, d3_, d4_));
-#pragma omp parallel for
-        for (int t = 0; t < dim_t; t++) {
-            for (int u = 0; u < dim_u; u++) {
-                int tu = temp2->row_idx_[t][u];
-                for (int r = 0; r < d3_; r++) {
-                    for (int s = 0; s < d4_; s++) {
-                        int rs = temp2->col_idx_[r][s];
-
-                        if (r1 == f_b1)
-                            rr1 = r;
-                        else if (r1 == f_b2)
-                            rr1 = s;
-                        else if (r1 == t_b1)
-                            rr1 = t;
-                        else if (r1 == t_b2)
-                            rr1 = u;
-
-                        if (r2 == f_b1)
-                            rr2 = r;
-                        else if (r2 == f_b2)
-                            rr2 = s;
-                        else if (r2 == t_b1)
-                            rr2 = t;
-                        else if (r2 == t_b2)
-                            rr2 = u;
-
-                        if (c1 == f_b1)
-                            cc1 = r;
-                        else if (c1 == f_b2)
-                            cc1 = s;
-                        else if (c1 == t_b1)
-                            cc1 = t;
-                        else if (c1 == t_b2)
-                            cc1 = u;
-
-                        if (c2 == f_b1)
-                            cc2 = r;
-                        else if (c2 == f_b2)
-                            cc2 = s;
-                        else if (c2 == t_b1)
-                            cc2 = t;
-                        else if (c2 == t_b2)
-                            cc2 = u;
-
-                        int row = rr2 + (rr1 * B->d2_);
-                        int col = cc2 + (cc1 * B->d4_);
-
-                        temp2->A2d_[tu][rs] = B->A2d_[row][col];
-                    }
-                }
-            }
-        }
+        temp2->sort(1000 * t_b1 + 100 * t_b2 + 10 * f_b1 + f_b2, B, 1.0, 0.0);
         // temp2->print();
         if (delete_b) B.reset();
 
@@ -4682,7 +4195,6 @@ void Tensor2d::cont444(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1 = 0, r2 = 0, c1 = 0, c2 = 0;
-    int rr1, rr2, cc1, cc2;
     int dim_t, dim_u;
     int t_a1 = 0, t_a2 = 0, f_a1 = 0, f_a2 = 0;
     int t_b1 = 0, t_b2 = 0, f_b1 = 0, f_b2 = 0;
@@ -4850,58 +4362,7 @@ void Tensor2d::cont444(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort A(..,..) to A(pq,tu)
     SharedTensor2d temp1 = SharedTensor2d(new Tensor2d("temp1", d1_, d2_, dim_t, dim_u));
-#pragma omp parallel for
-    for (int p = 0; p < d1_; p++) {
-        for (int q = 0; q < d2_; q++) {
-            int pq = temp1->row_idx_[p][q];
-            for (int t = 0; t < dim_t; t++) {
-                for (int u = 0; u < dim_u; u++) {
-                    int tu = temp1->col_idx_[t][u];
-
-                    if (r1 == f_a1)
-                        rr1 = p;
-                    else if (r1 == f_a2)
-                        rr1 = q;
-                    else if (r1 == t_a1)
-                        rr1 = t;
-                    else if (r1 == t_a2)
-                        rr1 = u;
-
-                    if (r2 == f_a1)
-                        rr2 = p;
-                    else if (r2 == f_a2)
-                        rr2 = q;
-                    else if (r2 == t_a1)
-                        rr2 = t;
-                    else if (r2 == t_a2)
-                        rr2 = u;
-
-                    if (c1 == f_a1)
-                        cc1 = p;
-                    else if (c1 == f_a2)
-                        cc1 = q;
-                    else if (c1 == t_a1)
-                        cc1 = t;
-                    else if (c1 == t_a2)
-                        cc1 = u;
-
-                    if (c2 == f_a1)
-                        cc2 = p;
-                    else if (c2 == f_a2)
-                        cc2 = q;
-                    else if (c2 == t_a1)
-                        cc2 = t;
-                    else if (c2 == t_a2)
-                        cc2 = u;
-
-                    int row = rr2 + (rr1 * A->d2_);
-                    int col = cc2 + (cc1 * A->d4_);
-
-                    temp1->A2d_[pq][tu] = A->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp1->sort(1000 * f_a1 + 100 * f_a2 + 10 * t_a1 + t_a2, A, 1.0, 0.0);
     // temp1->print();
     if (delete_a) A.reset();
 
@@ -4950,58 +4411,7 @@ void Tensor2d::cont444(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort B(..,..) to B(tu,rs)
     SharedTensor2d temp2 = SharedTensor2d(new Tensor2d("temp2", dim_t, dim_u, d3_, d4_));
-#pragma omp parallel for
-    for (int t = 0; t < dim_t; t++) {
-        for (int u = 0; u < dim_u; u++) {
-            int tu = temp2->row_idx_[t][u];
-            for (int r = 0; r < d3_; r++) {
-                for (int s = 0; s < d4_; s++) {
-                    int rs = temp2->col_idx_[r][s];
-
-                    if (r1 == f_b1)
-                        rr1 = r;
-                    else if (r1 == f_b2)
-                        rr1 = s;
-                    else if (r1 == t_b1)
-                        rr1 = t;
-                    else if (r1 == t_b2)
-                        rr1 = u;
-
-                    if (r2 == f_b1)
-                        rr2 = r;
-                    else if (r2 == f_b2)
-                        rr2 = s;
-                    else if (r2 == t_b1)
-                        rr2 = t;
-                    else if (r2 == t_b2)
-                        rr2 = u;
-
-                    if (c1 == f_b1)
-                        cc1 = r;
-                    else if (c1 == f_b2)
-                        cc1 = s;
-                    else if (c1 == t_b1)
-                        cc1 = t;
-                    else if (c1 == t_b2)
-                        cc1 = u;
-
-                    if (c2 == f_b1)
-                        cc2 = r;
-                    else if (c2 == f_b2)
-                        cc2 = s;
-                    else if (c2 == t_b1)
-                        cc2 = t;
-                    else if (c2 == t_b2)
-                        cc2 = u;
-
-                    int row = rr2 + (rr1 * B->d2_);
-                    int col = cc2 + (cc1 * B->d4_);
-
-                    temp2->A2d_[tu][rs] = B->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp2->sort(1000 * t_b1 + 100 * t_b2 + 10 * f_b1 + f_b2, B, 1.0, 0.0);
     // temp2->print();
     if (delete_b) B.reset();
 
@@ -5026,7 +4436,6 @@ void Tensor2d::cont444(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1 = 0, r2 = 0, c1 = 0, c2 = 0;
-    int rr1, rr2, cc1, cc2;
     int dim_t, dim_u;
     int t_a1 = 0, t_a2 = 0, f_a1 = 0, f_a2 = 0;
     int t_b1 = 0, t_b2 = 0, f_b1 = 0, f_b2 = 0;
@@ -5226,7 +4635,6 @@ void Tensor2d::cont343(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int t_b1, t_b2, f_b1, f_b2;
 
     // Expected order: C(Q,pq) = \sum_{rs} A(Q,rs) B(rs,pq)
@@ -5317,58 +4725,7 @@ void Tensor2d::cont343(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort B(..,..) to B(rs,pq)
     SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", A->d2_, A->d3_, d2_, d3_));
-#pragma omp parallel for
-    for (int r = 0; r < A->d2_; r++) {
-        for (int s = 0; s < A->d3_; s++) {
-            int rs = temp->row_idx_[r][s];
-            for (int p = 0; p < d2_; p++) {
-                for (int q = 0; q < d3_; q++) {
-                    int pq = temp->col_idx_[p][q];
-
-                    if (r1 == f_b1)
-                        rr1 = p;
-                    else if (r1 == f_b2)
-                        rr1 = q;
-                    else if (r1 == t_b1)
-                        rr1 = r;
-                    else if (r1 == t_b2)
-                        rr1 = s;
-
-                    if (r2 == f_b1)
-                        rr2 = p;
-                    else if (r2 == f_b2)
-                        rr2 = q;
-                    else if (r2 == t_b1)
-                        rr2 = r;
-                    else if (r2 == t_b2)
-                        rr2 = s;
-
-                    if (c1 == f_b1)
-                        cc1 = p;
-                    else if (c1 == f_b2)
-                        cc1 = q;
-                    else if (c1 == t_b1)
-                        cc1 = r;
-                    else if (c1 == t_b2)
-                        cc1 = s;
-
-                    if (c2 == f_b1)
-                        cc2 = p;
-                    else if (c2 == f_b2)
-                        cc2 = q;
-                    else if (c2 == t_b1)
-                        cc2 = r;
-                    else if (c2 == t_b2)
-                        cc2 = s;
-
-                    int row = rr2 + (rr1 * B->d2_);
-                    int col = cc2 + (cc1 * B->d4_);
-
-                    temp->A2d_[rs][pq] = B->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp->sort(1000 * t_b1 + 100 * t_b2 + 10 * f_b1 + f_b2, B, 1.0, 0.0);
     // temp->print();
     if (delete_b) B.reset();
 
@@ -5392,7 +4749,6 @@ void Tensor2d::cont442(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int dim_r, dim_s, dim_t;
     int t_a1, t_a2, t_a3, f_a1;
     int t_b1, t_b2, t_b3, f_b1;
@@ -5525,58 +4881,7 @@ void Tensor2d::cont442(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort A(..,..) to A(pr,st)
     SharedTensor2d temp1 = SharedTensor2d(new Tensor2d("temp1", dim1_, dim_r, dim_s, dim_t));
-#pragma omp parallel for
-    for (int p = 0; p < dim1_; p++) {
-        for (int r = 0; r < dim_r; r++) {
-            int pr = temp1->row_idx_[p][r];
-            for (int s = 0; s < dim_s; s++) {
-                for (int t = 0; t < dim_t; t++) {
-                    int st = temp1->col_idx_[s][t];
-
-                    if (r1 == f_a1)
-                        rr1 = p;
-                    else if (r1 == t_a1)
-                        rr1 = r;
-                    else if (r1 == t_a2)
-                        rr1 = s;
-                    else if (r1 == t_a3)
-                        rr1 = t;
-
-                    if (r2 == f_a1)
-                        rr2 = p;
-                    else if (r2 == t_a1)
-                        rr2 = r;
-                    else if (r2 == t_a2)
-                        rr2 = s;
-                    else if (r2 == t_a3)
-                        rr2 = t;
-
-                    if (c1 == f_a1)
-                        cc1 = p;
-                    else if (c1 == t_a1)
-                        cc1 = r;
-                    else if (c1 == t_a2)
-                        cc1 = s;
-                    else if (c1 == t_a3)
-                        cc1 = t;
-
-                    if (c2 == f_a1)
-                        cc2 = p;
-                    else if (c2 == t_a1)
-                        cc2 = r;
-                    else if (c2 == t_a2)
-                        cc2 = s;
-                    else if (c2 == t_a3)
-                        cc2 = t;
-
-                    int row = rr2 + (rr1 * A->d2_);
-                    int col = cc2 + (cc1 * A->d4_);
-
-                    temp1->A2d_[pr][st] = A->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp1->sort(1000 * f_a1 + 100 * t_a1 + 10 * t_a2 + t_a3, A, 1.0, 0.0);
     // temp1->print();
     if (delete_a) A.reset();
 
@@ -5623,58 +4928,7 @@ void Tensor2d::cont442(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort B(..,..) to B(rs,tq)
     SharedTensor2d temp2 = SharedTensor2d(new Tensor2d("temp2", dim_r, dim_s, dim_t, dim2_));
-#pragma omp parallel for
-    for (int r = 0; r < dim_r; r++) {
-        for (int s = 0; s < dim_s; s++) {
-            int rs = temp2->row_idx_[r][s];
-            for (int t = 0; t < dim_t; t++) {
-                for (int q = 0; q < dim2_; q++) {
-                    int tq = temp2->col_idx_[t][q];
-
-                    if (r1 == t_b1)
-                        rr1 = r;
-                    else if (r1 == t_b2)
-                        rr1 = s;
-                    else if (r1 == t_b3)
-                        rr1 = t;
-                    else if (r1 == f_b1)
-                        rr1 = q;
-
-                    if (r2 == t_b1)
-                        rr2 = r;
-                    else if (r2 == t_b2)
-                        rr2 = s;
-                    else if (r2 == t_b3)
-                        rr2 = t;
-                    else if (r2 == f_b1)
-                        rr2 = q;
-
-                    if (c1 == t_b1)
-                        cc1 = r;
-                    else if (c1 == t_b2)
-                        cc1 = s;
-                    else if (c1 == t_b3)
-                        cc1 = t;
-                    else if (c1 == f_b1)
-                        cc1 = q;
-
-                    if (c2 == t_b1)
-                        cc2 = r;
-                    else if (c2 == t_b2)
-                        cc2 = s;
-                    else if (c2 == t_b3)
-                        cc2 = t;
-                    else if (c2 == f_b1)
-                        cc2 = q;
-
-                    int row = rr2 + (rr1 * B->d2_);
-                    int col = cc2 + (cc1 * B->d4_);
-
-                    temp2->A2d_[rs][tq] = B->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp2->sort(1000 * t_b1 + 100 * t_b2 + 10 * t_b3 + f_b1, B, 1.0, 0.0);
     // temp2->print();
     if (delete_b) B.reset();
 
@@ -5699,7 +4953,6 @@ void Tensor2d::cont424(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int dim_t;
     int t_a1, f_a1, f_a2, f_a3;
     int t_b1, f_b1;
@@ -5804,58 +5057,7 @@ void Tensor2d::cont424(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort A(..,..) to A(pq,rt)
     SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", d1_, d2_, d3_, dim_t));
-#pragma omp parallel for
-    for (int p = 0; p < d1_; p++) {
-        for (int q = 0; q < d2_; q++) {
-            int pq = temp->row_idx_[p][q];
-            for (int r = 0; r < d3_; r++) {
-                for (int t = 0; t < dim_t; t++) {
-                    int rt = temp->col_idx_[r][t];
-
-                    if (r1 == f_a1)
-                        rr1 = p;
-                    else if (r1 == f_a2)
-                        rr1 = q;
-                    else if (r1 == f_a3)
-                        rr1 = r;
-                    else if (r1 == t_a1)
-                        rr1 = t;
-
-                    if (r2 == f_a1)
-                        rr2 = p;
-                    else if (r2 == f_a2)
-                        rr2 = q;
-                    else if (r2 == f_a3)
-                        rr2 = r;
-                    else if (r2 == t_a1)
-                        rr2 = t;
-
-                    if (c1 == f_a1)
-                        cc1 = p;
-                    else if (c1 == f_a2)
-                        cc1 = q;
-                    else if (c1 == f_a3)
-                        cc1 = r;
-                    else if (c1 == t_a1)
-                        cc1 = t;
-
-                    if (c2 == f_a1)
-                        cc2 = p;
-                    else if (c2 == f_a2)
-                        cc2 = q;
-                    else if (c2 == f_a3)
-                        cc2 = r;
-                    else if (c2 == t_a1)
-                        cc2 = t;
-
-                    int row = rr2 + (rr1 * A->d2_);
-                    int col = cc2 + (cc1 * A->d4_);
-
-                    temp->A2d_[pq][rt] = A->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp->sort(1000 * f_a1 + 100 * f_a2 + 10 * f_a3 + t_a1, A, 1.0, 0.0);
     if (delete_a) A.reset();
 
     ta = 'n';
@@ -5884,7 +5086,6 @@ void Tensor2d::cont244(std::string idx_c, std::string idx_a, std::string idx_b,
     int nca, ncb, ncc;
     int m, n, k;
     int r1, r2, c1, c2;
-    int rr1, rr2, cc1, cc2;
     int dim_t;
     int t_a1, f_a1;
     int t_b1, f_b1, f_b2, f_b3;
@@ -5987,58 +5188,7 @@ void Tensor2d::cont244(std::string idx_c, std::string idx_a, std::string idx_b,
 
     // Sort B(..,..) to B(tq,rs)
     SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", dim_t, d2_, d3_, d4_));
-#pragma omp parallel for
-    for (int t = 0; t < dim_t; t++) {
-        for (int q = 0; q < d2_; q++) {
-            int tq = temp->row_idx_[t][q];
-            for (int r = 0; r < d3_; r++) {
-                for (int s = 0; s < d4_; s++) {
-                    int rs = temp->col_idx_[r][s];
-
-                    if (r1 == t_b1)
-                        rr1 = t;
-                    else if (r1 == f_b1)
-                        rr1 = q;
-                    else if (r1 == f_b2)
-                        rr1 = r;
-                    else if (r1 == f_b3)
-                        rr1 = s;
-
-                    if (r2 == t_b1)
-                        rr2 = t;
-                    else if (r2 == f_b1)
-                        rr2 = q;
-                    else if (r2 == f_b2)
-                        rr2 = r;
-                    else if (r2 == f_b3)
-                        rr2 = s;
-
-                    if (c1 == t_b1)
-                        cc1 = t;
-                    else if (c1 == f_b1)
-                        cc1 = q;
-                    else if (c1 == f_b2)
-                        cc1 = r;
-                    else if (c1 == f_b3)
-                        cc1 = s;
-
-                    if (c2 == t_b1)
-                        cc2 = t;
-                    else if (c2 == f_b1)
-                        cc2 = q;
-                    else if (c2 == f_b2)
-                        cc2 = r;
-                    else if (c2 == f_b3)
-                        cc2 = s;
-
-                    int row = rr2 + (rr1 * B->d2_);
-                    int col = cc2 + (cc1 * B->d4_);
-
-                    temp->A2d_[tq][rs] = B->A2d_[row][col];
-                }
-            }
-        }
-    }
+    temp->sort(1000 * t_b1 + 100 * f_b1 + 10 * f_b2 + f_b3, B, 1.0, 0.0);
     if (delete_b) B.reset();
 
     if (t_a1 == 2)
@@ -6143,8 +5293,6 @@ void Tensor2d::cont323(std::string idx_c, std::string idx_a, std::string idx_b,
     int dim_r;
     int t_a1, f_a1;
     int t_b1, f_b1;
-    int r1, c1;
-    int rr1, cc1;
 
     // Expected order: C(Q,pq) = \sum_{r} A(Q,pr) B(r,q)
 
@@ -6170,43 +5318,9 @@ void Tensor2d::cont323(std::string idx_c, std::string idx_a, std::string idx_b,
         dim_r = B->dim1();
     }
 
-    // Figure out A
-    // r1
-    if (t_a1 == 1)
-        r1 = t_a1;
-    else if (f_a1 == 1)
-        r1 = f_a1;
-
-    // c1
-    if (t_a1 == 2)
-        c1 = t_a1;
-    else if (f_a1 == 2)
-        c1 = f_a1;
-
     // Sort A(Q,..) to A(Q,pr)
     SharedTensor2d temp = SharedTensor2d(new Tensor2d("temp", d1_, d2_, dim_r));
-#pragma omp parallel for
-    for (int Q = 0; Q < dim1_; Q++) {
-        for (int p = 0; p < d2_; p++) {
-            for (int r = 0; r < dim_r; r++) {
-                int pr = r + (p * dim_r);
-
-                if (r1 == f_a1)
-                    rr1 = p;
-                else if (r1 == t_a1)
-                    rr1 = r;
-
-                if (c1 == f_a1)
-                    cc1 = p;
-                else if (c1 == t_a1)
-                    cc1 = r;
-
-                int col = cc1 + (rr1 * A->d3_);
-
-                temp->A2d_[Q][pr] = A->A2d_[Q][col];
-            }
-        }
-    }
+    temp->sort3a(100 + 10 * (f_a1 + 1) + (t_a1 + 1), A->d1_, A->d2_, A->d3_, A, 1.0, 0.0);
     if (delete_a) A.reset();
 
     m = d1_ * d2_;
@@ -6237,8 +5351,6 @@ void Tensor2d::cont332(std::string idx_c, std::string idx_a, std::string idx_b,
     int dim_r;
     int t_a1, f_a1;
     int t_b1, f_b1;
-    int ra, ca, rb, cb;
-    int rra, cca, rrb, ccb;
 
     // Expected order: C(pq) = \sum_{Qr} A(Q,rp) B(Q,rq)
 
@@ -6264,82 +5376,14 @@ void Tensor2d::cont332(std::string idx_c, std::string idx_a, std::string idx_b,
         t_b1 = 1;
     }
 
-    // Figure out A
-    // ra
-    if (t_a1 == 1)
-        ra = t_a1;
-    else if (f_a1 == 1)
-        ra = f_a1;
-
-    // ca
-    if (t_a1 == 2)
-        ca = t_a1;
-    else if (f_a1 == 2)
-        ca = f_a1;
-
     // Sort A(Q,..) to A(Q,rp)
     SharedTensor2d temp1 = SharedTensor2d(new Tensor2d("temp1", A->d1_, dim_r, dim1_));
-#pragma omp parallel for
-    for (int Q = 0; Q < A->d1_; Q++) {
-        for (int r = 0; r < dim_r; r++) {
-            for (int p = 0; p < dim1_; p++) {
-                int rp = p + (r * dim1_);
-
-                if (ra == t_a1)
-                    rra = r;
-                else if (ra == f_a1)
-                    rra = p;
-
-                if (ca == t_a1)
-                    cca = r;
-                else if (ca == f_a1)
-                    cca = p;
-
-                int col = cca + (rra * A->d3_);
-
-                temp1->A2d_[Q][rp] = A->A2d_[Q][col];
-            }
-        }
-    }
+    temp1->sort3a(100 + 10 * (t_a1 + 1) + (f_a1 + 1), A->d1_, A->d2_, A->d3_, A, 1.0, 0.0);
     if (delete_a) A.reset();
 
-    // Figure out B
-    // rb
-    if (t_b1 == 1)
-        rb = t_b1;
-    else if (f_b1 == 1)
-        rb = f_b1;
-
-    // cb
-    if (t_b1 == 2)
-        cb = t_b1;
-    else if (f_b1 == 2)
-        cb = f_b1;
-
     // Sort B(Q,..) to B(Q,rq)
     SharedTensor2d temp2 = SharedTensor2d(new Tensor2d("temp2", B->d1_, dim_r, dim2_));
-#pragma omp parallel for
-    for (int Q = 0; Q < B->d1_; Q++) {
-        for (int r = 0; r < dim_r; r++) {
-            for (int q = 0; q < dim2_; q++) {
-                int rq = q + (r * dim2_);
-
-                if (rb == t_b1)
-                    rrb = r;
-                else if (rb == f_b1)
-                    rrb = q;
-
-                if (cb == t_b1)
-                    ccb = r;
-                else if (cb == f_b1)
-                    ccb = q;
-
-                int col = ccb + (rrb * B->d3_);
-
-                temp2->A2d_[Q][rq] = B->A2d_[Q][col];
-            }
-        }
-    }
+    temp2->sort3a(100 + 10 * (t_b1 + 1) + (f_b1 + 1), B->d1_, B->d2_, B->d3_, B, 1.0, 0.0);
     if (delete_b) B.reset();
 
     m = dim1_;
@@ -6818,5 +5862,88 @@ int Tensor3i::get(int h, int i, int j) { return A3i_[h][i][j]; }  //
 
 /********************************************************************************************/
 /********************************************************************************************/
+/********************************************************************************************/
+/************************** in-core entries *************************************************/
+/********************************************************************************************/
+bool TensorCoreStore::enabled_ = false;
+size_t TensorCoreStore::fileno_ = 0;
+size_t TensorCoreStore::max_bytes_ = 0;
+size_t TensorCoreStore::bytes_ = 0;
+std::map<std::string, std::vector<char>> TensorCoreStore::entries_;
+
+void TensorCoreStore::enable(size_t fileno, size_t max_doubles) {
+    disable();
+    enabled_ = true;
+    fileno_ = fileno;
+    max_bytes_ = max_doubles * sizeof(double);
+}
+
+void TensorCoreStore::disable() {
+    std::map<std::string, std::vector<char>>().swap(entries_);
+    enabled_ = false;
+    max_bytes_ = 0;
+    bytes_ = 0;
+}
+
+bool TensorCoreStore::write(psi::PSIO *psio, size_t fileno, const std::string &label, const char *buffer,
+                            size_t nbytes, size_t start) {
+    if (!enabled_ || fileno != fileno_) return false;
+
+    auto entry = entries_.find(label);
+    if (entry == entries_.end()) {
+        if (start + nbytes > max_bytes_ - bytes_) return false;
+
+        // Entries that are already on disk stay there
+        bool already_open = false;
+        if (psio->open_check(fileno))
+            already_open = true;
+        else
+            psio->open(fileno, PSIO_OPEN_OLD);
+        bool on_disk = (psio->tocscan(fileno, label.c_str()) != nullptr);
+        if (!already_open) psio->close(fileno, 1);  // Close and keep
+        if (on_disk) return false;
+
+        entry = entries_.emplace(label, std::vector<char>()).first;
+    }
+
+    std::vector<char> &data = entry->second;
+    if (start + nbytes > data.size()) {
+        size_t growth = start + nbytes - data.size();
+        if (growth > max_bytes_ - bytes_) {
+            // Out of budget: flush what is held so far, PSIO takes over the entry
+            if (!data.empty()) {
+                bool already_open = false;
+                if (psio->open_check(fileno))
+                    already_open = true;
+                else
+                    psio->open(fileno, PSIO_OPEN_OLD);
+                psio->write_entry(fileno, label.c_str(), data.data(), data.size());
+                if (!already_open) psio->close(fileno, 1);  // Close and keep
+            }
+            bytes_ -= data.size();
+            entries_.erase(entry);
+            return false;
+        }
+        data.resize(start + nbytes, 0);
+        bytes_ += growth;
+    }
+
+    ::memcpy(data.data() + start, buffer, nbytes);
+    return true;
+}
+
+bool TensorCoreStore::read(size_t fileno, const std::string &label, char *buffer, size_t nbytes, size_t start) {
+    if (!enabled_ || fileno != fileno_) return false;
+
+    auto entry = entries_.find(label);
+    if (entry == entries_.end()) return false;
+
+    if (start + nbytes > entry->second.size())
+        throw PSIEXCEPTION("DFOCC: read beyond the end of in-core entry " + label);
+
+    ::memcpy(buffer, entry->second.data() + start, nbytes);
+    return true;
+}
+
 }  // namespace dfoccwave
 }  // namespace psi
@@ -29,6 +29,10 @@
 #ifndef _dfocc_tensors_h_
 #define _dfocc_tensors_h_
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/typedefs.h"
 
@@ -50,6 +54,7 @@ class Tensor1d;
 class Tensor2d;
 class Tensor3d;
 class Tensor1i;
+class DFOCC;
 class Tensor2i;
 class Tensor3i;
 
@@ -337,7 +342,7 @@ class Tensor2d {
     void myread(int fileno, size_t start);
 
     // sort (for example 1432 sort): A2d_(ps,rq) = A(pq,rs)
-    // A2d_ = alpha*A + beta*A2d_
+    // A2d_ = alpha*A + beta*A2d_; any permutation of 1234 is accepted, A2d_ is not read if beta = 0
     void sort(int sort_type, const SharedTensor2d &A, double alpha, double beta);
     // A2d_[p][qr] = sort(A[p][qr])
     void sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta);
@@ -510,6 +515,7 @@ class Tensor2d {
     friend class Tensor3d;
     friend class Tensor1i;
     friend class Tensor2i;
+    friend class DFOCC;
 };
 
 class Tensor3d {
@@ -626,6 +632,46 @@ class Tensor3i {
     void set(int h, int i, int j, int value);
     int get(int h, int i, int j);
 };
+
+/*
+ * In-core copies of the entries of one PSIO file (DF_INTS_IN_CORE).
+ * Every Tensor2d read and write of that file goes through the store first.
+ * An entry keeps the layout of its disk copy (packed triangles, offsets of
+ * the address variants), so callers cannot tell the difference.  New entries
+ * stay in core while they fit in the budget; an entry that outgrows it is
+ * flushed to disk and handled by PSIO from then on.
+ */
+class TensorCoreStore {
+   private:
+    static bool enabled_;
+    static size_t fileno_;
+    static size_t max_bytes_;
+    static size_t bytes_;
+    static std::map<std::string, std::vector<char>> entries_;
+
+   public:
+    static void enable(size_t fileno, size_t max_doubles);
+    static void disable();
+    static bool enabled() { return enabled_; }
+    /// Bytes held in core
+    static size_t size() { return bytes_; }
+    /// Bytes the store may grow to
+    static size_t capacity() { return max_bytes_; }
+
+    /// Copy nbytes to the entry at byte offset start; false if the caller must write to disk
+    static bool write(psi::PSIO *psio, size_t fileno, const std::string &label, const char *buffer, size_t nbytes,
+                      size_t start);
+    /// Copy nbytes from the entry at byte offset start; false if the entry is not held in core
+    static bool read(size_t fileno, const std::string &label, char *buffer, size_t nbytes, size_t start);
+};
+
+/*
+ * Time Tensor2d::sort, sort3a and sort3b for the permutations the CC codes use most,
+ * next to an element-by-element reference loop, for nocc occupied, nvir virtual and
+ * naux auxiliary functions; each is run at least min_time [s].
+ * Returns {operation: {time, flops, bytes}}.
+ */
+std::map<std::string, std::map<std::string, double>> benchmark_sort(int nocc, int nvir, int naux, double min_time);
 }  // namespace dfoccwave
 }  // namespace psi
 #endif  // _dfocc_tensors_h_
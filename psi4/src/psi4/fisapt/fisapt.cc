@@ -35,6 +35,9 @@
 #ifdef _OPENMP
 #include <omp.h>
 #endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 #include "psi4/psi4-dec.h"
 #include "psi4/physconst.h"
@@ -3772,27 +3775,61 @@ void FISAPT::find() {
     double** RaCp = matrices_["Vlocc0A"]->pointer();
     double** RbDp = matrices_["Vlocc0B"]->pointer();
 
-    auto TsQ = std::make_shared<Matrix>("TsQ", ns, nQ);
-    auto T1As = std::make_shared<Matrix>("T1As", na, ns);
-    double** TsQp = TsQ->pointer();
-    double** T1Asp = T1As->pointer();
-    for (size_t b = 0; b < nb; b++) {
-        dfh_->fill_tensor("Abs", TsQ, {b, b + 1});
-        C_DGEMM('N', 'T', na, ns, nQ, 2.0, RaCp[0], nQ, TsQp[0], nQ, 0.0, T1Asp[0], ns);
-        for (size_t a = 0; a < na; a++) {
-            dfh_->write_disk_tensor("WAbs", T1Asp[a], {nA + a, nA + a + 1}, {b, b + 1});
+    // => Blocking ... how many occupied orbitals (and ESP sources) to handle at a time <= //
+
+    long int overhead = 0L;
+    overhead += 12L * nn * nn;                                      // S, D, V, J, K matrices for A and B
+    overhead += 6L * na * nr + 6L * nb * ns;                        // amplitudes, ESPs, and exchange potentials
+    overhead += 2L * nT * (na * (long int)nr + nb * (long int)ns);  // per-thread amplitudes in the source loops
+    overhead += 10L * (nA + na + 1) * (nB + nb + 1);                // induction terms
+    long int rem = doubles_ - overhead;
+    if (rem < 0L) {
+        throw PSIEXCEPTION("Too little static memory for FISAPT::find");
+    }
+
+    // (s|Q) slices and the resulting ESPs for a block of b, and the mirror image for a block of a
+    long int cost_b = ns * (long int)nQ + na * (long int)ns;
+    long int cost_a = nr * (long int)nQ + nb * (long int)nr;
+    int max_b = (int)std::min<long int>(nb, std::max(1L, rem / cost_b));
+    int max_a = (int)std::min<long int>(na, std::max(1L, rem / cost_a));
+
+    // ESPs of a block of sources
+    long int max_B_l = rem / std::max(1L, std::max(na * (long int)nr, nb * (long int)ns));
+    int max_B = (int)std::max(1L, std::min<long int>(max_B_l, std::max(nA + na + 1, nB + nb + 1)));
+
+    outfile->Printf("    %ld doubles - %ld overhead leaves %ld for induction\n", doubles_, overhead, rem);
+    outfile->Printf("    Occupied orbitals of A (B) processed in blocks of %d (%d)\n", max_a, max_b);
+    outfile->Printf("    ESP sources processed in blocks of %d\n\n", max_B);
+
+    {
+        auto TsQ = std::make_shared<Matrix>("TsQ", max_b * ns, nQ);
+        auto T1As = std::make_shared<Matrix>("T1As", na, max_b * ns);
+        double** TsQp = TsQ->pointer();
+        double** T1Asp = T1As->pointer();
+        for (size_t bstart = 0; bstart < nb; bstart += max_b) {
+            size_t nbblock = (bstart + max_b >= nb ? nb - bstart : max_b);
+            dfh_->fill_tensor("Abs", TsQ, {bstart, bstart + nbblock});
+            C_DGEMM('N', 'T', na, nbblock * ns, nQ, 2.0, RaCp[0], nQ, TsQp[0], nQ, 0.0, T1Asp[0], nbblock * ns);
+            for (size_t a = 0; a < na; a++) {
+                dfh_->write_disk_tensor("WAbs", T1Asp[0] + a * nbblock * ns, {nA + a, nA + a + 1},
+                                        {bstart, bstart + nbblock});
+            }
         }
     }
 
-    auto TrQ = std::make_shared<Matrix>("TrQ", nr, nQ);
-    auto T1Br = std::make_shared<Matrix>("T1Br", nb, nr);
-    double** TrQp = TrQ->pointer();
-    double** T1Brp = T1Br->pointer();
-    for (size_t a = 0; a < na; a++) {
-        dfh_->fill_tensor("Aar", TrQ, {a, a + 1});
-        C_DGEMM('N', 'T', nb, nr, nQ, 2.0, RbDp[0], nQ, TrQp[0], nQ, 0.0, T1Brp[0], nr);
-        for (size_t b = 0; b < nb; b++) {
-            dfh_->write_disk_tensor("WBar", T1Brp[b], {nB + b, nB + b + 1}, {a, a + 1});
+    {
+        auto TrQ = std::make_shared<Matrix>("TrQ", max_a * nr, nQ);
+        auto T1Br = std::make_shared<Matrix>("T1Br", nb, max_a * nr);
+        double** TrQp = TrQ->pointer();
+        double** T1Brp = T1Br->pointer();
+        for (size_t astart = 0; astart < na; astart += max_a) {
+            size_t nablock = (astart + max_a >= na ? na - astart : max_a);
+            dfh_->fill_tensor("Aar", TrQ, {astart, astart + nablock});
+            C_DGEMM('N', 'T', nb, nablock * nr, nQ, 2.0, RbDp[0], nQ, TrQp[0], nQ, 0.0, T1Brp[0], nablock * nr);
+            for (size_t b = 0; b < nb; b++) {
+                dfh_->write_disk_tensor("WBar", T1Brp[0] + b * nablock * nr, {nB + b, nB + b + 1},
+                                        {astart, astart + nablock});
+            }
         }
     }
 
@@ -3821,13 +3858,9 @@ void FISAPT::find() {
 
     auto xA = std::make_shared<Matrix>("xA", na, nr);
     auto xB = std::make_shared<Matrix>("xB", nb, ns);
-    double** xAp = xA->pointer();
-    double** xBp = xB->pointer();
 
     auto wB = std::make_shared<Matrix>("wB", na, nr);
     auto wA = std::make_shared<Matrix>("wA", nb, ns);
-    double** wBp = wB->pointer();
-    double** wAp = wA->pointer();
 
     // ==> Generalized ESP (Flat and Exchange) <== //
 
@@ -3904,7 +3937,8 @@ void FISAPT::find() {
     int snb = 0;
     int snA = 0;
 
-    if (options_.get_bool("SSAPT0_SCALE")) {
+    bool do_sscale = options_.get_bool("SSAPT0_SCALE");
+    if (do_sscale) {
         sna = na;
         snB = nB;
         snb = nb;
@@ -3951,40 +3985,72 @@ void FISAPT::find() {
         dfh_->write_disk_tensor("WBar", Var, {(size_t) nB + nb, (size_t) nB + nb + 1});
     }
 
-    for (size_t B = 0; B < nB + nb + 1; B++) { // add one for external potential
-        // ESP
-        dfh_->fill_tensor("WBar", wB, {B, B + 1});
+    // The source loops are threaded explicitly, so keep the BLAS calls inside them serial
+#ifdef USING_LAPACK_MKL
+    int old_threads = mkl_get_max_threads();
+    mkl_set_num_threads(1);
+#endif
 
-        // Uncoupled amplitude
-        for (int a = 0; a < na; a++) {
-            for (int r = 0; r < nr; r++) {
-                xAp[a][r] = wBp[a][r] / (eap[a] - erp[r]);
-            }
-        }
+    std::vector<std::shared_ptr<Matrix> > xT;
+    std::vector<std::shared_ptr<Matrix> > x2T;
+    for (int t = 0; t < nT; t++) {
+        xT.push_back(std::make_shared<Matrix>("xA", na, nr));
+        x2T.push_back(std::make_shared<Matrix>("x2A", na, nr));
+    }
+    double** Uocc_Ap = Uocc_A->pointer();
+
+    auto WBar = std::make_shared<Matrix>("WBar", max_B, na * (size_t)nr);
+    double** WBarp = WBar->pointer();
 
-        // Backtransform the amplitude to LO
-        std::shared_ptr<Matrix> x2A = linalg::doublet(Uocc_A, xA, true, false);
-        double** x2Ap = x2A->pointer();
+    size_t nBsource = nB + nb + 1;  // add one for external potential
+    for (size_t Bstart = 0; Bstart < nBsource; Bstart += max_B) {
+        size_t nBblock = (Bstart + max_B >= nBsource ? nBsource - Bstart : max_B);
 
-        // Zip up the Ind20 contributions
-        for (int a = 0; a < na; a++) {
-            double Jval = 2.0 * C_DDOT(nr, x2Ap[a], 1, wBTp[a], 1);
-            double Kval = 2.0 * C_DDOT(nr, x2Ap[a], 1, uBTp[a], 1);
-            Ind20u_AB_termsp[a][B] = Jval;
-            Ind20u_AB += Jval;
-            ExchInd20u_AB_termsp[a][B] = Kval;
-            ExchInd20u_AB += Kval;
-            if (options_.get_bool("SSAPT0_SCALE")) {
-                sExchInd20u_AB_termsp[a][B] = Kval;
-                sExchInd20u_AB += Kval;
-                sIndu_AB_termsp[a][B] = Jval + Kval;
-                sIndu_AB += Jval + Kval;
+        // ESPs
+        dfh_->fill_tensor("WBar", WBar, {Bstart, Bstart + nBblock});
+
+#pragma omp parallel for schedule(dynamic) num_threads(nT) \
+    reduction(+ : Ind20u_AB, ExchInd20u_AB, sExchInd20u_AB, sIndu_AB, Indu_AB)
+        for (size_t B = Bstart; B < Bstart + nBblock; B++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            double** xATp = xT[thread]->pointer();
+            double** x2Ap = x2T[thread]->pointer();
+            double* wBBp = WBarp[B - Bstart];
+
+            // Uncoupled amplitude
+            for (int a = 0; a < na; a++) {
+                for (int r = 0; r < nr; r++) {
+                    xATp[a][r] = wBBp[a * (size_t)nr + r] / (eap[a] - erp[r]);
+                }
             }
 
-            Indu_AB_termsp[a][B] = Jval + Kval;
-            Indu_AB += Jval + Kval;
+            // Backtransform the amplitude to LO
+            C_DGEMM('T', 'N', na, nr, na, 1.0, Uocc_Ap[0], na, xATp[0], nr, 0.0, x2Ap[0], nr);
+
+            // Zip up the Ind20 contributions
+            for (int a = 0; a < na; a++) {
+                double Jval = 2.0 * C_DDOT(nr, x2Ap[a], 1, wBTp[a], 1);
+                double Kval = 2.0 * C_DDOT(nr, x2Ap[a], 1, uBTp[a], 1);
+                Ind20u_AB_termsp[a][B] = Jval;
+                Ind20u_AB += Jval;
+                ExchInd20u_AB_termsp[a][B] = Kval;
+                ExchInd20u_AB += Kval;
+                if (do_sscale) {
+                    sExchInd20u_AB_termsp[a][B] = Kval;
+                    sExchInd20u_AB += Kval;
+                    sIndu_AB_termsp[a][B] = Jval + Kval;
+                    sIndu_AB += Jval + Kval;
+                }
+
+                Indu_AB_termsp[a][B] = Jval + Kval;
+                Indu_AB += Jval + Kval;
+            }
         }
     }
+    WBar.reset();
 
     // ==> B <- A Uncoupled <== //
 
@@ -4001,39 +4067,74 @@ void FISAPT::find() {
     }
 
 
-    for (size_t A = 0; A < nA + na + 1; A++) { // add one for extenral potential
-        // ESP
-        dfh_->fill_tensor("WAbs", wA, {A, A + 1});
+    xT.clear();
+    x2T.clear();
+    for (int t = 0; t < nT; t++) {
+        xT.push_back(std::make_shared<Matrix>("xB", nb, ns));
+        x2T.push_back(std::make_shared<Matrix>("x2B", nb, ns));
+    }
+    double** Uocc_Bp = Uocc_B->pointer();
 
-        // Uncoupled amplitude
-        for (int b = 0; b < nb; b++) {
-            for (int s = 0; s < ns; s++) {
-                xBp[b][s] = wAp[b][s] / (ebp[b] - esp[s]);
+    auto WAbs = std::make_shared<Matrix>("WAbs", max_B, nb * (size_t)ns);
+    double** WAbsp = WAbs->pointer();
+
+    size_t nAsource = nA + na + 1;  // add one for external potential
+    for (size_t Astart = 0; Astart < nAsource; Astart += max_B) {
+        size_t nAblock = (Astart + max_B >= nAsource ? nAsource - Astart : max_B);
+
+        // ESPs
+        dfh_->fill_tensor("WAbs", WAbs, {Astart, Astart + nAblock});
+
+#pragma omp parallel for schedule(dynamic) num_threads(nT) \
+    reduction(+ : Ind20u_BA, ExchInd20u_BA, sExchInd20u_BA, sIndu_BA, Indu_BA)
+        for (size_t A = Astart; A < Astart + nAblock; A++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            double** xBTp = xT[thread]->pointer();
+            double** x2Bp = x2T[thread]->pointer();
+            double* wAAp = WAbsp[A - Astart];
+
+            // Uncoupled amplitude
+            for (int b = 0; b < nb; b++) {
+                for (int s = 0; s < ns; s++) {
+                    xBTp[b][s] = wAAp[b * (size_t)ns + s] / (ebp[b] - esp[s]);
+                }
             }
-        }
 
-        // Backtransform the amplitude to LO
-        std::shared_ptr<Matrix> x2B = linalg::doublet(Uocc_B, xB, true, false);
-        double** x2Bp = x2B->pointer();
+            // Backtransform the amplitude to LO
+            C_DGEMM('T', 'N', nb, ns, nb, 1.0, Uocc_Bp[0], nb, xBTp[0], ns, 0.0, x2Bp[0], ns);
 
-        // Zip up the Ind20 contributions
-        for (int b = 0; b < nb; b++) {
-            double Jval = 2.0 * C_DDOT(ns, x2Bp[b], 1, wATp[b], 1);
-            double Kval = 2.0 * C_DDOT(ns, x2Bp[b], 1, uATp[b], 1);
-            Ind20u_BA_termsp[A][b] = Jval;
-            Ind20u_BA += Jval;
-            ExchInd20u_BA_termsp[A][b] = Kval;
-            ExchInd20u_BA += Kval;
-            if (options_.get_bool("SSAPT0_SCALE")) {
-                sExchInd20u_BA_termsp[A][b] = Kval;
-                sExchInd20u_BA += Kval;
-                sIndu_BA_termsp[A][b] = Jval + Kval;
-                sIndu_BA += Jval + Kval;
+            // Zip up the Ind20 contributions
+            for (int b = 0; b < nb; b++) {
+                double Jval = 2.0 * C_DDOT(ns, x2Bp[b], 1, wATp[b], 1);
+                double Kval = 2.0 * C_DDOT(ns, x2Bp[b], 1, uATp[b], 1);
+                Ind20u_BA_termsp[A][b] = Jval;
+                Ind20u_BA += Jval;
+                ExchInd20u_BA_termsp[A][b] = Kval;
+                ExchInd20u_BA += Kval;
+                if (do_sscale) {
+                    sExchInd20u_BA_termsp[A][b] = Kval;
+                    sExchInd20u_BA += Kval;
+                    sIndu_BA_termsp[A][b] = Jval + Kval;
+                    sIndu_BA += Jval + Kval;
+                }
+                Indu_BA_termsp[A][b] = Jval + Kval;
+                Indu_BA += Jval + Kval;
             }
-            Indu_BA_termsp[A][b] = Jval + Kval;
-            Indu_BA += Jval + Kval;
         }
     }
+    WAbs.reset();
+    xT.clear();
+    x2T.clear();
+
+    // The coupled loop below hands wA to CPHF as is; keep it holding the last ESP, as the serial loop left it
+    dfh_->fill_tensor("WAbs", wA, {nAsource - 1, nAsource});
+
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(old_threads);
+#endif
 
     double Ind20u = Ind20u_AB + Ind20u_BA;
     outfile->Printf("    Ind20,u (A<-B)      = %18.12lf [Eh]\n", Ind20u_AB);
@@ -4611,6 +4712,15 @@ void FISAPT::fdisp() {
         throw PSIEXCEPTION("Too little static memory for DFTSAPT::mp2_terms");
     }
 
+    // Each task handles one r against a tile of s values, so the (ab|Q) contractions run as a few wide
+    // GEMMs instead of one narrow GEMM per (r,s) pair.  The tile work arrays (VTab, W1ab, W2ab below) get
+    // at most a quarter of the remaining memory.
+    long int cost_tile = 3L * nT * na * nb;
+    long int max_tile_l = rem / (4L * cost_tile);
+    int max_tile = (max_tile_l > 16L ? 16 : (int)max_tile_l);
+    max_tile = std::max(1, std::min(max_tile, ns));
+    rem -= max_tile * cost_tile;
+
     // cost_r is how much mem for Aar, Bbr, Cbr, Dar for a single r
     // cost_s would be the same value, and is the mem requirement for Abs, Bas, Cas, and Dbs for single s
     long int cost_r = 2L * na * nQ + 2L * nb * nQ; 
@@ -4627,7 +4737,8 @@ void FISAPT::fdisp() {
     if (ns % max_s) nsblocks++;
     outfile->Printf("    Processing a single (r,s) pair requires %ld doubles\n", cost_r * 2L);
     outfile->Printf("    %d values of r processed in %d blocks of %d\n", nr, nrblocks, max_r);
-    outfile->Printf("    %d values of s processed in %d blocks of %d\n\n", ns, nsblocks, max_s);
+    outfile->Printf("    %d values of s processed in %d blocks of %d\n", ns, nsblocks, max_s);
+    outfile->Printf("    Each thread task contracts one r against %d values of s\n\n", max_tile);
 
     // => Tensor Slices <= //
 
@@ -4647,12 +4758,18 @@ void FISAPT::fdisp() {
     std::vector<std::shared_ptr<Matrix> > T2ab;
     std::vector<std::shared_ptr<Matrix> > V2ab;
     std::vector<std::shared_ptr<Matrix> > Iab;
+    std::vector<std::shared_ptr<Matrix> > VTab;
+    std::vector<std::shared_ptr<Matrix> > W1ab;
+    std::vector<std::shared_ptr<Matrix> > W2ab;
     for (int t = 0; t < nT; t++) {
         Tab.push_back(std::make_shared<Matrix>("Tab", na, nb));
         Vab.push_back(std::make_shared<Matrix>("Vab", na, nb));
         T2ab.push_back(std::make_shared<Matrix>("T2ab", na, nb));
         V2ab.push_back(std::make_shared<Matrix>("V2ab", na, nb));
         Iab.push_back(std::make_shared<Matrix>("Iab", na, nb));
+        VTab.push_back(std::make_shared<Matrix>("VTab", na, max_tile * nb));
+        W1ab.push_back(std::make_shared<Matrix>("W1ab", na, max_tile * nb));
+        W2ab.push_back(std::make_shared<Matrix>("W2ab", max_tile * na, nb));
     }
 
     // => Pointers <= //
@@ -4693,8 +4810,10 @@ void FISAPT::fdisp() {
 
         double* D2p = Darp[0];
         double* A2p = Aarp[0];
-        for (long int arQ = 0L; arQ < nrblock * naQ; arQ++) {
-            (*D2p++) += (*A2p++);
+        long int narQ = nrblock * naQ;
+#pragma omp parallel for schedule(static) num_threads(nT)
+        for (long int arQ = 0L; arQ < narQ; arQ++) {
+            D2p[arQ] += A2p[arQ];
         }
         dfh->write_disk_tensor("Far", Dar, {rstart, rstart + nrblock});
     }
@@ -4709,8 +4828,10 @@ void FISAPT::fdisp() {
 
         double* D2p = Dbsp[0];
         double* A2p = Absp[0];
-        for (long int bsQ = 0L; bsQ < nsblock * nbQ; bsQ++) {
-            (*D2p++) += (*A2p++);
+        long int nbsQ = nsblock * nbQ;
+#pragma omp parallel for schedule(static) num_threads(nT)
+        for (long int bsQ = 0L; bsQ < nbsQ; bsQ++) {
+            D2p[bsQ] += A2p[bsQ];
         }
         dfh->write_disk_tensor("Fbs", Dbs, {sstart, sstart + nsblock});
     }
@@ -4739,11 +4860,18 @@ void FISAPT::fdisp() {
 
     // ==> Master Loop <== //
 
+    bool do_sscale = options_.get_bool("SSAPT0_SCALE");
     double scale = 1.0;
-    if (options_.get_bool("SSAPT0_SCALE")) {
+    if (do_sscale) {
         scale = sSAPT0_scale_;
     }
 
+// The tasks below are threaded explicitly, so keep the BLAS calls inside them serial
+#ifdef USING_LAPACK_MKL
+    int old_threads = mkl_get_max_threads();
+    mkl_set_num_threads(1);
+#endif
+
     for (size_t rstart = 0; rstart < nr; rstart += max_r) {
         size_t nrblock = (rstart + max_r >= nr ? nr - rstart : max_r);
 
@@ -4760,12 +4888,14 @@ void FISAPT::fdisp() {
             dfh->fill_tensor("Bas", Bas, {sstart, sstart + nsblock});
             dfh->fill_tensor("Cas", Cas, {sstart, sstart + nsblock});
 
-            long int nrs = nrblock * nsblock;
+            long int ntiles = (nsblock + max_tile - 1) / max_tile;
+            long int ntasks = nrblock * ntiles;
 
-#pragma omp parallel for schedule(dynamic) reduction(+ : Disp20, ExchDisp20, sExchDisp20)
-            for (long int rs = 0L; rs < nrs; rs++) {
-                int r = rs / nsblock;
-                int s = rs % nsblock;
+#pragma omp parallel for schedule(dynamic) num_threads(nT) reduction(+ : Disp20, ExchDisp20, sExchDisp20)
+            for (long int task = 0L; task < ntasks; task++) {
+                int r = task / ntiles;
+                int s0 = (task % ntiles) * max_tile;
+                int nt = std::min(max_tile, (int)nsblock - s0);
 
                 int thread = 0;
 #ifdef _OPENMP
@@ -4781,60 +4911,85 @@ void FISAPT::fdisp() {
                 double** T2abp = T2ab[thread]->pointer();
                 double** V2abp = V2ab[thread]->pointer();
                 double** Iabp = Iab[thread]->pointer();
+                double** VTabp = VTab[thread]->pointer();
+                double** W1abp = W1ab[thread]->pointer();
+                double** W2abp = W2ab[thread]->pointer();
 
-                // => Amplitudes, Disp20 <= //
+                // => DF contractions for the whole (r, s-tile) at once <= //
 
-                C_DGEMM('N', 'T', na, nb, nQ, 1.0, Aarp[(r)*na], nQ, Absp[(s)*nb], nQ, 0.0, Vabp[0], nb);
-                for (int a = 0; a < na; a++) {
-                    for (int b = 0; b < nb; b++) {
-                        Tabp[a][b] = Vabp[a][b] / (eap[a] + ebp[b] - erp[r + rstart] - esp[s + sstart]);
+                // (ar|bs) in a x (s,b) order
+                C_DGEMM('N', 'T', na, nt * nb, nQ, 1.0, Aarp[(r)*na], nQ, Absp[(s0)*nb], nQ, 0.0, VTabp[0], nt * nb);
+
+                // Exch-Disp20 Q1-Q3 terms, split by the layout the DGEMMs produce: a x (s,b) and (s,a) x b
+                C_DGEMM('N', 'T', na, nt * nb, nQ, 1.0, Aarp[(r)*na], nQ, Dbsp[(s0)*nb], nQ, 0.0, W1abp[0], nt * nb);
+                C_DGEMM('N', 'T', na, nt * nb, nQ, 1.0, Darp[(r)*na], nQ, Absp[(s0)*nb], nQ, 1.0, W1abp[0], nt * nb);
+                C_DGEMM('N', 'T', nt * na, nb, nQ, 1.0, Basp[(s0)*na], nQ, Bbrp[(r)*nb], nQ, 0.0, W2abp[0], nb);
+                C_DGEMM('N', 'T', nt * na, nb, nQ, 1.0, Casp[(s0)*na], nQ, Cbrp[(r)*nb], nQ, 1.0, W2abp[0], nb);
+
+                for (int k = 0; k < nt; k++) {
+                    int s = s0 + k;
+
+                    // => Amplitudes, Disp20 <= //
+
+                    double* Vrsp = &VTabp[0][k * nb];
+                    for (int a = 0; a < na; a++) {
+                        for (int b = 0; b < nb; b++) {
+                            Tabp[a][b] = Vrsp[a * (size_t)nt * nb + b] /
+                                         (eap[a] + ebp[b] - erp[r + rstart] - esp[s + sstart]);
+                        }
                     }
-                }
 
-                C_DGEMM('N', 'N', na, nb, nb, 1.0, Tabp[0], nb, UBp[0], nb, 0.0, Iabp[0], nb);
-                C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, T2abp[0], nb);
-                C_DGEMM('N', 'N', na, nb, nb, 1.0, Vabp[0], nb, UBp[0], nb, 0.0, Iabp[0], nb);
-                C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, V2abp[0], nb);
+                    C_DGEMM('N', 'N', na, nb, nb, 1.0, Tabp[0], nb, UBp[0], nb, 0.0, Iabp[0], nb);
+                    C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, T2abp[0], nb);
+                    C_DGEMM('N', 'N', na, nb, nb, 1.0, Vrsp, nt * nb, UBp[0], nb, 0.0, Iabp[0], nb);
+                    C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, V2abp[0], nb);
 
-                for (int a = 0; a < na; a++) {
-                    for (int b = 0; b < nb; b++) {
-                        E_disp20Tp[a][b] += 4.0 * T2abp[a][b] * V2abp[a][b];
-                        Disp20 += 4.0 * T2abp[a][b] * V2abp[a][b];
+                    for (int a = 0; a < na; a++) {
+                        for (int b = 0; b < nb; b++) {
+                            E_disp20Tp[a][b] += 4.0 * T2abp[a][b] * V2abp[a][b];
+                            Disp20 += 4.0 * T2abp[a][b] * V2abp[a][b];
+                        }
                     }
-                }
 
-                // => Exch-Disp20 <= //
+                    // => Exch-Disp20 <= //
 
-                // > Q1-Q3 < //
+                    // > Q1-Q3 < //
 
-                C_DGEMM('N', 'T', na, nb, nQ, 1.0, Basp[(s)*na], nQ, Bbrp[(r)*nb], nQ, 0.0, Vabp[0], nb);
-                C_DGEMM('N', 'T', na, nb, nQ, 1.0, Casp[(s)*na], nQ, Cbrp[(r)*nb], nQ, 1.0, Vabp[0], nb);
-                C_DGEMM('N', 'T', na, nb, nQ, 1.0, Aarp[(r)*na], nQ, Dbsp[(s)*nb], nQ, 1.0, Vabp[0], nb);
-                C_DGEMM('N', 'T', na, nb, nQ, 1.0, Darp[(r)*na], nQ, Absp[(s)*nb], nQ, 1.0, Vabp[0], nb);
+                    double* W1rsp = &W1abp[0][k * nb];
+                    double** W2rsp = &W2abp[k * na];
+                    for (int a = 0; a < na; a++) {
+                        for (int b = 0; b < nb; b++) {
+                            Vabp[a][b] = W2rsp[a][b] + W1rsp[a * (size_t)nt * nb + b];
+                        }
+                    }
 
-                // > V,J,K < //
+                    // > V,J,K < //
 
-                C_DGER(na, nb, 1.0, &Sasp[0][s + sstart], ns, &Qbrp[0][r + rstart], nr, Vabp[0], nb);
-                C_DGER(na, nb, 1.0, &Qasp[0][s + sstart], ns, &Sbrp[0][r + rstart], nr, Vabp[0], nb);
-                C_DGER(na, nb, 1.0, &Qarp[0][r + rstart], nr, &SAbsp[0][s + sstart], ns, Vabp[0], nb);
-                C_DGER(na, nb, 1.0, &SBarp[0][r + rstart], nr, &Qbsp[0][s + sstart], ns, Vabp[0], nb);
+                    C_DGER(na, nb, 1.0, &Sasp[0][s + sstart], ns, &Qbrp[0][r + rstart], nr, Vabp[0], nb);
+                    C_DGER(na, nb, 1.0, &Qasp[0][s + sstart], ns, &Sbrp[0][r + rstart], nr, Vabp[0], nb);
+                    C_DGER(na, nb, 1.0, &Qarp[0][r + rstart], nr, &SAbsp[0][s + sstart], ns, Vabp[0], nb);
+                    C_DGER(na, nb, 1.0, &SBarp[0][r + rstart], nr, &Qbsp[0][s + sstart], ns, Vabp[0], nb);
 
-                C_DGEMM('N', 'N', na, nb, nb, 1.0, Vabp[0], nb, UBp[0], nb, 0.0, Iabp[0], nb);
-                C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, V2abp[0], nb);
+                    C_DGEMM('N', 'N', na, nb, nb, 1.0, Vabp[0], nb, UBp[0], nb, 0.0, Iabp[0], nb);
+                    C_DGEMM('T', 'N', na, nb, na, 1.0, UAp[0], na, Iabp[0], nb, 0.0, V2abp[0], nb);
 
-                for (int a = 0; a < na; a++) {
-                    for (int b = 0; b < nb; b++) {
-                        E_exch_disp20Tp[a][b] -= 2.0 * T2abp[a][b] * V2abp[a][b];
-                        if (options_.get_bool("SSAPT0_SCALE"))
-                            sE_exch_disp20Tp[a][b] -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
-                        ExchDisp20 -= 2.0 * T2abp[a][b] * V2abp[a][b];
-                        sExchDisp20 -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
+                    for (int a = 0; a < na; a++) {
+                        for (int b = 0; b < nb; b++) {
+                            E_exch_disp20Tp[a][b] -= 2.0 * T2abp[a][b] * V2abp[a][b];
+                            if (do_sscale) sE_exch_disp20Tp[a][b] -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
+                            ExchDisp20 -= 2.0 * T2abp[a][b] * V2abp[a][b];
+                            sExchDisp20 -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
+                        }
                     }
                 }
             }
         }
     }
 
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(old_threads);
+#endif
+
     auto E_disp20 = std::make_shared<Matrix>("E_disp20", na, nb);
     auto E_exch_disp20 = std::make_shared<Matrix>("E_exch_disp20", na, nb);
     double** E_disp20p = E_disp20->pointer();
@@ -32,8 +32,11 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
 #include "psi4/libqt/qt.h"
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <map>
+#include <utility>
 #include <vector>
 #include "cholesky.h"
 #include "psi4/psifiles.h"
@@ -44,14 +47,20 @@ PRAGMA_WARNING_POP
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/process.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 namespace psi {
 
-Cholesky::Cholesky(double delta, size_t memory) : delta_(delta), memory_(memory), Q_(0) {}
+Cholesky::Cholesky(double delta, size_t memory) : delta_(delta), memory_(memory), Q_(0), block_size_(64) {}
 Cholesky::~Cholesky() {}
+void Cholesky::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets) {
+    for (size_t k = 0; k < rows.size(); k++) {
+        compute_row(rows[k], targets[k]);
+    }
+}
 void Cholesky::choleskify() {
     // Initial dimensions
     size_t n = N();
@@ -63,81 +72,161 @@ void Cholesky::choleskify() {
     size_t max_rows_ULI = ((memory_ - n) / (2L * n));
     size_t max_rows = (max_rows_ULI > max_size_t ? max_size_t : max_rows_ULI);
 
+    // Pivots of a pass must lie within this fraction of the largest diagonal element,
+    // so that the block only takes pivots the one-at-a-time algorithm would soon reach
+    const double span = (block_size_ > 1 ? 1.0E-2 : 0.0);
+
     // Get the diagonal (Q|Q)^(0)
     auto* diag = new double[n];
     compute_diagonal(diag);
 
-    // Temporary cholesky factor
+    // Temporary cholesky factor, as blocks of contiguous rows
     std::vector<double*> L;
+    std::vector<size_t> Lrows;
 
     // List of selected pivots
     std::vector<int> pivots;
 
-    // Cholesky procedure
+    // Cholesky procedure, block_size_ pivot candidates per pass
     while (Q_ < n) {
-        // Select the pivot
-        size_t pivot = 0;
+        // Find the largest diagonal element
         double Dmax = diag[0];
         for (size_t P = 0; P < n; P++) {
-            if (Dmax < diag[P]) {
-                Dmax = diag[P];
-                pivot = P;
-            }
+            if (Dmax < diag[P]) Dmax = diag[P];
         }
 
         // Check to see if convergence reached
         if (Dmax < delta_ || Dmax < 0.0) break;
 
-        // If here, we're trying to add this row
-        pivots.push_back(pivot);
-        double L_QQ = sqrt(Dmax);
-
-        // Check to see if memory constraints are OK
-        if (Q_ > max_rows) {
+        // Select the candidate pivots, largest first
+        double Dmin = std::max(delta_, span * Dmax);
+        std::vector<int> candidates;
+        for (size_t P = 0; P < n; P++) {
+            if (diag[P] >= Dmin) candidates.push_back(P);
+        }
+        // Check to see if memory constraints are OK, and take no more rows than are left
+        if (Q_ >= max_rows + 1) {
             throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
         }
+        size_t ncand = std::min(candidates.size(), std::min(block_size_, n - Q_));
+        ncand = std::min(ncand, max_rows + 1 - Q_);
+        std::partial_sort(candidates.begin(), candidates.begin() + ncand, candidates.end(),
+                          [diag](int P1, int P2) { return diag[P1] > diag[P2] || (diag[P1] == diag[P2] && P1 < P2); });
+        candidates.resize(ncand);
+        std::vector<bool> inblock(n, false);
+        for (size_t c = 0; c < ncand; c++) inblock[candidates[c]] = true;
+
+        // (m|Q) for all candidates at once
+        auto* R = new double[ncand * n];
+        std::vector<double*> Rp(ncand);
+        for (size_t c = 0; c < ncand; c++) Rp[c] = &R[c * n];
+        compute_rows(candidates, Rp);
+
+        // [(m|Q) - L_m^P L_Q^P] for the pivots of previous passes
+        std::vector<double> LQ;
+        for (size_t B = 0, Poff = 0; B < L.size(); Poff += Lrows[B], B++) {
+            size_t nP = Lrows[B];
+            LQ.resize(ncand * nP);
+            for (size_t c = 0; c < ncand; c++) {
+                for (size_t P = 0; P < nP; P++) {
+                    LQ[c * nP + P] = L[B][P * n + candidates[c]];
+                }
+            }
+            C_DGEMM('N', 'N', ncand, n, nP, -1.0, LQ.data(), nP, L[B], n, 1.0, R, n);
+        }
 
-        // If here, we're really going to add this row
-        L.push_back(new double[n]);
+        // Pivot within the block, one row at a time; accepted rows are moved to the front of R
+        std::vector<size_t> slot(ncand);
+        std::vector<size_t> owner(ncand);
+        for (size_t c = 0; c < ncand; c++) slot[c] = owner[c] = c;
+        std::vector<bool> used(ncand, false);
+        size_t nacc = 0;
+        while (nacc < ncand) {
+            // Select the pivot
+            size_t best = ncand;
+            for (size_t c = 0; c < ncand; c++) {
+                if (used[c]) continue;
+                if (best == ncand || diag[candidates[c]] > diag[candidates[best]] ||
+                    (diag[candidates[c]] == diag[candidates[best]] && candidates[c] < candidates[best]))
+                    best = c;
+            }
+            size_t pivot = candidates[best];
+            double Dpivot = diag[pivot];
+            if (Dpivot < Dmin || Dpivot < 0.0) break;
+
+            // End the pass where the single-pivot algorithm would pick a row outside the block,
+            // so that both select the same pivots in the same order
+            size_t outside = n;
+            for (size_t P = 0; P < n; P++) {
+                if (!inblock[P] && (outside == n || diag[P] > diag[outside])) outside = P;
+            }
+            if (outside < n && (diag[outside] > Dpivot || (diag[outside] == Dpivot && outside < pivot))) break;
+
+            // If here, we're trying to add this row
+            used[best] = true;
+            pivots.push_back(pivot);
+            double L_QQ = sqrt(Dpivot);
+
+            // Move the row into the next free slot
+            if (slot[best] != nacc) {
+                size_t other = owner[nacc];
+                std::swap_ranges(Rp[slot[best]], Rp[slot[best]] + n, Rp[nacc]);
+                std::swap(slot[best], slot[other]);
+                owner[slot[best]] = best;
+                owner[slot[other]] = other;
+            }
+            double* LQrow = Rp[nacc];
 
-        // (m|Q)
-        compute_row(pivot, L[Q_]);
+            // [(m|Q) - L_m^P L_Q^P] for the pivots of this pass
+            for (size_t P = 0; P < nacc; P++) {
+                C_DAXPY(n, -Rp[P][pivot], Rp[P], 1, LQrow, 1);
+            }
 
-        // [(m|Q) - L_m^P L_Q^P]
-        for (size_t P = 0; P < Q_; P++) {
-            C_DAXPY(n, -L[P][pivots[Q_]], L[P], 1, L[Q_], 1);
-        }
+            // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
+            C_DSCAL(n, 1.0 / L_QQ, LQrow, 1);
 
-        // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
-        C_DSCAL(n, 1.0 / L_QQ, L[Q_], 1);
+            // Zero the upper triangle
+            for (size_t P = 0; P < pivots.size(); P++) {
+                LQrow[pivots[P]] = 0.0;
+            }
 
-        // Zero the upper triangle
-        for (size_t P = 0; P < pivots.size(); P++) {
-            L[Q_][pivots[P]] = 0.0;
-        }
+            // Set the pivot factor
+            LQrow[pivot] = L_QQ;
 
-        // Set the pivot factor
-        L[Q_][pivot] = L_QQ;
+            // Update the Schur complement diagonal
+            for (size_t P = 0; P < n; P++) {
+                diag[P] -= LQrow[P] * LQrow[P];
+            }
 
-        // Update the Schur complement diagonal
-        for (size_t P = 0; P < n; P++) {
-            diag[P] -= L[Q_][P] * L[Q_][P];
-        }
+            // Force truly zero elements to zero
+            for (size_t P = 0; P < pivots.size(); P++) {
+                diag[pivots[P]] = 0.0;
+            }
 
-        // Force truly zero elements to zero
-        for (size_t P = 0; P < pivots.size(); P++) {
-            diag[pivots[P]] = 0.0;
+            nacc++;
+            Q_++;
         }
 
-        Q_++;
+        // Keep only the accepted rows
+        if (nacc == ncand) {
+            L.push_back(R);
+        } else {
+            auto* Racc = new double[nacc * n];
+            ::memcpy(static_cast<void*>(Racc), static_cast<void*>(R), nacc * n * sizeof(double));
+            delete[] R;
+            L.push_back(Racc);
+        }
+        Lrows.push_back(nacc);
     }
+    delete[] diag;
+
     // Copy into a more permanant Matrix object
     L_ = std::make_shared<Matrix>("Partial Cholesky", Q_, n);
     double** Lp = L_->pointer();
 
-    for (size_t Q = 0; Q < Q_; Q++) {
-        ::memcpy(static_cast<void*>(Lp[Q]), static_cast<void*>(L[Q]), n * sizeof(double));
-        delete[] L[Q];
+    for (size_t B = 0, Q = 0; B < L.size(); Q += Lrows[B], B++) {
+        if (Lrows[B]) ::memcpy(static_cast<void*>(Lp[Q]), static_cast<void*>(L[B]), Lrows[B] * n * sizeof(double));
+        delete[] L[B];
     }
 }
 
@@ -220,6 +309,75 @@ void CholeskyERI::compute_row(int row, double* target) {
     }
 }
 
+void CholeskyERI::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets) {
+    size_t nbf = basisset_->nbf();
+    size_t nshell = basisset_->nshell();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    if (integrals_.empty()) integrals_.push_back(integral_);
+    while (integrals_.size() < static_cast<size_t>(nthread)) {
+        integrals_.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->clone()));
+    }
+
+    // Rows sharing the (RS| shell pair are computed from the same shell quartets
+    std::map<std::pair<int, int>, std::vector<size_t>> RS_rows;
+    for (size_t k = 0; k < rows.size(); k++) {
+        int R = basisset_->function_to_shell(rows[k] / nbf);
+        int S = basisset_->function_to_shell(rows[k] % nbf);
+        RS_rows[std::make_pair(R, S)].push_back(k);
+    }
+    std::vector<std::pair<std::pair<int, int>, std::vector<size_t>>> RS_tasks(RS_rows.begin(), RS_rows.end());
+
+    std::vector<std::pair<int, int>> MN_pairs;
+    for (int M = 0; M < nshell; M++) {
+        for (int N = M; N < nshell; N++) {
+            MN_pairs.emplace_back(M, N);
+        }
+    }
+
+    // Each (MN| pair writes its own elements of every row
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t MN = 0; MN < MN_pairs.size(); MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int M = MN_pairs[MN].first;
+        int N = MN_pairs[MN].second;
+        size_t nM = basisset_->shell(M).nfunction();
+        size_t nN = basisset_->shell(N).nfunction();
+        size_t mstart = basisset_->shell(M).function_index();
+        size_t nstart = basisset_->shell(N).function_index();
+
+        for (const auto& task : RS_tasks) {
+            int R = task.first.first;
+            int S = task.first.second;
+            size_t nR = basisset_->shell(R).nfunction();
+            size_t nS = basisset_->shell(S).nfunction();
+            size_t rstart = basisset_->shell(R).function_index();
+            size_t sstart = basisset_->shell(S).function_index();
+
+            integrals_[thread]->compute_shell(M, N, R, S);
+            const double* buffer = integrals_[thread]->buffer();
+
+            for (size_t k : task.second) {
+                size_t oR = rows[k] / nbf - rstart;
+                size_t os = rows[k] % nbf - sstart;
+                double* target = targets[k];
+                for (size_t om = 0; om < nM; om++) {
+                    for (size_t on = 0; on < nN; on++) {
+                        target[(om + mstart) * nbf + (on + nstart)] = target[(on + nstart) * nbf + (om + mstart)] =
+                            buffer[om * nN * nR * nS + on * nR * nS + oR * nS + os];
+                    }
+                }
+            }
+        }
+    }
+}
+
 CholeskyMP2::CholeskyMP2(SharedMatrix Qia, std::shared_ptr<Vector> eps_aocc, std::shared_ptr<Vector> eps_avir,
                          bool symmetric, double delta, size_t memory)
     : Qia_(Qia), eps_aocc_(eps_aocc), eps_avir_(eps_avir), symmetric_(symmetric), Cholesky(delta, memory) {}
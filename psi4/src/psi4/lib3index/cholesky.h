@@ -32,6 +32,8 @@
 #include "psi4/pragma.h"
 #include "psi4/libmints/typedefs.h"
 
+#include <vector>
+
 namespace psi {
 
 class Vector;
@@ -48,6 +50,8 @@ class Cholesky {
     SharedMatrix L_;
     /// Number of columns required, if choleskify() called
     size_t Q_;
+    /// Maximum number of pivots selected per pass of choleskify()
+    size_t block_size_;
 
    public:
     /*!
@@ -70,11 +74,15 @@ class Cholesky {
     virtual size_t N() = 0;
     /// Maximum Chebyshev error allowed in the decomposition
     double delta() const { return delta_; }
+    /// Set the maximum number of pivots selected per pass (1 recovers the single-pivot algorithm)
+    void set_block_size(size_t block_size) { block_size_ = (block_size ? block_size : 1); }
 
     /// Diagonal of the original square tensor, provided by the subclass
     virtual void compute_diagonal(double* target) = 0;
     /// Row row of the original square tensor, provided by the subclass
     virtual void compute_row(int row, double* target) = 0;
+    /// Rows rows of the original square tensor, by default one compute_row call each
+    virtual void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets);
 };
 
 class CholeskyMatrix : public Cholesky {
@@ -95,6 +103,8 @@ class PSI_API CholeskyERI : public Cholesky {
     double schwarz_;
     std::shared_ptr<BasisSet> basisset_;
     std::shared_ptr<TwoBodyAOInt> integral_;
+    /// Per-thread integral objects for compute_rows, integral_ first
+    std::vector<std::shared_ptr<TwoBodyAOInt>> integrals_;
 
    public:
     CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz, double delta, size_t memory);
@@ -103,6 +113,8 @@ class PSI_API CholeskyERI : public Cholesky {
     size_t N() override;
     void compute_diagonal(double* target) override;
     void compute_row(int row, double* target) override;
+    /// Computes rows sharing a shell pair together, threading over the bra shell pairs
+    void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets) override;
 };
 
 class CholeskyMP2 : public Cholesky {
@@ -182,6 +182,13 @@ void DFHelper::initialize() {
         outfile->Printf("%s in-core AOs.\n\n", AO_core_ ? "Using" : "Turning off");
     }
 
+    if (local_K_ && (!AO_core_ || do_wK_ || direct_ || direct_iaQ_)) {
+        std::stringstream error;
+        error << "DFHelper: local fitting of K needs the in-core STORE algorithm and no wK. \n"
+              << "Please supply more memory or turn off DF_LOCAL_K.";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
     // prepare AOs for STORE method
     if (AO_core_) {
         if (do_wK_) {
@@ -224,6 +231,9 @@ void DFHelper::AO_core() {
     // Auxiliary metric
     required_core_size_ += naux_ * naux_;
 
+    // Local K holds (A|B) and its Cholesky factor
+    if (local_K_) required_core_size_ += 2 * naux_ * naux_;
+
     // C_buffers (conservative estimate since I do not have max_nocc TODO)
     required_core_size_ += nthreads_ * nbf_ * nbf_;
 
@@ -505,7 +515,9 @@ void DFHelper::prepare_AO_core() {
     double* ppq = Ppq_.get();
 
     // outfile->Printf("\n    ==> Begin AO Blocked Construction <==\n\n");
-    if (direct_iaQ_ || direct_) {
+    if (direct_iaQ_ || direct_ || local_K_) {
+        // local K fits in each orbital's own domain, so it keeps the bare (Q|mn)
+        if (local_K_) prepare_local_K();
         timer_on("DFH: AO Construction");
         if (direct_iaQ_) {
             compute_dense_Qpq_blocking_Q(0, Qshells_ - 1, &Ppq_[0], eri);
@@ -550,6 +562,28 @@ void DFHelper::prepare_AO_core() {
     }
     // outfile->Printf("\n    ==> End AO Blocked Construction <==");
 }
+bool DFHelper::fill_AO_core(double* Qmn) {
+    // only the plain STORE path leaves (Q|mn) contracted with the metric
+    if (!built_ || !AO_core_ || !Ppq_ || direct_ || direct_iaQ_ || local_K_ || do_wK_) return false;
+    if (std::fabs(mpower_ + 0.5) > 1e-13) return false;
+
+    double* ppq = Ppq_.get();
+    size_t nbf2 = nbf_ * nbf_;
+#pragma omp parallel for num_threads(nthreads_) schedule(static)
+    for (size_t m = 0; m < nbf_; m++) {
+        size_t sm = small_skips_[m];
+        for (size_t Q = 0; Q < naux_; Q++) {
+            double* qmn = &Qmn[Q * nbf2 + m * nbf_];
+            double* pqm = &ppq[big_skips_[m] + Q * sm];
+            for (size_t n = 0; n < nbf_; n++) {
+                size_t mask = schwarz_fun_mask_[m * nbf_ + n];
+                qmn[n] = (mask ? pqm[mask - 1] : 0.0);
+            }
+        }
+    }
+    return true;
+}
+
 void DFHelper::prepare_AO_wK_core() {
     // get each thread an eri object
     std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
@@ -3006,6 +3040,11 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     // outfile->Printf("\n     ==> DFHelper:--Begin J/K builds <==\n\n");
     // outfile->Printf("\n     ==> Using the %s directive with AO_CORE = %d <==\n\n", method_.c_str(), AO_core_);
 
+    if (local_K_) {
+        compute_JK_local(Cleft, Cright, D, J, K, do_J, do_K, lr_symmetric);
+        return;
+    }
+
     // size checks for C matrices occur in jk.cc
     // computing D occurs inside of jk.cc
 
@@ -3219,6 +3258,9 @@ void DFHelper::compute_J(std::vector<SharedMatrix> D, std::vector<SharedMatrix>
             for (size_t l = 0; l < naux_; l++) T1p[l] += T1p[k * naux_ + l];
         }
 
+        // local K stores the bare (Q|mn), so the metric is applied here
+        if (local_K_) C_DPOTRS('L', naux_, 1, local_metric_chol_.data(), naux_, T1p, naux_);
+
 // complete pruned J
 #pragma omp parallel for schedule(guided) num_threads(nthreads_)
         for (size_t k = 0; k < nbf_; k++) {
@@ -3391,4 +3433,200 @@ void DFHelper::compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     }
 }
 
+void DFHelper::prepare_local_K() {
+    timer_on("DFH: local K setup");
+
+    // full Coulomb metric and its Cholesky factor
+    auto Jmet = std::make_shared<FittingMetric>(aux_, true);
+    Jmet->form_fitting_metric();
+    local_metric_ = Jmet->get_metric();
+    double* metp = local_metric_->pointer()[0];
+    local_metric_chol_.assign(metp, metp + naux_ * naux_);
+    if (C_DPOTRF('L', naux_, local_metric_chol_.data(), naux_)) {
+        throw PSIEXCEPTION("DFHelper: the Coulomb metric is not positive definite, cannot fit K locally.");
+    }
+
+    // significant partners of each basis function, in the order of the sparse storage
+    local_partners_.assign(nbf_, std::vector<size_t>());
+    for (size_t mu = 0; mu < nbf_; mu++) {
+        local_partners_[mu].reserve(small_skips_[mu]);
+        for (size_t nu = 0; nu < nbf_; nu++) {
+            if (schwarz_fun_mask_[mu * nbf_ + nu]) local_partners_[mu].push_back(nu);
+        }
+    }
+
+    // auxiliary functions and neighbours of each atom
+    auto mol = primary_->molecule();
+    size_t natom = mol->natom();
+    local_atom_aux_.assign(natom, std::vector<size_t>());
+    for (size_t P = 0; P < Qshells_; P++) {
+        size_t PHI = aux_->shell(P).function_index();
+        size_t numP = aux_->shell(P).nfunction();
+        for (size_t p = 0; p < numP; p++) local_atom_aux_[aux_->shell(P).ncenter()].push_back(PHI + p);
+    }
+    local_neighbors_.assign(natom, std::vector<size_t>());
+    for (size_t A = 0; A < natom; A++) {
+        for (size_t B = 0; B < natom; B++) {
+            if (mol->xyz(A).distance(mol->xyz(B)) <= local_K_radius_) local_neighbors_[A].push_back(B);
+        }
+    }
+
+    timer_off("DFH: local K setup");
+}
+void DFHelper::compute_JK_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                                std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, std::vector<SharedMatrix> K,
+                                bool do_J, bool do_K, bool lr_symmetric) {
+    // all of (Q|mn) is in core, so J is built in a single block of Q
+    if (do_J) {
+        timer_on("DFH: compute_J");
+        std::vector<std::vector<double>> D_buffers(nthreads_, std::vector<double>(nbf_));
+        std::vector<double> T1(nthreads_ * naux_);
+        std::vector<double> T2(nbf_ * nbf_);
+        compute_J(D, J, Ppq_.get(), T1.data(), T2.data(), D_buffers, 0, naux_);
+        timer_off("DFH: compute_J");
+    }
+
+    if (do_K) {
+        timer_on("DFH: compute_K local");
+        compute_K_local(Cleft, Cright, K, lr_symmetric);
+        timer_off("DFH: compute_K local");
+    }
+}
+void DFHelper::compute_K_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                               std::vector<SharedMatrix> K, bool lr_symmetric) {
+    // K_{mn} = sum_i (m l_i|A) [(A|B)_i]^{-1} (B|n r_i), with A and B restricted to the fitting domain
+    // of orbital i: the atoms carrying its charge and their neighbours within local_K_radius_.
+    // Both products of orbital i are fitted in the same domain with the Coulomb metric, so the robust
+    // (Dunlap) correction terms cancel exactly; the remaining error is the domain truncation itself.
+    size_t natom = local_atom_aux_.size();
+    double* metp = local_metric_->pointer()[0];
+    double* Mp = Ppq_.get();
+    std::vector<std::vector<double>> K_buffers(nthreads_);
+
+    for (size_t N = 0; N < K.size(); N++) {
+        SharedMatrix Cl = Cleft[N];
+        SharedMatrix Cr = Cright[N];
+        if (!Cl->colspi()[0]) continue;
+
+        // K only depends on C C^T; the pivoted Cholesky factor of the density has local columns
+        if (lr_symmetric) {
+            auto Dl = linalg::doublet(Cl, Cl, false, true);
+            Cl = Dl->partial_cholesky_factorize(cutoff_);
+            Cr = Cl;
+        }
+        size_t nocc = Cl->colspi()[0];
+        double** Clp = Cl->pointer();
+        double** Crp = Cr->pointer();
+
+        for (size_t t = 0; t < nthreads_; t++) K_buffers[t].assign(nbf_ * nbf_, 0.0);
+        bool failed = false;
+
+#pragma omp parallel num_threads(nthreads_)
+        {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            double* Kp = K_buffers[rank].data();
+            std::vector<double> weight(natom);
+            std::vector<char> in_domain(natom);
+            std::vector<char> in_rows(nbf_);
+            std::vector<size_t> aux, rows;
+            std::vector<double> cl(nbf_), cr(nbf_);
+            std::vector<double> Xl, Xr, Jd, Kloc;
+
+#pragma omp for schedule(dynamic)
+            for (size_t i = 0; i < nocc; i++) {
+                // Mulliken-like charge of the orbital pair on each atom
+                std::fill(weight.begin(), weight.end(), 0.0);
+                double total = 0.0;
+                for (size_t nu = 0; nu < nbf_; nu++) {
+                    double w = Clp[nu][i] * Clp[nu][i] + Crp[nu][i] * Crp[nu][i];
+                    weight[primary_->function_to_center(nu)] += w;
+                    total += w;
+                }
+                if (total == 0.0) continue;
+
+                // fitting domain
+                std::fill(in_domain.begin(), in_domain.end(), 0);
+                for (size_t A = 0; A < natom; A++) {
+                    if (weight[A] < local_K_cutoff_ * total) continue;
+                    for (size_t B : local_neighbors_[A]) in_domain[B] = 1;
+                }
+                aux.clear();
+                for (size_t A = 0; A < natom; A++) {
+                    if (in_domain[A]) aux.insert(aux.end(), local_atom_aux_[A].begin(), local_atom_aux_[A].end());
+                }
+
+                // rows m reached by the orbital through a significant pair (m nu)
+                rows.clear();
+                for (size_t nu = 0; nu < nbf_; nu++) {
+                    if (std::fabs(Clp[nu][i]) < cutoff_ && std::fabs(Crp[nu][i]) < cutoff_) continue;
+                    for (size_t m : local_partners_[nu]) {
+                        if (!in_rows[m]) {
+                            in_rows[m] = 1;
+                            rows.push_back(m);
+                        }
+                    }
+                }
+                std::sort(rows.begin(), rows.end());
+                for (size_t m : rows) in_rows[m] = 0;
+
+                size_t na = aux.size();
+                size_t nr = rows.size();
+                if (!na || !nr) continue;
+
+                // (A|m l_i) and (A|m r_i) for A in the domain, stored as (m, A)
+                Xl.assign(nr * na, 0.0);
+                if (!lr_symmetric) Xr.assign(nr * na, 0.0);
+                for (size_t r = 0; r < nr; r++) {
+                    size_t m = rows[r];
+                    size_t si = small_skips_[m];
+                    const std::vector<size_t>& partners = local_partners_[m];
+                    for (size_t s = 0; s < si; s++) cl[s] = Clp[partners[s]][i];
+                    if (!lr_symmetric)
+                        for (size_t s = 0; s < si; s++) cr[s] = Crp[partners[s]][i];
+                    double* Mm = &Mp[big_skips_[m]];
+                    for (size_t a = 0; a < na; a++) {
+                        Xl[r * na + a] = C_DDOT(si, &Mm[aux[a] * si], 1, cl.data(), 1);
+                        if (!lr_symmetric) Xr[r * na + a] = C_DDOT(si, &Mm[aux[a] * si], 1, cr.data(), 1);
+                    }
+                }
+
+                // domain metric (A|B)_i, factorized and applied to the right-hand products
+                Jd.resize(na * na);
+                for (size_t a = 0; a < na; a++) {
+                    for (size_t b = 0; b < na; b++) Jd[a * na + b] = metp[aux[a] * naux_ + aux[b]];
+                }
+                if (lr_symmetric) Xr = Xl;
+                if (C_DPOTRF('L', na, Jd.data(), na)) {
+#pragma omp atomic write
+                    failed = true;
+                    continue;
+                }
+                C_DPOTRS('L', na, nr, Jd.data(), na, Xr.data(), na);
+
+                // K_{mn} += (m l_i|A) [(A|B)_i]^{-1} (B|n r_i)
+                Kloc.resize(nr * nr);
+                C_DGEMM('N', 'T', nr, nr, na, 1.0, Xl.data(), na, Xr.data(), na, 0.0, Kloc.data(), nr);
+                for (size_t r = 0; r < nr; r++) {
+                    double* Kr = &Kp[rows[r] * nbf_];
+                    for (size_t s = 0; s < nr; s++) Kr[rows[s]] += Kloc[r * nr + s];
+                }
+            }
+        }
+
+        if (failed) {
+            throw PSIEXCEPTION("DFHelper: a local fitting metric is not positive definite. Increase DF_LOCAL_K_RADIUS.");
+        }
+
+        // reduce
+        double* Kp = K[N]->pointer()[0];
+        for (size_t t = 0; t < nthreads_; t++) {
+            double* Kt = K_buffers[t].data();
+            for (size_t mn = 0; mn < nbf_ * nbf_; mn++) Kp[mn] += Kt[mn];
+        }
+    }
+}
+
 }  // End namespaces
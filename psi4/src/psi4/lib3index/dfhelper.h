@@ -147,6 +147,25 @@ class PSI_API DFHelper {
     void set_wcombine(bool wcombine) {wcombine_ = wcombine;}
     bool get_wcombine() { return wcombine_; }
 
+    ///
+    /// Fit the exchange locally: the products (m i| of each occupied orbital are fitted
+    /// only with the auxiliary functions on atoms near that orbital. K then scales close to
+    /// linearly with system size. Needs in-core AOs (STORE) and no wK.
+    /// @param local_K boolean: fit K in local domains
+    ///
+    void set_local_K(bool local_K) { local_K_ = local_K; }
+    bool get_local_K() { return local_K_; }
+
+    ///
+    /// Sets the local fitting domains of K
+    /// @param cutoff: atoms carrying at least this fraction of an orbital's Mulliken charge belong to its domain
+    /// @param radius: the domain also holds every atom within radius (bohr) of those atoms
+    ///
+    void set_local_K_domains(double cutoff, double radius) {
+        local_K_cutoff_ = cutoff;
+        local_K_radius_ = radius;
+    }
+
     ///
     /// Lets me know whether to compute those other type of integrals
     /// @param do_wK boolean indicating to compute other integrals
@@ -302,6 +321,15 @@ class PSI_API DFHelper {
     size_t get_tensor_size(std::string key);
     std::tuple<size_t, size_t, size_t> get_tensor_shape(std::string key);
     size_t get_naux() { return naux_; }
+    std::shared_ptr<BasisSet> get_aux_basis() { return aux_; }
+
+    ///
+    /// Unpacks the in-core, metric-contracted AO integrals into a dense (Q|mn) tensor
+    /// @param Qmn naux x nbf x nbf buffer; pairs removed by the Schwarz screening are zero
+    /// @return false (and Qmn untouched) unless the integrals were stored in core
+    ///         and contracted with J^{-1/2}
+    ///
+    bool fill_AO_core(double* Qmn);
 
     /// builds J/K
     void build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
@@ -338,6 +366,9 @@ class PSI_API DFHelper {
     bool ordered_ = false;
     bool do_wK_ = false;
     bool wcombine_ = false;
+    bool local_K_ = false;
+    double local_K_cutoff_ = 1.0E-4;
+    double local_K_radius_ = 4.0;
     double omega_;
     double omega_alpha_;
     double omega_beta_;
@@ -354,6 +385,14 @@ class PSI_API DFHelper {
     std::unique_ptr<double[]> wPpq_;  // if do_wK_ holds (A|w|mn)
     std::unique_ptr<double[]> m1Ppq_;
 
+    // => local K machinery <=
+    SharedMatrix local_metric_;                          // (A|B), gathered into the domain metrics
+    std::vector<double> local_metric_chol_;              // Cholesky factor of (A|B), for J
+    std::vector<std::vector<size_t>> local_partners_;    // significant nu for each mu, in sparse order
+    std::vector<std::vector<size_t>> local_atom_aux_;    // auxiliary functions on each atom
+    std::vector<std::vector<size_t>> local_neighbors_;   // atoms within local_K_radius_ of each atom
+    void prepare_local_K();
+
     // => AO building machinery <=
     void prepare_AO();
     void prepare_AO_core();
@@ -516,6 +555,11 @@ class PSI_API DFHelper {
                                                           bool lr_symmetric);
     void compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> wK,
                     size_t max_nocc, bool do_J, bool do_K, bool do_wK);
+    void compute_JK_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                          std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, std::vector<SharedMatrix> K,
+                          bool do_J, bool do_K, bool lr_symmetric);
+    void compute_K_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                         std::vector<SharedMatrix> K, bool lr_symmetric);
 
     // => misc <=
     void fill(double* b, size_t count, double value);
@@ -36,6 +36,7 @@
 #include <cstdlib>
 #include <cstring>
 #include "psi4/psifiles.h"
+#include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 #ifdef _POSIX_MEMLOCK
@@ -53,7 +54,9 @@ namespace psi {
 ** doubles, allocates an array of pointers to the beginning of each row and
 ** returns the pointer to the first row pointer.  This allows transparent
 ** 2d-array style access, but keeps memory together such that the matrix
-** could be used in conjunction with FORTRAN matrix routines.
+** could be used in conjunction with FORTRAN matrix routines.  The
+** contiguous block comes from pool_alloc(), so it is 64-byte aligned and
+** large blocks are first touched by all threads.
 **
 ** Allocates memory for an n x m matrix and returns a pointer to the
 ** first row.
@@ -87,13 +90,7 @@ PSI_API double **block_matrix(size_t n, size_t m, bool memlock) {
         exit(PSI_RETURN_FAILURE);
     }
 
-    B = new double[n * m];
-    if (B == nullptr) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("m = %ld\n", m);
-        exit(PSI_RETURN_FAILURE);
-    }
-    memset(static_cast<void *>(B), 0, m * n * sizeof(double));
+    B = pool_alloc(n * m);
 
     for (i = 0; i < n; i++) {
         A[i] = &(B[i * m]);
@@ -147,7 +144,7 @@ PSI_API double **block_matrix(size_t n, size_t m, bool memlock) {
 */
 void PSI_API free_block(double **array) {
     if (array == nullptr) return;
-    delete[] array[0];
+    pool_free(array[0]);
     delete[] array;
 }
 }
@@ -112,6 +112,24 @@ PSI_API size_t *init_size_t_array(int size);
 PSI_API double **block_matrix(size_t n, size_t m, bool mlock = false);
 PSI_API void free_block(double **array);
 
+/* Functions in memory_pool.c */
+struct PoolStatistics {
+    size_t allocations = 0;
+    size_t pool_hits = 0;
+    size_t frees = 0;
+    size_t evictions = 0;
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;
+    size_t bytes_cached = 0;
+};
+PSI_API double *pool_alloc(size_t n, bool zero = true);
+PSI_API void pool_free(double *block);
+PSI_API void pool_set_limit(size_t bytes);
+PSI_API size_t pool_get_limit();
+PSI_API void pool_trim();
+PSI_API PoolStatistics pool_statistics();
+PSI_API void pool_print_statistics();
+
 /* Functions in fndcor */
 PSI_API void fndcor(long int *maxcrb, std::string out_fname);
 }  // namespace psi
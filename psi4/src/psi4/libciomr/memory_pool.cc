@@ -0,0 +1,285 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+\file
+\brief Pooled, aligned storage for the contiguous blocks behind block matrices
+\ingroup CIOMR
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+namespace psi {
+
+namespace {
+
+/// Alignment of every block handed out, one cache line / one AVX-512 register
+constexpr size_t pool_alignment = 64;
+/// Smallest size class in bytes; classes grow in quarter-octave steps from here
+constexpr size_t pool_min_class = 256;
+constexpr int pool_nclass = 4 * 64;
+/// Blocks at least this large are zeroed by all threads so that their pages are first touched where they are used
+constexpr size_t pool_first_touch_bytes = 1 << 20;
+
+/// Bookkeeping stored in the cache line just in front of every block
+struct PoolHeader {
+    void *raw;
+    size_t bytes;
+    int size_class;
+};
+static_assert(sizeof(PoolHeader) <= pool_alignment, "PoolHeader must fit in one alignment unit");
+
+class MemoryPool {
+    std::mutex lock_;
+    std::vector<std::vector<double *>> free_lists_;
+    size_t limit_ = 256 * (size_t)1024 * 1024;
+    size_t cached_ = 0;
+    PoolStatistics stats_;
+
+    static int size_class(size_t bytes, size_t &rounded) {
+        if (bytes <= pool_min_class) {
+            rounded = pool_min_class;
+            return 0;
+        }
+        int k = 0;
+        while ((bytes - 1) >> (k + 1)) ++k;
+        size_t base = (size_t)1 << k;
+        size_t step = base / 4;
+        size_t sub = (bytes - base + step - 1) / step;
+        rounded = base + sub * step;
+        return 4 * (k - 8) + static_cast<int>(sub);
+    }
+
+    static PoolHeader *header(double *block) {
+        return reinterpret_cast<PoolHeader *>(reinterpret_cast<char *>(block) - pool_alignment);
+    }
+
+    // The caller holds lock_
+    void evict(size_t target) {
+        for (int c = pool_nclass - 1; c >= 0 && cached_ > target; --c) {
+            auto &list = free_lists_[c];
+            while (!list.empty() && cached_ > target) {
+                PoolHeader *h = header(list.back());
+                list.pop_back();
+                cached_ -= h->bytes;
+                stats_.evictions++;
+                std::free(h->raw);
+            }
+        }
+        stats_.bytes_cached = cached_;
+    }
+
+   public:
+    MemoryPool() : free_lists_(pool_nclass) {}
+
+    double *allocate(size_t n, bool zero) {
+        size_t rounded = 0;
+        int c = size_class(n * sizeof(double), rounded);
+
+        double *block = nullptr;
+        bool fresh = false;
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stats_.allocations++;
+            if (!free_lists_[c].empty()) {
+                block = free_lists_[c].back();
+                free_lists_[c].pop_back();
+                cached_ -= rounded;
+                stats_.bytes_cached = cached_;
+                stats_.pool_hits++;
+            }
+            stats_.bytes_in_use += rounded;
+            if (stats_.bytes_in_use > stats_.peak_bytes_in_use) stats_.peak_bytes_in_use = stats_.bytes_in_use;
+        }
+
+        if (block == nullptr) {
+            void *raw = std::malloc(rounded + 2 * pool_alignment);
+            if (raw == nullptr) {
+                std::lock_guard<std::mutex> guard(lock_);
+                stats_.bytes_in_use -= rounded;
+                throw std::bad_alloc();
+            }
+            uintptr_t addr = (reinterpret_cast<uintptr_t>(raw) + 2 * pool_alignment - 1) & ~(pool_alignment - 1);
+            block = reinterpret_cast<double *>(addr);
+            PoolHeader *h = header(block);
+            h->raw = raw;
+            h->bytes = rounded;
+            h->size_class = c;
+            fresh = true;
+        }
+
+        // Fresh pages are always written once here, even when the caller does not need zeros, so that the first
+        // touch of a large block is spread over the threads that will later work on it.
+        size_t bytes = n * sizeof(double);
+        if (bytes >= pool_first_touch_bytes && (zero || fresh)) {
+            bool parallel = true;
+            int nthread = Process::environment.get_n_threads();
+#ifdef _OPENMP
+            parallel = !omp_in_parallel() && nthread > 1;
+#endif
+            size_t chunk = pool_first_touch_bytes / sizeof(double);
+            size_t nchunk = (n + chunk - 1) / chunk;
+#pragma omp parallel for schedule(static) num_threads(nthread) if (parallel)
+            for (size_t i = 0; i < nchunk; ++i) {
+                size_t start = i * chunk;
+                size_t len = std::min(chunk, n - start);
+                std::memset(block + start, 0, len * sizeof(double));
+            }
+        } else if (zero) {
+            std::memset(block, 0, bytes);
+        }
+        return block;
+    }
+
+    void release(double *block) {
+        PoolHeader *h = header(block);
+        std::lock_guard<std::mutex> guard(lock_);
+        stats_.frees++;
+        stats_.bytes_in_use -= h->bytes;
+        if (h->bytes > limit_) {
+            std::free(h->raw);
+            return;
+        }
+        free_lists_[h->size_class].push_back(block);
+        cached_ += h->bytes;
+        if (cached_ > limit_) evict(limit_);
+        stats_.bytes_cached = cached_;
+    }
+
+    void set_limit(size_t bytes) {
+        std::lock_guard<std::mutex> guard(lock_);
+        limit_ = bytes;
+        evict(limit_);
+    }
+
+    size_t limit() {
+        std::lock_guard<std::mutex> guard(lock_);
+        return limit_;
+    }
+
+    void trim() {
+        std::lock_guard<std::mutex> guard(lock_);
+        evict(0);
+    }
+
+    PoolStatistics statistics() {
+        std::lock_guard<std::mutex> guard(lock_);
+        return stats_;
+    }
+};
+
+// Never destroyed: matrices owned by Python may outlive every other static object
+MemoryPool &pool() {
+    static MemoryPool *instance = new MemoryPool();
+    return *instance;
+}
+
+}  // namespace
+
+/*!
+** pool_alloc(): Hand out an uninitialized or zeroed block of n doubles
+**
+** Blocks are 64-byte aligned and come from size-class free lists when a
+** block of the same class was released earlier.  Blocks of at least 1 MiB
+** are zeroed by all threads so that their pages land on the NUMA node of
+** the threads which use them.
+**
+** \param n    = number of doubles
+** \param zero = whether the block must be zeroed; pass false only if the
+**               caller overwrites every element
+**
+** \ingroup CIOMR
+*/
+PSI_API double *pool_alloc(size_t n, bool zero) { return pool().allocate(n, zero); }
+
+/*!
+** pool_free(): Return a block obtained from pool_alloc() to the pool
+**
+** \ingroup CIOMR
+*/
+PSI_API void pool_free(double *block) {
+    if (block == nullptr) return;
+    pool().release(block);
+}
+
+/*!
+** pool_set_limit(): Set the number of bytes the pool may keep cached for reuse
+**
+** Zero disables caching; cached blocks beyond the new limit are returned
+** to the system immediately.
+**
+** \ingroup CIOMR
+*/
+PSI_API void pool_set_limit(size_t bytes) { pool().set_limit(bytes); }
+
+PSI_API size_t pool_get_limit() { return pool().limit(); }
+
+/*!
+** pool_trim(): Return every cached block to the system
+**
+** \ingroup CIOMR
+*/
+PSI_API void pool_trim() { pool().trim(); }
+
+PSI_API PoolStatistics pool_statistics() { return pool().statistics(); }
+
+/*!
+** pool_print_statistics(): Print the allocation statistics of the pool
+**
+** \ingroup CIOMR
+*/
+PSI_API void pool_print_statistics() {
+    PoolStatistics s = pool().statistics();
+    double hit_rate = s.allocations ? 100.0 * s.pool_hits / s.allocations : 0.0;
+    outfile->Printf("\n  ==> Matrix Memory Pool <==\n\n");
+    outfile->Printf("    Allocations         = %14zu\n", s.allocations);
+    outfile->Printf("    Served from pool    = %14zu (%5.1f%%)\n", s.pool_hits, hit_rate);
+    outfile->Printf("    Frees               = %14zu\n", s.frees);
+    outfile->Printf("    Evictions           = %14zu\n", s.evictions);
+    outfile->Printf("    Bytes in use        = %14zu\n", s.bytes_in_use);
+    outfile->Printf("    Peak bytes in use   = %14zu\n", s.peak_bytes_in_use);
+    outfile->Printf("    Bytes cached        = %14zu\n", s.bytes_cached);
+    outfile->Printf("    Cache limit (bytes) = %14zu\n\n", pool_get_limit());
+}
+
+}  // namespace psi
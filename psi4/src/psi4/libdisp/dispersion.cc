@@ -44,6 +44,8 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <cstdlib>
@@ -52,9 +54,13 @@
 #include <vector>
 #include <memory>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
-Dispersion::Dispersion() {}
+Dispersion::Dispersion() : cutoff_(0.0) {}
 
 Dispersion::~Dispersion() {}
 
@@ -79,6 +85,7 @@ std::shared_ptr<Dispersion> Dispersion::build(const std::string &name, double s6
         disp->bibtex_ = "Grimme:2004:1463";
         disp->s6_ = s6;
         disp->d_ = 23.0;
+        disp->sr6_ = 1.1;  // damping radius is the sum of the atomic radii
         disp->C6_ = C6_D1_;
         disp->RvdW_ = RvdW_D1_;
         disp->C6_type_ = C6_arit;
@@ -237,126 +244,231 @@ std::string Dispersion::print_hessian(std::shared_ptr<Molecule> m) {
     return s.str();
 }
 
-double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
-    double E = 0.0;
+bool Dispersion::setup_atoms(std::shared_ptr<Molecule> m, std::vector<double> &xyz, std::vector<int> &type,
+                             std::vector<int> &group) {
+    int natom = m->natom();
+    xyz.resize(3 * natom);
+    type.assign(natom, 0);
+    group.assign(natom, -1);
 
     if (Damping_type_ == Damping_TT) {
         // -DAS dispersion only involves inter-fragment terms
         if (m->nactive_fragments() == 1) {
             // Just in case, since auto fragment is not called
             outfile->Printf("\n    Only one fragment provided, no empirical dispersion will be added.\n\n");
-            return 0.0;
+            return false;
         }
 
-        // need a check if there is only one active fragment ...
-
-        // list of atoms in monomer A
-        std::vector<int> realsA;
-        realsA.push_back(0);
-        std::vector<int> ghostsA;
-        ghostsA.push_back(1);
-        std::shared_ptr<Molecule> monoA = m->extract_subsets(realsA, ghostsA);
+        // The monomers, each with the other as ghost, type the hydrogens by their own bonding partners
+        std::shared_ptr<Molecule> monoA = m->extract_subsets(std::vector<int>{0}, std::vector<int>{1});
+        std::shared_ptr<Molecule> monoB = m->extract_subsets(std::vector<int>{1}, std::vector<int>{0});
         std::shared_ptr<Vector> alist = set_atom_list(monoA);
-        double *alist_p = alist->pointer();
-
-        // list of atoms in monomer B
-        std::vector<int> realsB;
-        realsB.push_back(1);
-        std::vector<int> ghostsB;
-        ghostsB.push_back(0);
-        std::shared_ptr<Molecule> monoB = m->extract_subsets(realsB, ghostsB);
         std::shared_ptr<Vector> blist = set_atom_list(monoB);
+        double *alist_p = alist->pointer();
         double *blist_p = blist->pointer();
 
-        for (int i = 0; i < monoA->natom(); i++) {
-            if ((int)monoA->Z(i) == 0) continue;
-            for (int j = 0; j < monoB->natom(); j++) {
-                if ((int)monoB->Z(j) == 0) continue;
-
-                double C6, C8, Rm6, Rm8, f_6, f_8, g, beta;
-
-                double dx = monoB->x(j) - monoA->x(i);
-                double dy = monoB->y(j) - monoA->y(i);
-                double dz = monoB->z(j) - monoA->z(i);
-
-                double R2 = dx * dx + dy * dy + dz * dz;
+        // Both monomers list the atoms of the two fragments in the order of m unless m has more fragments
+        std::shared_ptr<Molecule> dimer = (monoA->natom() == natom) ? m : monoA;
+        natom = monoA->natom();
+        xyz.resize(3 * natom);
+        type.assign(natom, 0);
+        group.assign(natom, -1);
+        for (int i = 0; i < natom; i++) {
+            xyz[3 * i + 0] = dimer->x(i);
+            xyz[3 * i + 1] = dimer->y(i);
+            xyz[3 * i + 2] = dimer->z(i);
+            if ((int)monoA->Z(i) != 0) {
+                group[i] = 0;
+                type[i] = (int)alist_p[i];
+            } else if ((int)monoB->Z(i) != 0) {
+                group[i] = 1;
+                type[i] = (int)blist_p[i];
+            }
+        }
+        return true;
+    }
 
-                double R = sqrt(R2);
-                double R6 = R2 * R2 * R2;
-                double R8 = R2 * R2 * R2 * R2;
-                Rm6 = 1.0 / R6;
-                Rm8 = 1.0 / R8;
+    std::shared_ptr<Vector> atom_list = set_atom_list(m);
+    double *atom_list_p = atom_list->pointer();
+    for (int i = 0; i < natom; i++) {
+        xyz[3 * i + 0] = m->x(i);
+        xyz[3 * i + 1] = m->y(i);
+        xyz[3 * i + 2] = m->z(i);
+        type[i] = (int)atom_list_p[i];
+        // ghost atoms carry no dispersion
+        if ((int)m->Z(i) != 0) group[i] = 0;
+    }
+    return true;
+}
 
-                // Compute geometric mean of atomic C6 coefficients
-                C6 = sqrt(C6_[(int)alist_p[i]] * C6_[(int)blist_p[j]]);
+std::vector<std::vector<int>> Dispersion::neighbors(const std::vector<double> &xyz, const std::vector<int> &group,
+                                                    bool half) const {
+    int natom = group.size();
+    bool inter_only = (Damping_type_ == Damping_TT);
+    std::vector<std::vector<int>> list(natom);
+
+    std::vector<int> atoms;
+    for (int i = 0; i < natom; i++)
+        if (group[i] >= 0) atoms.push_back(i);
+    if (atoms.empty()) return list;
+
+    // One cell holds everything unless a cutoff is given
+    double lo[3], hi[3];
+    for (int x = 0; x < 3; x++) lo[x] = hi[x] = xyz[3 * atoms[0] + x];
+    for (int i : atoms) {
+        for (int x = 0; x < 3; x++) {
+            lo[x] = std::min(lo[x], xyz[3 * i + x]);
+            hi[x] = std::max(hi[x], xyz[3 * i + x]);
+        }
+    }
+    double cutoff2 = cutoff_ * cutoff_;
+    double width = (cutoff_ > 0.0) ? cutoff_ : 0.0;
+    int ncell[3] = {1, 1, 1};
+    if (width > 0.0) {
+        // Cells no smaller than the cutoff, and not many more cells than atoms
+        while (true) {
+            size_t total = 1;
+            for (int x = 0; x < 3; x++) {
+                ncell[x] = (int)std::floor((hi[x] - lo[x]) / width) + 1;
+                total *= ncell[x];
+            }
+            if (total <= 8 * atoms.size() + 27) break;
+            width *= 2.0;
+        }
+    }
 
-                // Compute geometric mean of atomic C8 coefficients
-                C8 = sqrt(C8_[(int)alist_p[i]] * C8_[(int)blist_p[j]]);
+    std::vector<int> cell_of(natom, -1);
+    std::vector<std::vector<int>> cells((size_t)ncell[0] * ncell[1] * ncell[2]);
+    for (int i : atoms) {
+        int c[3];
+        for (int x = 0; x < 3; x++)
+            c[x] = (ncell[x] == 1) ? 0 : std::min(ncell[x] - 1, (int)((xyz[3 * i + x] - lo[x]) / width));
+        cell_of[i] = (c[0] * ncell[1] + c[1]) * ncell[2] + c[2];
+        cells[cell_of[i]].push_back(i);
+    }
 
-                // Tang-Toennies Damping function
-                double f_6_sum = 1.0;
-                double f_8_sum = 1.0;
-                beta = sqrt(Beta_[(int)alist_p[i]] * Beta_[(int)blist_p[j]]);
-                for (int n = 1; n <= 6; n++) {
-                    f_6_sum += pow(R * beta, n) / fac[n];
-                }
-                for (int n = 1; n <= 8; n++) {
-                    f_8_sum += pow(R * beta, n) / fac[n];
+#pragma omp parallel for schedule(dynamic)
+    for (size_t a = 0; a < atoms.size(); a++) {
+        int i = atoms[a];
+        int ci[3] = {cell_of[i] / (ncell[1] * ncell[2]), (cell_of[i] / ncell[2]) % ncell[1], cell_of[i] % ncell[2]};
+        for (int cx = std::max(0, ci[0] - 1); cx <= std::min(ncell[0] - 1, ci[0] + 1); cx++) {
+            for (int cy = std::max(0, ci[1] - 1); cy <= std::min(ncell[1] - 1, ci[1] + 1); cy++) {
+                for (int cz = std::max(0, ci[2] - 1); cz <= std::min(ncell[2] - 1, ci[2] + 1); cz++) {
+                    for (int j : cells[(cx * ncell[1] + cy) * ncell[2] + cz]) {
+                        if (j == i || (half && j > i)) continue;
+                        if (inter_only && group[j] == group[i]) continue;
+                        if (cutoff_ > 0.0) {
+                            double dx = xyz[3 * j + 0] - xyz[3 * i + 0];
+                            double dy = xyz[3 * j + 1] - xyz[3 * i + 1];
+                            double dz = xyz[3 * j + 2] - xyz[3 * i + 2];
+                            if (dx * dx + dy * dy + dz * dz > cutoff2) continue;
+                        }
+                        list[i].push_back(j);
+                    }
                 }
+            }
+        }
+    }
+    return list;
+}
 
-                f_6 = 1.0 - exp(-R * beta) * f_6_sum;
-                f_8 = 1.0 - exp(-R * beta) * f_8_sum;
+void Dispersion::pair_energy(int ti, int tj, double R, double &E, double &E_R, double &E_RR) const {
+    if (Damping_type_ == Damping_TT) {
+        // Tang-Toennies damped C6 and C8 terms, f_n = 1 - exp(-bR) sum_k=0^n (bR)^k / k!
+        double C6 = sqrt(C6_[ti] * C6_[tj]);
+        double C8 = sqrt(C8_[ti] * C8_[tj]);
+        double beta = sqrt(Beta_[ti] * Beta_[tj]);
+        double bR = beta * R;
+        double ebR = exp(-bR);
+
+        double term = 1.0;  // (bR)^k / k!
+        double sum = 1.0;
+        double f[9], f_R[9], f_RR[9];
+        for (int n = 1; n <= 8; n++) {
+            double term_prev = term;
+            term *= bR / n;
+            sum += term;
+            f[n] = 1.0 - ebR * sum;
+            f_R[n] = beta * ebR * term;
+            f_RR[n] = beta * beta * ebR * term_prev * (1.0 - bR / n);
+        }
 
-                if (Spherical_type_ == Spherical_Das) {
-                    g = sqrt(A_[(int)alist_p[i]] * A_[(int)blist_p[j]]) * exp(-R * beta);
-                } else if (Spherical_type_ == Spherical_zero) {
-                    g = 0.0;
-                } else {
-                    throw PSIEXCEPTION("Unrecognized Spherical Type");
-                }
+        E = E_R = E_RR = 0.0;
+        for (int n : {6, 8}) {
+            double C = (n == 6) ? C6 : C8;
+            double h = pow(R, -n);
+            double h_R = -n * h / R;
+            double h_RR = n * (n + 1) * h / (R * R);
+            E += C * h * f[n];
+            E_R += C * (h_R * f[n] + h * f_R[n]);
+            E_RR += C * (h_RR * f[n] + 2.0 * h_R * f_R[n] + h * f_RR[n]);
+        }
 
-                E += C6 * Rm6 * f_6;
-                E += C8 * Rm8 * f_8;
-                E += g;
-            }
+        if (Spherical_type_ == Spherical_Das) {
+            double g = sqrt(A_[ti] * A_[tj]) * ebR;
+            E += g;
+            E_R -= beta * g;
+            E_RR += beta * beta * g;
+        } else if (Spherical_type_ != Spherical_zero) {
+            throw PSIEXCEPTION("Unrecognized Spherical Type");
         }
+        return;
+    }
+
+    double C6;
+    if (C6_type_ == C6_arit) {
+        C6 = 2.0 * C6_[ti] * C6_[tj] / (C6_[ti] + C6_[tj]);
+    } else if (C6_type_ == C6_geom) {
+        C6 = sqrt(C6_[ti] * C6_[tj]);
     } else {
-        std::shared_ptr<Vector> atom_list = set_atom_list(m);
-        double *atom_list_p = atom_list->pointer();
-        for (int i = 0; i < m->natom(); i++) {
-            for (int j = 0; j < i; j++) {
-                double C6, Rm6, f;
-
-                double dx = m->x(j) - m->x(i);
-                double dy = m->y(j) - m->y(i);
-                double dz = m->z(j) - m->z(i);
-
-                double R2 = dx * dx + dy * dy + dz * dz;
-                double R = sqrt(R2);
-                double R6 = R2 * R2 * R2;
-                Rm6 = 1.0 / R6;
-
-                if (C6_type_ == C6_arit) {
-                    C6 = 2.0 * C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]] /
-                         (C6_[(int)atom_list_p[i]] + C6_[(int)atom_list_p[j]]);
-                } else if (C6_type_ == C6_geom) {
-                    C6 = sqrt(C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]]);
-                } else {
-                    throw PSIEXCEPTION("Unrecognized C6 Type");
-                }
+        throw PSIEXCEPTION("Unrecognized C6 Type");
+    }
 
-                if (Damping_type_ == Damping_D1) {
-                    double RvdW = (RvdW_[(int) atom_list_p[i]] + RvdW_[(int) atom_list_p[j]]) / 1.1;
-                    f = 1.0 / (1.0 + exp(-d_ * (R / (sr6_ * RvdW) - 1)));
-                } else if (Damping_type_ == Damping_CHG) {
-                    double RvdW = RvdW_[(int)atom_list_p[i]] + RvdW_[(int)atom_list_p[j]];
-                    f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                } else {
-                    throw PSIEXCEPTION("Unrecognized Damping Function");
-                }
+    double f, f_R, f_RR;
+    if (Damping_type_ == Damping_D1) {
+        double RvdW = sr6_ * (RvdW_[ti] + RvdW_[tj]) / 1.1;
+        double a = d_ / RvdW;
+        double e = exp(-d_ * (R / RvdW - 1.0));
+        f = 1.0 / (1.0 + e);
+        f_R = a * e * f * f;
+        f_RR = a * a * e * f * f * (2.0 * e * f - 1.0);
+    } else if (Damping_type_ == Damping_CHG) {
+        double RvdW = RvdW_[ti] + RvdW_[tj];
+        double t = d_ * pow((R / RvdW), -12.0);
+        f = 1.0 / (1.0 + t);
+        f_R = 12.0 * t * f * f / R;
+        f_RR = (-156.0 * t * f * f + 288.0 * t * t * f * f * f) / (R * R);
+    } else {
+        throw PSIEXCEPTION("Unrecognized Damping Function");
+    }
 
-                E += C6 * Rm6 * f;
-            }
+    double Rm6 = 1.0 / (R * R * R * R * R * R);
+    double Rm6_R = -6.0 * Rm6 / R;
+    double Rm6_RR = 42.0 * Rm6 / (R * R);
+
+    E = C6 * Rm6 * f;
+    E_R = C6 * (Rm6_R * f + Rm6 * f_R);
+    E_RR = C6 * (Rm6_RR * f + 2.0 * Rm6_R * f_R + Rm6 * f_RR);
+}
+
+double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
+    std::vector<double> xyz;
+    std::vector<int> type, group;
+    if (!setup_atoms(m, xyz, type, group)) return 0.0;
+    std::vector<std::vector<int>> list = neighbors(xyz, group, true);
+
+    double E = 0.0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : E)
+    for (size_t i = 0; i < list.size(); i++) {
+        for (int j : list[i]) {
+            double dx = xyz[3 * j + 0] - xyz[3 * i + 0];
+            double dy = xyz[3 * j + 1] - xyz[3 * i + 1];
+            double dz = xyz[3 * j + 2] - xyz[3 * i + 2];
+            double R = sqrt(dx * dx + dy * dy + dz * dz);
+
+            double e, e_R, e_RR;
+            pair_energy(type[i], type[j], R, e, e_R, e_RR);
+            E += e;
         }
     }
     E *= -s6_;
@@ -368,77 +480,88 @@ SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
     auto G = std::make_shared<Matrix>("Dispersion Gradient", m->natom(), 3);
     double **Gp = G->pointer();
 
-    if (Damping_type_ == Damping_TT) {
-        throw PSIEXCEPTION("+Das Gradients not yet implemented");
-    }
-
-    for (int i = 0; i < m->natom(); i++) {
-        for (int j = 0; j < i; j++) {
-            double C6, Rm6, f;
-            double C6_R, Rm6_R, f_R;
-
-            double R;
-            double R_xi, R_yi, R_zi;
-            double R_xj, R_yj, R_zj;
-
-            double dx = m->x(j) - m->x(i);
-            double dy = m->y(j) - m->y(i);
-            double dz = m->z(j) - m->z(i);
-
-            double R2 = dx * dx + dy * dy + dz * dz;
-            R = sqrt(R2);
-
-            R_xi = -dx / R;
-            R_xj = dx / R;
-            R_yi = -dy / R;
-            R_yj = dy / R;
-            R_zi = -dz / R;
-            R_zj = dz / R;
-
-            double R6 = R2 * R2 * R2;
-            Rm6 = 1.0 / R6;
-            Rm6_R = -6.0 * Rm6 / R;
-
-            double RvdW = RvdW_[(int)m->Z(i)] + RvdW_[(int)m->Z(j)];
-
-            if (C6_type_ == C6_arit) {
-                C6 = 2.0 * C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)] / (C6_[(int)m->Z(i)] + C6_[(int)m->Z(j)]);
-                C6_R = 0.0;
-            } else if (C6_type_ == C6_geom) {
-                C6 = sqrt(C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)]);
-                C6_R = 0.0;
-            } else {
-                throw PSIEXCEPTION("Unrecognized C6 Type");
-            }
-            if (Damping_type_ == Damping_D1) {
-                f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1.0)));
-                f_R = -f * f * exp(-d_ * (R / RvdW - 1.0)) * (-d_ / RvdW);
-            } else if (Damping_type_ == Damping_CHG) {
-                f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                f_R = -f * f * d_ * (-12.0) * pow((R / RvdW), -13.0) * (1.0 / RvdW);
-            } else if (Damping_type_ == Damping_TT) {
-                throw PSIEXCEPTION("+Das Gradients not yet implemented");
-            } else {
-                throw PSIEXCEPTION("Unrecognized Damping Function");
+    std::vector<double> xyz;
+    std::vector<int> type, group;
+    if (!setup_atoms(m, xyz, type, group)) return G;
+    if ((int)group.size() != m->natom())
+        throw PSIEXCEPTION("Dispersion: -DAS derivatives need a molecule of exactly two fragments");
+    std::vector<std::vector<int>> list = neighbors(xyz, group, true);
+
+    int natom = m->natom();
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+    // Each thread sums into its own copy of the gradient
+    std::vector<double> Gt((size_t)nthread * 3 * natom, 0.0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < list.size(); i++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *Gi = Gt.data() + (size_t)thread * 3 * natom;
+        for (int j : list[i]) {
+            double d[3];
+            for (int x = 0; x < 3; x++) d[x] = xyz[3 * j + x] - xyz[3 * i + x];
+            double R = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+            double e, E_R, e_RR;
+            pair_energy(type[i], type[j], R, e, E_R, e_RR);
+
+            for (int x = 0; x < 3; x++) {
+                Gi[3 * i + x] -= E_R * d[x] / R;
+                Gi[3 * j + x] += E_R * d[x] / R;
             }
-
-            double E_R = C6_R * Rm6 * f + C6 * Rm6_R * f + C6 * Rm6 * f_R;
-
-            Gp[i][0] += E_R * R_xi;
-            Gp[i][1] += E_R * R_yi;
-            Gp[i][2] += E_R * R_zi;
-            Gp[j][0] += E_R * R_xj;
-            Gp[j][1] += E_R * R_yj;
-            Gp[j][2] += E_R * R_zj;
         }
     }
 
+    for (int t = 0; t < nthread; t++)
+        for (int a = 0; a < natom; a++)
+            for (int x = 0; x < 3; x++) Gp[a][x] += Gt[(size_t)t * 3 * natom + 3 * a + x];
+
     G->scale(-s6_);
     return G;
 }
 
 SharedMatrix Dispersion::compute_hessian(std::shared_ptr<Molecule> m) {
-    throw PSIEXCEPTION("Dispersion: Hessians not implemented");
+    auto H = std::make_shared<Matrix>("Dispersion Hessian", 3 * m->natom(), 3 * m->natom());
+    double **Hp = H->pointer();
+
+    std::vector<double> xyz;
+    std::vector<int> type, group;
+    if (!setup_atoms(m, xyz, type, group)) return H;
+    if ((int)group.size() != m->natom())
+        throw PSIEXCEPTION("Dispersion: -DAS derivatives need a molecule of exactly two fragments");
+
+    // With full neighbor lists, the pass over atom i only writes the rows of atom i
+    std::vector<std::vector<int>> list = neighbors(xyz, group, false);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < list.size(); i++) {
+        for (int j : list[i]) {
+            double u[3];
+            for (int x = 0; x < 3; x++) u[x] = xyz[3 * j + x] - xyz[3 * i + x];
+            double R = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+            for (int x = 0; x < 3; x++) u[x] /= R;
+
+            double e, E_R, E_RR;
+            pair_energy(type[i], type[j], R, e, E_R, E_RR);
+
+            // d2E / dr_i dr_j = -(E_RR u u^T + E_R / R (1 - u u^T)), and the negative of that on the diagonal block
+            for (int x = 0; x < 3; x++) {
+                for (int y = 0; y < 3; y++) {
+                    double h = (E_RR - E_R / R) * u[x] * u[y] + (x == y ? E_R / R : 0.0);
+                    Hp[3 * i + x][3 * i + y] += h;
+                    Hp[3 * i + x][3 * j + y] -= h;
+                }
+            }
+        }
+    }
+
+    H->scale(-s6_);
+    return H;
 }
 
 std::shared_ptr<Vector> Dispersion::set_atom_list(std::shared_ptr<Molecule> mol) {
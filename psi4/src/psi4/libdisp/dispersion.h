@@ -37,6 +37,7 @@
 ***********************************************************/
 #include "psi4/psi4-dec.h"
 #include <string>
+#include <vector>
 
 namespace psi {
 
@@ -72,6 +73,20 @@ class Dispersion {
     const double *A_;
     const double *Beta_;
 
+    /// Pair cutoff in bohr; pairs beyond it are dropped.  Zero keeps all pairs.
+    double cutoff_;
+
+    /// Coordinates (natom x 3), atom types, and interacting groups of m.
+    /// Atoms with group -1 do not interact; for -DAS only pairs between groups 0 and 1 do.
+    bool setup_atoms(std::shared_ptr<Molecule> m, std::vector<double> &xyz, std::vector<int> &type,
+                     std::vector<int> &group);
+    /// For each atom i, the atoms j it interacts with within cutoff_, found with a cell list.
+    /// If half, only j < i is kept, so that every pair appears once.
+    std::vector<std::vector<int>> neighbors(const std::vector<double> &xyz, const std::vector<int> &group,
+                                            bool half) const;
+    /// Pair energy of atom types ti and tj at distance R and its first two derivatives in R, before scaling by -s6
+    void pair_energy(int ti, int tj, double R, double &E, double &E_R, double &E_RR) const;
+
    public:
     Dispersion();
     virtual ~Dispersion();
@@ -96,6 +111,7 @@ class Dispersion {
     double get_s8() const { return s8_; }
     double get_a1() const { return a1_; }
     double get_a2() const { return a2_; }
+    double get_cutoff() const { return cutoff_; }
 
     void set_d(double d) { d_ = d; }
     void set_s6(double s6) { s6_ = s6; }
@@ -103,6 +119,7 @@ class Dispersion {
     void set_s8(double s8) { s8_ = s8; }
     void set_a1(double a1) { a1_ = a1; }
     void set_a2(double a2) { a2_ = a2; }
+    void set_cutoff(double cutoff) { cutoff_ = cutoff; }
 
     std::string print_energy(std::shared_ptr<Molecule> m);
     std::string print_gradient(std::shared_ptr<Molecule> m);
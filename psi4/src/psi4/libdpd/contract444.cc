@@ -32,13 +32,39 @@
 */
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
 #include "dpd.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// MKL Header
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 namespace psi {
 
+
+namespace {
+
+/* A contiguous range of rows of the product block of irrep Hx. Each slice
+** is contracted with a single-threaded DGEMM. */
+struct contract444_slice {
+    int Hx;
+    int row_start;
+    int nrows;
+    double flops;
+};
+
+}  // namespace
+
 /* dpd_contract444(): Contracts a pair of four-index quantities to
 ** give a product four-index quantity.
 **
@@ -53,12 +79,19 @@ namespace psi {
 **                 ket) of Y is the target pair.
 **   double alpha: A prefactor for the product alpha * X * Y.
 **   double beta: A prefactor for the target beta * Z.
+**
+** The irrep blocks of the product are independent. If all of them fit in
+** core at once, they are read up front and their DGEMMs are run
+** concurrently, each block receiving a share of the threads proportional
+** to its flop count. Otherwise the blocks are contracted one at a time and
+** the out-of-core buckets of X are double-buffered, so that the next
+** bucket is read while the current one is contracted.
 */
 
 int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int target_Y, double alpha, double beta) {
     int n, Hx, Hy, Hz, GX, GY, GZ, nirreps, Xtrans, Ytrans, *numlinks, symlink;
     long int size_Y, size_Z, size_file_X_row;
-    int incore, nbuckets;
+    int incore, nbuckets, prefetch, nthreads;
     long int memoryd, core, rows_per_bucket, rows_left, memtotal;
     int nrows, ncols, nlinks;
 #if DPD_DEBUG
@@ -112,27 +145,129 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     }
 #endif
 
+    /* Irreps of the Y and Z blocks that pair with each irrep of X */
+    std::vector<int> Hy_of(nirreps), Hz_of(nirreps);
     for (Hx = 0; Hx < nirreps; Hx++) {
         if ((!Xtrans) && (!Ytrans)) {
-            Hy = Hx ^ GX;
-            Hz = Hx;
+            Hy_of[Hx] = Hx ^ GX;
+            Hz_of[Hx] = Hx;
         } else if ((!Xtrans) && (Ytrans)) {
-            Hy = Hx ^ GX ^ GY;
-            Hz = Hx;
+            Hy_of[Hx] = Hx ^ GX ^ GY;
+            Hz_of[Hx] = Hx;
         } else if ((Xtrans) && (!Ytrans)) {
-            Hy = Hx;
-            Hz = Hx ^ GX;
+            Hy_of[Hx] = Hx;
+            Hz_of[Hx] = Hx ^ GX;
         } else /* (( Xtrans)&&( Ytrans))*/ {
-            Hy = Hx ^ GY;
-            Hz = Hx ^ GX;
+            Hy_of[Hx] = Hx ^ GY;
+            Hz_of[Hx] = Hx ^ GX;
+        }
+    }
+
+    nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+
+    if (nthreads > 1 && nirreps > 1) {
+        int nblocks = 0;
+        double flops_total = 0.0;
+        std::vector<double> flops(nirreps, 0.0);
+
+        memtotal = 0;
+        for (Hx = 0; Hx < nirreps; Hx++) {
+            Hy = Hy_of[Hx];
+            Hz = Hz_of[Hx];
+            memtotal += ((long)X->params->rowtot[Hx]) * ((long)X->params->coltot[Hx ^ GX]);
+            memtotal += ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
+            memtotal += ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
+
+            nrows = Z->params->rowtot[Hz];
+            ncols = Z->params->coltot[Hz ^ GZ];
+            nlinks = numlinks[Hx ^ symlink];
+            if (nrows && ncols && nlinks) {
+                flops[Hx] = 2.0 * nrows * ncols * nlinks;
+                flops_total += flops[Hx];
+                nblocks++;
+            }
         }
 
+        if (nblocks > 1 && memtotal <= dpd_memfree()) {
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                Hy = Hy_of[Hx];
+                Hz = Hz_of[Hx];
+                buf4_mat_irrep_init(X, Hx);
+                buf4_mat_irrep_rd(X, Hx);
+                buf4_mat_irrep_init(Y, Hy);
+                buf4_mat_irrep_rd(Y, Hy);
+                buf4_mat_irrep_init(Z, Hz);
+                if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
+            }
+
+            /* Cut each block into row slices, the number of slices being
+               proportional to the block's share of the total flops */
+            std::vector<contract444_slice> slices;
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                if (flops[Hx] == 0.0) continue;
+                nrows = Z->params->rowtot[Hz_of[Hx]];
+                int nslices = (int)std::lround(nthreads * flops[Hx] / flops_total);
+                nslices = std::max(1, std::min(nslices, nrows));
+                for (int s = 0; s < nslices; s++) {
+                    int row_start = (int)(((long)s * nrows) / nslices);
+                    int row_end = (int)(((long)(s + 1) * nrows) / nslices);
+                    slices.push_back({Hx, row_start, row_end - row_start, flops[Hx] * (row_end - row_start) / nrows});
+                }
+            }
+            /* Largest first, so the dynamic schedule balances the tail */
+            std::sort(slices.begin(), slices.end(),
+                      [](const contract444_slice &a, const contract444_slice &b) { return a.flops > b.flops; });
+
+// Each slice runs a serial DGEMM; don't let MKL spawn threads underneath ours
+#ifdef USING_LAPACK_MKL
+            int old_threads = mkl_get_max_threads();
+            mkl_set_num_threads(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+            for (size_t s = 0; s < slices.size(); s++) {
+                int h = slices[s].Hx;
+                int hy = Hy_of[h];
+                int hz = Hz_of[h];
+                int row_start = slices[s].row_start;
+                /* Rows of Z are columns of X when X is transposed */
+                double *Xp = Xtrans ? &(X->matrix[h][0][row_start]) : &(X->matrix[h][row_start][0]);
+                C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', slices[s].nrows, Z->params->coltot[hz ^ GZ],
+                        numlinks[h ^ symlink], alpha, Xp, X->params->coltot[h ^ GX], &(Y->matrix[hy][0][0]),
+                        Y->params->coltot[hy ^ GY], beta, &(Z->matrix[hz][row_start][0]), Z->params->coltot[hz ^ GZ]);
+            }
+
+#ifdef USING_LAPACK_MKL
+            mkl_set_num_threads(old_threads);
+#endif
+
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                Hy = Hy_of[Hx];
+                Hz = Hz_of[Hx];
+                buf4_mat_irrep_close(X, Hx);
+                buf4_mat_irrep_wrt(Z, Hz);
+                buf4_mat_irrep_close(Y, Hy);
+                buf4_mat_irrep_close(Z, Hz);
+            }
+
+            return 0;
+        }
+    }
+
+    for (Hx = 0; Hx < nirreps; Hx++) {
+        Hy = Hy_of[Hx];
+        Hz = Hz_of[Hx];
+
         size_Y = ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
         size_Z = ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
         size_file_X_row = ((long)X->file.params->coltot[0]); /* need room for a row of the X->file */
 
         memoryd = dpd_memfree() - (size_Y + size_Z + size_file_X_row);
 
+        prefetch = 0;
         if (X->params->rowtot[Hx] && X->params->coltot[Hx ^ GX]) {
             if (X->params->coltot[Hx ^ GX])
                 rows_per_bucket = memoryd / X->params->coltot[Hx ^ GX];
@@ -145,10 +280,19 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
 
             nbuckets = (int)ceil((double)X->params->rowtot[Hx] / (double)rows_per_bucket);
 
-            rows_left = X->params->rowtot[Hx] % rows_per_bucket;
-
             incore = 1;
             if (nbuckets > 1) incore = 0;
+
+            /* Split the memory between two buckets, so that the next one
+               can be read while the current one is contracted */
+            if (!incore && rows_per_bucket > 1) {
+                rows_per_bucket /= 2;
+                nbuckets = (int)ceil((double)X->params->rowtot[Hx] / (double)rows_per_bucket);
+                prefetch = 1;
+            }
+
+            /* number of rows in the last bucket */
+            rows_left = X->params->rowtot[Hx] - (nbuckets - 1) * rows_per_bucket;
         } else
             incore = 1;
 
@@ -206,25 +350,38 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                 dpd_error("contract444", "outfile");
             }
 
-            buf4_mat_irrep_init_block(X, Hx, rows_per_bucket);
+            int nbuf = prefetch ? 2 : 1;
+            double **bucket[2];
+            for (int b = 0; b < nbuf; b++) {
+                buf4_mat_irrep_init_block(X, Hx, rows_per_bucket);
+                bucket[b] = X->matrix[Hx];
+            }
 
             buf4_mat_irrep_init(Y, Hy);
             buf4_mat_irrep_rd(Y, Hy);
             buf4_mat_irrep_init(Z, Hz);
             if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
 
+            /* The buf4 reads into X->matrix[Hx], so point it at the bucket being filled */
+            auto read_bucket = [&](int m) {
+                X->matrix[Hx] = bucket[m % nbuf];
+                buf4_mat_irrep_rd_block(X, Hx, m * rows_per_bucket, (m < (nbuckets - 1)) ? rows_per_bucket : rows_left);
+            };
+
+            read_bucket(0);
             for (n = 0; n < nbuckets; n++) {
-                if (n < (nbuckets - 1))
-                    buf4_mat_irrep_rd_block(X, Hx, n * rows_per_bucket, rows_per_bucket);
-                else
-                    buf4_mat_irrep_rd_block(X, Hx, n * rows_per_bucket, rows_left);
+                double **Xbucket = bucket[n % nbuf];
+
+                /* Only the reader touches the buf4 and PSIO while the DGEMM below runs */
+                std::thread reader;
+                if (prefetch && n < (nbuckets - 1)) reader = std::thread(read_bucket, n + 1);
 
                 if (!Xtrans && Ytrans) {
                     nrows = n < (nbuckets - 1) ? rows_per_bucket : rows_left;
                     ncols = Z->params->coltot[Hz ^ GZ];
                     nlinks = numlinks[Hx ^ symlink];
                     if (nrows && ncols && nlinks)
-                        C_DGEMM('n', 't', nrows, ncols, nlinks, alpha, &(X->matrix[Hx][0][0]), numlinks[Hx ^ symlink],
+                        C_DGEMM('n', 't', nrows, ncols, nlinks, alpha, &(Xbucket[0][0]), numlinks[Hx ^ symlink],
                                 &(Y->matrix[Hy][0][0]), numlinks[Hx ^ symlink], beta,
                                 &(Z->matrix[Hz][n * rows_per_bucket][0]), Z->params->coltot[Hz ^ GZ]);
                 } else if (Xtrans && !Ytrans) {
@@ -236,14 +393,21 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                     ncols = Z->params->coltot[Hz ^ GZ];
                     nlinks = n < (nbuckets - 1) ? rows_per_bucket : rows_left;
                     if (nrows && ncols && nlinks)
-                        C_DGEMM('t', 'n', nrows, ncols, nlinks, alpha, &(X->matrix[Hx][0][0]),
-                                X->params->coltot[Hx ^ GX], &(Y->matrix[Hy][n * rows_per_bucket][0]),
-                                Y->params->coltot[Hy ^ GY], (n == 0 ? beta : 1.0), &(Z->matrix[Hz][0][0]),
-                                Z->params->coltot[Hz ^ GZ]);
+                        C_DGEMM('t', 'n', nrows, ncols, nlinks, alpha, &(Xbucket[0][0]), X->params->coltot[Hx ^ GX],
+                                &(Y->matrix[Hy][n * rows_per_bucket][0]), Y->params->coltot[Hy ^ GY],
+                                (n == 0 ? beta : 1.0), &(Z->matrix[Hz][0][0]), Z->params->coltot[Hz ^ GZ]);
                 }
+
+                if (reader.joinable())
+                    reader.join();
+                else if (n < (nbuckets - 1))
+                    read_bucket(n + 1);
             }
 
-            buf4_mat_irrep_close_block(X, Hx, rows_per_bucket);
+            for (int b = 0; b < nbuf; b++) {
+                X->matrix[Hx] = bucket[b];
+                buf4_mat_irrep_close_block(X, Hx, rows_per_bucket);
+            }
 
             buf4_mat_irrep_close(Y, Hy);
             buf4_mat_irrep_wrt(Z, Hz);
@@ -87,6 +87,8 @@ void MemDFJK::preiterations() {
     }
     dfh_->set_omega_alpha(omega_alpha_);
     dfh_->set_omega_beta(omega_beta_);
+    dfh_->set_local_K(local_K_);
+    dfh_->set_local_K_domains(local_K_cutoff_, local_K_radius_);
 
     // we need to prepare the AOs here, and that's it.
     // DFHelper takes care of all the housekeeping
@@ -119,7 +121,12 @@ void MemDFJK::print_header() const {
         outfile->Printf("    Algorithm:          %11s\n", (dfh_->get_AO_core() ? "Core" : "Disk"));
         outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
         outfile->Printf("    Mask sparsity (%%):  %11.4f\n", 100. * dfh_->ao_sparsity());
-        outfile->Printf("    Fitting Condition:  %11.0E\n\n", condition_);
+        outfile->Printf("    Fitting Condition:  %11.0E\n", condition_);
+        if (local_K_) {
+            outfile->Printf("    Local K Cutoff:     %11.0E\n", local_K_cutoff_);
+            outfile->Printf("    Local K Radius:     %11.3f\n", local_K_radius_);
+        }
+        outfile->Printf("\n");
 
         outfile->Printf("   => Auxiliary Basis Set <=\n\n");
         auxiliary_->print_by_level("outfile", print_);
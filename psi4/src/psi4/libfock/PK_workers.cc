@@ -859,8 +859,8 @@ PKWrkrIWL::PKWrkrIWL(std::shared_ptr<BasisSet> primary, SharedSieve sieve, std::
 
     // Constructing the IWL buffers needed
     for (int i = 0; i < nbuf(); ++i) {
-        IWL_J_.push_back(new IWLAsync_PK(&((*addresses_)[2 * i]), AIO(), target_file()));
-        IWL_K_.push_back(new IWLAsync_PK(&((*addresses_)[2 * i + 1]), AIO(), K_file_));
+        IWL_J_.push_back(new IWLAsync_PK(&((*addresses_)[2 * i]), AIO(), target_file(), buf_size()));
+        IWL_K_.push_back(new IWLAsync_PK(&((*addresses_)[2 * i + 1]), AIO(), K_file_, buf_size()));
     }
 }
 
@@ -880,7 +880,7 @@ void PKWrkrIWL::allocate_wK(std::shared_ptr<std::vector<size_t>> pos, int wKfile
 
     // Constructing the IWL buffers needed for wK
     for (int i = 0; i < nbuf(); ++i) {
-        IWL_wK_.push_back(new IWLAsync_PK(&((*addresses_wK_)[i]), AIO(), wK_file_));
+        IWL_wK_.push_back(new IWLAsync_PK(&((*addresses_wK_)[i]), AIO(), wK_file_, buf_size()));
     }
 }
 
@@ -992,11 +992,11 @@ void PKWrkrIWL::flush_wK() {
     }
 }
 
-IWLAsync_PK::IWLAsync_PK(size_t *address, std::shared_ptr<AIOHandler> AIO, int itap) {
+IWLAsync_PK::IWLAsync_PK(size_t *address, std::shared_ptr<AIOHandler> AIO, int itap, size_t ints_per_buf) {
     itap_ = itap;
     address_ = address;
     AIO_ = AIO;
-    ints_per_buf_ = IWL_INTS_PER_BUF;
+    ints_per_buf_ = ints_per_buf;
     nints_ = 0;
     idx_ = 0;
     labels_[0] = new Label[4 * ints_per_buf_];
@@ -190,7 +190,7 @@ class IWLAsync_PK {
 
    public:
     /// Constructor, also allocates the arrays
-    IWLAsync_PK(size_t* address, std::shared_ptr<AIOHandler> AIO, int itap);
+    IWLAsync_PK(size_t* address, std::shared_ptr<AIOHandler> AIO, int itap, size_t ints_per_buf);
     /// Destructor, also deallocates the arrays
     ~IWLAsync_PK();
 
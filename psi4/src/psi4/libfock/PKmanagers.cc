@@ -923,7 +923,9 @@ PKMgrYoshimine::PKMgrYoshimine(std::shared_ptr<PSIO> psio, std::shared_ptr<Basis
     iwl_file_J_ = PSIF_SO_PKSUPER1;
     iwl_file_K_ = PSIF_SO_PKSUPER2;
     iwl_file_wK_ = PSIF_WK_PK;
-    ints_per_buf_ = IWL_INTS_PER_BUF;
+    // Buckets hold fewer integrals than regular IWL buffers so that, with 32-bit labels,
+    // they take no more memory than they did with 16-bit ones
+    ints_per_buf_ = IWL_INTS_PER_BUF * (4 * sizeof(short int) + sizeof(Value)) / (4 * sizeof(Label) + sizeof(Value));
     iwl_int_size_ = ints_per_buf_ * (4L * sizeof(Label) + sizeof(Value)) + 2L * sizeof(int);
 }
 
@@ -1245,6 +1247,7 @@ void PKMgrYoshimine::close_iwl_buckets_wK() { psio()->close(iwl_file_wK_, 1); }
 
 void PKMgrYoshimine::generate_J_PK(double* twoel_ints, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_J_, 0.0, 1, 0);
+    inbuf.ints_per_buffer() = ints_per_buf_;
 
     int idx, id;
     size_t p, q, r, s;
@@ -1302,6 +1305,7 @@ void PKMgrYoshimine::generate_J_PK(double* twoel_ints, size_t max_size) {
 
 void PKMgrYoshimine::generate_K_PK(double* twoel_ints, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_K_, 0.0, 1, 0);
+    inbuf.ints_per_buffer() = ints_per_buf_;
 
     int idx, id;
     size_t p, q, r, s;
@@ -1382,6 +1386,7 @@ void PKMgrYoshimine::generate_K_PK(double* twoel_ints, size_t max_size) {
 
 void PKMgrYoshimine::generate_wK_PK(double* twoel_ints, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_wK_, 0.0, 1, 0);
+    inbuf.ints_per_buffer() = ints_per_buf_;
 
     int idx, id;
     size_t p, q, r, s;
@@ -40,6 +40,9 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/matrix.h"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -2765,6 +2768,11 @@ void StandardGridMgr::Initialize_SG1() {
     }
 }
 
+// Cutoff radius of the smoother Becke (SBECKE) scheme
+static const double SBeckeRCut = 5.0;
+// Relative size below which a cell function is dropped under the Becke, Treutler and naive schemes
+static const double BeckeWeightTol = 1.0E-14;
+
 class NuclearWeightMgr {
     enum NuclearSchemes { NAIVE, BECKE, TREUTLER, STRATMANN, SBECKE };  // Must match the nuclearschemenames array!
     static const char *nuclearschemenames[];
@@ -2774,6 +2782,14 @@ class NuclearWeightMgr {
     std::shared_ptr<Molecule> molecule_;
     double **inv_dist_;
     double **amatrix_;
+    // Becke-type schemes: atoms further than becke_ratio_ times the nearest atom's distance are negligible
+    double becke_ratio_;
+    // Uniform cell list over the atoms, used to find the atoms near a point
+    double cell_size_;
+    double cell_origin_[3];
+    int ncell_[3];
+    std::vector<int> cell_start_;  // Offset of each cell's atoms in cell_atoms_, plus a final entry
+    std::vector<int> cell_atoms_;
     ////
 
     inline double distToAtom(MassPoint mp, int A) const {
@@ -2782,6 +2798,12 @@ class NuclearWeightMgr {
                     (mp.z - molecule_->z(A)) * (mp.z - molecule_->z(A)));
     }
 
+    void buildCellList();
+    void atomsNearPoint(MassPoint mp, double radius, std::vector<int> &atoms) const;
+    bool isScreened() const { return scheme_ == STRATMANN || scheme_ == SBECKE; }
+    double saturationRadius(double r) const;
+    double computeScreenedNuclearWeight(MassPoint mp, int A) const;
+
     static double BeckeMu(double ri, double rj, double inv_rij);
     static double SmoothBeckeMu(double ri, double rj, double inv_rij);
     static double BeckeStepFunction(double x);
@@ -2841,6 +2863,30 @@ NuclearWeightMgr::NuclearWeightMgr(std::shared_ptr<Molecule> mol, int scheme) {
     } else {
         throw PSIEXCEPTION("Unrecognized weighting scheme!");
     }
+
+    if (!isScreened()) {
+        // The Becke step is within BeckeWeightTol of 0 or 1 once |nu| >= xtol
+        double lo = 0.0, hi = 1.0;
+        for (int iter = 0; iter < 100; iter++) {
+            double mid = (lo + hi) / 2;
+            if (BeckeStepFunction(mid) > BeckeWeightTol)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        double xtol = hi;
+        // nu(i,j) = mu + a(1-mu^2) <= mu + amax(1-mu^2), which is -xtol at mu = mucut
+        double amax = 0;
+        for (int i = 0; i < natom; i++)
+            for (int j = 0; j < natom; j++) amax = std::max(amax, amatrix_[i][j]);
+        double mucut = (amax == 0) ? -xtol : (1 - sqrt(1 + 4 * amax * (amax + xtol))) / (2 * amax);
+        // mu(i,j) <= (ri - rj) / (ri + rj) by the triangle inequality, which is mucut at rj = ri * becke_ratio_
+        becke_ratio_ = (1 - mucut) / (1 + mucut);
+    } else {
+        becke_ratio_ = 0;
+    }
+
+    buildCellList();
 }
 
 NuclearWeightMgr::~NuclearWeightMgr() {
@@ -2859,8 +2905,7 @@ double NuclearWeightMgr::BeckeMu(double ri, double rj, double inv_rij) { return
 
 // smoother Becke (SBECKE) integration after Ochsenfeld J. Chem. Phys. 149, 204111 (2018); doi: 10.1063/1.5049435
 double NuclearWeightMgr::SmoothBeckeMu(double ri, double rj, double inv_rij) {
-    static double RCut = 5.0;
-    static double invRCut = 1.0 / RCut;
+    static double invRCut = 1.0 / SBeckeRCut;
     double mu = (ri - rj) * std::max(inv_rij, invRCut);
     if (mu <= -1.0) {
         return -1.0;
@@ -2947,32 +2992,188 @@ double NuclearWeightMgr::GetStratmannCutoff(int A) const {
     return distToNearestAtom * (1 + mucutoff) / 2;
 }
 
-double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratmannCutoff) const {
-    // Stratmann's step function gives us this handy check
-    if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff) return 1;
-
+void NuclearWeightMgr::buildCellList() {
     int natom = molecule_->natom();
-    // Find the distance from point mp to each atom in the molecule.
-    std::vector<double> dist(natom);
-    for (int l = 0; l < natom; l++) dist[l] = distToAtom(mp, l);
+    double lo[3] = {molecule_->x(0), molecule_->y(0), molecule_->z(0)};
+    double hi[3] = {lo[0], lo[1], lo[2]};
+    for (int A = 1; A < natom; A++) {
+        double xyz[3] = {molecule_->x(A), molecule_->y(A), molecule_->z(A)};
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], xyz[d]);
+            hi[d] = std::max(hi[d], xyz[d]);
+        }
+    }
+
+    // A few bohr per cell, grown for sparse systems so that the cell count stays proportional to the atom count
+    cell_size_ = 3.0;
+    size_t ncell;
+    do {
+        ncell = 1;
+        for (int d = 0; d < 3; d++) {
+            ncell_[d] = (int)((hi[d] - lo[d]) / cell_size_) + 1;
+            ncell *= ncell_[d];
+        }
+        if (ncell > 8L * natom + 64L) cell_size_ *= 1.5;
+    } while (ncell > 8L * natom + 64L);
+    for (int d = 0; d < 3; d++) cell_origin_[d] = lo[d];
+
+    std::vector<int> cell_of_atom(natom);
+    cell_start_.assign(ncell + 1, 0);
+    for (int A = 0; A < natom; A++) {
+        double xyz[3] = {molecule_->x(A), molecule_->y(A), molecule_->z(A)};
+        int c[3];
+        for (int d = 0; d < 3; d++) c[d] = std::min(ncell_[d] - 1, (int)((xyz[d] - lo[d]) / cell_size_));
+        cell_of_atom[A] = (c[0] * ncell_[1] + c[1]) * ncell_[2] + c[2];
+        cell_start_[cell_of_atom[A] + 1]++;
+    }
+    for (size_t c = 0; c < ncell; c++) cell_start_[c + 1] += cell_start_[c];
+    cell_atoms_.resize(natom);
+    std::vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (int A = 0; A < natom; A++) cell_atoms_[fill[cell_of_atom[A]]++] = A;
+}
+
+// All atoms within `radius' of the point, in increasing index order
+void NuclearWeightMgr::atomsNearPoint(MassPoint mp, double radius, std::vector<int> &atoms) const {
+    atoms.clear();
+    double p[3] = {mp.x, mp.y, mp.z};
+    int clo[3], chi[3];
+    for (int d = 0; d < 3; d++) {
+        // Clamp in floating point first; the radius may be huge for points far from every atom
+        double flo = std::floor((p[d] - radius - cell_origin_[d]) / cell_size_);
+        double fhi = std::floor((p[d] + radius - cell_origin_[d]) / cell_size_);
+        clo[d] = (int)std::max(0.0, std::min(flo, (double)ncell_[d]));
+        chi[d] = (int)std::max(-1.0, std::min(fhi, (double)(ncell_[d] - 1)));
+        if (clo[d] > chi[d]) return;
+    }
+    for (int cx = clo[0]; cx <= chi[0]; cx++) {
+        for (int cy = clo[1]; cy <= chi[1]; cy++) {
+            for (int cz = clo[2]; cz <= chi[2]; cz++) {
+                int c = (cx * ncell_[1] + cy) * ncell_[2] + cz;
+                for (int n = cell_start_[c]; n < cell_start_[c + 1]; n++) {
+                    if (distToAtom(mp, cell_atoms_[n]) <= radius) atoms.push_back(cell_atoms_[n]);
+                }
+            }
+        }
+    }
+    std::sort(atoms.begin(), atoms.end());
+}
+
+// For the screened schemes, the step function saturates: if a point lies a distance r from atom i,
+// every atom j further than saturationRadius(r) from the point has s(i,j) == 1 exactly, and the
+// cell function of j vanishes exactly whenever i is the atom nearest to the point. The Becke step
+// never saturates; there s(i,j) is within BeckeWeightTol of 1 beyond saturationRadius(r).
+double NuclearWeightMgr::saturationRadius(double r) const {
+    // A small relative margin keeps the bound safe against rounding in mu
+    const double margin = 1.0 + 1.0E-10;
+    if (!isScreened()) {
+        return r * becke_ratio_ * margin;
+    } else if (scheme_ == STRATMANN) {
+        // mu(i,j) >= (rj - ri) / (ri + rj) by the triangle inequality, and s == 1 once mu <= -0.64
+        const double a = 0.64;
+        return r * (1 + a) / (1 - a) * margin;
+    } else {
+        // mu(i,j) is clipped to -1 once rj - ri >= RCut, where nu == -1 and s == 1
+        return (r + SBeckeRCut) * margin;
+    }
+}
+
+double NuclearWeightMgr::computeScreenedNuclearWeight(MassPoint mp, int A) const {
+    // The nearest atom is no further away than the parent atom
+    std::vector<int> near;
+    double rA = distToAtom(mp, A);
+    atomsNearPoint(mp, rA * (1.0 + 1.0E-10), near);
+    double rnear = rA;
+    for (int l : near) rnear = std::min(rnear, distToAtom(mp, l));
+
+    // Only atoms within saturationRadius(rnear) have a nonzero cell function, and only atoms within
+    // saturationRadius of those can change it, so the rest of the molecule contributes exact zeros and ones.
+    double rcontrib = saturationRadius(rnear);
+    atomsNearPoint(mp, saturationRadius(rcontrib), near);
+    size_t nnear = near.size();
+    std::vector<double> dist(nnear);
+    for (size_t l = 0; l < nnear; l++) dist[l] = distToAtom(mp, near[l]);
 
     double (*stepFunction)(double) = (scheme_ == STRATMANN) ? StratmannStepFunction : BeckeStepFunction;
     double (*muFunction)(double, double, double) = (scheme_ == SBECKE) ? SmoothBeckeMu : BeckeMu;
 
-    double numerator = NAN;
+    // Same loop as in computeNuclearWeight, visiting the atoms in the same order, less the skipped factors
+    double numerator = 0;
     double denominator = 0;
-    for (int i = 0; i < natom; i++) {
+    for (size_t ii = 0; ii < nnear; ii++) {
+        if (dist[ii] > rcontrib) continue;
+        int i = near[ii];
+        double rsat = saturationRadius(dist[ii]);
         double prod = 1;
-        for (int j = 0; j < natom; j++) {
-            if (i == j) continue;
-            // if ( dist[j] >= (dist[i]+RCut) ) continue; // sugested cutoff
-            double mu = muFunction(dist[i], dist[j], inv_dist_[i][j]);
+        for (size_t jj = 0; jj < nnear; jj++) {
+            if (ii == jj || dist[jj] > rsat) continue;
+            int j = near[jj];
+            double mu = muFunction(dist[ii], dist[jj], inv_dist_[i][j]);
             double nu = mu + amatrix_[i][j] * (1 - mu * mu);  // Adjust for ratios between atomic radii
             double s = stepFunction(nu);
             prod *= s;
-            if (prod == 0) break;  // Under the Stratmann scheme, this should happen often enough to be worth the test.
+            if (prod == 0) break;
+        }
+        if (i == A) numerator = prod;
+        denominator += prod;
+    }
+    return numerator / denominator;
+}
+
+double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratmannCutoff) const {
+    // Stratmann's step function gives us this handy check
+    if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff) return 1;
+
+    // Schemes whose step function saturates only need the atoms near the point
+    if (isScreened()) return computeScreenedNuclearWeight(mp, A);
+
+    // The Becke step function never saturates exactly. Atoms further than saturationRadius(rnear)
+    // from the point, rnear being the distance to the nearest atom, have cell functions below
+    // BeckeWeightTol and change the factors of the nearer atoms by less than BeckeWeightTol, so
+    // only the atoms inside that radius are visited. The nearest atom is no further away than the parent.
+    std::vector<int> near;
+    double rA = distToAtom(mp, A);
+    atomsNearPoint(mp, rA * (1.0 + 1.0E-10), near);
+    double rnear = rA;
+    for (int l : near) rnear = std::min(rnear, distToAtom(mp, l));
+    atomsNearPoint(mp, saturationRadius(rnear), near);
+    // A parent outside the radius has a negligible cell function
+    if (!std::binary_search(near.begin(), near.end(), A)) return 0.0;
+
+    // Visiting the atoms nearest to the point first, the product for an atom far from the point
+    // falls off after a few factors. The cell function of the nearest atom is a lower bound on the
+    // denominator, and cell functions below BeckeWeightTol times it are dropped, which changes the
+    // weight by a relative amount of order natom * BeckeWeightTol.
+    size_t nnear = near.size();
+    std::vector<double> dist(nnear);
+    for (size_t l = 0; l < nnear; l++) dist[l] = distToAtom(mp, near[l]);
+    std::vector<size_t> order(nnear);
+    for (size_t l = 0; l < nnear; l++) order[l] = l;
+    std::sort(order.begin(), order.end(), [&dist](size_t k, size_t l) { return dist[k] < dist[l]; });
+
+    auto cellFunction = [&](size_t ii, double cutoff) {
+        int i = near[ii];
+        double prod = 1;
+        for (size_t jj : order) {
+            if (ii == jj) continue;
+            int j = near[jj];
+            double mu = BeckeMu(dist[ii], dist[jj], inv_dist_[i][j]);
+            double nu = mu + amatrix_[i][j] * (1 - mu * mu);  // Adjust for ratios between atomic radii
+            prod *= BeckeStepFunction(nu);
+            if (prod < cutoff) return 0.0;
         }
-        if (i == A) numerator = prod;  // Meow: If we do `i == A' first, then we can check to see if numerator == 0...
+        return prod;
+    };
+
+    size_t nearest = order[0];
+    double pnearest = cellFunction(nearest, 0.0);
+    double cutoff = BeckeWeightTol * pnearest;
+
+    double numerator = NAN;
+    double denominator = 0;
+    for (size_t ii = 0; ii < nnear; ii++) {
+        int i = near[ii];
+        double prod = (ii == nearest) ? pnearest : cellFunction(ii, (i == A) ? 0.0 : cutoff);
+        if (i == A) numerator = prod;
         denominator += prod;
     }
     return numerator / denominator;
@@ -3722,6 +3923,9 @@ int RadialPruneMgr::ShellPruning(int ri, int Z, int radial_pts) {
 void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
     options_ = opt;                                                // Save a copy
     std::vector<std::vector<MassPoint>> grid(molecule_->natom());  // This is just for the first pass.
+    // Unpartitioned points per atom, and which of them survive the weight cutoff, if keep_unpartitioned_
+    std::vector<std::vector<MassPoint>> raw(molecule_->natom());
+    std::vector<std::vector<int>> kept(molecule_->natom());
 
     OrientationMgr std_orientation(molecule_);
     RadialPruneMgr prune(opt);
@@ -3814,9 +4018,13 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
                     MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z,
                                     wr[i] * anggrid[j].w};
                     mp = std_orientation.MoveIntoPosition(mp, A);
+                    if (keep_unpartitioned_) raw[A].push_back(mp);
                     mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff);  // This ain't gonna fly. Must abate this
                                                                                // mickey mouse a most rikky tikki tavi.
-                    if (std::abs(mp.w) > weightcut) {grid[A].push_back(mp);}
+                    if (std::abs(mp.w) > weightcut) {
+                        grid[A].push_back(mp);
+                        if (keep_unpartitioned_) kept[A].push_back(raw[A].size() - 1);
+                    }
                     assert(!std::isnan(mp.w));
                 }
             }
@@ -3833,10 +4041,14 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
 
             for (int i = 0; i < npts; i++) {
                 MassPoint mp = std_orientation.MoveIntoPosition(sg[i], A);
+                if (keep_unpartitioned_) raw[A].push_back(mp);
                 mp.w *= nuc.computeNuclearWeight(
                     mp, A,
                     stratmannCutoff);  // This ain't gonna fly. Must abate this mickey mouse a most rikky tikki tavi.
-                if (std::abs(mp.w) > weightcut) {grid[A].push_back(mp);}
+                if (std::abs(mp.w) > weightcut) {
+                    grid[A].push_back(mp);
+                    if (keep_unpartitioned_) kept[A].push_back(raw[A].size() - 1);
+                }
                 assert(!std::isnan(mp.w));
             }
         }
@@ -3932,10 +4144,22 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
             y_[grid_vector_index] = grid[i][j].y;
             z_[grid_vector_index] = grid[i][j].z;
             w_[grid_vector_index] = grid[i][j].w;
-            index_[i] = grid_vector_index;
+            index_[grid_vector_index] = grid_vector_index;
             ++grid_vector_index;
         }
     }
+
+    unpartitioned_points_.clear();
+    unpartitioned_atoms_.clear();
+    slow_to_unpartitioned_.clear();
+    if (keep_unpartitioned_) {
+        for (int A = 0; A < grid.size(); A++) {
+            int offset = unpartitioned_points_.size();
+            for (int k : kept[A]) slow_to_unpartitioned_.push_back(offset + k);
+            unpartitioned_points_.insert(unpartitioned_points_.end(), raw[A].begin(), raw[A].end());
+            unpartitioned_atoms_.insert(unpartitioned_atoms_.end(), raw[A].size(), A);
+        }
+    }
 }
 
 void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt, const std::vector<std::vector<double>> &rs,
@@ -4145,6 +4369,118 @@ void BasisExtents::computeExtents() {
             maxR_ = Rc;
         }
     }
+
+    buildCellList();
+}
+void BasisExtents::buildCellList() {
+    cell_start_.clear();
+    cell_shells_.clear();
+    cell_maxR_.clear();
+
+    // Infinite extents (delta = 0) leave nothing to screen
+    int nshell = primary_->nshell();
+    if (nshell == 0 || maxR_ == std::numeric_limits<double>::max()) return;
+
+    double *Rp = shell_extents_->pointer();
+    Vector3 v0 = primary_->shell(0).center();
+    double lo[3] = {v0[0], v0[1], v0[2]};
+    double hi[3] = {v0[0], v0[1], v0[2]};
+    for (int P = 1; P < nshell; P++) {
+        Vector3 v = primary_->shell(P).center();
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], v[d]);
+            hi[d] = std::max(hi[d], v[d]);
+        }
+    }
+
+    // Start from a few bohr per cell and coarsen until the cell count is proportional to the shell count
+    cell_size_ = 4.0;
+    size_t ncell;
+    do {
+        ncell = 1;
+        for (int d = 0; d < 3; d++) {
+            ncell_[d] = (int)((hi[d] - lo[d]) / cell_size_) + 1;
+            ncell *= ncell_[d];
+        }
+        if (ncell > 8L * nshell + 64L) cell_size_ *= 1.5;
+    } while (ncell > 8L * nshell + 64L);
+    for (int d = 0; d < 3; d++) cell_origin_[d] = lo[d];
+
+    std::vector<int> cell_of_shell(nshell);
+    cell_start_.assign(ncell + 1, 0);
+    cell_maxR_.assign(ncell, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        Vector3 v = primary_->shell(P).center();
+        int c[3];
+        for (int d = 0; d < 3; d++) c[d] = std::min(ncell_[d] - 1, (int)((v[d] - lo[d]) / cell_size_));
+        int cell = (c[0] * ncell_[1] + c[1]) * ncell_[2] + c[2];
+        cell_of_shell[P] = cell;
+        cell_start_[cell + 1]++;
+        cell_maxR_[cell] = std::max(cell_maxR_[cell], Rp[P]);
+    }
+    for (size_t c = 0; c < ncell; c++) cell_start_[c + 1] += cell_start_[c];
+    cell_shells_.resize(nshell);
+    std::vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (int P = 0; P < nshell; P++) cell_shells_[fill[cell_of_shell[P]]++] = P;
+}
+void BasisExtents::shells_near_sphere(const Vector3 &center, double R, std::vector<int> &shells) const {
+    shells.clear();
+    double *Rp = shell_extents_->pointer();
+
+    if (cell_start_.empty()) {
+        for (int P = 0; P < primary_->nshell(); P++) shells.push_back(P);
+        return;
+    }
+
+    // Only cells within R + maxR of the center can hold a shell that reaches the sphere
+    double reach = R + maxR_;
+    int clo[3], chi[3];
+    for (int d = 0; d < 3; d++) {
+        double flo = std::floor((center[d] - reach - cell_origin_[d]) / cell_size_);
+        double fhi = std::floor((center[d] + reach - cell_origin_[d]) / cell_size_);
+        clo[d] = (int)std::max(0.0, std::min(flo, (double)ncell_[d]));
+        chi[d] = (int)std::max(-1.0, std::min(fhi, (double)(ncell_[d] - 1)));
+        if (clo[d] > chi[d]) return;
+    }
+
+    for (int cx = clo[0]; cx <= chi[0]; cx++) {
+        for (int cy = clo[1]; cy <= chi[1]; cy++) {
+            for (int cz = clo[2]; cz <= chi[2]; cz++) {
+                int c = (cx * ncell_[1] + cy) * ncell_[2] + cz;
+                if (cell_start_[c] == cell_start_[c + 1]) continue;
+
+                // Distance from the center to the cell's box against the cell's largest extent
+                int cc[3] = {cx, cy, cz};
+                double D2 = 0.0;
+                for (int d = 0; d < 3; d++) {
+                    double blo = cell_origin_[d] + cc[d] * cell_size_;
+                    double bhi = blo + cell_size_;
+                    double t = std::max(0.0, std::max(blo - center[d], center[d] - bhi));
+                    D2 += t * t;
+                }
+                double Rcell = R + cell_maxR_[c];
+                if (D2 > Rcell * Rcell) continue;
+
+                for (int n = cell_start_[c]; n < cell_start_[c + 1]; n++) {
+                    int P = cell_shells_[n];
+                    Vector3 v = primary_->shell(P).center();
+                    double Reff = sqrt((v[0] - center[0]) * (v[0] - center[0]) + (v[1] - center[1]) * (v[1] - center[1]) +
+                                       (v[2] - center[2]) * (v[2] - center[2]));
+                    if (Reff <= R + Rp[P]) shells.push_back(P);
+                }
+            }
+        }
+    }
+    std::sort(shells.begin(), shells.end());
+}
+void BasisExtents::set_basis(std::shared_ptr<BasisSet> primary) {
+    if (primary->nshell() != primary_->nshell()) {
+        throw PSIEXCEPTION("BasisExtents::set_basis: New basis does not have the same shells.");
+    }
+    primary_ = primary;
+    // Copies of this object share the extents vector, so detach it before the cell list is rebuilt
+    shell_extents_ = std::make_shared<Vector>(*shell_extents_);
+    buildCellList();
 }
 void BasisExtents::print(std::string out) {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
@@ -4213,14 +4549,13 @@ void BlockOPoints::populate() {
     std::shared_ptr<BasisSet> primary = extents_->basis();
     double *Rp = extents_->shell_extents()->pointer();
 
+    // First pass: shells reaching the bounding sphere of the point cloud, from the spatial index
+    std::vector<int> candidates;
+    extents_->shells_near_sphere(xc_, R_, candidates);
+
     // Determine significant shell/functions
-    for (int P = 0; P < primary->nshell(); P++) {
-        // First pass: mean center/max spread of point clould
+    for (int P : candidates) {
         Vector3 v = primary->shell(P).center();
-        double Reff = sqrt((v[0] - xc_[0]) * (v[0] - xc_[0]) + (v[1] - xc_[1]) * (v[1] - xc_[1]) +
-                           (v[2] - xc_[2]) * (v[2] - xc_[2]));
-
-        if (Reff > R_ + Rp[P]) continue;
 
         // Second pass: check individual points
         double Rp2 = Rp[P] * Rp[P];
@@ -4274,6 +4609,39 @@ void BlockOPoints::print(std::string out, int print) {
         printer->Printf("\n\n");
     }
 }
+namespace {
+// A DFT grid kept for reuse at nearby geometries (DFT_GRID_REUSE)
+struct ReusableGrid {
+    /// Atomic numbers and geometry the grid was built for
+    std::vector<int> Z;
+    std::vector<Vector3> geometry;
+    /// Angular momenta and exponents of the basis, which fix the extents
+    std::vector<double> shells;
+    /// Points before nuclear partitioning, their parent atoms, and their block (-1 if in none)
+    std::vector<MassPoint> points;
+    std::vector<int> atoms;
+    std::vector<int> leaf;
+    int nleaf;
+    std::shared_ptr<Matrix> orientation;
+    std::vector<std::shared_ptr<RadialGrid>> radial_grids;
+    std::vector<std::vector<std::shared_ptr<SphericalGrid>>> spherical_grids;
+    std::shared_ptr<BasisExtents> extents;
+};
+// One grid per set of grid options, so that the VV10 grid does not evict the XC grid
+std::map<std::string, std::shared_ptr<ReusableGrid>> reusable_grids;
+
+std::vector<double> shell_signature(std::shared_ptr<BasisSet> basis) {
+    std::vector<double> signature;
+    for (int P = 0; P < basis->nshell(); P++) {
+        const GaussianShell &shell = basis->shell(P);
+        signature.push_back(shell.am());
+        signature.insert(signature.end(), shell.exps(), shell.exps() + shell.nprimitive());
+        signature.insert(signature.end(), shell.coefs(), shell.coefs() + shell.nprimitive());
+    }
+    return signature;
+}
+}  // namespace
+
 DFTGrid::DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary, Options &options)
     : MolecularGrid(molecule), primary_(primary), options_(options) {
     std::map<std::string, std::string> opts_map;
@@ -4287,6 +4655,8 @@ DFTGrid::DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> p
 }
 DFTGrid::~DFTGrid() {}
 
+void DFTGrid::clear_reusable_grids() { reusable_grids.clear(); }
+
 void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map,
                                    std::map<std::string, std::string> opts_map) {
     std::map<std::string, std::string> full_str_options;
@@ -4353,15 +4723,227 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map,
         throw PSIEXCEPTION("Invalid number of spherical points (not a Lebedev number)");
     }
 
-    MolecularGrid::buildGridFromOptions(opt);
-
     // Blocking/sieving info
     int max_points = full_int_options["DFT_BLOCK_MAX_POINTS"];
     int min_points = full_int_options["DFT_BLOCK_MIN_POINTS"];
     double max_radius = options_.get_double("DFT_BLOCK_MAX_RADIUS");
     double epsilon = options_.get_double("DFT_BASIS_TOLERANCE");
+
+    bool reuse = options_.get_bool("DFT_GRID_REUSE");
+#ifdef USING_BrianQC
+    // BrianQC is handed the grid while it is built
+    if (brianEnable and brianEnableDFT) reuse = false;
+#endif
+    std::string key;
+    if (reuse) {
+        std::stringstream ss;
+        ss.precision(17);
+        ss << opt.bs_radius_alpha << " " << opt.pruning_alpha << " " << opt.radscheme << " " << opt.prunefunction
+           << " " << opt.nucscheme << " " << opt.namedGrid << " " << opt.nradpts << " " << opt.nangpts << " "
+           << opt.weights_cutoff << " " << opt.prunescheme << " " << max_points << " " << min_points << " "
+           << max_radius << " " << epsilon << " " << options_.get_str("DFT_BLOCK_SCHEME") << " " << primary_->name();
+        key = ss.str();
+        if (reuseGrid(key, opt, max_points, min_points, max_radius)) return;
+    }
+
+    keep_unpartitioned_ = reuse;
+    MolecularGrid::buildGridFromOptions(opt);
+
     auto extents = std::make_shared<BasisExtents>(primary_, epsilon);
     postProcess(extents, max_points, min_points, max_radius);
+
+    if (reuse) storeGrid(key);
+}
+
+void DFTGrid::storeGrid(const std::string &key) {
+    auto grid = std::make_shared<ReusableGrid>();
+    for (int A = 0; A < molecule_->natom(); A++) {
+        grid->Z.push_back(molecule_->true_atomic_number(A));
+        grid->geometry.push_back(molecule_->xyz(A));
+    }
+    grid->shells = shell_signature(primary_);
+
+    grid->points = std::move(unpartitioned_points_);
+    grid->atoms = std::move(unpartitioned_atoms_);
+    grid->leaf.assign(grid->points.size(), -1);
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        size_t offset = blocks_[b]->x() - x_;
+        for (size_t Q = 0; Q < blocks_[b]->npoints(); Q++) {
+            grid->leaf[slow_to_unpartitioned_[index_[offset + Q]]] = b;
+        }
+    }
+    grid->nleaf = blocks_.size();
+    slow_to_unpartitioned_.clear();
+    unpartitioned_points_.clear();
+    unpartitioned_atoms_.clear();
+
+    grid->orientation = orientation_;
+    grid->radial_grids = radial_grids_;
+    grid->spherical_grids = spherical_grids_;
+    grid->extents = extents_;
+    reusable_grids[key] = grid;
+}
+
+bool DFTGrid::reuseGrid(const std::string &key, MolecularGridOptions const &opt, int max_points, int min_points,
+                        double max_radius) {
+    auto it = reusable_grids.find(key);
+    if (it == reusable_grids.end()) return false;
+    const ReusableGrid &grid = *it->second;
+
+    // Same atoms, same basis, and no atom further than the threshold from where the grid was built
+    int natom = molecule_->natom();
+    if (grid.Z.size() != (size_t)natom) return false;
+    double threshold = options_.get_double("DFT_GRID_REUSE_THRESHOLD");
+    std::vector<Vector3> geometry(natom), shift(natom);
+    for (int A = 0; A < natom; A++) {
+        if (grid.Z[A] != molecule_->true_atomic_number(A)) return false;
+        geometry[A] = molecule_->xyz(A);
+        shift[A] = geometry[A] - grid.geometry[A];
+        if (shift[A].norm() > threshold) return false;
+    }
+    if (grid.shells != shell_signature(primary_)) return false;
+
+    MolecularGrid::options_ = opt;
+    MolecularGrid::primary_ = primary_;
+    orientation_ = grid.orientation;
+    radial_grids_ = grid.radial_grids;
+    spherical_grids_ = grid.spherical_grids;
+    extents_ = std::make_shared<BasisExtents>(*grid.extents);
+    extents_->set_basis(primary_);
+
+    // => Move the points rigidly with their atoms and repartition them <= //
+    NuclearWeightMgr nuc(molecule_, opt.nucscheme);
+    std::vector<double> stratmannCutoff(natom);
+    for (int A = 0; A < natom; A++) stratmannCutoff[A] = nuc.GetStratmannCutoff(A);
+    double Rmax = extents_->maxR();
+    double Rmax2 = (Rmax == std::numeric_limits<double>::max() ? Rmax : Rmax * Rmax);
+
+    size_t nraw = grid.points.size();
+    std::vector<MassPoint> points(nraw);
+    std::vector<char> keep(nraw);
+#pragma omp parallel for schedule(dynamic, 256) num_threads(Process::environment.get_n_threads())
+    for (size_t p = 0; p < nraw; p++) {
+        int A = grid.atoms[p];
+        MassPoint mp = grid.points[p];
+        mp.x += shift[A][0];
+        mp.y += shift[A][1];
+        mp.z += shift[A][2];
+        mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff[A]);
+        assert(!std::isnan(mp.w));
+        bool significant = std::abs(mp.w) > opt.weights_cutoff;
+
+        // Same sieve as remove_distant_points
+        if (significant && Rmax2 != std::numeric_limits<double>::max()) {
+            double R2 = std::numeric_limits<double>::max();
+            for (int B = 0; B < natom; B++) {
+                const Vector3 &v = geometry[B];
+                R2 = std::min(R2, (mp.x - v[0]) * (mp.x - v[0]) + (mp.y - v[1]) * (mp.y - v[1]) +
+                                      (mp.z - v[2]) * (mp.z - v[2]));
+            }
+            significant = (R2 <= Rmax2);
+        }
+        points[p] = mp;
+        keep[p] = significant;
+    }
+
+    // => Incremental blocking <= //
+    auto blocking_start = std::chrono::steady_clock::now();
+
+    // Points keep their previous block; the few that had none (last bucket) are blocked afresh
+    int nleaf = grid.nleaf;
+    std::vector<size_t> leaf_start(nleaf + 2, 0);
+    for (size_t p = 0; p < nraw; p++) {
+        if (keep[p]) leaf_start[(grid.leaf[p] < 0 ? nleaf : grid.leaf[p]) + 1]++;
+    }
+    for (int b = 0; b <= nleaf; b++) leaf_start[b + 1] += leaf_start[b];
+    size_t nold = leaf_start[nleaf];
+    size_t nnew = leaf_start[nleaf + 1] - nold;
+
+    std::vector<double> xnew(nnew), ynew(nnew), znew(nnew), wnew(nnew);
+    std::vector<int> inew(nnew);
+    std::vector<size_t> fill(leaf_start.begin(), leaf_start.end() - 1);
+    npoints_ = nold + nnew;
+    x_ = new double[npoints_];
+    y_ = new double[npoints_];
+    z_ = new double[npoints_];
+    w_ = new double[npoints_];
+    index_ = new int[npoints_];
+    for (size_t p = 0; p < nraw; p++) {
+        if (!keep[p]) continue;
+        if (grid.leaf[p] < 0) {
+            size_t Q = fill[nleaf]++ - nold;
+            xnew[Q] = points[p].x;
+            ynew[Q] = points[p].y;
+            znew[Q] = points[p].z;
+            wnew[Q] = points[p].w;
+            inew[Q] = p;
+        } else {
+            size_t Q = fill[grid.leaf[p]]++;
+            x_[Q] = points[p].x;
+            y_[Q] = points[p].y;
+            z_[Q] = points[p].z;
+            w_[Q] = points[p].w;
+            index_[Q] = p;
+        }
+    }
+
+    std::vector<std::shared_ptr<BlockOPoints>> new_blocks;
+    if (nnew) {
+        std::shared_ptr<GridBlocker> blocker;
+        if (options_.get_str("DFT_BLOCK_SCHEME") == "NAIVE") {
+            blocker = std::make_shared<NaiveGridBlocker>(nnew, xnew.data(), ynew.data(), znew.data(), wnew.data(),
+                                                         inew.data(), max_points, min_points, max_radius, extents_);
+        } else {
+            blocker = std::make_shared<OctreeGridBlocker>(nnew, xnew.data(), ynew.data(), znew.data(), wnew.data(),
+                                                          inew.data(), max_points, min_points, max_radius, extents_);
+        }
+        blocker->block();
+        if ((size_t)blocker->npoints() != nnew) throw PSIEXCEPTION("DFTGrid: Blocker lost grid points on reuse.");
+
+        // Move the new points behind the old ones and rebuild their blocks there, numbered after the old blocks
+        std::copy(blocker->x(), blocker->x() + nnew, x_ + nold);
+        std::copy(blocker->y(), blocker->y() + nnew, y_ + nold);
+        std::copy(blocker->z(), blocker->z() + nnew, z_ + nold);
+        std::copy(blocker->w(), blocker->w() + nnew, w_ + nold);
+        std::copy(blocker->index(), blocker->index() + nnew, index_ + nold);
+        for (const auto &block : blocker->blocks()) {
+            size_t off = nold + (block->x() - blocker->x());
+            new_blocks.push_back(std::make_shared<BlockOPoints>(nleaf + block->index(), block->npoints(), &x_[off],
+                                                                &y_[off], &z_[off], &w_[off], extents_));
+        }
+        delete[] blocker->x();
+        delete[] blocker->y();
+        delete[] blocker->z();
+        delete[] blocker->w();
+        delete[] blocker->index();
+    }
+
+    std::vector<std::shared_ptr<BlockOPoints>> leaf_blocks(nleaf);
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+    for (int b = 0; b < nleaf; b++) {
+        size_t n = leaf_start[b + 1] - leaf_start[b];
+        if (!n) continue;
+        size_t off = leaf_start[b];
+        leaf_blocks[b] = std::make_shared<BlockOPoints>(b, n, &x_[off], &y_[off], &z_[off], &w_[off], extents_);
+    }
+    blocks_.clear();
+    for (int b = 0; b < nleaf; b++) {
+        if (leaf_blocks[b] && leaf_blocks[b]->local_nbf()) blocks_.push_back(leaf_blocks[b]);
+    }
+    blocks_.insert(blocks_.end(), new_blocks.begin(), new_blocks.end());
+
+    max_points_ = 0;
+    max_functions_ = 0;
+    collocation_size_ = 0;
+    for (const auto &block : blocks_) {
+        max_points_ = std::max(max_points_, (int)block->npoints());
+        max_functions_ = std::max(max_functions_, (int)block->local_nbf());
+        collocation_size_ += block->local_nbf() * block->npoints();
+    }
+
+    blocking_time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - blocking_start).count();
+    reused_ = true;
+    return true;
 }
 
 PseudospectralGrid::PseudospectralGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
@@ -4400,7 +4982,14 @@ void PseudospectralGrid::buildGridFromOptions() {
 }
 
 MolecularGrid::MolecularGrid(std::shared_ptr<Molecule> molecule)
-    : debug_(0), molecule_(molecule), npoints_(0), max_points_(0), max_functions_(0) {}
+    : debug_(0),
+      molecule_(molecule),
+      npoints_(0),
+      max_points_(0),
+      max_functions_(0),
+      blocking_time_(0.0),
+      reused_(false),
+      keep_unpartitioned_(false) {}
 MolecularGrid::~MolecularGrid() {
     if (npoints_) {
         delete[] x_;
@@ -4415,6 +5004,8 @@ void MolecularGrid::block(int max_points, int min_points, double max_radius) {
     // Hack
     Options &options_ = Process::environment.options;
 
+    auto blocking_start = std::chrono::steady_clock::now();
+
     // Reassign
     std::shared_ptr<GridBlocker> blocker;
     if (options_.get_str("DFT_BLOCK_SCHEME") == "NAIVE") {
@@ -4452,6 +5043,8 @@ void MolecularGrid::block(int max_points, int min_points, double max_radius) {
     for (size_t i = 0; i < block.size(); i++) {
         blocks_.push_back(block[i]);
     }
+
+    blocking_time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - blocking_start).count();
 }
 
 void MolecularGrid::remove_distant_points(double Rmax) {
@@ -4516,6 +5109,8 @@ void MolecularGrid::print(std::string out, int /*print*/) const {
     printer->Printf("    Max Points             = %14d\n", max_points_);
     printer->Printf("    Max Functions          = %14d\n", max_functions_);
     printer->Printf("    Weights Tolerance      = %14.2E\n", options_.weights_cutoff);
+    printer->Printf("    Blocking Time [s]      = %14.3f\n", blocking_time_);
+    if (reused_) printer->Printf("    Grid Reused            = %14s\n", "RIGID");
     // printer->Printf("    Collocation Size [MiB] = %14d\n", (int)((8.0 * collocation_size_) / (1024.0 * 1024.0)));
     printer->Printf("\n");
     Process::environment.globals["XC GRID TOTAL POINTS"] = npoints_;
@@ -4778,22 +5373,34 @@ void OctreeGridBlocker::block() {
         if (block.size()) unique_block++;
     }
 
-    blocks_.clear();
+    // Populating the blocks is independent work, so build them in parallel and filter in order
+    size_t nleaves = completed_tree.size();
+    std::vector<int> leaf_offsets(nleaves);
     index = 0;
+    for (size_t A = 0; A < nleaves; A++) {
+        leaf_offsets[A] = index;
+        index += completed_tree[A].size();
+    }
+    std::vector<std::shared_ptr<BlockOPoints>> leaf_blocks(nleaves);
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+    for (size_t A = 0; A < nleaves; A++) {
+        size_t n = completed_tree[A].size();
+        if (!n) continue;
+        int off = leaf_offsets[A];
+        leaf_blocks[A] = std::make_shared<BlockOPoints>(A, n, &x_[off], &y_[off], &z_[off], &w_[off], extents_);
+    }
+
+    blocks_.clear();
     max_points_ = 0;
-    for (size_t A = 0; A < completed_tree.size(); A++) {
-        std::vector<int> block = completed_tree[A];
-        if (!block.size()) continue;
-        auto bop =
-            std::make_shared<BlockOPoints>(A, block.size(), &x_[index], &y_[index], &z_[index], &w_[index], extents_);
+    for (size_t A = 0; A < nleaves; A++) {
+        auto bop = leaf_blocks[A];
         // BlockOPoints construction performs additional pruning. Need to test if any points remain.
-        if (bop->local_nbf()) {
+        if (bop && bop->local_nbf()) {
             blocks_.push_back(bop);
-            if ((size_t)max_points_ < block.size()) {
-                max_points_ = block.size();
+            if ((size_t)max_points_ < completed_tree[A].size()) {
+                max_points_ = completed_tree[A].size();
             }
         }
-        index += block.size();
     }
 
     max_functions_ = 0;
@@ -77,6 +77,10 @@ class MolecularGrid {
     int max_functions_;
     // The total collocation size
     size_t collocation_size_;
+    /// Wall time spent blocking the grid [s]
+    double blocking_time_;
+    /// Was this grid moved from a previous geometry rather than built?
+    bool reused_;
     /// Full x points.
     double* x_;
     /// Full y points.
@@ -105,6 +109,15 @@ class MolecularGrid {
     /// BasisSet from extents_
     std::shared_ptr<BasisSet> primary_;
 
+    /// Record the points before nuclear partitioning in buildGridFromOptions?
+    bool keep_unpartitioned_;
+    /// Points before nuclear partitioning, if kept
+    std::vector<MassPoint> unpartitioned_points_;
+    /// Parent atom of each unpartitioned point, if kept
+    std::vector<int> unpartitioned_atoms_;
+    /// Unpartitioned point of each slow index, if kept
+    std::vector<int> slow_to_unpartitioned_;
+
     /// Sieve and block
     void postProcess(std::shared_ptr<BasisExtents> extents, int max_points, int min_points, double max_radius);
     void remove_distant_points(double Rcut);
@@ -207,6 +220,11 @@ class DFTGrid : public MolecularGrid {
     std::shared_ptr<BasisSet> primary_;
     /// Master builder methods
     void buildGridFromOptions(std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map);
+    /// Move the grid stored under key to this geometry, if it is close enough (DFT_GRID_REUSE)
+    bool reuseGrid(const std::string& key, MolecularGridOptions const& opt, int max_points, int min_points,
+                   double max_radius);
+    /// Store this grid under key for reuse at later geometries (DFT_GRID_REUSE)
+    void storeGrid(const std::string& key);
     /// The Options object
     Options& options_;
 
@@ -215,6 +233,9 @@ class DFTGrid : public MolecularGrid {
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
             std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map, Options& options);
     ~DFTGrid() override;
+
+    /// Drop the grids kept for reuse (DFT_GRID_REUSE); called from psi4.core.clean()
+    static void clear_reusable_grids();
 };
 
 class RadialGrid {
@@ -426,8 +447,23 @@ class BasisExtents {
     /// Maximum extent
     double maxR_;
 
+    /// Edge length of the cells binning the shell centers
+    double cell_size_;
+    /// Lower corner of the cell grid
+    double cell_origin_[3];
+    /// Number of cells along each axis
+    int ncell_[3];
+    /// Offset of each cell's shells in cell_shells_, plus a final entry (empty if no cell grid)
+    std::vector<int> cell_start_;
+    /// Shells binned by cell, in increasing order within each cell
+    std::vector<int> cell_shells_;
+    /// Largest extent of the shells in each cell
+    std::vector<double> cell_maxR_;
+
     /// Recompute and shell_extents_
     void computeExtents();
+    /// Bin the shell centers into cells, called after the extents change
+    void buildCellList();
 
    public:
     BasisExtents(std::shared_ptr<BasisSet> primary, double delta);
@@ -440,6 +476,8 @@ class BasisExtents {
         delta_ = delta;
         computeExtents();
     }
+    /// Rebind to a basis with the same shells on moved centers, keeping the extents
+    void set_basis(std::shared_ptr<BasisSet> primary);
 
     /// The cutoff value
     double delta() const { return delta_; }
@@ -449,6 +487,8 @@ class BasisExtents {
     std::shared_ptr<Vector> shell_extents() const { return shell_extents_; }
     /// Maximum spatial extent over all atoms
     double maxR() const { return maxR_; }
+    /// Shells whose significant extent reaches the sphere of radius R about center, in increasing order
+    void shells_near_sphere(const Vector3& center, double R, std::vector<int>& shells) const;
 };
 }
 #endif
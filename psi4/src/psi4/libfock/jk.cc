@@ -97,6 +97,10 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         DiskDFJK* jk = new DiskDFJK(primary, auxiliary);
         _set_dfjk_options<DiskDFJK>(jk, options);
         if (options["DF_INTS_IO"].has_changed()) jk->set_df_ints_io(options.get_str("DF_INTS_IO"));
+        if (options.get_bool("DF_LOCAL_K")) {
+            delete jk;
+            throw PSIEXCEPTION("JK::build_JK: DF_LOCAL_K is only available with SCF_TYPE MEM_DF.");
+        }
 
         return std::shared_ptr<JK>(jk);
 
@@ -105,6 +109,8 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         jk->set_wcombine(true);
         _set_dfjk_options<MemDFJK>(jk, options);
         if (options["WCOMBINE"].has_changed()) { jk->set_wcombine(options.get_bool("WCOMBINE")); }
+        jk->set_local_K(options.get_bool("DF_LOCAL_K"), options.get_double("DF_LOCAL_K_CUTOFF"),
+                        options.get_double("DF_LOCAL_K_RADIUS"));
 
         return std::shared_ptr<JK>(jk);
     } else if (jk_type == "PK") {
@@ -1044,6 +1044,12 @@ class PSI_API MemDFJK : public JK {
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_ = 1.0E-12;
+    /// Fit K in local domains?
+    bool local_K_ = false;
+    /// Fraction of an orbital's charge that puts an atom in its fitting domain
+    double local_K_cutoff_ = 1.0E-4;
+    /// Radius (bohr) around the orbital's atoms spanned by its fitting domain
+    double local_K_radius_ = 4.0;
 
     // => Required Algorithm-Specific Methods <= //
 
@@ -1090,6 +1096,20 @@ class PSI_API MemDFJK : public JK {
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
 
+    /**
+     * Fit the exchange of each occupied orbital only with the auxiliary
+     * functions near it, for near-linear scaling K
+     * @param local_K fit K in local domains?
+     * @param cutoff atoms with at least this fraction of an orbital's
+     *        Mulliken charge are in its domain
+     * @param radius the domain holds all atoms within radius (bohr) of those
+     */
+    void set_local_K(bool local_K, double cutoff, double radius) {
+        local_K_ = local_K;
+        local_K_cutoff_ = cutoff;
+        local_K_radius_ = radius;
+    }
+
     /**
  * A set_do_wK function that affects the dfhelper object.
  * used to control wK workflow.
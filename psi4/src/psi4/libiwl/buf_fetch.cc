@@ -32,12 +32,18 @@
 */
 #include <cstdio>
 #include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
 #include "iwl.h"
 #include "iwl.hpp"
 
 namespace psi {
 
 void IWL::fetch() {
+    if (compact_) {
+        iwl_fetch_compact(psio_, itap_, &lastbuf_, &inbuf_, labels_, values_, &bufpos_);
+        idx_ = 0;
+        return;
+    }
     psio_->read(itap_, IWL_KEY_BUF, (char *)&(lastbuf_), sizeof(int), bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *)&(inbuf_), sizeof(int), bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *)labels_, ints_per_buf_ * 4 * sizeof(Label), bufpos_, &bufpos_);
@@ -53,6 +59,12 @@ void IWL::fetch() {
 ** \ingroup IWL
 */
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf) {
+    if (Buf->compact) {
+        iwl_fetch_compact(_default_psio_lib_.get(), Buf->itap, &Buf->lastbuf, &Buf->inbuf, Buf->labels, Buf->values,
+                          &Buf->bufpos);
+        Buf->idx = 0;
+        return;
+    }
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->lastbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->inbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)Buf->labels, Buf->ints_per_buf * 4 * sizeof(Label), Buf->bufpos,
@@ -51,6 +51,8 @@ IWL::IWL() {
     lastbuf_ = 0;
     inbuf_ = 0;
     idx_ = 0;
+    compact_ = true;
+    fp32_cutoff_ = 0.0;
 }
 
 IWL::IWL(PSIO *psio, int it, double coff, int oldfile, int readflag) : keep_(true) {
@@ -65,6 +67,7 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag) {
     bufpos_ = PSIO_ZERO;
     ints_per_buf_ = IWL_INTS_PER_BUF;
     cutoff_ = coff;
+    fp32_cutoff_ = Process::environment.options.get_double("IWL_FP32_CUTOFF");
     bufszc_ = 2 * sizeof(int) + ints_per_buf_ * 4 * sizeof(Label) + ints_per_buf_ * sizeof(Value);
     lastbuf_ = 0;
     inbuf_ = 0;
@@ -78,8 +81,10 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag) {
 
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
+    /*! New files are written in the compact format; old ones are read in the format they were written in */
     psio_->open(itap_, oldfile ? PSIO_OPEN_OLD : PSIO_OPEN_NEW);
-    if (oldfile && (psio_->tocscan(itap_, IWL_KEY_BUF) == nullptr)) {
+    compact_ = !oldfile || (psio_->tocscan(itap_, IWL_KEY_CBUF) != nullptr);
+    if (oldfile && !compact_ && (psio_->tocscan(itap_, IWL_KEY_BUF) == nullptr)) {
         outfile->Printf("iwl_buf_init: Can't open file %d\n", itap_);
         psio_->close(itap_, 0);
         return;
@@ -113,6 +118,7 @@ void PSI_API iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff, int oldf
     Buf->bufpos = PSIO_ZERO;
     Buf->ints_per_buf = IWL_INTS_PER_BUF;
     Buf->cutoff = cutoff;
+    Buf->fp32_cutoff = Process::environment.options.get_double("IWL_FP32_CUTOFF");
     Buf->bufszc = 2 * sizeof(int) + Buf->ints_per_buf * 4 * sizeof(Label) + Buf->ints_per_buf * sizeof(Value);
     Buf->lastbuf = 0;
     Buf->inbuf = 0;
@@ -125,7 +131,8 @@ void PSI_API iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff, int oldf
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
     psio_open(Buf->itap, oldfile ? PSIO_OPEN_OLD : PSIO_OPEN_NEW);
-    if (oldfile && (psio_tocscan(Buf->itap, IWL_KEY_BUF) == nullptr)) {
+    Buf->compact = !oldfile || (psio_tocscan(Buf->itap, IWL_KEY_CBUF) != nullptr);
+    if (oldfile && !Buf->compact && (psio_tocscan(Buf->itap, IWL_KEY_BUF) == nullptr)) {
         outfile->Printf("iwl_buf_init: Can't open file %d\n", Buf->itap);
         psio_close(Buf->itap, 0);
         return;
@@ -32,12 +32,17 @@
 */
 #include <cstdio>
 #include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
 #include "iwl.h"
 #include "iwl.hpp"
 
 namespace psi {
 
 void IWL::put() {
+    if (compact_) {
+        iwl_put_compact(psio_, itap_, lastbuf_, inbuf_, labels_, values_, fp32_cutoff_, &bufpos_);
+        return;
+    }
     psio_->write(itap_, IWL_KEY_BUF, (char *)&(lastbuf_), sizeof(int), bufpos_, &(bufpos_));
     psio_->write(itap_, IWL_KEY_BUF, (char *)&(inbuf_), sizeof(int), bufpos_, &(bufpos_));
     psio_->write(itap_, IWL_KEY_BUF, (char *)labels_, ints_per_buf_ * 4 * sizeof(Label), bufpos_, &(bufpos_));
@@ -52,6 +57,11 @@ void IWL::put() {
 ** \ingroup IWL
 */
 void iwl_buf_put(struct iwlbuf *Buf) {
+    if (Buf->compact) {
+        iwl_put_compact(_default_psio_lib_.get(), Buf->itap, Buf->lastbuf, Buf->inbuf, Buf->labels, Buf->values,
+                        Buf->fp32_cutoff, &Buf->bufpos);
+        return;
+    }
     psio_write(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->lastbuf), sizeof(int), Buf->bufpos, &(Buf->bufpos));
     psio_write(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->inbuf), sizeof(int), Buf->bufpos, &(Buf->bufpos));
     psio_write(Buf->itap, IWL_KEY_BUF, (char *)Buf->labels, Buf->ints_per_buf * 4 * sizeof(Label), Buf->bufpos,
@@ -0,0 +1,180 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+  \file
+  \brief Compact on-disk encoding of IWL buffers
+  \ingroup IWL
+
+  A compact buffer is stored as four ints (lastbuf, inbuf, number of label
+  bytes, number of value bytes) followed by the two byte streams. Each
+  integral starts with a flag byte telling which of its four labels differ
+  from those of the previous integral; only those follow, as zigzag varints.
+  Integrals are usually written with the last index running fastest, so most
+  of them carry a single one-byte label. A flag bit marks values stored in
+  single precision, which is used for integrals smaller in magnitude than the
+  writer's fp32 cutoff (option IWL_FP32_CUTOFF, zero by default, i.e. never).
+*/
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "iwl.h"
+#include "iwl.hpp"
+
+namespace psi {
+
+namespace {
+
+const unsigned char IWL_FLAG_FP32 = 0x10;
+
+inline void put_varint(std::vector<unsigned char>& out, Label label) {
+    unsigned int v = (static_cast<unsigned int>(label) << 1) ^ static_cast<unsigned int>(label >> 31);
+    while (v >= 0x80) {
+        out.push_back(static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(v));
+}
+
+inline Label get_varint(const unsigned char*& in) {
+    unsigned int v = 0;
+    int shift = 0;
+    while (*in & 0x80) {
+        v |= static_cast<unsigned int>(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    v |= static_cast<unsigned int>(*in++) << shift;
+    return static_cast<Label>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+}  // namespace
+
+/*!
+** iwl_pack()
+**
+** Encode the first n integrals of an IWL buffer into the label and value
+** byte streams of a compact buffer. Integrals smaller in magnitude than
+** fp32_cutoff are stored in single precision.
+** \ingroup IWL
+*/
+void iwl_pack(const Label* labels, const Value* values, int n, double fp32_cutoff, std::vector<unsigned char>& lab,
+              std::vector<unsigned char>& val) {
+    lab.clear();
+    val.clear();
+    lab.reserve(3 * static_cast<size_t>(n));
+    val.reserve(sizeof(Value) * static_cast<size_t>(n));
+
+    const Label* prev = nullptr;
+    for (int i = 0; i < n; ++i) {
+        const Label* cur = &labels[4 * i];
+        unsigned char flag = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (prev == nullptr || cur[k] != prev[k]) flag |= static_cast<unsigned char>(1 << k);
+        }
+        Value value = values[i];
+        if (std::fabs(value) < fp32_cutoff) flag |= IWL_FLAG_FP32;
+
+        lab.push_back(flag);
+        for (int k = 0; k < 4; ++k) {
+            if (flag & (1 << k)) put_varint(lab, cur[k]);
+        }
+
+        if (flag & IWL_FLAG_FP32) {
+            float f = static_cast<float>(value);
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&f);
+            val.insert(val.end(), bytes, bytes + sizeof(float));
+        } else {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+            val.insert(val.end(), bytes, bytes + sizeof(Value));
+        }
+        prev = cur;
+    }
+}
+
+/*!
+** iwl_unpack()
+**
+** Decode n integrals from the byte streams of a compact buffer
+** \ingroup IWL
+*/
+void iwl_unpack(const unsigned char* lab, const unsigned char* val, int n, Label* labels, Value* values) {
+    for (int i = 0; i < n; ++i) {
+        Label* cur = &labels[4 * i];
+        unsigned char flag = *lab++;
+        for (int k = 0; k < 4; ++k) {
+            cur[k] = (flag & (1 << k)) ? get_varint(lab) : cur[k - 4];
+        }
+        if (flag & IWL_FLAG_FP32) {
+            float f;
+            std::memcpy(&f, val, sizeof(float));
+            values[i] = f;
+            val += sizeof(float);
+        } else {
+            std::memcpy(&values[i], val, sizeof(Value));
+            val += sizeof(Value);
+        }
+    }
+}
+
+/*!
+** iwl_put_compact()
+**
+** Write a compact buffer at *bufpos and advance it
+** \ingroup IWL
+*/
+void iwl_put_compact(PSIO* psio, int itap, int lastbuf, int inbuf, const Label* labels, const Value* values,
+                     double fp32_cutoff, psio_address* bufpos) {
+    std::vector<unsigned char> lab, val;
+    iwl_pack(labels, values, inbuf, fp32_cutoff, lab, val);
+
+    int header[4] = {lastbuf, inbuf, static_cast<int>(lab.size()), static_cast<int>(val.size())};
+    psio->write(itap, IWL_KEY_CBUF, (char*)header, 4 * sizeof(int), *bufpos, bufpos);
+    if (!lab.empty()) psio->write(itap, IWL_KEY_CBUF, (char*)lab.data(), lab.size(), *bufpos, bufpos);
+    if (!val.empty()) psio->write(itap, IWL_KEY_CBUF, (char*)val.data(), val.size(), *bufpos, bufpos);
+}
+
+/*!
+** iwl_fetch_compact()
+**
+** Read the compact buffer at *bufpos, decode it and advance *bufpos
+** \ingroup IWL
+*/
+void iwl_fetch_compact(PSIO* psio, int itap, int* lastbuf, int* inbuf, Label* labels, Value* values,
+                       psio_address* bufpos) {
+    int header[4];
+    psio->read(itap, IWL_KEY_CBUF, (char*)header, 4 * sizeof(int), *bufpos, bufpos);
+    *lastbuf = header[0];
+    *inbuf = header[1];
+
+    std::vector<unsigned char> lab(header[2]), val(header[3]);
+    if (header[2]) psio->read(itap, IWL_KEY_CBUF, (char*)lab.data(), lab.size(), *bufpos, bufpos);
+    if (header[3]) psio->read(itap, IWL_KEY_CBUF, (char*)val.data(), val.size(), *bufpos, bufpos);
+    iwl_unpack(lab.data(), val.data(), *inbuf, labels, values);
+}
+}  // namespace psi
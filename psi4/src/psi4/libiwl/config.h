@@ -31,10 +31,11 @@
 
 namespace psi {
 
-typedef short int Label;
+typedef int Label;
 typedef double Value;
 
 #define IWL_KEY_BUF "IWL Buffers"
+#define IWL_KEY_CBUF "IWL Compact Buffers"
 #define IWL_KEY_ONEL "IWL One-electron matrix elements"
 
 #define IWL_INTS_PER_BUF 2980
@@ -39,6 +39,7 @@
 #define _psi_src_lib_libiwl_iwl_h_
 
 #include <cstdio>
+#include <vector>
 #include "psi4/libpsio/psio.h"
 #include "config.h"
 #include "psi4/psi4-dec.h"
@@ -55,8 +56,19 @@ struct iwlbuf {
     int idx;             /* index of integral in current buffer */
     Label *labels;       /* pointer to where integral values begin */
     Value *values;       /* integral values */
+    int compact;         /* are the buffers stored in the compact format? */
+    double fp32_cutoff;  /* smaller integrals are written in single precision */
 };
 
+class PSIO;
+void iwl_pack(const Label *labels, const Value *values, int n, double fp32_cutoff, std::vector<unsigned char> &lab,
+              std::vector<unsigned char> &val);
+void iwl_unpack(const unsigned char *lab, const unsigned char *val, int n, Label *labels, Value *values);
+void iwl_put_compact(PSIO *psio, int itap, int lastbuf, int inbuf, const Label *labels, const Value *values,
+                     double fp32_cutoff, psio_address *bufpos);
+void iwl_fetch_compact(PSIO *psio, int itap, int *lastbuf, int *inbuf, Label *labels, Value *values,
+                       psio_address *bufpos);
+
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf);
 void iwl_buf_put(struct iwlbuf *Buf);
 
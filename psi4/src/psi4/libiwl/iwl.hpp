@@ -50,6 +50,10 @@ class PSI_API IWL {
     PSIO *psio_;
     /*! Flag indicating whether to keep the IWL file or not */
     bool keep_;
+    /*! Are the buffers stored in the compact format? */
+    bool compact_;
+    /*! Integrals smaller than this are written in single precision */
+    double fp32_cutoff_;
 
    public:
     IWL();
@@ -68,6 +72,7 @@ class PSI_API IWL {
     Label *labels() { return labels_; }
     Value *values() { return values_; }
     bool &keep() { return keep_; }
+    bool compact() const { return compact_; }
 
     void init(PSIO *psio, int itap, double cutoff, int oldfile, int readflag);
 
@@ -33,9 +33,13 @@
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libdpd/dpd.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsio/psio.h"
 #include "psi4/psi4-dec.h"
+#include "psi4/psifiles.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
@@ -2558,4 +2562,186 @@ void benchmark_integrals(int max_am, double min_time) {
     }
 }
 
+namespace {
+
+/// Fills every irrep block of a (file-ordered) buf4 with random numbers
+void fill_buf4(dpdbuf4* buf) {
+    for (int h = 0; h < buf->params->nirreps; h++) {
+        global_dpd_->buf4_mat_irrep_init(buf, h);
+        for (int pq = 0; pq < buf->params->rowtot[h]; pq++)
+            for (int rs = 0; rs < buf->params->coltot[h ^ buf->file.my_irrep]; rs++)
+                buf->matrix[h][pq][rs] = rand() / (double)RAND_MAX;
+        global_dpd_->buf4_mat_irrep_wrt(buf, h);
+        global_dpd_->buf4_mat_irrep_close(buf, h);
+    }
+}
+
+}  // namespace
+
+std::map<std::string, std::map<std::string, double> > benchmark_dpd(int nocc, int nvir, double min_time) {
+    if (dpd_list[0] != nullptr || dpd_list[1] != nullptr)
+        throw PSIEXCEPTION("benchmark_dpd: a DPD instance is already active.");
+
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    std::vector<int> files = {PSIF_CC_TMP0, PSIF_CC_TMP1, PSIF_CC_TMP2, PSIF_CC_TMP3};
+    for (int file : files) psio->open(file, PSIO_OPEN_NEW);
+
+    // A single irrep, two orbital spaces: occupied (0) and virtual (1)
+    std::vector<int> occpi = {nocc}, virpi = {nvir};
+    std::vector<int> occsym(nocc, 0), virsym(nvir, 0);
+    std::vector<int*> spaces = {occpi.data(), occsym.data(), virpi.data(), virsym.data()};
+    std::vector<int> cachefiles(PSIO_MAXUNIT, 0);
+    int** cachelist = init_int_matrix(12, 12);
+    dpd_init(0, 1, Process::environment.get_memory(), 0, cachefiles.data(), cachelist, nullptr, 2, spaces);
+
+    const double o = nocc, v = nvir;
+    std::map<std::string, std::map<std::string, double> > results;
+    dpdbuf4 W, T, Z, X, Y;
+    double T_elapsed;
+    size_t rounds;
+    Timer* qq;
+
+    // <ij|kl>, <ij|ab> and the ladder product, [O,O] = 0, [V,V] = 5, [O,V] = 10
+    global_dpd_->buf4_init(&W, PSIF_CC_TMP0, 0, 0, 0, 0, 0, 0, "W <ij|kl>");
+    fill_buf4(&W);
+    global_dpd_->buf4_init(&T, PSIF_CC_TMP1, 0, 0, 5, 0, 5, 0, "T <ij|ab>");
+    fill_buf4(&T);
+    global_dpd_->buf4_init(&Z, PSIF_CC_TMP2, 0, 0, 5, 0, 5, 0, "Z <ij|ab>");
+
+    // Hole-hole ladder, Z(ij,ab) = W(ij,kl) T(kl,ab)
+    T_elapsed = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T_elapsed < min_time || rounds == 0) {
+        global_dpd_->contract444(&W, &T, &Z, 0, 1, 1.0, 0.0);
+        T_elapsed = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["CONTRACT444 (OO,OO x OO,VV)"]["time"] = T_elapsed / (double)rounds;
+    results["CONTRACT444 (OO,OO x OO,VV)"]["flops"] = 2.0 * o * o * o * o * v * v;
+    results["CONTRACT444 (OO,OO x OO,VV)"]["bytes"] = 8.0 * (o * o * o * o + 2.0 * o * o * v * v);
+
+    // Sort <ij|ab> to (ia|jb)
+    T_elapsed = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T_elapsed < min_time || rounds == 0) {
+        global_dpd_->buf4_sort(&T, PSIF_CC_TMP3, prqs, 10, 10, "T (ia|jb)");
+        T_elapsed = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["SORT (pqrs->prqs)"]["time"] = T_elapsed / (double)rounds;
+    results["SORT (pqrs->prqs)"]["flops"] = 0.0;
+    results["SORT (pqrs->prqs)"]["bytes"] = 8.0 * 2.0 * o * o * v * v;
+
+    global_dpd_->buf4_close(&Z);
+    global_dpd_->buf4_close(&T);
+    global_dpd_->buf4_close(&W);
+
+    // Ring term, Z(ia,jb) = X(ia,kc) T(kc,jb)
+    global_dpd_->buf4_init(&X, PSIF_CC_TMP3, 0, 10, 10, 10, 10, 0, "T (ia|jb)");
+    global_dpd_->buf4_init(&Y, PSIF_CC_TMP3, 0, 10, 10, 10, 10, 0, "T (ia|jb)");
+    global_dpd_->buf4_init(&Z, PSIF_CC_TMP2, 0, 10, 10, 10, 10, 0, "Z (ia|jb)");
+    T_elapsed = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T_elapsed < min_time || rounds == 0) {
+        global_dpd_->contract444(&X, &Y, &Z, 0, 0, 1.0, 0.0);
+        T_elapsed = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["CONTRACT444 (OV,OV x OV,OV)"]["time"] = T_elapsed / (double)rounds;
+    results["CONTRACT444 (OV,OV x OV,OV)"]["flops"] = 2.0 * o * v * o * v * o * v;
+    results["CONTRACT444 (OV,OV x OV,OV)"]["bytes"] = 8.0 * 3.0 * o * o * v * v;
+    global_dpd_->buf4_close(&Z);
+    global_dpd_->buf4_close(&Y);
+    global_dpd_->buf4_close(&X);
+
+    dpd_close(0);
+    free_int_matrix(cachelist);
+    for (int file : files) psio->close(file, 0);
+
+    return results;
+}
+
+std::map<std::string, std::map<std::string, double> > benchmark_psio(int N, double min_time) {
+    std::map<std::string, std::map<std::string, double> > results;
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    psio_address psiadd;
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    size_t dim = 1L << N;
+    size_t full_dim = dim * dim;
+    double bytes = full_dim * (double)sizeof(double);
+    double* A = init_array(full_dim);
+
+    psio->open(0, PSIO_OPEN_NEW);
+    psiadd = PSIO_ZERO;
+    psio->write(0, "BENCH_DATA", (char*)&A[0], full_dim * sizeof(double), psiadd, &psiadd);
+
+    T = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T < min_time || rounds == 0) {
+        psiadd = PSIO_ZERO;
+        psio->write(0, "BENCH_DATA", (char*)&A[0], full_dim * sizeof(double), psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["WRITE (Continuous)"]["time"] = T / (double)rounds;
+    results["WRITE (Continuous)"]["bytes"] = bytes;
+
+    T = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T < min_time || rounds == 0) {
+        psiadd = PSIO_ZERO;
+        for (size_t Q = 0; Q < dim; Q++)
+            psio->write(0, "BENCH_DATA", (char*)&A[Q * dim], dim * sizeof(double), psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["WRITE (Blocked)"]["time"] = T / (double)rounds;
+    results["WRITE (Blocked)"]["bytes"] = bytes;
+
+    T = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T < min_time || rounds == 0) {
+        psiadd = PSIO_ZERO;
+        psio->read(0, "BENCH_DATA", (char*)&A[0], full_dim * sizeof(double), psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["READ (Continuous)"]["time"] = T / (double)rounds;
+    results["READ (Continuous)"]["bytes"] = bytes;
+
+    T = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T < min_time || rounds == 0) {
+        psiadd = PSIO_ZERO;
+        for (size_t Q = 0; Q < dim; Q++)
+            psio->read(0, "BENCH_DATA", (char*)&A[Q * dim], dim * sizeof(double), psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    results["READ (Blocked)"]["time"] = T / (double)rounds;
+    results["READ (Blocked)"]["bytes"] = bytes;
+
+    psio->close(0, 0);
+    free(A);
+
+    return results;
+}
+
 }  // namespace psi
@@ -29,6 +29,9 @@
 #ifndef _psi_src_lib_libmints_bench_h
 #define _psi_src_lib_libmints_bench_h
 
+#include <map>
+#include <string>
+
 namespace psi {
 
 /**
@@ -81,6 +84,24 @@ void benchmark_integrals(int max_am, double min_time);
  * \param min_time minimum amount of time to run each routine [s]
  **/
 void benchmark_math(double min_time);
+/**
+ * Time the DPD kernels of the coupled-cluster codes (buf4 sort and
+ * contract444) on random C1 buffers with nocc occupied and nvir
+ * virtual orbitals. Needs all DPD instances to be closed.
+ * \param nocc number of occupied orbitals
+ * \param nvir number of virtual orbitals
+ * \param min_time minimum amount of time to run each routine [s]
+ * \returns operation -> {"time" [s per call], "flops", "bytes"}
+ **/
+std::map<std::string, std::map<std::string, double> > benchmark_dpd(int nocc, int nvir, double min_time);
+/**
+ * Time PSIO reads and writes of one (2^N x 2^N) double matrix,
+ * as one operation and as 2^N row operations
+ * \param N dimension exponent
+ * \param min_time minimum amount of time to run each routine [s]
+ * \returns operation -> {"time" [s per call], "bytes"}
+ **/
+std::map<std::string, std::map<std::string, double> > benchmark_psio(int N, double min_time);
 
 }  // namespace psi
 
@@ -237,6 +237,9 @@ class Libint2TwoElectronInt : public TwoBodyAOInt {
     //! Shell pair information
     ShellPairData pairs12_, pairs34_;
 
+    //! Index into pairs12_ (pairs34_) of shell pair P*nshell2+Q (R*nshell4+S), or -1 if no shell pair data exist
+    std::vector<long int> pairs12_index_, pairs34_index_;
+
     /// The type of shell combo to be handled by this object
     libint2::BraKet braket_;
 
@@ -279,6 +282,9 @@ class Libint2TwoElectronInt : public TwoBodyAOInt {
                                     const libint2::Shell &sh4, const libint2::ShellPair *sp12=nullptr, const libint2::ShellPair *sp34=nullptr) = 0;
 
     void compute_shell_blocks(int shellpair12, int shellpair34, int npair12 = -1, int npair34 = -1) override;
+
+    /// Compute ERIs for a list of quartets of one angular momentum class, reusing the precomputed shell pair data.
+    size_t compute_shell_batch(const std::vector<ShellQuartet> &quartets) override;
 };
 
 class Libint2ERI : public Libint2TwoElectronInt {
@@ -3093,6 +3093,8 @@ Libint2TwoElectronInt::Libint2TwoElectronInt(const Libint2TwoElectronInt &rhs)
 {
     pairs12_ = rhs.pairs12_;
     pairs34_ = rhs.pairs34_;
+    pairs12_index_ = rhs.pairs12_index_;
+    pairs34_index_ = rhs.pairs34_index_;
     zero_vec_ = rhs.zero_vec_;
     for (const auto &e : rhs.engines_) engines_.emplace_back(e);
 }
@@ -3160,6 +3162,18 @@ void Libint2TwoElectronInt::common_init() {
         pairs34_[pair] = std::make_shared<libint2::ShellPair>(basis3()->l2_shell(s3), basis4()->l2_shell(s4),
                                                               std::log(max_engine_precision));
     }
+
+    // Reverse lookup from shell indices to the shell pair data, used by the batched interface
+    const size_t nshell2 = basis2()->nshell();
+    const size_t nshell4 = basis4()->nshell();
+    pairs12_index_.assign(basis1()->nshell() * nshell2, -1L);
+    for (size_t pair = 0; pair < shell_pairs_bra_.size(); ++pair) {
+        pairs12_index_[shell_pairs_bra_[pair].first * nshell2 + shell_pairs_bra_[pair].second] = pair;
+    }
+    pairs34_index_.assign(basis3()->nshell() * nshell4, -1L);
+    for (size_t pair = 0; pair < shell_pairs_ket_.size(); ++pair) {
+        pairs34_index_[shell_pairs_ket_[pair].first * nshell4 + shell_pairs_ket_[pair].second] = pair;
+    }
 }
 
 Libint2TwoElectronInt::~Libint2TwoElectronInt() { libint2::finalize(); }
@@ -3321,3 +3335,71 @@ void Libint2TwoElectronInt::compute_shell_blocks(int shellpair12, int shellpair3
     timer_off("Libint2ERI::compute_shell_blocks");
 #endif
 }
+
+size_t Libint2TwoElectronInt::compute_shell_batch(const std::vector<ShellQuartet> &quartets) {
+#ifdef MINTS_TIMER
+    timer_on("Libint2ERI::compute_shell_batch");
+#endif
+    const size_t nquartet = quartets.size();
+    batch_offsets_.resize(nquartet + 1);
+    batch_offsets_[0] = 0;
+
+    // All quartets must share one angular momentum class, so that the engine runs the same kernel throughout
+    int am1 = -1, am2 = -1, am3 = -1, am4 = -1;
+    if (nquartet) {
+        am1 = bs1_->shell(quartets[0][0]).am();
+        am2 = bs2_->shell(quartets[0][1]).am();
+        am3 = bs3_->shell(quartets[0][2]).am();
+        am4 = bs4_->shell(quartets[0][3]).am();
+    }
+    for (size_t n = 0; n < nquartet; ++n) {
+        const auto &q = quartets[n];
+        const auto &sh1 = bs1_->shell(q[0]);
+        const auto &sh2 = bs2_->shell(q[1]);
+        const auto &sh3 = bs3_->shell(q[2]);
+        const auto &sh4 = bs4_->shell(q[3]);
+        if (sh1.am() != am1 || sh2.am() != am2 || sh3.am() != am3 || sh4.am() != am4)
+            throw PSIEXCEPTION("Libint2TwoElectronInt::compute_shell_batch: quartets span more than one angular momentum class.");
+        size_t size = (size_t)sh1.nfunction() * sh2.nfunction() * sh3.nfunction() * sh4.nfunction();
+        batch_offsets_[n + 1] = batch_offsets_[n] + size;
+    }
+    batch_buffer_.resize(batch_offsets_[nquartet]);
+
+    // Visit the quartets ordered by bra pair, then ket pair, so consecutive calls touch the same shell pair data
+    std::vector<size_t> order(nquartet);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&quartets](size_t a, size_t b) { return quartets[a] < quartets[b]; });
+
+    const size_t nshell2 = bs2_->nshell();
+    const size_t nshell4 = bs4_->nshell();
+    size_t ntot = 0;
+    for (size_t n : order) {
+        const auto &q = quartets[n];
+        const auto &sh1 = bs1_->l2_shell(q[0]);
+        const auto &sh2 = bs2_->l2_shell(q[1]);
+        const auto &sh3 = bs3_->l2_shell(q[2]);
+        const auto &sh4 = bs4_->l2_shell(q[3]);
+
+        // Pairs that did not survive the sieve, or were requested in the opposite order, are built on the fly
+        long int pair12 = pairs12_index_[q[0] * nshell2 + q[1]];
+        long int pair34 = pairs34_index_[q[2] * nshell4 + q[3]];
+        const auto *sp12 = pair12 < 0 ? nullptr : pairs12_[pair12].get();
+        const auto *sp34 = pair34 < 0 ? nullptr : pairs34_[pair34].get();
+        libint2_wrapper0(sh1, sh2, sh3, sh4, sp12, sp34);
+
+        const double *result = engines_[0].results()[0];
+        double *target = batch_buffer_.data() + batch_offsets_[n];
+        size_t size = batch_offsets_[n + 1] - batch_offsets_[n];
+        if (result) {
+            std::copy(result, result + size, target);
+            ntot += size;
+        } else {
+            std::fill(target, target + size, 0.0);
+        }
+    }
+
+#ifdef MINTS_TIMER
+    timer_off("Libint2ERI::compute_shell_batch");
+#endif
+    return ntot;
+}
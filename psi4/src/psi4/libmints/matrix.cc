@@ -87,7 +87,7 @@ Matrix::Matrix(const Matrix &c) : rowspi_(c.rowspi_), colspi_(c.colspi_) {
     nirrep_ = c.nirrep_;
     symmetry_ = c.symmetry_;
     name_ = c.name();
-    alloc();
+    alloc(false);
     copy_from(c.matrix_);
 }
 
@@ -98,7 +98,7 @@ Matrix &Matrix::operator=(const Matrix &c) {
     name_ = c.name();
     rowspi_ = c.rowspi_;
     colspi_ = c.colspi_;
-    alloc();
+    alloc(false);
     copy_from(c.matrix_);
 
     return *this;
@@ -109,7 +109,7 @@ Matrix::Matrix(const SharedMatrix &c) : rowspi_(c->rowspi_), colspi_(c->colspi_)
     nirrep_ = c->nirrep_;
     symmetry_ = c->symmetry_;
     name_ = c->name();
-    alloc();
+    alloc(false);
     copy_from(c->matrix_);
 }
 
@@ -118,7 +118,7 @@ Matrix::Matrix(const Matrix *c) : rowspi_(c->rowspi_), colspi_(c->colspi_) {
     nirrep_ = c->nirrep_;
     symmetry_ = c->symmetry_;
     name_ = c->name();
-    alloc();
+    alloc(false);
     copy_from(c->matrix_);
 }
 
@@ -246,7 +246,7 @@ Matrix::Matrix(dpdfile2 *inFile)
         rowspi_[i] = inFile->params->rowtot[i];
         colspi_[i] = inFile->params->coltot[i];
     }
-    alloc();
+    alloc(false);
     copy_from(inFile->matrix);
     global_dpd_->file2_mat_close(inFile);
 }
@@ -324,7 +324,7 @@ void Matrix::copy(const Matrix *cp) {
             rowspi_[i] = cp->rowspi_[i];
             colspi_[i] = cp->colspi_[i];
         }
-        alloc();
+        alloc(false);
     }
 
 // When here we are the same size
@@ -393,7 +393,7 @@ void Matrix::copy(const Matrix &cp) { copy(&cp); }
 
 void Matrix::copy(const SharedMatrix &cp) { copy(cp.get()); }
 
-void Matrix::alloc() {
+void Matrix::alloc(bool zero) {
     if (matrix_) release();
 
     // This is probably a default constructor matrix
@@ -405,7 +405,7 @@ void Matrix::alloc() {
     matrix_ = (double ***)malloc(sizeof(double ***) * nirrep_);
     for (int h = 0; h < nirrep_; ++h) {
         if (rowspi_[h] != 0 && colspi_[h ^ symmetry_] != 0)
-            matrix_[h] = linalg::detail::matrix(rowspi_[h], colspi_[h ^ symmetry_]);
+            matrix_[h] = linalg::detail::matrix(rowspi_[h], colspi_[h ^ symmetry_], zero);
         else {
             // Force rowspi_[h] and colspi_[h^symmetry] to hard 0
             // This solves an issue where a row can have 0 dim but a col does not (or the other way).
@@ -3528,18 +3528,16 @@ SharedMatrix triplet(const SharedMatrix &A, const SharedMatrix &B, const SharedM
 
 namespace detail {
 /// allocate a block matrix -- analogous to libciomr's block_matrix
-double **matrix(int nrow, int ncol) {
+double **matrix(int nrow, int ncol, bool zero) {
     double **mat = (double **)malloc(sizeof(double *) * nrow);
-    const size_t size = sizeof(double) * nrow * (size_t)ncol;
-    mat[0] = (double *)malloc(size);
-    ::memset((void *)mat[0], 0, size);
+    mat[0] = pool_alloc(nrow * (size_t)ncol, zero);
     for (int r = 1; r < nrow; ++r) mat[r] = mat[r - 1] + ncol;
     return mat;
 }
 
 /// free a (block) matrix -- analogous to libciomr's free_block
 void free(double **Block) {
-    ::free(Block[0]);
+    pool_free(Block[0]);
     ::free(Block);
 }
 }  // namespace detail
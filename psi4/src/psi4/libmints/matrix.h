@@ -96,9 +96,10 @@ Matrix triplet(const Matrix&A, const Matrix& B, const Matrix& C, bool transA = f
 namespace detail {
 /*!
  * allocate a block matrix -- analogous to libciomr's block_matrix
+ * if zero is false the elements are left uninitialized; use it only when every element is overwritten
  */
 PSI_API
-double** matrix(int nrow, int ncol);
+double** matrix(int nrow, int ncol, bool zero = true);
 
 /*!
  * free a (block) matrix -- analogous to libciomr's free_block
@@ -129,8 +130,8 @@ class PSI_API Matrix : public std::enable_shared_from_this<Matrix> {
     /// Symmetry of this matrix (in most cases this will be 0 [totally symmetric])
     int symmetry_;
 
-    /// Allocates matrix_
-    void alloc();
+    /// Allocates matrix_, zeroed unless the caller overwrites every element
+    void alloc(bool zero = true);
     /// Release matrix_
     void release();
 
@@ -0,0 +1,259 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/matrix_product.h"
+
+#include <cstring>
+#include <limits>
+
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libqt/qt.h"
+
+namespace psi {
+namespace linalg {
+
+MatrixProduct& MatrixProduct::append(const Matrix& M, bool trans, bool symmetric) {
+    // op(S) = S for a symmetric factor, which keeps it eligible for DSYMM
+    Factor f{&M, nullptr, symmetric ? false : trans, symmetric};
+    if (symmetric && (M.symmetry() != 0 || M.rowspi() != M.colspi()))
+        throw PSIEXCEPTION("MatrixProduct: a factor flagged symmetric must be square and totally symmetric.");
+    if (!factors_.empty()) {
+        Dimension inner = f.trans ? M.colspi() : M.rowspi();
+        if (inner != cols(factors_.size() - 1))
+            throw PSIEXCEPTION("MatrixProduct: factor " + std::to_string(factors_.size()) +
+                               " does not conform with the previous factor.");
+    }
+    factors_.push_back(f);
+    planned_ = false;
+    scratch_.clear();
+    return *this;
+}
+
+MatrixProduct& MatrixProduct::append(const SharedMatrix& M, bool trans, bool symmetric) {
+    append(*M, trans, symmetric);
+    factors_.back().hold = M;
+    return *this;
+}
+
+void MatrixProduct::set(size_t i, const SharedMatrix& M) {
+    if (i >= factors_.size()) throw PSIEXCEPTION("MatrixProduct::set: factor index out of range.");
+    if (!conforms(i, M)) throw PSIEXCEPTION("MatrixProduct::set: the new factor has a different shape.");
+    Factor& f = factors_[i];
+    f.M = M.get();
+    f.hold = M;
+}
+
+bool MatrixProduct::conforms(size_t i, const SharedMatrix& M) const {
+    if (i >= factors_.size()) return false;
+    const Factor& f = factors_[i];
+    Dimension r = f.trans ? M->colspi() : M->rowspi();
+    Dimension c = f.trans ? M->rowspi() : M->colspi();
+    return r == rows(i) && c == cols(i) && M->symmetry() == f.M->symmetry();
+}
+
+Dimension MatrixProduct::rows(size_t i) const {
+    const Factor& f = factors_[i];
+    return f.trans ? f.M->colspi() : f.M->rowspi();
+}
+
+Dimension MatrixProduct::cols(size_t i) const {
+    const Factor& f = factors_[i];
+    return f.trans ? f.M->rowspi() : f.M->colspi();
+}
+
+int MatrixProduct::symmetry(size_t i, size_t j) const {
+    int sym = 0;
+    for (size_t k = i; k <= j; ++k) sym ^= factors_[k].M->symmetry();
+    return sym;
+}
+
+// True if op(M_j) ... op(M_i) is the transpose of op(M_i) ... op(M_j), i.e. the product is symmetric
+bool MatrixProduct::palindrome(size_t i, size_t j) const {
+    for (size_t a = i, b = j; a <= b; ++a, --b) {
+        const Factor& fa = factors_[a];
+        const Factor& fb = factors_[b];
+        if (a == b) return fa.symmetric;
+        if (fa.M != fb.M) return false;
+        if (!fa.symmetric && fa.trans == fb.trans) return false;
+    }
+    return true;
+}
+
+// Multiply-adds of (i..k) x (k+1..j), summed over the irrep blocks of the left operand
+double MatrixProduct::multiply_cost(size_t i, size_t k, size_t j) const {
+    Dimension r = rows(i);
+    Dimension inner = cols(k);
+    Dimension c = cols(j);
+    int sL = symmetry(i, k);
+    int sR = symmetry(k + 1, j);
+    double cost = 0.0;
+    for (int h = 0; h < r.n(); ++h) cost += (double)r[h] * inner[h ^ sL] * c[h ^ sL ^ sR];
+    return cost;
+}
+
+void MatrixProduct::plan() {
+    if (planned_) return;
+    size_t n = factors_.size();
+    if (n == 0) throw PSIEXCEPTION("MatrixProduct: the chain is empty.");
+
+    // Textbook matrix-chain ordering, with the irrep-blocked cost of every multiplication
+    cost_.assign(n * n, 0.0);
+    split_.assign(n * n, 0);
+    for (size_t len = 2; len <= n; ++len) {
+        for (size_t i = 0; i + len <= n; ++i) {
+            size_t j = i + len - 1;
+            cost_[i * n + j] = std::numeric_limits<double>::max();
+            for (size_t k = i; k < j; ++k) {
+                double cost = cost_[i * n + k] + cost_[(k + 1) * n + j] + multiply_cost(i, k, j);
+                if (cost < cost_[i * n + j]) {
+                    cost_[i * n + j] = cost;
+                    split_[i * n + j] = k;
+                }
+            }
+        }
+    }
+    planned_ = true;
+}
+
+double MatrixProduct::flops() {
+    plan();
+    return cost_[factors_.size() - 1];
+}
+
+std::string MatrixProduct::order(size_t i, size_t j) const {
+    if (i == j) return std::to_string(i) + (factors_[i].trans ? "^T" : "");
+    size_t k = split_[i * factors_.size() + j];
+    return "(" + order(i, k) + " " + order(k + 1, j) + ")";
+}
+
+std::string MatrixProduct::order() {
+    plan();
+    return order(0, factors_.size() - 1);
+}
+
+MatrixProduct::Operand MatrixProduct::node(size_t i, size_t j, Matrix* target, double alpha, double beta) {
+    if (i == j) return Operand{factors_[i].M, factors_[i].trans, factors_[i].symmetric};
+
+    size_t n = factors_.size();
+    size_t k = split_[i * n + j];
+    Operand L = node(i, k, nullptr, 1.0, 0.0);
+    Operand R = node(k + 1, j, nullptr, 1.0, 0.0);
+
+    Matrix* C = target;
+    if (C == nullptr) {
+        int sym = symmetry(i, j);
+        SharedMatrix& tmp = scratch_[i * n + j];
+        if (!tmp || tmp->rowspi() != rows(i) || tmp->colspi() != cols(j) || tmp->symmetry() != sym)
+            tmp = std::make_shared<Matrix>("MatrixProduct intermediate", rows(i), cols(j), sym);
+        C = tmp.get();
+    }
+    multiply(L, R, *C, alpha, beta);
+
+    return Operand{C, false, C->symmetry() == 0 && palindrome(i, j)};
+}
+
+void MatrixProduct::multiply(const Operand& L, const Operand& R, Matrix& C, double alpha, double beta) const {
+    const Matrix& A = *L.M;
+    const Matrix& B = *R.M;
+    bool totally_symmetric = A.symmetry() == 0 && B.symmetry() == 0;
+
+    // X^T X or X X^T: only the upper triangle is computed
+    if (totally_symmetric && beta == 0.0 && L.M == R.M && L.trans != R.trans && !L.symmetric) {
+        for (int h = 0; h < A.nirrep(); ++h) {
+            int nrow = A.rowspi(h);
+            int ncol = A.colspi(h);
+            int dim = L.trans ? ncol : nrow;
+            int k = L.trans ? nrow : ncol;
+            if (dim == 0) continue;
+            double** Cp = C.pointer(h);
+            if (k == 0) {
+                ::memset(Cp[0], 0, sizeof(double) * dim * dim);
+                continue;
+            }
+            C_DSYRK('U', L.trans ? 'T' : 'N', dim, k, alpha, A.pointer(h)[0], ncol, 0.0, Cp[0], dim);
+            for (int p = 0; p < dim; ++p)
+                for (int q = 0; q < p; ++q) Cp[p][q] = Cp[q][p];
+        }
+        return;
+    }
+
+    // S op(B) with S symmetric
+    if (L.symmetric && A.symmetry() == 0 && !R.trans) {
+        for (int h = 0; h < A.nirrep(); ++h) {
+            int m = A.rowspi(h);
+            int n = B.colspi(h ^ B.symmetry());
+            if (m == 0 || n == 0) continue;
+            C_DSYMM('L', 'U', m, n, alpha, A.pointer(h)[0], m, B.pointer(h)[0], n, beta, C.pointer(h)[0], n);
+        }
+        return;
+    }
+
+    // op(A) S with S symmetric
+    if (R.symmetric && B.symmetry() == 0 && !L.trans) {
+        for (int h = 0; h < A.nirrep(); ++h) {
+            int m = A.rowspi(h);
+            int n = A.colspi(h ^ A.symmetry());
+            if (m == 0 || n == 0) continue;
+            C_DSYMM('R', 'U', m, n, alpha, B.pointer(h ^ A.symmetry())[0], n, A.pointer(h)[0], n, beta,
+                    C.pointer(h)[0], n);
+        }
+        return;
+    }
+
+    C.gemm(L.trans, R.trans, alpha, L.M, R.M, beta);
+}
+
+void MatrixProduct::evaluate(Matrix& result, double alpha, double beta) {
+    plan();
+    size_t n = factors_.size();
+    for (const auto& f : factors_)
+        if (f.M == &result) throw PSIEXCEPTION("MatrixProduct::evaluate: the result may not alias a factor.");
+    if (result.rowspi() != rows(0) || result.colspi() != cols(n - 1) || result.symmetry() != symmetry(0, n - 1))
+        throw PSIEXCEPTION("MatrixProduct::evaluate: the result does not have the shape of the product.");
+
+    if (n == 1) {
+        const Factor& f = factors_[0];
+        SharedMatrix op = f.trans ? f.M->transpose() : f.M->clone();
+        result.scale(beta);
+        result.axpy(alpha, op);
+        return;
+    }
+    node(0, n - 1, &result, alpha, beta);
+}
+
+SharedMatrix MatrixProduct::evaluate() {
+    plan();
+    size_t n = factors_.size();
+    auto result = std::make_shared<Matrix>("T", rows(0), cols(n - 1), symmetry(0, n - 1));
+    evaluate(*result);
+    return result;
+}
+
+}  // namespace linalg
+}  // namespace psi
@@ -0,0 +1,127 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_matrix_product_h_
+#define _psi_src_lib_libmints_matrix_product_h_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "psi4/libmints/dimension.h"
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class Matrix;
+using SharedMatrix = std::shared_ptr<Matrix>;
+
+namespace linalg {
+
+/*! \ingroup MINTS
+ *  \class MatrixProduct
+ *  \brief A lazily evaluated chain of matrix products op(M1) op(M2) ... op(Mn).
+ *
+ * Factors are only referenced when they are appended; nothing is multiplied
+ * until evaluate() is called.  Evaluation
+ *   - picks the cheapest parenthesization over the irrep blocks,
+ *   - multiplies factors flagged as symmetric with DSYMM,
+ *   - forms X^T X and X X^T pairs with DSYRK, and
+ *   - keeps every intermediate so that evaluating the chain again, e.g. once
+ *     per SCF iteration after set() rebinds a factor, allocates nothing.
+ *
+ * DSYMM and DSYRK are only used for totally symmetric factors; everything
+ * else goes through Matrix::gemm.
+ */
+class PSI_API MatrixProduct {
+   public:
+    MatrixProduct() = default;
+
+    /// Append op(M) to the right end of the chain.  The caller keeps M alive until evaluation.
+    MatrixProduct& append(const Matrix& M, bool trans = false, bool symmetric = false);
+    /// Append op(M) to the right end of the chain and hold a reference to M
+    MatrixProduct& append(const SharedMatrix& M, bool trans = false, bool symmetric = false);
+
+    /// Replace factor i; intermediates are kept if the dimensions are unchanged
+    void set(size_t i, const SharedMatrix& M);
+    /// Can M replace factor i through set()?
+    bool conforms(size_t i, const SharedMatrix& M) const;
+
+    /// Number of factors
+    size_t size() const { return factors_.size(); }
+
+    /// Evaluate the chain into a new matrix
+    SharedMatrix evaluate();
+    /// result = alpha * chain + beta * result; result must already have the shape of the chain
+    void evaluate(Matrix& result, double alpha = 1.0, double beta = 0.0);
+
+    /// Estimated multiply-add count of the chosen order
+    double flops();
+    /// The chosen order as a string, e.g. "((0^T 1) 2)"
+    std::string order();
+
+    /// Drop the cached intermediates
+    void clear_scratch() { scratch_.clear(); }
+
+   private:
+    struct Factor {
+        const Matrix* M;
+        SharedMatrix hold;
+        bool trans;
+        bool symmetric;
+    };
+    struct Operand {
+        const Matrix* M;
+        bool trans;
+        bool symmetric;
+    };
+
+    std::vector<Factor> factors_;
+    /// split_[i * n + j] is the last factor of the left half of the product i..j
+    std::vector<size_t> split_;
+    std::vector<double> cost_;
+    bool planned_ = false;
+    std::map<size_t, SharedMatrix> scratch_;
+
+    Dimension rows(size_t i) const;
+    Dimension cols(size_t i) const;
+    int symmetry(size_t i, size_t j) const;
+    bool palindrome(size_t i, size_t j) const;
+    double multiply_cost(size_t i, size_t k, size_t j) const;
+
+    void plan();
+    Operand node(size_t i, size_t j, Matrix* target, double alpha, double beta);
+    void multiply(const Operand& L, const Operand& R, Matrix& C, double alpha, double beta) const;
+    std::string order(size_t i, size_t j) const;
+};
+
+}  // namespace linalg
+}  // namespace psi
+
+#endif
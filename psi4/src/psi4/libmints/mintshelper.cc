@@ -47,6 +47,7 @@
 #include "psi4/libpsi4util/process.h"
 #include "electricfield.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
@@ -132,6 +133,93 @@ class PSI_API IWLWriter {
     size_t count() const { return count_; }
 };
 
+/**
+ * IWLThreadWriter functor for use with SO TEIs computed on several threads.
+ * Each thread fills its own buffer and appends it to the shared IWL file
+ * once it is full, so threads only synchronize once per IWL buffer.
+ **/
+class IWLThreadWriter {
+    IWL &writeto_;
+    size_t count_;
+    int nbuf_;
+    std::vector<Label> labels_;
+    std::vector<Value> values_;
+
+   public:
+    IWLThreadWriter(IWL &writeto)
+        : writeto_(writeto),
+          count_(0),
+          nbuf_(0),
+          labels_(4 * writeto.ints_per_buffer()),
+          values_(writeto.ints_per_buffer()) {}
+
+    void operator()(int i, int j, int k, int l, int, int, int, int, int, int, int, int, double value) {
+        int current_label_position = 4 * nbuf_;
+        labels_[current_label_position++] = i;
+        labels_[current_label_position++] = j;
+        labels_[current_label_position++] = k;
+        labels_[current_label_position] = l;
+        values_[nbuf_++] = value;
+        count_++;
+
+        if (nbuf_ == writeto_.ints_per_buffer()) flush();
+    }
+
+    /// Append the integrals held by this thread to the IWL file
+    void flush() {
+        if (nbuf_ == 0) return;
+#pragma omp critical(IWLThreadWriter_flush)
+        {
+            std::copy(labels_.begin(), labels_.begin() + 4 * nbuf_, writeto_.labels());
+            std::copy(values_.begin(), values_.begin() + nbuf_, writeto_.values());
+            writeto_.last_buffer() = 0;
+            writeto_.buffer_count() = nbuf_;
+            writeto_.put();
+        }
+        nbuf_ = 0;
+    }
+
+    size_t count() const { return count_; }
+};
+
+/**
+ * Compute all the unique SO shell quartets of eri on nthread threads and write
+ * the integrals to ERIOUT. The quartets are handed out in chunks of consecutive
+ * iterations: each thread walks its own iterator and computes the chunks it claims.
+ * The order of the integrals in the file depends on the thread schedule.
+ * @return the number of integrals written
+ **/
+static size_t compute_so_tei(std::shared_ptr<TwoBodySOInt> eri, std::shared_ptr<SOBasisSet> sobasis, IWL &ERIOUT,
+                             int nthread) {
+    const size_t quartets_per_chunk = 64;
+    size_t next_chunk = 0;
+    size_t count = 0;
+
+#pragma omp parallel num_threads(nthread) reduction(+ : count)
+    {
+        IWLThreadWriter writer(ERIOUT);
+        SOShellCombinationsIterator shellIter(sobasis, sobasis, sobasis, sobasis);
+
+        size_t mine;
+#pragma omp atomic capture
+        mine = next_chunk++;
+
+        size_t quartet = 0;
+        for (shellIter.first(); shellIter.is_done() == false; shellIter.next(), ++quartet) {
+            // chunks are claimed in increasing order, so the walk never passes a claimed chunk
+            if (quartet / quartets_per_chunk < mine) continue;
+            eri->compute_shell(shellIter, writer);
+            if ((quartet + 1) % quartets_per_chunk == 0) {
+#pragma omp atomic capture
+                mine = next_chunk++;
+            }
+        }
+        writer.flush();
+        count += writer.count();
+    }
+    return count;
+}
+
 MintsHelper::MintsHelper(std::shared_ptr<BasisSet> basis, Options &options, int print)
     : options_(options), print_(print) {
     init_helper(basis);
@@ -290,17 +378,13 @@ void MintsHelper::integrals() {
 
     // Open the IWL buffer where we will store the integrals.
     IWL ERIOUT(psio_.get(), PSIF_SO_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Let the user know what we're doing.
     if (print_) {
         outfile->Printf("      Computing two-electron integrals...");
     }
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
-        eri->compute_shell(shellIter, writer);
-    }
+    size_t count = compute_so_tei(eri, sobasis_, ERIOUT, nthread_);
 
     // Flush out buffers.
     ERIOUT.flush(1);
@@ -314,7 +398,7 @@ void MintsHelper::integrals() {
         outfile->Printf(
             "      Computed %lu non-zero two-electron integrals.\n"
             "        Stored in file %d.\n\n",
-            writer.count(), PSIF_SO_TEI);
+            count, PSIF_SO_TEI);
     }
 }
 
@@ -322,7 +406,6 @@ void MintsHelper::integrals_erf(double w) {
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERF_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
@@ -332,8 +415,7 @@ void MintsHelper::integrals_erf(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERF integrals (omega = %.3f)...", omega);
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    size_t count = compute_so_tei(erf, sobasis_, ERIOUT, nthread_);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -346,14 +428,13 @@ void MintsHelper::integrals_erf(double w) {
     outfile->Printf(
         "      Computed %lu non-zero ERF integrals.\n"
         "        Stored in file %d.\n\n",
-        writer.count(), PSIF_SO_ERF_TEI);
+        count, PSIF_SO_ERF_TEI);
 }
 
 void MintsHelper::integrals_erfc(double w) {
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERFC_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
@@ -364,8 +445,7 @@ void MintsHelper::integrals_erfc(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERFComplement integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    size_t count = compute_so_tei(erf, sobasis_, ERIOUT, nthread_);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -378,7 +458,7 @@ void MintsHelper::integrals_erfc(double w) {
     outfile->Printf(
         "      Computed %lu non-zero ERFComplement integrals.\n"
         "        Stored in file %d.\n\n",
-        writer.count(), PSIF_SO_ERFC_TEI);
+        count, PSIF_SO_ERFC_TEI);
 }
 
 void MintsHelper::one_electron_integrals() {
@@ -511,6 +511,35 @@ void TwoBodyAOInt::compute_shell_blocks_deriv2(int shellpair12, int shellpair34,
     }
 }
 
+size_t TwoBodyAOInt::compute_shell_batch(const std::vector<ShellQuartet> &quartets) {
+    // Default implementation - compute each quartet in turn and copy it out of the engine's buffer
+    const size_t nquartet = quartets.size();
+    batch_offsets_.resize(nquartet + 1);
+    batch_offsets_[0] = 0;
+    for (size_t n = 0; n < nquartet; ++n) {
+        const auto &q = quartets[n];
+        size_t size = (size_t)bs1_->shell(q[0]).nfunction() * bs2_->shell(q[1]).nfunction() *
+                      bs3_->shell(q[2]).nfunction() * bs4_->shell(q[3]).nfunction();
+        batch_offsets_[n + 1] = batch_offsets_[n] + size;
+    }
+    batch_buffer_.resize(batch_offsets_[nquartet]);
+
+    size_t ntot = 0;
+    for (size_t n = 0; n < nquartet; ++n) {
+        const auto &q = quartets[n];
+        size_t nints = compute_shell(q[0], q[1], q[2], q[3]);
+        double *target = batch_buffer_.data() + batch_offsets_[n];
+        size_t size = batch_offsets_[n + 1] - batch_offsets_[n];
+        if (nints) {
+            std::copy(buffer(), buffer() + size, target);
+        } else {
+            std::fill(target, target + size, 0.0);
+        }
+        ntot += nints;
+    }
+    return ntot;
+}
+
 void TwoBodyAOInt::normalize_am(std::shared_ptr<GaussianShell> s1, std::shared_ptr<GaussianShell> s2,
                                 std::shared_ptr<GaussianShell> s3, std::shared_ptr<GaussianShell> s4, int nchunk) {
     // Integrals assume this normalization is 1.0.
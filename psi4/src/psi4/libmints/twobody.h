@@ -31,6 +31,7 @@
 
 #include "psi4/pragma.h"
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <tuple>
@@ -52,6 +53,9 @@ enum PermutedOrder { ABCD = 0, BACD = 1, ABDC = 2, BADC = 3, CDAB = 4, CDBA = 5,
 
 typedef std::vector<std::pair<int, int>> ShellPairBlock;
 
+/// Shell indices (P, Q, R, S) of a single (PQ|RS) quartet
+typedef std::array<int, 4> ShellQuartet;
+
 class IntegralFactory;
 class AOShellCombinationsIterator;
 class BasisSet;
@@ -110,6 +114,11 @@ class PSI_API TwoBodyAOInt {
     /// The blocking scheme used for the integrals
     std::vector<ShellPairBlock> blocks12_, blocks34_;
 
+    /// Contiguous integral buffer filled by compute_shell_batch()
+    std::vector<double> batch_buffer_;
+    /// Start of each requested quartet in batch_buffer_, plus a final entry holding the total size
+    std::vector<size_t> batch_offsets_;
+
     /*
      * Sieve information
      */
@@ -275,6 +284,23 @@ class PSI_API TwoBodyAOInt {
     /*! Compute derivative integrals for two blocks */
     virtual void compute_shell_blocks_deriv2(int shellpair12, int shellpair34, int npair12 = -1, int npair34 = -1);
 
+    /*! Compute integrals for a list of shell quartets in a single call
+     *
+     * Quartet \p n of \p quartets is written to batch_buffer() starting at
+     * batch_offsets()[n], in the same layout compute_shell() produces; quartets
+     * that vanish are zero filled.  Engines are free to visit the quartets in any
+     * order, so callers should pass quartets of a single angular momentum class.
+     * Returns the number of integrals actually computed.  The default
+     * implementation simply loops over compute_shell().
+     */
+    virtual size_t compute_shell_batch(const std::vector<ShellQuartet> &quartets);
+
+    /// Buffer where compute_shell_batch() places the integrals
+    const std::vector<double> &batch_buffer() const { return batch_buffer_; }
+
+    /// Offsets of each quartet of the last compute_shell_batch() call into batch_buffer()
+    const std::vector<size_t> &batch_offsets() const { return batch_offsets_; }
+
     /// Is the shell zero?
     virtual int shell_is_zero(int, int, int, int) { return 0; }
 
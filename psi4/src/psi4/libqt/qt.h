@@ -89,6 +89,9 @@ void parallel_timer_on(const std::string& key, int thread_rank);
 void parallel_timer_off(const std::string& key, int thread_rank);
 void start_skip_timers();
 void stop_skip_timers();
+void start_trace_timers();
+void stop_trace_timers();
+void write_timer_trace(const std::string& filename);
 void clean_timers();
 
 void print_block(double*, int, int, FILE*);
@@ -87,9 +87,11 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -118,6 +120,7 @@ typedef int omp_lock_t;
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/exception.h"
+#include "qt.h"
 
 /* guess for HZ, if missing */
 #ifndef HZ
@@ -362,6 +365,43 @@ class Timer_Structure {
                 break;
         }
     }
+    /// Turn on the slot of thread_rank only, without ever falling back to
+    /// the serial (ON/OFF) status, so that thread 0 costs the same as any other.
+    void turn_on_thread(int thread_rank) {
+        status_ = PARALLEL;
+        if (thread_rank >= thread_timers_.size()) {
+            thread_timers_.resize(thread_rank + 1);
+        }
+        if (thread_timers_[thread_rank].turn_on()) {
+            std::string str = "Timer ";
+            str += key_;
+            str += " on thread ";
+            str += std::to_string(thread_rank);
+            str += " is already on.";
+            throw PsiException(str, __FILE__, __LINE__);
+        }
+    }
+    void turn_off_thread(int thread_rank) {
+        if (status_ != PARALLEL || thread_rank >= thread_timers_.size()) {
+            std::string str = "Timer ";
+            str += key_;
+            str += " on thread ";
+            str += std::to_string(thread_rank);
+            str += " has never been turned on.";
+            throw PsiException(str, __FILE__, __LINE__);
+        }
+        if (thread_timers_[thread_rank].turn_off()) {
+            std::string str = "Timer ";
+            str += key_;
+            str += " on thread ";
+            str += std::to_string(thread_rank);
+            str += " is already off.";
+            throw PsiException(str, __FILE__, __LINE__);
+        }
+    }
+    clock::time_point get_thread_wall_start(int thread_rank) const {
+        return thread_timers_[thread_rank].get_wall_start();
+    }
     const std::string &get_key() const { return key_; }
     Timer_Status get_status() const { return status_; }
     void set_status(Timer_Status status) { status_ = status; }
@@ -928,11 +968,34 @@ bool Timer_thread::merge_move(Timer_Structure *another) {
     return false;
 }
 
-Timer_Structure root_timer(nullptr, ""), parallel_timer(nullptr, "");
+/// One closed timer interval, for the trace export
+struct Trace_Event {
+    std::string key;
+    clock::time_point start;
+    clock::time_point end;
+};
+
+/// The timers of one thread inside parallel regions. A thread only ever
+/// touches its own Thread_Timers, so parallel timers run without a lock.
+/// The tree is merged under the serial timer that was on when the thread
+/// started timing, the next time a serial timer is turned on or off.
+struct Thread_Timers {
+    Timer_Structure root;
+    std::list<Timer_Structure *> on_timers;
+    std::vector<Trace_Event> events;
+    Thread_Timers() : root(nullptr, "") {}
+};
+
+Timer_Structure root_timer(nullptr, "");
 std::list<Timer_Structure *> ser_on_timers;
-std::vector<std::list<Timer_Structure *>> par_on_timers;
+std::vector<std::unique_ptr<Thread_Timers>> par_timers;
+std::atomic<int> n_par_on_threads(0);
+std::atomic<size_t> par_timers_generation(0);
 std::time_t timer_start, timer_end;
 bool skip_timers;
+bool trace_timers = false;
+clock::time_point trace_start;
+std::vector<Trace_Event> ser_events;
 static omp_lock_t lock_timer;
 
 void print_timer(const Timer_Structure &timer, std::shared_ptr<PsiOutStream> printer, int align_key_width) {
@@ -965,15 +1028,100 @@ void print_nested_timer(const Timer_Structure &timer, std::shared_ptr<PsiOutStre
     }
 }
 
-bool empty_parallel() {
-    extern std::vector<std::list<Timer_Structure *>> par_on_timers;
-    size_t on_timer_size = par_on_timers.size();
-    for (size_t i = 0; i < on_timer_size; ++i) {
-        if (par_on_timers[i].size() != 0) {
-            return false;
+std::string json_escape(const std::string &str) {
+    std::string escaped;
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    escaped += buf;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+void print_json_timer(const Timer_Structure &timer, std::shared_ptr<PsiOutStream> printer, const std::string &indent) {
+    double wtime = std::chrono::duration_cast<std::chrono::duration<double>>(timer.get_total_wtime()).count();
+    printer->Printf("%s{\"name\": \"%s\", \"calls\": %zu, \"wall\": %.6f, ", indent.c_str(),
+                    json_escape(timer.get_key()).c_str(), timer.get_n_calls(), wtime);
+    if (timer.get_status() == PARALLEL) {
+        printer->Printf("\"parallel\": true, ");
+    } else {
+        printer->Printf("\"user\": %.3f, \"system\": %.3f, \"parallel\": false, ", timer.get_utime(), timer.get_stime());
+    }
+    printer->Printf("\"children\": [");
+    const std::list<Timer_Structure> &children = timer.get_children();
+    for (auto child_iter = children.begin(), end_child_iter = children.end(); child_iter != end_child_iter;
+         ++child_iter) {
+        printer->Printf("%s\n", child_iter == children.begin() ? "" : ",");
+        print_json_timer(*child_iter, printer, indent + "  ");
+    }
+    printer->Printf("%s]}", children.empty() ? "" : ("\n" + indent).c_str());
+}
+
+void print_trace_events(const std::vector<Trace_Event> &events, int thread_rank, std::shared_ptr<PsiOutStream> printer,
+                        bool &first) {
+    for (const Trace_Event &event : events) {
+        double ts = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(event.start - trace_start).count();
+        double dur = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(event.end - event.start).count();
+        printer->Printf("%s\n  {\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 0, \"tid\": %d}",
+                        first ? "" : ",", json_escape(event.key).c_str(), ts, dur, thread_rank);
+        first = false;
+    }
+}
+
+/// Returns the timers of thread_rank. The lock is only taken the first time
+/// a given thread asks for them (and again after clean_timers()).
+Thread_Timers *get_thread_timers(int thread_rank) {
+    thread_local Thread_Timers *cached_timers = nullptr;
+    thread_local int cached_rank = -1;
+    thread_local size_t cached_generation = 0;
+    size_t generation = par_timers_generation.load(std::memory_order_acquire);
+    if (cached_timers != nullptr && cached_rank == thread_rank && cached_generation == generation) {
+        return cached_timers;
+    }
+    omp_set_lock(&lock_timer);
+    if (par_timers.size() <= thread_rank) {
+        par_timers.resize(thread_rank + 1);
+    }
+    if (!par_timers[thread_rank]) {
+        par_timers[thread_rank] = std::unique_ptr<Thread_Timers>(new Thread_Timers());
+    }
+    cached_timers = par_timers[thread_rank].get();
+    cached_rank = thread_rank;
+    cached_generation = generation;
+    omp_unset_lock(&lock_timer);
+    return cached_timers;
+}
+
+/// Merges the per-thread timer trees into the serial tree. Only call with
+/// lock_timer held and when no thread has a parallel timer on.
+void merge_parallel_timers() {
+    for (auto &thread_timers : par_timers) {
+        if (!thread_timers) continue;
+        Timer_Structure *parent = thread_timers->root.get_parent();
+        if (parent != nullptr) {
+            parent->merge_move_all(&(thread_timers->root));
+            thread_timers->root.set_parent(nullptr);
         }
     }
-    return true;
 }
 
 /*!
@@ -984,26 +1132,22 @@ bool empty_parallel() {
 void timer_init() {
     omp_init_lock(&lock_timer);
     omp_set_lock(&lock_timer);
-    extern std::time_t timer_start;
-    extern Timer_Structure root_timer;
     timer_start = std::time(nullptr);
     root_timer.turn_on();
-    extern std::list<Timer_Structure *> ser_on_timers;
     ser_on_timers.push_back(&root_timer);
-    extern bool skip_timers;
     skip_timers = false;
     omp_unset_lock(&lock_timer);
 }
 
 /*!
-** timer_done(): Close down all timers and write results to timer.dat
+** timer_done(): Close down all timers and write results to timer.dat.
+** If timer tracing is on, the trace is also written to timer.json.
 **
 ** \ingroup QT
 */
 void timer_done() {
-    extern std::time_t timer_start, timer_end;
     omp_set_lock(&lock_timer);
-    extern Timer_Structure root_timer;
+    merge_parallel_timers();
     root_timer.turn_off();
     char *host;
 
@@ -1038,32 +1182,92 @@ void timer_done() {
     printer->Printf("\n**************************************************************************************\n");
 
     omp_unset_lock(&lock_timer);
+    if (trace_timers) {
+        write_timer_trace("timer.json");
+    }
     omp_destroy_lock(&lock_timer);
 }
 
 void clean_timers() {
     timer_done();
-    Timer_Structure new_root_timer(nullptr, ""), new_parallel_timer(nullptr, "");
-    extern Timer_Structure root_timer, parallel_timer;
+    Timer_Structure new_root_timer(nullptr, "");
     root_timer = new_root_timer;
-    parallel_timer = new_parallel_timer;
+    ser_on_timers.clear();
+    par_timers.clear();
+    ser_events.clear();
+    trace_start = clock::now();
+    par_timers_generation.fetch_add(1, std::memory_order_release);
     timer_init();
 }
 
 void start_skip_timers() {
     omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     skip_timers = true;
     omp_unset_lock(&lock_timer);
 }
 
 void stop_skip_timers() {
     omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     skip_timers = false;
     omp_unset_lock(&lock_timer);
 }
 
+/*!
+** start_trace_timers(): Record every interval during which a timer is on,
+** per thread, so that the timeline can be written by write_timer_trace().
+** Should only be called out of OpenMP parallel section.
+**
+** \ingroup QT
+*/
+void start_trace_timers() {
+    omp_set_lock(&lock_timer);
+    if (ser_events.empty()) trace_start = clock::now();
+    trace_timers = true;
+    omp_unset_lock(&lock_timer);
+}
+
+/*!
+** stop_trace_timers(): Stop recording timer intervals. The intervals already
+** recorded are kept until clean_timers().
+**
+** \ingroup QT
+*/
+void stop_trace_timers() {
+    omp_set_lock(&lock_timer);
+    trace_timers = false;
+    omp_unset_lock(&lock_timer);
+}
+
+/*!
+** write_timer_trace(): Write the recorded timer intervals in the Chrome
+** trace event format (load the file in chrome://tracing or Perfetto), one
+** track per thread, together with the nested timer tree under "timers".
+** Should only be called out of OpenMP parallel section.
+**
+** \param filename = Name of the JSON file
+**
+** \ingroup QT
+*/
+void write_timer_trace(const std::string &filename) {
+    omp_set_lock(&lock_timer);
+    if (n_par_on_threads.load() == 0) {
+        merge_parallel_timers();
+    }
+    auto printer = std::make_shared<PsiOutStream>(filename, std::ostream::trunc);
+    printer->Printf("{\"traceEvents\": [");
+    bool first = true;
+    print_trace_events(ser_events, 0, printer, first);
+    for (size_t thread_rank = 0; thread_rank < par_timers.size(); ++thread_rank) {
+        if (par_timers[thread_rank]) {
+            print_trace_events(par_timers[thread_rank]->events, thread_rank, printer, first);
+        }
+    }
+    printer->Printf("\n],\n\"displayTimeUnit\": \"ms\",\n\"timers\":\n");
+    print_json_timer(root_timer, printer, "");
+    printer->Printf("\n}\n");
+    omp_unset_lock(&lock_timer);
+}
+
 /*!
 ** timer_on(): Turn on the timer with the name given as an argument.  Can
 ** be turned on and off, time will accumulate while on.
@@ -1075,19 +1279,17 @@ void stop_skip_timers() {
 */
 PSI_API void timer_on(const std::string &key) {
     omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     if (skip_timers) {
         omp_unset_lock(&lock_timer);
         return;
     }
-    extern Timer_Structure parallel_timer;
-    if (parallel_timer.get_parent() != nullptr) {
+    if (n_par_on_threads.load() != 0) {
         std::string str = "Unable to turn on serial Timer ";
         str += key;
         str += " when parallel timers are not all off.";
         throw PsiException(str, __FILE__, __LINE__);
     }
-    extern std::list<Timer_Structure *> ser_on_timers;
+    merge_parallel_timers();
     Timer_Structure *top_timer_ptr = nullptr;
     Timer_Structure *top_timer = ser_on_timers.back();
     if (key == top_timer->get_key()) {
@@ -1111,23 +1313,22 @@ PSI_API void timer_on(const std::string &key) {
 */
 PSI_API void timer_off(const std::string &key) {
     omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     if (skip_timers) {
         omp_unset_lock(&lock_timer);
         return;
     }
-    extern Timer_Structure parallel_timer;
-    extern std::list<Timer_Structure *> ser_on_timers;
-    if (parallel_timer.get_parent() != nullptr) {
+    if (n_par_on_threads.load() != 0) {
         std::string str = "Unable to turn on serial Timer ";
         str += key;
         str += " when parallel timers are not all off.";
         throw PsiException(str, __FILE__, __LINE__);
     }
+    merge_parallel_timers();
     Timer_Structure *timer_ptr = nullptr;
     timer_ptr = ser_on_timers.back();
     if (key == timer_ptr->get_key()) {
         timer_ptr->turn_off();
+        if (trace_timers) ser_events.push_back({key, timer_ptr->get_wall_start(), clock::now()});
         ser_on_timers.pop_back();
     } else {
         timer_ptr = nullptr;
@@ -1152,6 +1353,7 @@ PSI_API void timer_off(const std::string &key) {
             throw PsiException(str, __FILE__, __LINE__);
         }
         timer_ptr->turn_off();
+        if (trace_timers) ser_events.push_back({key, timer_ptr->get_wall_start(), clock::now()});
         auto on_child_iter = timer_iter;
         ++on_child_iter;
         Timer_Structure *on_child_ptr = *(on_child_iter);
@@ -1174,44 +1376,39 @@ PSI_API void timer_off(const std::string &key) {
 /*!
 ** parallel_timer_on(): Turn on the timer with the name given as an argument.  Can
 ** be turned on and off, time will accumulate while on.
-** Should only be called in OpenMP parallel sections.
+** Should only be called in OpenMP parallel sections. Each thread keeps its own
+** stack of timers, so no lock is taken.
 **
 ** \param key = Name of timer
 **
 ** \ingroup QT
 */
 void parallel_timer_on(const std::string &key, int thread_rank) {
-    omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     if (skip_timers) {
-        omp_unset_lock(&lock_timer);
         return;
     }
-    extern std::list<Timer_Structure *> ser_on_timers;
-    extern std::vector<std::list<Timer_Structure *>> par_on_timers;
-    extern Timer_Structure parallel_timer;
-    if (par_on_timers.size() <= thread_rank) {
-        par_on_timers.resize(thread_rank + 1);
-    }
-    if (parallel_timer.get_parent() == nullptr) {
-        parallel_timer.set_parent(ser_on_timers.back());
-    }
+    Thread_Timers *thread_timers = get_thread_timers(thread_rank);
+    std::list<Timer_Structure *> &on_timers = thread_timers->on_timers;
     Timer_Structure *top_timer_ptr = nullptr;
-    if (par_on_timers[thread_rank].empty()) {
-        top_timer_ptr = parallel_timer.get_child(key);
-        par_on_timers[thread_rank].push_back(top_timer_ptr);
-        top_timer_ptr->turn_on(thread_rank);
+    if (on_timers.empty()) {
+        // The serial stack does not change while a parallel region runs
+        if (thread_timers->root.get_parent() == nullptr) {
+            thread_timers->root.set_parent(ser_on_timers.back());
+        }
+        n_par_on_threads.fetch_add(1);
+        top_timer_ptr = thread_timers->root.get_child(key);
+        on_timers.push_back(top_timer_ptr);
+        top_timer_ptr->turn_on_thread(thread_rank);
     } else {
-        top_timer_ptr = par_on_timers[thread_rank].back();
+        top_timer_ptr = on_timers.back();
         if (key == top_timer_ptr->get_key()) {
-            top_timer_ptr->turn_on(thread_rank);
+            top_timer_ptr->turn_on_thread(thread_rank);
         } else {
             top_timer_ptr = top_timer_ptr->get_child(key);
-            par_on_timers[thread_rank].push_back(top_timer_ptr);
-            top_timer_ptr->turn_on(thread_rank);
+            on_timers.push_back(top_timer_ptr);
+            top_timer_ptr->turn_on_thread(thread_rank);
         }
     }
-    omp_unset_lock(&lock_timer);
 }
 
 /*!
@@ -1224,15 +1421,12 @@ void parallel_timer_on(const std::string &key, int thread_rank) {
 ** \ingroup QT
 */
 void parallel_timer_off(const std::string &key, int thread_rank) {
-    omp_set_lock(&lock_timer);
-    extern bool skip_timers;
     if (skip_timers) {
-        omp_unset_lock(&lock_timer);
         return;
     }
-    extern std::vector<std::list<Timer_Structure *>> par_on_timers;
-    extern Timer_Structure parallel_timer;
-    if (par_on_timers[thread_rank].empty()) {
+    Thread_Timers *thread_timers = get_thread_timers(thread_rank);
+    std::list<Timer_Structure *> &on_timers = thread_timers->on_timers;
+    if (on_timers.empty()) {
         std::string str = "Timer ";
         str += key;
         str += " on thread ";
@@ -1241,17 +1435,17 @@ void parallel_timer_off(const std::string &key, int thread_rank) {
         throw PsiException(str, __FILE__, __LINE__);
     }
     Timer_Structure *timer_ptr = nullptr;
-    timer_ptr = par_on_timers[thread_rank].back();
+    timer_ptr = on_timers.back();
     if (key == timer_ptr->get_key()) {
-        timer_ptr->turn_off(thread_rank);
-        par_on_timers[thread_rank].pop_back();
+        timer_ptr->turn_off_thread(thread_rank);
+        on_timers.pop_back();
     } else {
         timer_ptr = nullptr;
-        auto timer_iter = par_on_timers[thread_rank].end();
+        auto timer_iter = on_timers.end();
         --timer_iter;
         std::list<std::string> stack_keys;
         stack_keys.push_front((*timer_iter)->get_key());
-        auto iter_begin = par_on_timers[thread_rank].begin();
+        auto iter_begin = on_timers.begin();
         while (timer_iter != iter_begin) {
             --timer_iter;
             if ((*timer_iter)->get_key() == key) {
@@ -1269,7 +1463,7 @@ void parallel_timer_off(const std::string &key, int thread_rank) {
             str += " is not on.";
             throw PsiException(str, __FILE__, __LINE__);
         }
-        timer_ptr->turn_off(thread_rank);
+        timer_ptr->turn_off_thread(thread_rank);
         auto on_child_iter = timer_iter;
         ++on_child_iter;
         Timer_Structure *on_child_ptr = *(on_child_iter);
@@ -1278,18 +1472,19 @@ void parallel_timer_off(const std::string &key, int thread_rank) {
         if (parent_on_child_ptr->merge_move(on_child_ptr, thread_rank)) {
             timer_ptr->remove_child(on_child_ptr);
         }
-        par_on_timers[thread_rank].erase(timer_iter, par_on_timers[thread_rank].end());
+        on_timers.erase(timer_iter, on_timers.end());
         for (auto stack_iter = stack_keys.begin(), stack_end = stack_keys.end(); stack_iter != stack_end;
              ++stack_iter) {
             on_child_ptr = parent_ptr->get_child(*stack_iter);
-            par_on_timers[thread_rank].push_back(on_child_ptr);
+            on_timers.push_back(on_child_ptr);
             parent_ptr = on_child_ptr;
         }
     }
-    if (parallel_timer.get_parent() != nullptr && empty_parallel()) {
-        parallel_timer.get_parent()->merge_move_all(&parallel_timer);
-        parallel_timer.set_parent(nullptr);
+    if (trace_timers) {
+        thread_timers->events.push_back({key, timer_ptr->get_thread_wall_start(thread_rank), clock::now()});
+    }
+    if (on_timers.empty()) {
+        n_par_on_threads.fetch_sub(1);
     }
-    omp_unset_lock(&lock_timer);
 }
 }  // namespace psi
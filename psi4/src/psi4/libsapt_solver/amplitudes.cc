@@ -930,8 +930,8 @@ void SAPT2p3::Y3_2(double **yAR, int intfile, const char *ARlabel, const char *R
     for (int r1 = 0, r1r2 = 0; r1 < nvirA; r1++) {
         for (int r2 = 0; r2 <= r1; r2++, r1r2++) {
             next_DF_RR = psio_get_address(PSIO_ZERO, sizeof(double) * (r1 * nvirA + r2) * (ndf_ + 3));
-            psio_->read(intfile, RRlabel, (char *)&(B_p_RR[r1r2][0]), sizeof(double) * (ndf_ + 3), next_DF_RR,
-                        &next_DF_RR);
+            read_DF(intfile, RRlabel, (char *)&(B_p_RR[r1r2][0]), sizeof(double) * (ndf_ + 3), next_DF_RR,
+                    &next_DF_RR);
         }
     }
 
@@ -1358,7 +1358,7 @@ void SAPT2p3::disp30_amps(int ampfile, const char *amplabel, int AAintfile, cons
 
     psio_address next_RR = PSIO_ZERO;
     for (int r = 0; r < nvirA; r++) {
-        psio_->read(AAintfile, RRlabel, (char *)B_p_RR[0], sizeof(double) * nvirA * (ndf_ + 3), next_RR, &next_RR);
+        read_DF(AAintfile, RRlabel, (char *)B_p_RR[0], sizeof(double) * nvirA * (ndf_ + 3), next_RR, &next_RR);
 
         C_DGEMM('N', 'T', nvirA, nvirB * nvirB, ndf_ + 3, 1.0, B_p_RR[0], ndf_ + 3, &(B_p_SS[0][0]), ndf_ + 3, 0.0,
                 &(X_RS[0][0]), nvirB * nvirB);
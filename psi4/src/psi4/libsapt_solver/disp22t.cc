@@ -27,6 +27,7 @@
  */
 
 #include <ctime>
+#include <vector>
 
 #include "sapt2p.h"
 #include "psi4/libciomr/libciomr.h"
@@ -34,6 +35,7 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 namespace psi {
 namespace sapt {
@@ -255,6 +257,22 @@ void SAPT2p::natural_orbitalify_ccd() {
     free_block(tBsAr);
 }
 
+int SAPT2p::triples_threads(long int shared_mem, long int thread_mem) {
+    int nthreads = Process::environment.get_n_threads();
+
+    long int mem_avail = mem_ - shared_mem;
+    int possible_nthreads = (thread_mem > 0) ? (int)(mem_avail / thread_mem) : nthreads;
+    if (possible_nthreads < 1) possible_nthreads = 1;
+
+    if (possible_nthreads < nthreads) {
+        nthreads = possible_nthreads;
+        if (print_) outfile->Printf("    Reducing threads due to memory limitations.\n");
+    }
+    if (print_) outfile->Printf("    Number of threads for explicit (bs) threading: %4d\n\n", nthreads);
+
+    return nthreads;
+}
+
 double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, const char *RRlabel, int BBfile,
                         const char *BSlabel, int ampfile, const char *tlabel, size_t foccA, size_t noccA, size_t nvirA,
                         size_t foccB, size_t noccB, size_t nvirB, double *evalsA, double *evalsB) {
@@ -263,34 +281,56 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, co
     size_t aoccA = noccA - foccA;
     size_t aoccB = noccB - foccB;
 
-    double **wARAR = block_matrix(aoccA * nvirA, aoccA * nvirA);
-
-    double **vbsAA = block_matrix(aoccA, aoccA);
-    double **vbsRR = block_matrix(nvirA, nvirA);
     double **vARAA = block_matrix(aoccA * nvirA, aoccA * aoccA);
 
     double **tARAR = block_matrix(aoccA * nvirA, aoccA * nvirA);
     psio_->read_entry(ampfile, tlabel, (char *)tARAR[0], sizeof(double) * aoccA * nvirA * aoccA * nvirA);
-    double **tbsAR = block_matrix(aoccA, nvirA);
 
     double **B_p_AA = get_DF_ints(AAfile, AAlabel, foccA, noccA, foccA, noccA);
     double **B_p_AR = get_DF_ints(AAfile, ARlabel, foccA, noccA, 0, nvirA);
     double **B_p_RR = get_DF_ints(AAfile, RRlabel, 0, nvirA, 0, nvirA);
-    double *B_p_bs = init_array(ndf_ + 3);
-
-    double **C_p_AR = block_matrix(aoccA * nvirA, ndf_ + 3);
+    double **B_p_BS = get_DF_ints(BBfile, BSlabel, foccB, noccB, 0, nvirB);
 
     C_DGEMM('N', 'T', aoccA * nvirA, aoccA * aoccA, ndf_ + 3, 1.0, &(B_p_AR[0][0]), ndf_ + 3, &(B_p_AA[0][0]), ndf_ + 3,
             0.0, &(vARAA[0][0]), aoccA * aoccA);
 
+    long int shared_mem = 2L * aoccA * nvirA * aoccA * nvirA + aoccA * nvirA * aoccA * aoccA;
+    long int thread_mem =
+        (long int)aoccA * nvirA * aoccA * nvirA + aoccA * nvirA * (ndf_ + 4) + nvirA * nvirA + aoccA * aoccA;
+    int nthreads = triples_threads(shared_mem, thread_mem);
+
+// The (bs) loop is threaded explicitly, so keep the BLAS calls inside it serial
+#ifdef USING_LAPACK_MKL
+    int mkl_threads = mkl_get_max_threads();
+    if (nthreads > 1) mkl_set_num_threads(1);
+#endif
+
+    std::vector<double **> thread_wARAR(nthreads), thread_vbsAA(nthreads), thread_vbsRR(nthreads);
+    std::vector<double **> thread_tbsAR(nthreads), thread_C_p_AR(nthreads);
+    for (int thread = 0; thread < nthreads; thread++) {
+        thread_wARAR[thread] = block_matrix(aoccA * nvirA, aoccA * nvirA);
+        thread_vbsAA[thread] = block_matrix(aoccA, aoccA);
+        thread_vbsRR[thread] = block_matrix(nvirA, nvirA);
+        thread_tbsAR[thread] = block_matrix(aoccA, nvirA);
+        thread_C_p_AR[thread] = block_matrix(aoccA * nvirA, ndf_ + 3);
+    }
+
     std::time_t start = std::time(nullptr);
     std::time_t stop;
 
-    for (size_t b = 0, bs = 0; b < aoccB; b++) {
-        for (int s = 0; s < nvirB; s++, bs++) {
-            psio_address next_DF_BS = psio_get_address(
-                PSIO_ZERO, sizeof(double) * (b + foccB) * nvirB * (ndf_ + 3) + sizeof(double) * s * (ndf_ + 3));
-            psio_->read(BBfile, BSlabel, (char *)&(B_p_bs[0]), sizeof(double) * (ndf_ + 3), next_DF_BS, &next_DF_BS);
+    for (size_t b = 0; b < aoccB; b++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : energy)
+        for (int s = 0; s < nvirB; s++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            double **wARAR = thread_wARAR[thread];
+            double **vbsAA = thread_vbsAA[thread];
+            double **vbsRR = thread_vbsRR[thread];
+            double **tbsAR = thread_tbsAR[thread];
+            double **C_p_AR = thread_C_p_AR[thread];
+            double *B_p_bs = B_p_BS[b * nvirB + s];
 
             C_DGEMV('n', aoccA * nvirA, ndf_ + 3, 1.0, B_p_AR[0], ndf_ + 3, B_p_bs, 1, 0.0, tbsAR[0], 1);
 
@@ -337,17 +377,23 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, co
         }
     }
 
-    free(B_p_bs);
-    free_block(wARAR);
-    free_block(vbsAA);
-    free_block(vbsRR);
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(mkl_threads);
+#endif
+
+    for (int thread = 0; thread < nthreads; thread++) {
+        free_block(thread_wARAR[thread]);
+        free_block(thread_vbsAA[thread]);
+        free_block(thread_vbsRR[thread]);
+        free_block(thread_tbsAR[thread]);
+        free_block(thread_C_p_AR[thread]);
+    }
     free_block(vARAA);
     free_block(tARAR);
-    free_block(tbsAR);
     free_block(B_p_AA);
     free_block(B_p_AR);
     free_block(B_p_RR);
-    free_block(C_p_AR);
+    free_block(B_p_BS);
 
     return (energy);
 }
@@ -361,18 +407,13 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
     noccA -= foccA;
     noccB -= foccB;
 
-    double **w_ARAR = block_matrix(noccA * nvirA, noccA * nvirA);
-
-    double **v_bsAA = block_matrix(noccA, noccA);
-    double **v_bsRR = block_matrix(nvirA, nvirA);
     double **v_ARAA = block_matrix(noccA * nvirA, noccA * noccA);
 
     double **B_p_AA = get_DF_ints_nongimp(AAnum, AA_label, foccA, noccA + foccA, foccA, noccA + foccA);
     double **B_p_AR = get_DF_ints_nongimp(Rnum, AR_label, foccA, noccA + foccA, 0, nvirA);
     double **B_p_RR = get_DF_ints_nongimp(Rnum, RR_label, 0, nvirA, 0, nvirA);
-    double *B_p_bs = init_array(ndf_);
+    double **B_p_BS = get_DF_ints(BBnum, BS_label, foccB, noccB + foccB, 0, nvirB);
 
-    double **t_bsAR = block_matrix(noccA, nvirA);
     double **t_ARAR;
 
     psio_address next_ARAR;
@@ -408,28 +449,56 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
         }
     }
 
-    double **C_p_AR = block_matrix(noccA * nvirA, ndf_);
-
     C_DGEMM('N', 'T', noccA * nvirA, noccA * noccA, ndf_, 1.0, &(B_p_AR[0][0]), ndf_, &(B_p_AA[0][0]), ndf_, 0.0,
             &(v_ARAA[0][0]), noccA * noccA);
 
-    psio_address next_BSAR;
+    long int shared_mem = 2L * noccA * nvirA * noccA * nvirA + noccA * nvirA * noccA * noccA;
+    long int thread_mem =
+        (long int)noccA * nvirA * noccA * nvirA + noccA * nvirA * (ndf_ + 1) + nvirA * nvirA + noccA * noccA;
+    int nthreads = triples_threads(shared_mem, thread_mem);
+
+// The (bs) loop is threaded explicitly, so keep the BLAS calls inside it serial
+#ifdef USING_LAPACK_MKL
+    int mkl_threads = mkl_get_max_threads();
+    if (nthreads > 1) mkl_set_num_threads(1);
+#endif
+
+    std::vector<double **> thread_w_ARAR(nthreads), thread_v_bsAA(nthreads), thread_v_bsRR(nthreads);
+    std::vector<double **> thread_t_bsAR(nthreads), thread_C_p_AR(nthreads);
+    for (int thread = 0; thread < nthreads; thread++) {
+        thread_w_ARAR[thread] = block_matrix(noccA * nvirA, noccA * nvirA);
+        thread_v_bsAA[thread] = block_matrix(noccA, noccA);
+        thread_v_bsRR[thread] = block_matrix(nvirA, nvirA);
+        thread_t_bsAR[thread] = block_matrix(noccA, nvirA);
+        thread_C_p_AR[thread] = block_matrix(noccA * nvirA, ndf_);
+    }
 
     std::time_t start = std::time(nullptr);
     std::time_t stop;
 
-    for (size_t b = 0, bs = 0; b < noccB; b++) {
-        for (int s = 0; s < nvirB; s++, bs++) {
-            psio_address next_DF_BS =
-                psio_get_address(PSIO_ZERO, ((foccB + b) * nvirB + s) * (ndf_ + 3) * (size_t)sizeof(double));
-            psio_->read(BBnum, BS_label, (char *)&(B_p_bs[0]), sizeof(double) * ndf_, next_DF_BS, &next_DF_BS);
+    for (size_t b = 0; b < noccB; b++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : energy)
+        for (int s = 0; s < nvirB; s++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            double **w_ARAR = thread_w_ARAR[thread];
+            double **v_bsAA = thread_v_bsAA[thread];
+            double **v_bsRR = thread_v_bsRR[thread];
+            double **t_bsAR = thread_t_bsAR[thread];
+            double **C_p_AR = thread_C_p_AR[thread];
+            double *B_p_bs = B_p_BS[b * nvirB + s];
+            size_t bs = b * nvirB + s;
 
             if (ampnum == PSIF_SAPT_CCD) {
-                next_BSAR = psio_get_address(PSIO_ZERO, bs * noccA * nvirA * sizeof(double));
+                psio_address next_BSAR = psio_get_address(PSIO_ZERO, bs * noccA * nvirA * sizeof(double));
+#pragma omp critical(disp220tccd_amplitudes)
                 psio_->read(ampnum, tbsar, (char *)t_bsAR[0], sizeof(double) * noccA * nvirA, next_BSAR, &next_BSAR);
             } else if (ampnum) {
-                next_BSAR = psio_get_address(
+                psio_address next_BSAR = psio_get_address(
                     PSIO_ZERO, ((foccB * nvirB + bs) * (noccA + foccA) * nvirA + foccA * nvirA) * sizeof(double));
+#pragma omp critical(disp220tccd_amplitudes)
                 psio_->read(ampnum, tbsar, (char *)t_bsAR[0], sizeof(double) * noccA * nvirA, next_BSAR, &next_BSAR);
             } else {
                 C_DGEMV('n', noccA * nvirA, ndf_, 1.0, B_p_AR[0], ndf_, B_p_bs, 1, 0.0, t_bsAR[0], 1);
@@ -478,17 +547,23 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
         outfile->Printf("    (i = %3zu of %3zu) %10ld seconds\n", b + 1, noccB, stop - start);
     }
 
-    free(B_p_bs);
-    free_block(w_ARAR);
-    free_block(v_bsAA);
-    free_block(v_bsRR);
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(mkl_threads);
+#endif
+
+    for (int thread = 0; thread < nthreads; thread++) {
+        free_block(thread_w_ARAR[thread]);
+        free_block(thread_v_bsAA[thread]);
+        free_block(thread_v_bsRR[thread]);
+        free_block(thread_t_bsAR[thread]);
+        free_block(thread_C_p_AR[thread]);
+    }
     free_block(v_ARAA);
     free_block(t_ARAR);
-    free_block(t_bsAR);
     free_block(B_p_AA);
     free_block(B_p_AR);
     free_block(B_p_RR);
-    free_block(C_p_AR);
+    free_block(B_p_BS);
 
     return (energy);
 }
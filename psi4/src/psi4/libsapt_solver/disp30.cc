@@ -106,8 +106,8 @@ double SAPT2p3::disp30_1(int ampfile, const char *amplabel, int AAintfile, const
     for (int r1 = 0, r1r2 = 0; r1 < nvirA; r1++) {
         for (int r2 = 0; r2 <= r1; r2++, r1r2++) {
             next_DF_RR = psio_get_address(PSIO_ZERO, sizeof(double) * (r1 * nvirA + r2) * (ndf_ + 3));
-            psio_->read(AAintfile, RRlabel, (char *)&(B_p_RR[r1r2][0]), sizeof(double) * (ndf_ + 3), next_DF_RR,
-                        &next_DF_RR);
+            read_DF(AAintfile, RRlabel, (char *)&(B_p_RR[r1r2][0]), sizeof(double) * (ndf_ + 3), next_DF_RR,
+                    &next_DF_RR);
             if (r1 != r2) C_DSCAL(ndf_ + 3, 2.0, B_p_RR[r1r2], 1);
         }
     }
@@ -115,8 +115,8 @@ double SAPT2p3::disp30_1(int ampfile, const char *amplabel, int AAintfile, const
     for (int s1 = 0, s1s2 = 0; s1 < nvirB; s1++) {
         for (int s2 = 0; s2 <= s1; s2++, s1s2++) {
             next_DF_SS = psio_get_address(PSIO_ZERO, sizeof(double) * (s1 * nvirB + s2) * (ndf_ + 3));
-            psio_->read(BBintfile, SSlabel, (char *)&(B_p_SS[s1s2][0]), sizeof(double) * (ndf_ + 3), next_DF_SS,
-                        &next_DF_SS);
+            read_DF(BBintfile, SSlabel, (char *)&(B_p_SS[s1s2][0]), sizeof(double) * (ndf_ + 3), next_DF_SS,
+                    &next_DF_SS);
             if (s1 != s2) C_DSCAL(ndf_ + 3, 2.0, B_p_SS[s1s2], 1);
         }
     }
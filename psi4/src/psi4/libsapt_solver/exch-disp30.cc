@@ -31,6 +31,9 @@
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <vector>
 
 namespace psi {
 namespace sapt {
@@ -339,16 +342,7 @@ double SAPT2p3::exch_disp30_22() {
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
 
-    for (int a = 0, ar = 0; a < aoccA_; a++) {
-        for (int r = 0; r < nvirA_; r++, ar++) {
-            for (int b = 0, bs = 0; b < aoccB_; b++) {
-                for (int s = 0; s < nvirB_; s++, bs++) {
-                    tAS_RB[r][b] += tARBS[ar][bs] * sAB_[a + foccA_][s + noccB_];
-                    tRB_AS[a][s] += tARBS[ar][bs] * sAB_[r + noccA_][b + foccB_];
-                }
-            }
-        }
-    }
+    tARBS_overlap(tARBS, tAS_RB, tRB_AS);
 
     double **T_p_AR = block_matrix(aoccA_ * nvirA_, ndf_ + 3);
     psio_->read_entry(PSIF_SAPT_AMPS, "T AR Intermediates", (char *)T_p_AR[0],
@@ -458,8 +452,18 @@ double SAPT2p3::exch_disp30_22() {
 
     double **vABRS = block_matrix(aoccA_ * aoccB_, nvirA_ * nvirB_);
 
-    for (int a = 0, ab = 0; a < aoccA_; a++) {
-        for (int b = 0; b < aoccB_; b++, ab++) {
+    int nthreads = Process::environment.get_n_threads();
+
+// The (ab) loops are threaded explicitly, so keep the BLAS calls inside them serial
+#ifdef USING_LAPACK_MKL
+    int mkl_threads = mkl_get_max_threads();
+    if (nthreads > 1) mkl_set_num_threads(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int a = 0; a < aoccA_; a++) {
+        for (int b = 0; b < aoccB_; b++) {
+            int ab = a * aoccB_ + b;
             C_DGEMM('N', 'T', nvirA_, nvirB_, ndf_ + 3, 1.0, &(B_p_AR[a * nvirA_][0]), ndf_ + 3,
                     &(B_p_BS[b * nvirB_][0]), ndf_ + 3, 0.0, &(vABRS[ab][0]), nvirB_);
         }
@@ -468,19 +472,30 @@ double SAPT2p3::exch_disp30_22() {
     free_block(B_p_AR);
     free_block(B_p_BS);
 
-    double **xAR = block_matrix(aoccA_, nvirA_);
+    std::vector<double **> xAR(nthreads);
+    for (int thread = 0; thread < nthreads; thread++) xAR[thread] = block_matrix(aoccA_, nvirA_);
     double **ABAB = block_matrix(aoccA_ * aoccB_, aoccA_ * aoccB_);
 
-    for (int a = 0, ab = 0; a < aoccA_; a++) {
-        for (int b = 0; b < aoccB_; b++, ab++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int a = 0; a < aoccA_; a++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        for (int b = 0; b < aoccB_; b++) {
+            int ab = a * aoccB_ + b;
             C_DGEMM('N', 'T', aoccA_, nvirA_, nvirB_, 1.0, &(sAB_[foccA_][noccB_]), nmoB_, &(tABRS[ab][0]), nvirB_, 0.0,
-                    &(xAR[0][0]), nvirA_);
-            C_DGEMM('N', 'N', aoccA_, aoccB_, nvirA_, 1.0, &(xAR[0][0]), nvirA_, &(sAB_[noccA_][foccB_]), nmoB_, 0.0,
-                    &(ABAB[ab][0]), aoccB_);
+                    &(xAR[thread][0][0]), nvirA_);
+            C_DGEMM('N', 'N', aoccA_, aoccB_, nvirA_, 1.0, &(xAR[thread][0][0]), nvirA_, &(sAB_[noccA_][foccB_]), nmoB_,
+                    0.0, &(ABAB[ab][0]), aoccB_);
         }
     }
 
-    free_block(xAR);
+    for (int thread = 0; thread < nthreads; thread++) free_block(xAR[thread]);
+
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(mkl_threads);
+#endif
 
     double **xABRS = block_matrix(aoccA_ * aoccB_, nvirA_ * nvirB_);
 
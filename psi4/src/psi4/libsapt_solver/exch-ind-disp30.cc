@@ -123,16 +123,7 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
 
-    for (int a = 0, ar = 0; a < aoccA_; a++) {
-        for (int r = 0; r < nvirA_; r++, ar++) {
-            for (int b = 0, bs = 0; b < aoccB_; b++) {
-                for (int s = 0; s < nvirB_; s++, bs++) {
-                    tAS_RB[r][b] += tARBS[ar][bs] * sAB_[a + foccA_][s + noccB_];
-                    tRB_AS[a][s] += tARBS[ar][bs] * sAB_[r + noccA_][b + foccB_];
-                }
-            }
-        }
-    }
+    tARBS_overlap(tARBS, tAS_RB, tRB_AS);
 
     double **B_p_AR = get_AR_ints(1, foccA_);
     double **B_p_RB = get_RB_ints(1, foccB_);
@@ -148,15 +139,8 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
                 0.0, &(C_p_AS[a * nvirB_][0]), (ndf_ + 3));
     }
 
-    double **xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, ndf_ + 3, 1.0, &(B_p_RB[0][0]), ndf_ + 3, &(C_p_AS[a * nvirB_][0]),
-                ndf_ + 3, 0.0, &(xRBS[0][0]), nvirB_);
-        energy += C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy += tARBS_RBAS(tARBS, B_p_RB, C_p_AS);
 
-    free_block(xRBS);
     free_block(C_p_AS);
 
     double **B_p_AB = block_matrix(aoccA_ * aoccB_, ndf_ + 3);
@@ -223,16 +207,9 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
     C_DGEMM('N', 'N', aoccA_, nvirB_ * (ndf_ + 3), noccB_, 1.0, &(sAB_[foccA_][0]), nmoB_, &(B_p_BS[0][0]),
             nvirB_ * (ndf_ + 3), 0.0, &(C_p_AS[0][0]), nvirB_ * (ndf_ + 3));
 
-    xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, ndf_ + 3, 1.0, &(C_p_RB[0][0]), ndf_ + 3, &(C_p_AS[a * nvirB_][0]),
-                ndf_ + 3, 0.0, &(xRBS[0][0]), nvirB_);
-        energy -= C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy -= tARBS_RBAS(tARBS, C_p_RB, C_p_AS);
 
     free_block(xAB);
-    free_block(xRBS);
     free_block(C_p_AS);
     free_block(C_p_RB);
 
@@ -383,16 +360,9 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
     C_DGEMM('N', 'N', nvirA_, aoccB_ * (ndf_ + 3), noccB_, 1.0, &(sAB_[noccA_][0]), nmoB_, &(B_p_BB[0][0]),
             aoccB_ * (ndf_ + 3), 0.0, &(C_p_RB[0][0]), aoccB_ * (ndf_ + 3));
 
-    xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, ndf_ + 3, 1.0, &(C_p_RB[0][0]), ndf_ + 3, &(C_p_AS[a * nvirB_][0]),
-                ndf_ + 3, 0.0, &(xRBS[0][0]), nvirB_);
-        energy -= C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy -= tARBS_RBAS(tARBS, C_p_RB, C_p_AS);
 
     free_block(xRS);
-    free_block(xRBS);
     free_block(B_p_BB);
     free_block(C_p_AS);
     free_block(C_p_RB);
@@ -552,16 +522,7 @@ double SAPT2p3::exch_ind_disp30_12(double **sBS) {
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
 
-    for (int a = 0, ar = 0; a < aoccA_; a++) {
-        for (int r = 0; r < nvirA_; r++, ar++) {
-            for (int b = 0, bs = 0; b < aoccB_; b++) {
-                for (int s = 0; s < nvirB_; s++, bs++) {
-                    tAS_RB[r][b] += tARBS[ar][bs] * sAB_[a + foccA_][s + noccB_];
-                    tRB_AS[a][s] += tARBS[ar][bs] * sAB_[r + noccA_][b + foccB_];
-                }
-            }
-        }
-    }
+    tARBS_overlap(tARBS, tAS_RB, tRB_AS);
 
     double **B_p_BS = get_BS_ints(1, foccB_);
     double **B_p_AS = get_AS_ints(1, foccA_);
@@ -577,15 +538,8 @@ double SAPT2p3::exch_ind_disp30_12(double **sBS) {
                 0.0, &(C_p_RB[b][0]), aoccB_ * (ndf_ + 3));
     }
 
-    double **xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, (ndf_ + 3), 1.0, &(C_p_RB[0][0]), (ndf_ + 3),
-                &(B_p_AS[a * nvirB_][0]), (ndf_ + 3), 0.0, &(xRBS[0][0]), nvirB_);
-        energy += C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy += tARBS_RBAS(tARBS, C_p_RB, B_p_AS);
 
-    free_block(xRBS);
     free_block(C_p_RB);
 
     double **B_p_AB = block_matrix(aoccA_ * aoccB_, (ndf_ + 3));
@@ -654,16 +608,9 @@ double SAPT2p3::exch_ind_disp30_12(double **sBS) {
                 nvirA_ * (ndf_ + 3), 0.0, &(C_p_RB[r * aoccB_][0]), (ndf_ + 3));
     }
 
-    xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, (ndf_ + 3), 1.0, &(C_p_RB[0][0]), (ndf_ + 3),
-                &(C_p_AS[a * nvirB_][0]), (ndf_ + 3), 0.0, &(xRBS[0][0]), nvirB_);
-        energy -= C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy -= tARBS_RBAS(tARBS, C_p_RB, C_p_AS);
 
     free_block(xAB);
-    free_block(xRBS);
     free_block(C_p_AS);
     free_block(C_p_RB);
 
@@ -819,16 +766,9 @@ double SAPT2p3::exch_ind_disp30_12(double **sBS) {
                 (ndf_ + 3), 0.0, &(C_p_AS[a * nvirB_][0]), (ndf_ + 3));
     }
 
-    xRBS = block_matrix(nvirA_ * aoccB_, nvirB_);
-
-    for (int a = 0; a < aoccA_; a++) {
-        C_DGEMM('N', 'T', nvirA_ * aoccB_, nvirB_, (ndf_ + 3), 1.0, &(C_p_RB[0][0]), (ndf_ + 3),
-                &(C_p_AS[a * nvirB_][0]), (ndf_ + 3), 0.0, &(xRBS[0][0]), nvirB_);
-        energy -= C_DDOT(nvirA_ * aoccB_ * nvirB_, tARBS[a * nvirA_], 1, xRBS[0], 1);
-    }
+    energy -= tARBS_RBAS(tARBS, C_p_RB, C_p_AS);
 
     free_block(xRS);
-    free_block(xRBS);
     free_block(C_p_AS);
     free_block(C_p_RB);
 
@@ -968,7 +968,7 @@ void SAPT2::cphf_solver(double **tAR, double **wBAR, double *evals, int intfile,
                         const char *RRints, size_t nocc, size_t nvir) {
     double **B_p_AR = block_matrix(nocc * nvir, ndf_ + 3);
 
-    psio_->read_entry(intfile, ARints, (char *)&(B_p_AR[0][0]), sizeof(double) * nocc * nvir * (ndf_ + 3));
+    read_DF_entry(intfile, ARints, (char *)&(B_p_AR[0][0]), sizeof(double) * nocc * nvir * (ndf_ + 3));
 
     double **Amat = block_matrix(nocc * nvir, nocc * nvir);
 
@@ -987,12 +987,12 @@ void SAPT2::cphf_solver(double **tAR, double **wBAR, double *evals, int intfile,
     double **B_p_AA = block_matrix(nocc * nocc, ndf_ + 3);
     double **B_p_R = block_matrix(nvir, ndf_ + 3);
 
-    psio_->read_entry(intfile, AAints, (char *)&(B_p_AA[0][0]), sizeof(double) * nocc * nocc * (ndf_ + 3));
+    read_DF_entry(intfile, AAints, (char *)&(B_p_AA[0][0]), sizeof(double) * nocc * nocc * (ndf_ + 3));
 
     psio_address next_PSIF = PSIO_ZERO;
 
     for (int r = 0; r < nvir; r++) {
-        psio_->read(intfile, RRints, (char *)&(B_p_R[0][0]), sizeof(double) * nvir * (ndf_ + 3), next_PSIF, &next_PSIF);
+        read_DF(intfile, RRints, (char *)&(B_p_R[0][0]), sizeof(double) * nvir * (ndf_ + 3), next_PSIF, &next_PSIF);
         for (int a = 0; a < nocc; a++) {
             int ar = a * nvir + r;
             C_DGEMM('N', 'T', nocc, nvir, ndf_, 1.0, B_p_AA[a * nocc], ndf_ + 3, B_p_R[0], ndf_ + 3, 1.0, Amat[ar],
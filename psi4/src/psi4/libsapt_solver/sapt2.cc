@@ -40,6 +40,8 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
 
+#include <algorithm>
+
 namespace psi {
 namespace sapt {
 
@@ -75,6 +77,12 @@ SAPT2::SAPT2(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefu
     nat_orbs_v4_ = options.get_bool("NAT_ORBS_V4");
     occ_cutoff_ = options.get_double("OCC_TOLERANCE");
 
+    // Whatever the working arrays of print_header's estimate leave over may hold DF integrals
+    long int occ = std::max(noccA_, noccB_);
+    long int vir = std::max(nvirA_, nvirB_);
+    df_ints_in_core_ = options.get_bool("SAPT_DF_INTS_IN_CORE");
+    df_ints_budget_ = std::max(0L, mem_ - vir * vir * (long int)ndf_ - 3L * occ * occ * vir * vir);
+
     ioff_ = (int *)malloc(sizeof(int) * (nso_ * (nso_ + 1) / 2));
     index2i_ = (int *)malloc(sizeof(int) * (nso_ * (nso_ + 1) / 2));
     index2j_ = (int *)malloc(sizeof(int) * (nso_ * (nso_ + 1) / 2));
@@ -460,6 +468,10 @@ void SAPT2::df_integrals() {
 
     psio_->open(PSIF_SAPT_TEMP, 0);
 
+    // The transformed integrals stay in core only if their sorted copies fit alongside them
+    if (df_ints_budget_ >= (long int)(nmoA_ * nmoA_ * (2 * ndf_ + 3)))
+        alloc_DF(PSIF_SAPT_TEMP, "MO AA RI Integrals", ndf_ * nmoA_ * nmoA_);
+
     double **AO_RI = block_matrix(maxPshell, nso_ * nso_);
     double *halftrans = init_array(nmoA_ * nso_);
     double **MO_RI = block_matrix(maxPshell, nmoA_ * nmoA_);
@@ -507,20 +519,21 @@ void SAPT2::df_integrals() {
             C_DGEMM('N', 'N', nmoA_, nmoA_, nso_, 1.0, halftrans, nso_, CA_[0], nmoA_, 0.0, MO_RI[P], nmoA_);
         }
 
-        psio_->write(PSIF_SAPT_TEMP, "MO AA RI Integrals", (char *)&(MO_RI[0][0]),
-                     sizeof(double) * numPshell * nmoA_ * nmoA_, next_DF_MO, &next_DF_MO);
+        write_DF(PSIF_SAPT_TEMP, "MO AA RI Integrals", (char *)&(MO_RI[0][0]),
+                 sizeof(double) * numPshell * nmoA_ * nmoA_, next_DF_MO, &next_DF_MO);
     }
 
     free_block(AO_RI);
     free(halftrans);
     free_block(MO_RI);
 
-    zero_disk(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", noccA_ * noccA_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", noccA_ * nvirA_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", nvirA_ * nvirA_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", noccA_ * noccA_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", noccA_ * nvirA_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", nvirA_ * nvirA_, ndf_ + 3);
 
+    // The sort buffers temp and temp_J come on top of the in-core DF integrals
     long int numP;
-    long int temp_size = mem_ / (2 * ndf_);
+    long int temp_size = std::max(1L, (mem_ - df_ints_size()) / (long int)(2 * ndf_ + 3));
 
     if (temp_size > nmoA_ * nmoA_) temp_size = nmoA_ * nmoA_;
 
@@ -541,8 +554,8 @@ void SAPT2::df_integrals() {
 
         next_DF_MO = psio_get_address(PSIO_ZERO, sizeof(double) * oP);
         for (int P = 0; P < ndf_; ++P) {
-            psio_->read(PSIF_SAPT_TEMP, "MO AA RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
-                        &next_DF_MO);
+            read_DF(PSIF_SAPT_TEMP, "MO AA RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
+                    &next_DF_MO);
             next_DF_MO = psio_get_address(next_DF_MO, sizeof(double) * (nmoA_ * nmoA_ - numP));
         }
 
@@ -556,8 +569,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoA_;
             int j = (ij + oP) % nmoA_;
             if (i < noccA_ && j < noccA_) {
-                psio_->write(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_AA, &next_DF_AA);
+                write_DF(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_AA, &next_DF_AA);
             }
         }
 
@@ -565,8 +578,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoA_;
             int j = (ij + oP) % nmoA_;
             if (i < noccA_ && j >= noccA_) {
-                psio_->write(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_AR, &next_DF_AR);
+                write_DF(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_AR, &next_DF_AR);
             }
         }
 
@@ -574,14 +587,16 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoA_;
             int j = (ij + oP) % nmoA_;
             if (i >= noccA_ && j >= noccA_) {
-                psio_->write(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_RR, &next_DF_RR);
+                write_DF(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_RR, &next_DF_RR);
             }
         }
 
         free_block(temp_J);
     }
 
+    free_DF(PSIF_SAPT_TEMP, "MO AA RI Integrals");
+
     AO_RI = block_matrix(maxPshell, nso_ * nso_);
     halftrans = init_array(nmoB_ * nso_);
     MO_RI = block_matrix(maxPshell, nmoB_ * nmoB_);
@@ -589,6 +604,9 @@ void SAPT2::df_integrals() {
     next_DF_MO = PSIO_ZERO;
     psio_address next_bare_BS = PSIO_ZERO;
 
+    if (df_ints_budget_ >= (long int)(nmoB_ * nmoB_ * (2 * ndf_ + 3)))
+        alloc_DF(PSIF_SAPT_TEMP, "MO BB RI Integrals", ndf_ * nmoB_ * nmoB_);
+
     for (int Pshell = 0; Pshell < ribasis_->nshell(); ++Pshell) {
         int numPshell = ribasis_->shell(Pshell).nfunction();
 
@@ -627,18 +645,19 @@ void SAPT2::df_integrals() {
             C_DGEMM('N', 'N', nmoB_, nmoB_, nso_, 1.0, halftrans, nso_, CB_[0], nmoB_, 0.0, MO_RI[P], nmoB_);
         }
 
-        psio_->write(PSIF_SAPT_TEMP, "MO BB RI Integrals", (char *)&(MO_RI[0][0]),
-                     sizeof(double) * numPshell * nmoB_ * nmoB_, next_DF_MO, &next_DF_MO);
+        write_DF(PSIF_SAPT_TEMP, "MO BB RI Integrals", (char *)&(MO_RI[0][0]),
+                 sizeof(double) * numPshell * nmoB_ * nmoB_, next_DF_MO, &next_DF_MO);
     }
 
     free_block(AO_RI);
     free(halftrans);
     free_block(MO_RI);
 
-    zero_disk(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", noccB_ * noccB_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", noccB_ * nvirB_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", nvirB_ * nvirB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", noccB_ * noccB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", noccB_ * nvirB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", nvirB_ * nvirB_, ndf_ + 3);
 
+    temp_size = std::max(1L, (mem_ - df_ints_size()) / (long int)(2 * ndf_ + 3));
     if (temp_size > nmoB_ * nmoB_) temp_size = nmoB_ * nmoB_;
 
     psio_address next_DF_BB = PSIO_ZERO;
@@ -655,8 +674,8 @@ void SAPT2::df_integrals() {
 
         next_DF_MO = psio_get_address(PSIO_ZERO, sizeof(double) * oP);
         for (int P = 0; P < ndf_; ++P) {
-            psio_->read(PSIF_SAPT_TEMP, "MO BB RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
-                        &next_DF_MO);
+            read_DF(PSIF_SAPT_TEMP, "MO BB RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
+                    &next_DF_MO);
             next_DF_MO = psio_get_address(next_DF_MO, sizeof(double) * (nmoB_ * nmoB_ - numP));
         }
 
@@ -670,8 +689,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i < noccB_ && j < noccB_) {
-                psio_->write(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_BB, &next_DF_BB);
+                write_DF(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_BB, &next_DF_BB);
             }
         }
 
@@ -679,8 +698,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i < noccB_ && j >= noccB_) {
-                psio_->write(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_BS, &next_DF_BS);
+                write_DF(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_BS, &next_DF_BS);
             }
         }
 
@@ -688,20 +707,25 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i >= noccB_ && j >= noccB_) {
-                psio_->write(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_SS, &next_DF_SS);
+                write_DF(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_SS, &next_DF_SS);
             }
         }
 
         free_block(temp_J);
     }
 
+    free_DF(PSIF_SAPT_TEMP, "MO BB RI Integrals");
+
     AO_RI = block_matrix(maxPshell, nso_ * nso_);
     halftrans = init_array(nmoA_ * nso_);
     MO_RI = block_matrix(maxPshell, nmoA_ * nmoB_);
 
     next_DF_MO = PSIO_ZERO;
 
+    if (df_ints_budget_ >= (long int)(nmoA_ * nmoB_ * (2 * ndf_ + 3)))
+        alloc_DF(PSIF_SAPT_TEMP, "MO AB RI Integrals", ndf_ * nmoA_ * nmoB_);
+
     for (int Pshell = 0; Pshell < ribasis_->nshell(); ++Pshell) {
         int numPshell = ribasis_->shell(Pshell).nfunction();
 
@@ -740,17 +764,18 @@ void SAPT2::df_integrals() {
             C_DGEMM('N', 'N', nmoA_, nmoB_, nso_, 1.0, halftrans, nso_, CB_[0], nmoB_, 0.0, MO_RI[P], nmoB_);
         }
 
-        psio_->write(PSIF_SAPT_TEMP, "MO AB RI Integrals", (char *)&(MO_RI[0][0]),
-                     sizeof(double) * numPshell * nmoA_ * nmoB_, next_DF_MO, &next_DF_MO);
+        write_DF(PSIF_SAPT_TEMP, "MO AB RI Integrals", (char *)&(MO_RI[0][0]),
+                 sizeof(double) * numPshell * nmoA_ * nmoB_, next_DF_MO, &next_DF_MO);
     }
 
     free_block(AO_RI);
     free_block(MO_RI);
 
-    zero_disk(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", noccA_ * noccB_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", noccA_ * nvirB_, ndf_ + 3);
-    zero_disk(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", nvirA_ * noccB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", noccA_ * noccB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", noccA_ * nvirB_, ndf_ + 3);
+    zero_DF(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", nvirA_ * noccB_, ndf_ + 3);
 
+    temp_size = std::max(1L, (mem_ - df_ints_size()) / (long int)(2 * ndf_ + 3));
     if (temp_size > nmoA_ * nmoB_) temp_size = nmoA_ * nmoB_;
 
     psio_address next_DF_AB = PSIO_ZERO;
@@ -767,8 +792,8 @@ void SAPT2::df_integrals() {
 
         next_DF_MO = psio_get_address(PSIO_ZERO, sizeof(double) * oP);
         for (int P = 0; P < ndf_; ++P) {
-            psio_->read(PSIF_SAPT_TEMP, "MO AB RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
-                        &next_DF_MO);
+            read_DF(PSIF_SAPT_TEMP, "MO AB RI Integrals", (char *)&(temp[P][0]), sizeof(double) * numP, next_DF_MO,
+                    &next_DF_MO);
             next_DF_MO = psio_get_address(next_DF_MO, sizeof(double) * (nmoA_ * nmoB_ - numP));
         }
 
@@ -782,8 +807,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i < noccA_ && j < noccB_) {
-                psio_->write(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_AB, &next_DF_AB);
+                write_DF(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_AB, &next_DF_AB);
             }
         }
 
@@ -791,8 +816,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i < noccA_ && j >= noccB_) {
-                psio_->write(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_AS, &next_DF_AS);
+                write_DF(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_AS, &next_DF_AS);
             }
         }
 
@@ -800,8 +825,8 @@ void SAPT2::df_integrals() {
             int i = (ij + oP) / nmoB_;
             int j = (ij + oP) % nmoB_;
             if (i >= noccA_ && j < noccB_) {
-                psio_->write(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", (char *)&(temp_J[ij][0]),
-                             sizeof(double) * (ndf_ + 3), next_DF_RB, &next_DF_RB);
+                write_DF(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", (char *)&(temp_J[ij][0]),
+                         sizeof(double) * (ndf_ + 3), next_DF_RB, &next_DF_RB);
             }
         }
 
@@ -812,8 +837,16 @@ void SAPT2::df_integrals() {
 
     free_block(J_mhalf);
 
+    free_DF(PSIF_SAPT_TEMP, "MO AB RI Integrals");
     psio_->close(PSIF_SAPT_TEMP, 0);
 
+    if (df_ints_in_core_ && print_) {
+        size_t incore = 0;
+        for (const auto &entry : df_ints_) incore += entry.second.size();
+        outfile->Printf("    %zu DF integral tensors held in core (%.1lf MB)\n\n", df_ints_.size(),
+                        8.0 * incore / 1000000.0);
+    }
+
     free(Schwartz);
     free(DFSchwartz);
     delete[] eri;
@@ -1000,8 +1033,8 @@ void SAPT2::natural_orbitalify_df_ints() {
                 C_p_AR[a * no_nvirA_], ndf_ + 3);
     }
 
-    psio_->write_entry(PSIF_SAPT_AA_DF_INTS, "AR NO RI Integrals", (char *)C_p_AR[0],
-                       sizeof(double) * noccA_ * no_nvirA_ * (ndf_ + 3));
+    write_DF_entry(PSIF_SAPT_AA_DF_INTS, "AR NO RI Integrals", (char *)C_p_AR[0],
+                   sizeof(double) * noccA_ * no_nvirA_ * (ndf_ + 3));
 
     free_block(B_p_AR);
     free_block(C_p_AR);
@@ -1014,8 +1047,8 @@ void SAPT2::natural_orbitalify_df_ints() {
                 C_p_BS[b * no_nvirB_], ndf_ + 3);
     }
 
-    psio_->write_entry(PSIF_SAPT_BB_DF_INTS, "BS NO RI Integrals", (char *)C_p_BS[0],
-                       sizeof(double) * noccB_ * no_nvirB_ * (ndf_ + 3));
+    write_DF_entry(PSIF_SAPT_BB_DF_INTS, "BS NO RI Integrals", (char *)C_p_BS[0],
+                   sizeof(double) * noccB_ * no_nvirB_ * (ndf_ + 3));
 
     free_block(B_p_BS);
     free_block(C_p_BS);
@@ -1035,8 +1068,8 @@ void SAPT2::natural_orbitalify_df_ints() {
                 D_p_RR[r * no_nvirA_], ndf_ + 3);
     }
 
-    psio_->write_entry(PSIF_SAPT_AA_DF_INTS, "RR NO RI Integrals", (char *)D_p_RR[0],
-                       sizeof(double) * no_nvirA_ * no_nvirA_ * (ndf_ + 3));
+    write_DF_entry(PSIF_SAPT_AA_DF_INTS, "RR NO RI Integrals", (char *)D_p_RR[0],
+                   sizeof(double) * no_nvirA_ * no_nvirA_ * (ndf_ + 3));
 
     free_block(C_p_RR);
     free_block(D_p_RR);
@@ -1056,8 +1089,8 @@ void SAPT2::natural_orbitalify_df_ints() {
                 D_p_SS[s * no_nvirB_], ndf_ + 3);
     }
 
-    psio_->write_entry(PSIF_SAPT_BB_DF_INTS, "SS NO RI Integrals", (char *)D_p_SS[0],
-                       sizeof(double) * no_nvirB_ * no_nvirB_ * (ndf_ + 3));
+    write_DF_entry(PSIF_SAPT_BB_DF_INTS, "SS NO RI Integrals", (char *)D_p_SS[0],
+                   sizeof(double) * no_nvirB_ * no_nvirB_ * (ndf_ + 3));
 
     free_block(C_p_SS);
     free_block(D_p_SS);
@@ -30,6 +30,12 @@
 #define SAPT2_H
 
 #include "sapt.h"
+#include "psi4/libpsio/config.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace psi {
 namespace sapt {
@@ -88,6 +94,11 @@ class SAPT2 : public SAPT {
     double **wABS_;
     double **wASS_;
 
+    // DF integrals held in core (SAPT_DF_INTS_IN_CORE), keyed by the file and label of their disk copy
+    bool df_ints_in_core_;
+    long int df_ints_budget_;
+    std::map<std::pair<int, std::string>, std::vector<double>> df_ints_;
+
     double **get_AA_ints(const int, int = 0, int = 0);
     double **get_diag_AA_ints(const int);
     double **get_AR_ints(const int, int = 0);
@@ -104,6 +115,15 @@ class SAPT2 : public SAPT {
     void w_integrals();
 
     double **get_DF_ints(int, const char *, int, int, int, int);
+
+    bool alloc_DF(int, const char *, size_t);
+    void free_DF(int, const char *);
+    long int df_ints_size() const;
+    void zero_DF(int, const char *, size_t, size_t);
+    void read_DF(int, const char *, char *, size_t, psio_address, psio_address *);
+    void read_DF_entry(int, const char *, char *, size_t);
+    void write_DF(int, const char *, const char *, size_t, psio_address, psio_address *);
+    void write_DF_entry(int, const char *, const char *, size_t);
     double **get_DF_ints_nongimp(int, const char *, int, int, int, int);
     void antisym(double *, size_t, size_t);
     void antisym(double **, size_t, size_t);
@@ -62,6 +62,10 @@ class SAPT2p : public SAPT2 {
     double disp220q_3(int, const char *, const char *, const char, int, const char *, size_t, size_t, size_t, size_t, size_t, size_t);
     double disp220q_4(int, const char *, const char *, const char, int, const char *, size_t, size_t, size_t, size_t, size_t, size_t);
 
+    // Number of threads for the explicitly threaded triples, capped so that the
+    // shared arrays plus one scratch set per thread fit in memory (doubles)
+    int triples_threads(long int shared_mem, long int thread_mem);
+
     double disp220t(int, const char *, const char *, const char *, int, const char *, int, const char *, size_t, size_t, size_t,
                     size_t, size_t, size_t, double *, double *);
 
@@ -28,9 +28,12 @@
 
 #include "sapt2p3.h"
 #include "psi4/physconst.h"
+#include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libqt/qt.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace psi {
 namespace sapt {
@@ -698,5 +701,83 @@ void SAPT2p3::print_results() {
         }
     }
 }
+
+void SAPT2p3::tARBS_overlap(double **tARBS, double **tAS_RB, double **tRB_AS) {
+    int nthreads = Process::environment.get_n_threads();
+
+    // Each thread owns a row of the target, so there is no reduction to make
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int r = 0; r < nvirA_; r++) {
+        for (int a = 0; a < aoccA_; a++) {
+            int ar = a * nvirA_ + r;
+            for (int b = 0, bs = 0; b < aoccB_; b++) {
+                for (int s = 0; s < nvirB_; s++, bs++) {
+                    tAS_RB[r][b] += tARBS[ar][bs] * sAB_[a + foccA_][s + noccB_];
+                }
+            }
+        }
+    }
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int a = 0; a < aoccA_; a++) {
+        for (int r = 0; r < nvirA_; r++) {
+            int ar = a * nvirA_ + r;
+            for (int b = 0, bs = 0; b < aoccB_; b++) {
+                for (int s = 0; s < nvirB_; s++, bs++) {
+                    tRB_AS[a][s] += tARBS[ar][bs] * sAB_[r + noccA_][b + foccB_];
+                }
+            }
+        }
+    }
+}
+
+double SAPT2p3::tARBS_RBAS(double **tARBS, double **X_p_RB, double **Y_p_AS) {
+    double energy = 0.0;
+
+    // Each thread builds (rb|as) for one a and a batch of rb rows; size the batches from what mem_ leaves
+    long int nrow = (long int)nvirA_ * aoccB_;
+    long int shared_mem = (long int)aoccA_ * nvirA_ * aoccB_ * nvirB_ + (nrow + (long int)aoccA_ * nvirB_) * (ndf_ + 3);
+    long int mem_avail = mem_ - shared_mem;
+
+    int nthreads = Process::environment.get_n_threads();
+    long int nvirB = nvirB_;
+    long int rows = nrow;
+    if (mem_avail < nthreads * rows * nvirB) {
+        nthreads = (int)std::max(1L, mem_avail / (rows * nvirB));
+        if (mem_avail < rows * nvirB) rows = std::max(1L, mem_avail / nvirB);
+    }
+    long int nbatch = (nrow + rows - 1) / rows;
+
+#ifdef USING_LAPACK_MKL
+    int mkl_threads = mkl_get_max_threads();
+    if (nthreads > 1) mkl_set_num_threads(1);
+#endif
+
+    std::vector<double **> xRBS(nthreads);
+    for (int thread = 0; thread < nthreads; thread++) xRBS[thread] = block_matrix(rows, nvirB_);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : energy)
+    for (long int task = 0; task < aoccA_ * nbatch; task++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        long int a = task / nbatch;
+        long int rb0 = (task % nbatch) * rows;
+        long int nrb = std::min(rows, nrow - rb0);
+        C_DGEMM('N', 'T', nrb, nvirB_, ndf_ + 3, 1.0, &(X_p_RB[rb0][0]), ndf_ + 3, &(Y_p_AS[a * nvirB_][0]), ndf_ + 3,
+                0.0, &(xRBS[thread][0][0]), nvirB_);
+        energy += C_DDOT(nrb * nvirB_, &(tARBS[a * nvirA_][rb0 * nvirB_]), 1, xRBS[thread][0], 1);
+    }
+
+    for (int thread = 0; thread < nthreads; thread++) free_block(xRBS[thread]);
+
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(mkl_threads);
+#endif
+
+    return energy;
+}
+
 }  // namespace sapt
 }  // namespace psi
@@ -84,6 +84,11 @@ class SAPT2p3 : public SAPT2p {
     double exch_ind30_2(double **);
     double exch_ind30_3(double **);
 
+    // Overlap contractions of tARBS: tAS_RB[r][b] and tRB_AS[a][s]
+    void tARBS_overlap(double **tARBS, double **tAS_RB, double **tRB_AS);
+    // sum_{arbs} tARBS[ar][bs] * sum_P X_p_RB[rb][P] * Y_p_AS[as][P]
+    double tARBS_RBAS(double **tARBS, double **X_p_RB, double **Y_p_AS);
+
     double exch_ind_disp30_21(double **);
     double exch_ind_disp30_12(double **);
 
@@ -1071,8 +1071,8 @@ double **SAPT2::get_diag_AA_ints(const int dress) {
 
     psio_address next_PSIF = PSIO_ZERO;
     for (int a = 0; a < noccA_; a++) {
-        psio_->read(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(A[a][0]), sizeof(double) * (ndf_ + 3), next_PSIF,
-                    &next_PSIF);
+        read_DF(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(A[a][0]), sizeof(double) * (ndf_ + 3), next_PSIF,
+                &next_PSIF);
         next_PSIF = psio_get_address(next_PSIF, sizeof(double) * noccA_ * (ndf_ + 3));
         if (dress) {
             A[a][ndf_] = 1.0;
@@ -1111,8 +1111,8 @@ double **SAPT2::get_diag_BB_ints(const int dress) {
 
     psio_address next_PSIF = PSIO_ZERO;
     for (int b = 0; b < noccB_; b++) {
-        psio_->read(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(A[b][0]), sizeof(double) * (ndf_ + 3), next_PSIF,
-                    &next_PSIF);
+        read_DF(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(A[b][0]), sizeof(double) * (ndf_ + 3), next_PSIF,
+                &next_PSIF);
         next_PSIF = psio_get_address(next_PSIF, sizeof(double) * noccB_ * (ndf_ + 3));
         if (dress) {
             A[b][ndf_] = vABB_[b][b] / (double)NA_;
@@ -1187,8 +1187,8 @@ double **SAPT2::get_RR_ints(const int dress) {
 
     double **A = block_matrix(nvirA_ * nvirA_, ndf_ + 3);
 
-    psio_->read_entry(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(A[0][0]),
-                      sizeof(double) * nvirA_ * nvirA_ * (ndf_ + 3));
+    read_DF_entry(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(A[0][0]),
+                  sizeof(double) * nvirA_ * nvirA_ * (ndf_ + 3));
 
     if (dress) {
         for (int r = 0, rrp = 0; r < nvirA_; r++) {
@@ -1209,8 +1209,8 @@ double **SAPT2::get_SS_ints(const int dress) {
 
     double **A = block_matrix(nvirB_ * nvirB_, ndf_ + 3);
 
-    psio_->read_entry(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(A[0][0]),
-                      sizeof(double) * nvirB_ * nvirB_ * (ndf_ + 3));
+    read_DF_entry(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(A[0][0]),
+                  sizeof(double) * nvirB_ * nvirB_ * (ndf_ + 3));
 
     if (dress) {
         for (int s = 0, ssp = 0; s < nvirB_; s++) {
@@ -1286,22 +1286,109 @@ double **SAPT2::get_DF_ints(int filenum, const char *label, int startA, int stop
     double **A = block_matrix(lengthAB, ndf_ + 3);
 
     if (startA == 0 && startB == 0) {
-        psio_->read_entry(filenum, label, (char *)A[0], sizeof(double) * lengthAB * (ndf_ + 3));
+        read_DF_entry(filenum, label, (char *)A[0], sizeof(double) * lengthAB * (ndf_ + 3));
     } else if (startB == 0) {
         psio_address next_PSIF = psio_get_address(PSIO_ZERO, sizeof(double) * startA * lengthB * (ndf_ + 3));
-        psio_->read(filenum, label, (char *)A[0], sizeof(double) * lengthAB * (ndf_ + 3), next_PSIF, &next_PSIF);
+        read_DF(filenum, label, (char *)A[0], sizeof(double) * lengthAB * (ndf_ + 3), next_PSIF, &next_PSIF);
     } else {
         psio_address next_PSIF = psio_get_address(PSIO_ZERO, sizeof(double) * startA * stopB * (ndf_ + 3));
         for (int i = 0; i < lengthA; i++) {
             next_PSIF = psio_get_address(next_PSIF, sizeof(double) * startB * (ndf_ + 3));
-            psio_->read(filenum, label, (char *)A[i * lengthB], sizeof(double) * lengthB * (ndf_ + 3), next_PSIF,
-                        &next_PSIF);
+            read_DF(filenum, label, (char *)A[i * lengthB], sizeof(double) * lengthB * (ndf_ + 3), next_PSIF,
+                    &next_PSIF);
         }
     }
 
     return (A);
 }
 
+// The in-core DF integrals mirror the layout of their disk copy, so disk addresses become offsets
+static size_t psio_address_bytes(psio_address address) { return address.page * PSIO_PAGELEN + address.offset; }
+
+bool SAPT2::alloc_DF(int filenum, const char *label, size_t length) {
+    if (!df_ints_in_core_) return false;
+
+    auto key = std::make_pair(filenum, std::string(label));
+    auto entry = df_ints_.find(key);
+    if (entry != df_ints_.end()) {
+        if (entry->second.size() == length) return true;
+        df_ints_budget_ += entry->second.size();
+        df_ints_.erase(entry);
+    }
+
+    if ((long int)length > df_ints_budget_) return false;
+
+    df_ints_[key].assign(length, 0.0);
+    df_ints_budget_ -= length;
+
+    return true;
+}
+
+void SAPT2::free_DF(int filenum, const char *label) {
+    auto entry = df_ints_.find(std::make_pair(filenum, std::string(label)));
+    if (entry == df_ints_.end()) return;
+
+    df_ints_budget_ += entry->second.size();
+    df_ints_.erase(entry);
+}
+
+// Doubles held by the in-core DF integrals
+long int SAPT2::df_ints_size() const {
+    long int size = 0;
+    for (const auto &entry : df_ints_) size += entry.second.size();
+    return size;
+}
+
+void SAPT2::zero_DF(int filenum, const char *label, size_t rows, size_t columns) {
+    if (!alloc_DF(filenum, label, rows * columns)) zero_disk(filenum, label, rows, columns);
+}
+
+void SAPT2::read_DF(int filenum, const char *label, char *buffer, size_t size, psio_address start,
+                    psio_address *end) {
+    auto entry = df_ints_.find(std::make_pair(filenum, std::string(label)));
+    if (entry == df_ints_.end()) {
+        psio_->read(filenum, label, buffer, size, start, end);
+        return;
+    }
+
+    size_t offset = psio_address_bytes(start);
+    if (offset + size > sizeof(double) * entry->second.size())
+        throw PSIEXCEPTION("SAPT2: read beyond the end of in-core DF integrals " + std::string(label));
+
+    ::memcpy(buffer, (char *)entry->second.data() + offset, size);
+    *end = psio_get_address(start, size);
+}
+
+void SAPT2::read_DF_entry(int filenum, const char *label, char *buffer, size_t size) {
+    psio_address end;
+    read_DF(filenum, label, buffer, size, PSIO_ZERO, &end);
+}
+
+void SAPT2::write_DF(int filenum, const char *label, const char *buffer, size_t size, psio_address start,
+                     psio_address *end) {
+    auto entry = df_ints_.find(std::make_pair(filenum, std::string(label)));
+    if (entry == df_ints_.end()) {
+        psio_->write(filenum, label, const_cast<char *>(buffer), size, start, end);
+        return;
+    }
+
+    size_t offset = psio_address_bytes(start);
+    if (offset + size > sizeof(double) * entry->second.size())
+        throw PSIEXCEPTION("SAPT2: write beyond the end of in-core DF integrals " + std::string(label));
+
+    ::memcpy((char *)entry->second.data() + offset, buffer, size);
+    *end = psio_get_address(start, size);
+}
+
+void SAPT2::write_DF_entry(int filenum, const char *label, const char *buffer, size_t size) {
+    if (alloc_DF(filenum, label, size / sizeof(double))) {
+        psio_address end;
+        write_DF(filenum, label, buffer, size, PSIO_ZERO, &end);
+    } else {
+        psio_->write_entry(filenum, label, const_cast<char *>(buffer), size);
+    }
+}
+
 double **SAPT2::get_DF_ints_nongimp(int filenum, const char *label, int startA, int stopA, int startB, int stopB) {
     int lengthA = stopA - startA;
     int lengthB = stopB - startB;
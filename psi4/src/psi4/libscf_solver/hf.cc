@@ -60,6 +60,7 @@
 #include "psi4/libmints/mintshelper.h"
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/matrix_product.h"
 #include "psi4/libmints/extern.h"
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/pointgrp.h"
@@ -1374,28 +1375,60 @@ SharedMatrix HF::form_Fia(SharedMatrix Fso, SharedMatrix Cso, int* noccpi) {
     return Fia;
 }
 SharedMatrix HF::form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso) {
-    auto FDSmSDF = std::make_shared<Matrix>("FDS-SDF", nirrep_, nsopi_, nsopi_);
-    auto DS = std::make_shared<Matrix>("DS", nirrep_, nsopi_, nsopi_);
-
-    DS->gemm(false, false, 1.0, Dso, S_, 0.0);
-    FDSmSDF->gemm(false, false, 1.0, Fso, DS, 0.0);
-
-    SharedMatrix SDF(FDSmSDF->transpose());
-    FDSmSDF->subtract(SDF);
-
-    DS.reset();
-    SDF.reset();
-
-    auto XP = std::make_shared<Matrix>("X'(FDS - SDF)", nirrep_, nmopi_, nsopi_);
-    auto XPX = std::make_shared<Matrix>("X'(FDS - SDF)X", nirrep_, nmopi_, nmopi_);
-    XP->gemm(true, false, 1.0, X_, FDSmSDF, 0.0);
-    XPX->gemm(false, false, 1.0, XP, X_, 0.0);
+    // F, D and S are symmetric, so SDF = (FDS)^T and the commutator is antisymmetrized in place.
+    // The chains keep their intermediates on the wavefunction; set() rebinds this iteration's F and D.
+    if (FDS_chain_.size() == 0 || !FDS_chain_.conforms(0, Fso) || !XPX_chain_.conforms(0, X_)) {
+        FDS_chain_ = linalg::MatrixProduct();
+        FDS_chain_.append(Fso, false, true).append(Dso, false, true).append(S_, false, true);
+        FDSmSDF_ = std::make_shared<Matrix>("FDS - SDF", Fso->rowspi(), Fso->colspi());
+        XPX_chain_ = linalg::MatrixProduct();
+        XPX_chain_.append(X_, true).append(FDSmSDF_).append(X_);
+    } else {
+        FDS_chain_.set(0, Fso);
+        FDS_chain_.set(1, Dso);
+        FDS_chain_.set(2, S_);
+        XPX_chain_.set(0, X_);
+        XPX_chain_.set(2, X_);
+    }
+    FDS_chain_.evaluate(*FDSmSDF_);
+    for (int h = 0; h < nirrep_; ++h) {
+        double** Gp = FDSmSDF_->pointer(h);
+        for (int p = 0; p < nsopi_[h]; ++p) {
+            Gp[p][p] = 0.0;
+            for (int q = 0; q < p; ++q) {
+                double val = Gp[p][q] - Gp[q][p];
+                Gp[p][q] = val;
+                Gp[q][p] = -val;
+            }
+        }
+    }
 
-    // XPX->print();
+    auto XPX = XPX_chain_.evaluate();
+    XPX->set_name("X'(FDS - SDF)X");
 
     return XPX;
 }
 
+void HF::bind_onel_Hx(linalg::MatrixProduct& occ, linalg::MatrixProduct& vir, SharedMatrix F, SharedMatrix Co,
+                      SharedMatrix Cv, SharedMatrix x) {
+    // F is symmetric, so both Fock blocks are formed with DSYMM
+    if (occ.size() == 0 || !occ.conforms(0, Co) || !occ.conforms(3, x) || !vir.conforms(1, Cv)) {
+        occ = linalg::MatrixProduct();
+        occ.append(Co, true).append(F, false, true).append(Co).append(x);
+        vir = linalg::MatrixProduct();
+        vir.append(x).append(Cv, true).append(F, false, true).append(Cv);
+        return;
+    }
+    occ.set(0, Co);
+    occ.set(1, F);
+    occ.set(2, Co);
+    occ.set(3, x);
+    vir.set(0, x);
+    vir.set(1, Cv);
+    vir.set(2, F);
+    vir.set(3, Cv);
+}
+
 void HF::print_stability_analysis(std::vector<std::pair<double, int> >& vec) {
     std::sort(vec.begin(), vec.end());
     std::vector<std::pair<double, int> >::const_iterator iter = vec.begin();
@@ -33,6 +33,7 @@
 #include <functional>
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libmints/vector3.h"
+#include "psi4/libmints/matrix_product.h"
 #include "psi4/psi4-dec.h"
 
 namespace psi {
@@ -67,6 +68,11 @@ class HF : public Wavefunction {
     SharedMatrix diag_F_temp_;
     /// Temporary matrix for diagonalize_F
     SharedMatrix diag_C_temp_;
+    /// F D S and X^T (FDS - SDF) X chains for form_FDSmSDF, rebound every iteration
+    linalg::MatrixProduct FDS_chain_;
+    linalg::MatrixProduct XPX_chain_;
+    /// FDS - SDF, for form_FDSmSDF
+    SharedMatrix FDSmSDF_;
     /// List of external potentials to add to Fock matrix and updated at every iteration
     /// e.g. PCM potential
     std::vector<SharedMatrix> external_potentials_;
@@ -223,6 +229,10 @@ class HF : public Wavefunction {
     /** Form X'(FDS - SDF)X (for DIIS) **/
     virtual SharedMatrix form_FDSmSDF(SharedMatrix Fso, SharedMatrix Dso);
 
+    /** Point the onel_Hx chains Co'F Co x and x Cv'F Cv at new factors, rebuilding them if the shapes changed **/
+    void bind_onel_Hx(linalg::MatrixProduct& occ, linalg::MatrixProduct& vir, SharedMatrix F, SharedMatrix Co,
+                      SharedMatrix Cv, SharedMatrix x);
+
     /** Performs any operations required for a incoming guess **/
     virtual void format_guess();
 
@@ -291,6 +301,8 @@ class HF : public Wavefunction {
 
     /// Sets the internal JK object (expert)
     void set_jk(std::shared_ptr<JK> jk);
+    /// Drops the internal JK object, e.g. one kept with SAVE_JK (expert)
+    void reset_jk() { jk_.reset(); }
 
     /// The DFT Functional object (or null if it has been deleted)
     std::shared_ptr<SuperFunctional> functional() const { return functional_; }
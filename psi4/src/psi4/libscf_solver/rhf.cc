@@ -50,6 +50,7 @@
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/matrix_product.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
@@ -429,11 +430,9 @@ std::vector<SharedMatrix> RHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
             Cv = Cvir_so;
         }
 
-        SharedMatrix tmp1 = linalg::triplet(Co, F, Co, true, false, false);
-        SharedMatrix result = linalg::doublet(tmp1, x_vec[i], false, false);
-
-        SharedMatrix tmp2 = linalg::triplet(x_vec[i], Cv, F, false, true, false);
-        result->gemm(false, false, -1.0, tmp2, Cv, 1.0);
+        bind_onel_Hx(onel_Hx_occ_, onel_Hx_vir_, F, Co, Cv, x_vec[i]);
+        SharedMatrix result = onel_Hx_occ_.evaluate();
+        onel_Hx_vir_.evaluate(*result, -1.0, 1.0);
 
         ret.push_back(result);
     }
@@ -45,6 +45,9 @@ class RHF : public HF {
     SharedMatrix J_;
     SharedMatrix K_;
     SharedMatrix wK_;
+    /// Co'F Co x and x Cv'F Cv chains of onel_Hx, reused across calls
+    linalg::MatrixProduct onel_Hx_occ_;
+    linalg::MatrixProduct onel_Hx_vir_;
 
     double compute_initial_E() override;
 
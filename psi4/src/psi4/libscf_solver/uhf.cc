@@ -51,6 +51,7 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/matrix_product.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/liboptions/liboptions.h"
@@ -466,20 +467,16 @@ std::vector<SharedMatrix> UHF::onel_Hx(std::vector<SharedMatrix> x_vec) {
             Cbv = Cbvir_so;
         }
         // Alpha
-        SharedMatrix tmp1 = linalg::triplet(Cao, Fa, Cao, true, false, false);
-        SharedMatrix result = linalg::doublet(tmp1, x_vec[2 * i], false, false);
-
-        SharedMatrix tmp2 = linalg::triplet(x_vec[2 * i], Cav, Fa, false, true, false);
-        result->gemm(false, false, -1.0, tmp2, Cav, 1.0);
+        bind_onel_Hx(onel_Hx_occ_[0], onel_Hx_vir_[0], Fa, Cao, Cav, x_vec[2 * i]);
+        SharedMatrix result = onel_Hx_occ_[0].evaluate();
+        onel_Hx_vir_[0].evaluate(*result, -1.0, 1.0);
 
         ret.push_back(result);
 
         // Beta
-        tmp1 = linalg::triplet(Cbo, Fb, Cbo, true, false, false);
-        result = linalg::doublet(tmp1, x_vec[2 * i + 1], false, false);
-
-        tmp2 = linalg::triplet(x_vec[2 * i + 1], Cbv, Fb, false, true, false);
-        result->gemm(false, false, -1.0, tmp2, Cbv, 1.0);
+        bind_onel_Hx(onel_Hx_occ_[1], onel_Hx_vir_[1], Fb, Cbo, Cbv, x_vec[2 * i + 1]);
+        result = onel_Hx_occ_[1].evaluate();
+        onel_Hx_vir_[1].evaluate(*result, -1.0, 1.0);
 
         ret.push_back(result);
     }
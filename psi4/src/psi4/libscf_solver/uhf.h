@@ -40,6 +40,9 @@ class UHF : public HF {
     SharedMatrix Dt_, Dt_old_;
     SharedMatrix Da_old_, Db_old_;
     SharedMatrix Ga_, Gb_, J_, Ka_, Kb_, wKa_, wKb_;
+    /// Co'F Co x and x Cv'F Cv chains of onel_Hx for alpha and beta, reused across calls
+    linalg::MatrixProduct onel_Hx_occ_[2];
+    linalg::MatrixProduct onel_Hx_vir_[2];
 
     double compute_initial_E() override;
     bool stability_analysis_pk();
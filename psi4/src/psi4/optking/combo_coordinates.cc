@@ -32,6 +32,7 @@
 */
 
 #include "coordinates.h"
+#include "sparse_b.h"
 #include "psi4/optking/physconst.h"
 #include <sstream>
 #include "print.h"
@@ -83,6 +84,23 @@ bool COMBO_COORDINATES::DqDx(GeomType geom, int lookup, double *dqdx, int atom_o
   return true;
 }
 
+// Adds the B matrix row for one coordinate to a sparse B matrix.
+bool COMBO_COORDINATES::DqDx(GeomType geom, int lookup, SPARSE_B &B, int row, int atom_offset) const {
+  for (std::size_t s=0; s<index.at(lookup).size(); ++s) {          // loop over simples in combo
+    double **dqdx_simple = simples.at(index[lookup][s])->DqDx(geom);
+
+    for (int j=0; j < simples[ index[lookup][s] ]->g_natom(); ++j) { // loop over atoms in s vector
+      int atom = atom_offset + simples[ index[lookup][s] ]->g_atom(j);
+
+      for (int xyz=0; xyz<3; ++xyz)
+        B.add(row, 3*atom + xyz, coeff.at(lookup).at(s) * dqdx_simple[j][xyz]);
+    }
+
+    free_matrix(dqdx_simple);
+  }
+  return true;
+}
+
 // Fills in a B' derivative matrix for one coordinate.
 // If the desired cartesian indices/dimension spans more than just one fragment, provide the atom offset.
 
@@ -42,6 +42,8 @@ using std::string;
 
 namespace opt {
 
+class SPARSE_B;
+
 class COMBO_COORDINATES {
 
   private:
@@ -67,6 +69,9 @@ class COMBO_COORDINATES {
   // possibly more than just one fragment, then provide the atom offset.
   bool DqDx(GeomType geom, int lookup, double *dqdx, int frag_atom_offset=0) const;
 
+  // Adds the B matrix row for one coordinate to row 'row' of a sparse B matrix.
+  bool DqDx(GeomType geom, int lookup, SPARSE_B &B, int row, int frag_atom_offset=0) const;
+
   // Fills in a B' derivative matrix for one coordinate.
   // If the desired cartesian indices/dimension spans the molecule, i.e.,
   // possibly more than just one fragment, then provide the atom offset.
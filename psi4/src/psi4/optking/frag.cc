@@ -655,6 +655,12 @@ void FRAG::compute_B(double **B, int coord_offset, int atom_offset) const {
     coords.DqDx(geom, cc, B[coord_offset+cc], atom_offset);
 }
 
+// Adds B matrix elements of coordinates for this fragment to a sparse B matrix.
+void FRAG::compute_B(SPARSE_B &B, int coord_offset, int atom_offset) const {
+  for (int cc=0; cc<Ncoord(); ++cc)
+    coords.DqDx(geom, cc, B, coord_offset+cc, atom_offset);
+}
+
 
 // Returns B matrix of only the simple coordinates for this fragment.
 /*
@@ -39,6 +39,7 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "print.h"
 #include "coordinates.h"
+#include "sparse_b.h"
 #include "psi4/psi4-dec.h"
 
 namespace opt {
@@ -135,6 +136,9 @@ class FRAG {
   // Compute B matrix. Use prevously allocated memory.  Offsets are ideal for molecule.
   void compute_B(double **B_in, int coord_offset, int atom_offset) const ;
 
+  // Add B matrix elements to a sparse B matrix.  Offsets are ideal for molecule.
+  void compute_B(SPARSE_B &B, int coord_offset, int atom_offset) const ;
+
   // Compute B only for the simple coordinates.
   //void compute_B_simples(double **B, int coord_offset, int atom_offset) const;
 
@@ -251,8 +251,11 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
   double * first_geom = init_array(Ncarts); // first try at back-transformation
   double * dx = init_array(Ncarts);
   double * tmp_v_Nints = init_array(Nints);
-  double **B = init_matrix(Nints, Ncarts);
-  double **G = init_matrix(Nints, Nints);
+
+  // With many coordinates dx = B^-1 dq is found by conjugate gradients with a sparse B.
+  bool sparse = use_sparse_B(Nints);
+  double **B = sparse ? nullptr : init_matrix(Nints, Ncarts);
+  double **G = sparse ? nullptr : init_matrix(Nints, Nints);
 
   bool bt_iter_done = false;
   bool bt_converged = true;
@@ -284,14 +287,21 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
     // B dx = B * (Bt (B Bt)^-1) dq
     //   dx = Bt (B Bt)^-1 dq
     //   dx = Bt G^-1 dq, where G = B B^t.
-    compute_B(B,0,0);
-    opt_matrix_mult(B, false, B, true, G, false, Nints, Ncarts, Nints, false);
-
-    // u B^t (G_inv dq) = dx
-    G_inv = symm_matrix_inv(G, Nints, true);
-    opt_matrix_mult(G_inv, false, &dq, true, &tmp_v_Nints, true, Nints, Nints, 1, false);
-    opt_matrix_mult(B, true, &tmp_v_Nints, true, &dx, true, Ncarts, Nints, 1, false);
-    free_matrix(G_inv);
+    if (sparse) {
+      SPARSE_B B_sparse(Nints, Ncarts);
+      compute_B(B_sparse, 0, 0);
+      B_sparse.pinv(dq, dx);
+    }
+    else {
+      compute_B(B,0,0);
+      opt_matrix_mult(B, false, B, true, G, false, Nints, Ncarts, Nints, false);
+
+      // u B^t (G_inv dq) = dx
+      G_inv = symm_matrix_inv(G, Nints, true);
+      opt_matrix_mult(G_inv, false, &dq, true, &tmp_v_Nints, true, Nints, Nints, 1, false);
+      opt_matrix_mult(B, true, &tmp_v_Nints, true, &dx, true, Ncarts, Nints, 1, false);
+      free_matrix(G_inv);
+    }
 
     for (i=0; i<Ncarts; ++i)
       new_geom[i] += dx[i];
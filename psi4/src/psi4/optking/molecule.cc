@@ -56,6 +56,24 @@
 
 namespace opt {
 
+// A <- O A O for a symmetric matrix A and a symmetric operator O that is only
+// available as a function applying it to one vector.
+template <typename Op>
+static void symm_matrix_sandwich(double **A, int dim, Op apply_O) {
+  double **T = init_matrix(dim, dim);
+  for (int j=0; j<dim; ++j) // T = (O A)^t
+    apply_O(A[j], T[j]);
+  for (int i=0; i<dim; ++i) // T = O A
+    for (int j=0; j<i; ++j) {
+      double tval = T[i][j];
+      T[i][j] = T[j][i];
+      T[j][i] = tval;
+    }
+  for (int j=0; j<dim; ++j) // rows of O (O A)^t = columns of O A O
+    apply_O(T[j], A[j]);
+  free_matrix(T);
+}
+
 // if allocate_fragment, then read the number of atoms and allocate memory for
 //   a fragment of that size.  Otherwise, this is an empty constructor.
 
@@ -98,31 +116,43 @@ void MOLECULE::forces() {
   if (Opt_params.print_lvl > 3)
     oprint_array_out_precise(f_x, Ncart);
 
-  // B (u f_x)
-  B = compute_B();
-  if (Opt_params.print_lvl >= 3) {
-    oprintf_out( "B matrix\n");
-    oprint_matrix_out(B, Nintco, Ncart);
+  double * f_q = p_Opt_data->g_forces_pointer();
+
+  if (use_sparse_B(Nintco)) {
+    // f_q = G^-1 (B f_x) with conjugate gradients
+    SPARSE_B Bs = compute_sparse_B();
+    temp_arr = init_array(Nintco);
+    Bs.mult(f_x, temp_arr);
+    free_array(f_x);
+    Bs.G_inv_mult(temp_arr, f_q);
+    free_array(temp_arr);
   }
-  temp_arr = init_array(Nintco);
-  opt_matrix_mult(B, false, &f_x, true, &temp_arr, true, Nintco, Ncart, 1, false);
-  free_array(f_x);
+  else {
+    // B (u f_x)
+    B = compute_B();
+    if (Opt_params.print_lvl >= 3) {
+      oprintf_out( "B matrix\n");
+      oprint_matrix_out(B, Nintco, Ncart);
+    }
+    temp_arr = init_array(Nintco);
+    opt_matrix_mult(B, false, &f_x, true, &temp_arr, true, Nintco, Ncart, 1, false);
+    free_array(f_x);
 
-  // G^-1 = (BuBt)^-1
-  G = init_matrix(Nintco, Nintco);
-  for (int i=0; i<Nintco; ++i)
-    for (int k=0; k<Ncart; ++k)
-      for (int j=0; j<Nintco; ++j)
-        G[i][j] += B[i][k] * /* u[k] * */ B[j][k];
-  free_matrix(B);
+    // G^-1 = (BuBt)^-1
+    G = init_matrix(Nintco, Nintco);
+    for (int i=0; i<Nintco; ++i)
+      for (int k=0; k<Ncart; ++k)
+        for (int j=0; j<Nintco; ++j)
+          G[i][j] += B[i][k] * /* u[k] * */ B[j][k];
+    free_matrix(B);
 
-  G_inv = symm_matrix_inv(G, Nintco, true);
-  free_matrix(G);
+    G_inv = symm_matrix_inv(G, Nintco, true);
+    free_matrix(G);
 
-  double * f_q = p_Opt_data->g_forces_pointer();
-  opt_matrix_mult(G_inv, false, &temp_arr, true, &f_q, true, Nintco, Nintco, 1, false);
-  free_matrix(G_inv);
-  free_array(temp_arr);
+    opt_matrix_mult(G_inv, false, &temp_arr, true, &f_q, true, Nintco, Nintco, 1, false);
+    free_matrix(G_inv);
+    free_array(temp_arr);
+  }
 
   // append exernally determined fb forces
   double * fb_force;
@@ -218,6 +248,11 @@ void MOLECULE::apply_constraint_forces() {
 void MOLECULE::project_f_and_H() {
   int Nintco = Ncoord();
 
+  if (use_sparse_B(Nintco)) {
+    project_f_and_H_sparse();
+    return;
+  }
+
   // compute G = B B^t
   double **G = compute_G(false);
 
@@ -285,6 +320,12 @@ void MOLECULE::project_f_and_H() {
     //oprint_array_out_precise(f_q, Ncoord());
   }
 
+  // The L-BFGS step does not use the Hessian
+  if (Opt_params.step_type == OPT_PARAMS::LBFGS) {
+    free_matrix(P);
+    return;
+  }
+
   // Project redundances and constraints out of Hessian matrix
   // Peng, Ayala, Schlegel, JCC 1996 give H -> PHP + 1000(1-P)
   // The second term appears unnecessary and sometimes messes up Hessian updating.
@@ -312,6 +353,99 @@ void MOLECULE::project_f_and_H() {
 
 }
 
+// project_f_and_H() with the sparse B matrix.  P' = G G^-1 is only applied to
+// vectors; the constraint term P' C (C P' C)^-1 C P' needs the columns of P' C
+// for the constrained coordinates only.
+void MOLECULE::project_f_and_H_sparse() {
+  int Nintco = Ncoord();
+  SPARSE_B B = compute_sparse_B();
+
+  if (Opt_params.print_lvl >= 3)
+    oprintf_out("\tProjecting redundancies with a sparse B matrix (%zu elements).\n", B.nnz());
+
+  double **C = compute_constraints();
+  std::vector<int> K; // constrained coordinates
+  for (int i=0; i<Nintco; ++i)
+    for (int j=0; j<Nintco; ++j)
+      if (C[i][j] != 0) {
+        K.push_back(i);
+        break;
+      }
+  int nK = K.size();
+
+  // PC[b] = P' C e_K[b] ; M = (C P' C) restricted to K
+  double **PC = nullptr, **M_inv = nullptr;
+  if (nK) {
+    PC = init_matrix(nK, Nintco);
+    double *Ccol = init_array(Nintco);
+    for (int b=0; b<nK; ++b) {
+      for (int i=0; i<Nintco; ++i)
+        Ccol[i] = C[i][K[b]];
+      B.project(Ccol, PC[b]);
+    }
+    free_array(Ccol);
+
+    double **M = init_matrix(nK, nK);
+    for (int a=0; a<nK; ++a)
+      for (int b=0; b<nK; ++b)
+        M[a][b] = array_dot(C[K[a]], PC[b], Nintco);
+    M_inv = symm_matrix_inv(M, nK, true);
+    free_matrix(M);
+  }
+
+  double *t = (nK ? init_array(nK) : nullptr);
+  double *u = (nK ? init_array(nK) : nullptr);
+
+  // Pv = P' v - P' C (C P' C)^-1 C P' v
+  auto apply_P = [&](const double *v, double *Pv) {
+    B.project(v, Pv);
+    if (!nK) return;
+    for (int a=0; a<nK; ++a)
+      t[a] = array_dot(C[K[a]], Pv, Nintco);
+    for (int a=0; a<nK; ++a)
+      u[a] = array_dot(M_inv[a], t, nK);
+    for (int b=0; b<nK; ++b)
+      for (int i=0; i<Nintco; ++i)
+        Pv[i] -= PC[b][i] * u[b];
+  };
+
+  // Project redundancies and contraints out of forces
+  double *f_q = p_Opt_data->g_forces_pointer();
+  double *temp_arr = init_array(Nintco);
+  apply_P(f_q, temp_arr);
+  array_copy(temp_arr, f_q, Nintco);
+  free_array(temp_arr);
+
+  if (Opt_params.print_lvl >= 3) {
+    oprintf_out("\tInternal forces in au, after projection of redundancies and constraints.\n");
+    if (Opt_params.fb_fragments)
+      oprintf_out("\tFB external coordinates are not projected.\n");
+    oprint_array_out(f_q, Ncoord());
+  }
+
+  // Project redundances and constraints out of Hessian matrix, H -> PHP.
+  // Not needed by steps that do not use the Hessian.
+  if (Opt_params.step_type != OPT_PARAMS::SD && Opt_params.step_type != OPT_PARAMS::LBFGS) {
+    double **H = p_Opt_data->g_H_pointer();
+    symm_matrix_sandwich(H, Nintco, apply_P);
+
+    if (Opt_params.print_lvl >= 3) {
+      oprintf_out("Projected (PHP) Hessian matrix\n");
+      if (Opt_params.fb_fragments)
+        oprintf_out("FB external coordinates are not projected.\n");
+      oprint_matrix_out(H, Ncoord(), Ncoord());
+    }
+  }
+
+  if (nK) {
+    free_array(u);
+    free_array(t);
+    free_matrix(M_inv);
+    free_matrix(PC);
+  }
+  free_matrix(C);
+}
+
 // project redundancies out of displacement vector; so far, doesn't seem to make much difference
 void MOLECULE::project_dq(double *dq) {
   int Nintco = Ncoord();
@@ -323,11 +457,20 @@ void MOLECULE::project_dq(double *dq) {
     array_copy(dq, dq_orig, Ncoord());
   }
 
-  double **B = compute_B();
+  if (use_sparse_B(Nintco)) {
+    // P dq = B (B^t B)^-1 B^t dq with conjugate gradients
+    SPARSE_B Bs = compute_sparse_B();
+    double * temp_arr = init_array(Nintco);
+    Bs.project(dq, temp_arr);
+    array_copy(temp_arr, dq, Ncoord());
+    free_array(temp_arr);
+  }
+  else {
+    double **B = compute_B();
 
-  //double **G = compute_G(true);
-  double **G = init_matrix(Ncart, Ncart);
-  opt_matrix_mult(B, true, B, false, G, false, Ncart, Nintco, Ncart, false);
+    //double **G = compute_G(true);
+    double **G = init_matrix(Ncart, Ncart);
+    opt_matrix_mult(B, true, B, false, G, false, Ncart, Nintco, Ncart, false);
 
 /*  will need fixed if this function ever helps
 #if defined (OPTKING_PACKAGE_QCHEM)
@@ -338,26 +481,27 @@ void MOLECULE::project_dq(double *dq) {
 #endif
 */
 
-  // B dx = dq
-  // B^t B dx = B^t dq
-  // dx = (B^t B)^-1 B^t dq
-  double **G_inv = symm_matrix_inv(G, Ncart, true);
-  free_matrix(G);
+    // B dx = dq
+    // B^t B dx = B^t dq
+    // dx = (B^t B)^-1 B^t dq
+    double **G_inv = symm_matrix_inv(G, Ncart, true);
+    free_matrix(G);
 
-  double **B_inv = init_matrix(Ncart, Nintco);
-  opt_matrix_mult(G_inv, false, B, true, B_inv, false, Ncart, Ncart, Nintco, false);
-  free_matrix(G_inv);
+    double **B_inv = init_matrix(Ncart, Nintco);
+    opt_matrix_mult(G_inv, false, B, true, B_inv, false, Ncart, Ncart, Nintco, false);
+    free_matrix(G_inv);
 
-  double **P = init_matrix(Nintco, Nintco);
-  opt_matrix_mult(B, false, B_inv, false, P, false, Nintco, Ncart, Nintco, false);
-  free_matrix(B);
-  free_matrix(B_inv);
+    double **P = init_matrix(Nintco, Nintco);
+    opt_matrix_mult(B, false, B_inv, false, P, false, Nintco, Ncart, Nintco, false);
+    free_matrix(B);
+    free_matrix(B_inv);
 
-  double * temp_arr = init_array(Nintco);
-  opt_matrix_mult(P, false, &dq, true, &temp_arr, true, Nintco, Nintco, 1, false);
-  array_copy(temp_arr, dq, Ncoord());
-  free_array(temp_arr);
-  free_matrix(P);
+    double * temp_arr = init_array(Nintco);
+    opt_matrix_mult(P, false, &dq, true, &temp_arr, true, Nintco, Nintco, 1, false);
+    array_copy(temp_arr, dq, Ncoord());
+    free_array(temp_arr);
+    free_matrix(P);
+  }
 
   if (Opt_params.print_lvl >=2) {
     oprintf_out("Projection of redundancies out of step:\n");
@@ -491,6 +635,9 @@ bool MOLECULE::cartesian_H_to_internals(double **H_cart) const {
     return true;
   }
 
+  if (use_sparse_B(Nintco))
+    return cartesian_H_to_internals_sparse(H_cart);
+
   // compute A = u B^t (B u B^t)^-1 where u=unit matrix and -1 is generalized inverse
   double **B = compute_B();
   double **G = init_matrix(Nintco, Nintco);
@@ -567,6 +714,61 @@ bool MOLECULE::cartesian_H_to_internals(double **H_cart) const {
   return success;
 }
 
+// cartesian_H_to_internals() with the sparse B matrix and no dense A:
+// g_q = G^-1 B g_x and H_int = G^-1 B (H_x - K) B^t G^-1
+bool MOLECULE::cartesian_H_to_internals_sparse(double **H_cart) const {
+  int Nintco = Ncoord();
+  int Ncart = 3*g_natom();
+  double **H_int = p_Opt_data->g_H_pointer();
+
+  SPARSE_B B = compute_sparse_B();
+
+  // compute gradient in internal coordinates
+  double *grad_x = g_grad_array();
+  double *grad_q = init_array(Nintco);
+  double *temp_arr = init_array(Nintco);
+  B.mult(grad_x, temp_arr);
+  B.G_inv_mult(temp_arr, grad_q);
+  free_array(temp_arr);
+  free_array(grad_x);
+
+  // K_ij = sum_q ( grad_q[q] d^2(q)/(dxi dxj) )
+  double **dq2dx2;
+  for (int q=0; q<Nintco; ++q) {
+    dq2dx2 = compute_derivative_B(q); // d^2(q)/ dx_i dx_j
+
+    for (int i=0; i<Ncart; ++i)
+      for (int j=0; j<Ncart; ++j)
+        H_cart[i][j] -= grad_q[q] * dq2dx2[i][j];
+
+    free_matrix(dq2dx2);
+  }
+  free_array(grad_q);
+
+  // T = (H_x - K) B^t, transposed to B (H_x - K)
+  double **T = init_matrix(Ncart, Nintco);
+  for (int x=0; x<Ncart; ++x)
+    B.mult(H_cart[x], T[x]);
+  double **BH = init_matrix(Nintco, Ncart);
+  for (int i=0; i<Nintco; ++i)
+    for (int x=0; x<Ncart; ++x)
+      BH[i][x] = T[x][i];
+  free_matrix(T);
+
+  // B (H_x - K) B^t
+  for (int i=0; i<Nintco; ++i)
+    B.mult(BH[i], H_int[i]);
+  free_matrix(BH);
+
+  symm_matrix_sandwich(H_int, Nintco, [&](const double *v, double *Gv) { B.G_inv_mult(v, Gv); });
+
+  if (Opt_params.print_lvl >= 3) {
+    oprintf_out( "Hessian transformed to internal coordinates:\n");
+    oprint_matrix_out(H_int, Nintco, Nintco);
+  }
+  return true;
+}
+
 double *MOLECULE::g_masses() const {
   double *u = init_array(g_natom());
   int cnt = 0;
@@ -604,6 +806,33 @@ double ** MOLECULE::compute_B() const {
   return B;
 }
 
+// compute sparse B matrix - FB coordinate rows have no elements
+SPARSE_B MOLECULE::compute_sparse_B() const {
+  SPARSE_B B(Ncoord(), 3*g_natom());
+
+  for (std::size_t f=0; f<fragments.size(); ++f)
+    fragments[f]->compute_B(B, g_coord_offset(f), g_atom_offset(f));
+
+  // Interfragment coordinates are few, but depend on every atom in the reference points
+  for (std::size_t I=0; I<interfragments.size(); ++I) {
+    int A_off = g_atom_offset( interfragments[I]->g_A_index());
+    int B_off = g_atom_offset( interfragments[I]->g_B_index());
+    int coord_off = g_interfragment_coord_offset(I);
+    int natom_A = interfragments[I]->g_natom_A();
+    int natom_B = interfragments[I]->g_natom_B();
+
+    double **B_inter = interfragments[I]->compute_B(); // Ncoord() X (3*natom_A)+3(natom_B)
+    for (int i=0; i<interfragments[I]->Ncoord(); ++i) {
+      for (int x=0; x<3*natom_A; ++x)
+        B.add(coord_off + i, 3*A_off + x, B_inter[i][x]);
+      for (int x=0; x<3*natom_B; ++x)
+        B.add(coord_off + i, 3*B_off + x, B_inter[i][3*natom_A + x]);
+    }
+    free_matrix(B_inter);
+  }
+  return B;
+}
+
 double ** MOLECULE::compute_derivative_B(int intco_index) const {
   int cnt_intcos = 0;
   int fragment_index = -1;
@@ -267,6 +267,7 @@ class MOLECULE {
   void print_geom_out_irc();
 
   double ** compute_B() const;
+  SPARSE_B compute_sparse_B() const;
   double ** compute_derivative_B(int coord_index) const ;
 
   double ** compute_G(bool use_masses=false) const;
@@ -337,6 +338,7 @@ class MOLECULE {
   void apply_constraint_forces();
   bool has_fixed_eq_vals();
   void project_f_and_H();
+  void project_f_and_H_sparse();
   void project_dq(double *);
   void irc_step();
   void nr_step();
@@ -344,6 +346,7 @@ class MOLECULE {
   void prfo_step();
   void backstep();
   void sd_step();
+  void lbfgs_step();
   //void sd_step_cartesians(void); now obsolete
   void linesearch_step();
 
@@ -395,6 +398,7 @@ class MOLECULE {
   void test_derivative_B();
 
   bool cartesian_H_to_internals(double **H_cart) const;
+  bool cartesian_H_to_internals_sparse(double **H_cart) const;
 
   void set_masses() {
     for (std::size_t f=0; f<fragments.size(); ++f)
@@ -122,7 +122,7 @@ void MOLECULE::backstep() {
     DE_projected = DE_nr_energy(dq_norm, dq_grad, dq_hess);
   else if (Opt_params.step_type == OPT_PARAMS::RFO)
     DE_projected = DE_rfo_energy(dq_norm, dq_grad, dq_hess);
-  else if (Opt_params.step_type == OPT_PARAMS::SD)
+  else if (Opt_params.step_type == OPT_PARAMS::SD || Opt_params.step_type == OPT_PARAMS::LBFGS)
     DE_projected = DE_nr_energy(dq_norm, dq_grad, dq_hess);
 
   oprintf_out( "\tNewly projected energy change : %20.10lf\n", DE_projected);
@@ -0,0 +1,223 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file    molecule_lbfgs_step.cc
+    \ingroup optking
+    \brief limited-memory BFGS step for molecule
+*/
+
+#include "molecule.h"
+
+#include <vector>
+
+#include "linear_algebra.h"
+#include "print.h"
+#define EXTERN
+#include "globals.h"
+
+#if defined(OPTKING_PACKAGE_PSI)
+ #include <cmath>
+#elif defined (OPTKING_PACKAGE_QCHEM)
+ #include "qcmath.h"
+#endif
+
+namespace opt {
+
+/*
+  The step -H^-1 g is built by the L-BFGS two-loop recursion from the changes
+  in internal coordinates and gradients over the last H_update_use_last steps
+  (Nocedal, Math. Comp. 35, 773 (1980)).  The initial inverse Hessian is the
+  inverse of the diagonal of the model guess Hessian.  Neither the full
+  Hessian nor its eigenvectors are ever needed, so the cost of a step is
+  linear in the number of coordinates.
+*/
+void MOLECULE::lbfgs_step() {
+  int dim = Ncoord();
+  double *fq = p_Opt_data->g_forces_pointer();
+  double *dq = p_Opt_data->g_dq_pointer();
+  double **H = p_Opt_data->g_H_pointer(); // only the diagonal of the guess is used
+
+  oprintf_out("\tTaking L-BFGS optimization step.\n");
+
+  int step_this = p_Opt_data->nsteps() - 1;
+  int step_first = 0;
+  if (Opt_params.H_update_use_last > 0 && step_this - Opt_params.H_update_use_last > 0)
+    step_first = step_this - Opt_params.H_update_use_last;
+
+  // Internal coordinates of the steps kept, in the torsional phase of the current geometry
+  double *x = p_Opt_data->g_geom_const_pointer(step_this);
+  set_geom_array(x);
+  fix_tors_near_180();
+  fix_oofp_near_180();
+
+  std::vector<double *> q;
+  for (int i_step=step_first; i_step<=step_this; ++i_step) {
+    set_geom_array(p_Opt_data->g_geom_const_pointer(i_step));
+    q.push_back(coord_values());
+  }
+  set_geom_array(x);
+
+  // (s, y) pairs that satisfy the curvature condition, oldest first
+  std::vector<double *> s, y;
+  std::vector<double> rho;
+  for (int i_step=step_first+1; i_step<=step_this; ++i_step) {
+    double *s_i = init_array(dim);
+    double *y_i = init_array(dim);
+    double *f_new = p_Opt_data->g_forces_pointer(i_step);
+    double *f_old = p_Opt_data->g_forces_pointer(i_step-1);
+    for (int i=0; i<dim; ++i) {
+      s_i[i] = q[i_step - step_first][i] - q[i_step - step_first - 1][i];
+      y_i[i] = -1.0 * (f_new[i] - f_old[i]); // gradients -- not forces!
+    }
+
+    double sy = array_dot(s_i, y_i, dim);
+    if (sy < Opt_params.H_update_den_tol || array_abs_max(s_i, dim) > Opt_params.H_update_dq_tol) {
+      oprintf_out("\tSkipping step %d in L-BFGS update.\n", i_step+1);
+      free_array(s_i);
+      free_array(y_i);
+      continue;
+    }
+    s.push_back(s_i);
+    y.push_back(y_i);
+    rho.push_back(1.0 / sy);
+  }
+  for (std::size_t i=0; i<q.size(); ++i)
+    free_array(q[i]);
+
+  oprintf_out("\tUsing %zu previous steps in L-BFGS update.\n", s.size());
+
+  // initial inverse Hessian
+  double *H0_inv = init_array(dim);
+  for (int i=0; i<dim; ++i)
+    H0_inv[i] = 1.0 / ((H[i][i] > 1.0e-8) ? H[i][i] : Opt_params.sd_hessian);
+
+  // two-loop recursion for r = H^-1 g
+  int npairs = s.size();
+  double *r = init_array(dim);
+  double *alpha = init_array(npairs);
+  for (int i=0; i<dim; ++i)
+    r[i] = -fq[i];
+
+  for (int p=npairs-1; p>=0; --p) {
+    alpha[p] = rho[p] * array_dot(s[p], r, dim);
+    for (int i=0; i<dim; ++i)
+      r[i] -= alpha[p] * y[p][i];
+  }
+  for (int i=0; i<dim; ++i)
+    r[i] *= H0_inv[i];
+  for (int p=0; p<npairs; ++p) {
+    double beta = rho[p] * array_dot(y[p], r, dim);
+    for (int i=0; i<dim; ++i)
+      r[i] += (alpha[p] - beta) * s[p][i];
+  }
+
+  for (int i=0; i<dim; ++i)
+    dq[i] = -r[i];
+
+  // Only a downhill step is acceptable; otherwise use the initial Hessian alone
+  if (array_dot(dq, fq, dim) <= 0.0) {
+    oprintf_out("\tL-BFGS step is not downhill; using the diagonal guess Hessian.\n");
+    for (int i=0; i<dim; ++i)
+      dq[i] = fq[i] * H0_inv[i];
+  }
+
+  free_array(alpha);
+  free_array(r);
+  free_array(H0_inv);
+  for (int p=0; p<npairs; ++p) {
+    free_array(s[p]);
+    free_array(y[p]);
+  }
+
+  // curvature along the step of the quadratic model
+  double dqdq = array_dot(dq, dq, dim);
+  double lbfgs_h = (dqdq > 0.0) ? array_dot(dq, fq, dim) / dqdq : Opt_params.sd_hessian;
+
+  // Zero steps for frozen fragment
+  for (std::size_t f=0; f<fragments.size(); ++f) {
+    if (fragments[f]->is_frozen() || Opt_params.freeze_intrafragment) {
+      oprintf_out("\tZero'ing out displacements for frozen fragment %zu\n", f+1);
+      for (int i=0; i<fragments[f]->Ncoord(); ++i)
+        dq[ g_coord_offset(f) + i ] = 0.0;
+    }
+  }
+
+  apply_intrafragment_step_limit(dq);
+
+  // norm of step
+  double lbfgs_dqnorm = sqrt( array_dot(dq, dq, dim) );
+  oprintf_out("\tNorm of target step-size %10.5lf\n", lbfgs_dqnorm);
+
+  // unit vector in step direction
+  double *lbfgs_u = init_array(dim);
+  array_copy(dq, lbfgs_u, dim);
+  if (lbfgs_dqnorm > 0.0)
+    array_normalize(lbfgs_u, dim);
+
+  // gradient in step direction
+  double lbfgs_g = - array_dot(fq, lbfgs_u, dim);
+
+  double DE_projected = lbfgs_dqnorm * lbfgs_g + 0.5 * lbfgs_dqnorm * lbfgs_dqnorm * lbfgs_h;
+  oprintf_out("\tProjected energy change: %20.10lf\n", DE_projected);
+
+  std::vector<int> lin_angles = validate_angles(dq);
+  if (!lin_angles.empty())
+    throw(INTCO_EXCEPT("New linear angles", lin_angles));
+
+  // do displacements for each fragment separately
+  for (std::size_t f=0; f<fragments.size(); ++f) {
+    if (fragments[f]->is_frozen() || Opt_params.freeze_intrafragment) {
+      oprintf_out("\tDisplacements for frozen fragment %zu skipped.\n", f+1);
+      continue;
+    }
+    fragments[f]->displace(&(dq[g_coord_offset(f)]), &(fq[g_coord_offset(f)]), g_atom_offset(f));
+  }
+
+  // do displacements for interfragment coordinates
+  for (std::size_t I=0; I<interfragments.size(); ++I) {
+    if (interfragments[I]->is_frozen() || Opt_params.freeze_interfragment) {
+      oprintf_out("\tDisplacements for frozen interfragment %zu skipped.\n", I+1);
+      continue;
+    }
+    interfragments[I]->orient_fragment( &(dq[g_interfragment_coord_offset(I)]),
+                                        &(fq[g_interfragment_coord_offset(I)]) );
+  }
+
+  // fix rotation matrix for rotations in QCHEM EFP code
+  for (std::size_t I=0; I<fb_fragments.size(); ++I)
+    fb_fragments[I]->displace( I, &(dq[g_fb_fragment_coord_offset(I)]) );
+
+  symmetrize_geom(); // now symmetrize the geometry for next step
+
+  // save values in step data
+  p_Opt_data->save_step_info(DE_projected, lbfgs_u, lbfgs_dqnorm, lbfgs_g, lbfgs_h);
+
+  free_array(lbfgs_u);
+}
+
+}
@@ -71,8 +71,9 @@ struct OPT_PARAMS {
   double rsrfo_alpha_max; // absolute maximum val
 
   enum OPT_TYPE {MIN, TS, IRC} opt_type;
-  // Newton-Raphson (NR), rational function optimization step, steepest descent step
-  enum STEP_TYPE {NR, RFO, P_RFO, SD, LINESEARCH_STATIC} step_type;
+  // Newton-Raphson (NR), rational function optimization step, steepest descent step,
+  // limited-memory BFGS step
+  enum STEP_TYPE {NR, RFO, P_RFO, SD, LINESEARCH_STATIC, LBFGS} step_type;
 
   // Coordinates for optimization
   enum COORDINATES {REDUNDANT, DELOCALIZED, NATURAL, CARTESIAN, BOTH} coordinates;
@@ -181,6 +182,13 @@ struct OPT_PARAMS {
   // rms and max change in cartesian coordinates in backtransformation
   double bt_dx_conv;
 
+  // How generalized inverses of G = B B^t are applied: by diagonalizing the dense G,
+  // or by conjugate gradients with the sparse B; AUTO picks PCG for many coordinates
+  enum INTCO_SOLVER {AUTO, DENSE, PCG} intco_solver;
+  int intco_solver_min_coords; // AUTO uses PCG for at least this many coordinates
+  double intco_solver_conv;    // relative residual at which PCG is converged
+  int intco_solver_maxiter;
+
   // give up on backtransformation iterations if change rms from one iteration to the
   // next is below this value
   double bt_dx_conv_rms_change;
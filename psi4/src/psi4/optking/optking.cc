@@ -280,7 +280,10 @@ OptReturnType optking(void) {
 
   bool read_H_worked = false;
 
-  if (Opt_params.step_type != OPT_PARAMS::SD) {  // ignore all hessian stuff if SD
+  if (Opt_params.step_type == OPT_PARAMS::LBFGS) {
+    mol1->H_guess(); // its diagonal is the initial L-BFGS Hessian; nothing is updated
+  }
+  else if (Opt_params.step_type != OPT_PARAMS::SD) {  // ignore all hessian stuff if SD
 
     if (Opt_params.H_guess_every) { // ignore Hessian already present
         mol1->H_guess(); // empirical model guess Hessian
@@ -336,6 +339,8 @@ OptReturnType optking(void) {
       mol1->prfo_step();
     else if (Opt_params.step_type == OPT_PARAMS::SD)
       mol1->sd_step();
+    else if (Opt_params.step_type == OPT_PARAMS::LBFGS)
+      mol1->lbfgs_step();
     else if (Opt_params.step_type == OPT_PARAMS::LINESEARCH_STATIC) {
       // compute geometries and then quit
       mol1->linesearch_step();
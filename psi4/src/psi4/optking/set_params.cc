@@ -77,6 +77,7 @@ void set_params(void)
       }
       else if (s == "NR") Opt_params.step_type = OPT_PARAMS::NR;
       else if (s == "SD") Opt_params.step_type = OPT_PARAMS::SD;
+      else if (s == "LBFGS") Opt_params.step_type = OPT_PARAMS::LBFGS;
       else if (s == "LINESEARCH_STATIC") Opt_params.step_type = OPT_PARAMS::LINESEARCH_STATIC;
    }
    else { // Set defaults for step type.
@@ -121,6 +122,12 @@ void set_params(void)
 // step to cartesians.
     Opt_params.ensure_bt_convergence = options.get_bool("ENSURE_BT_CONVERGENCE");
 
+// Dense generalized inverse of G = B B^t, or conjugate gradients with a sparse B
+    s = options.get_str("INTCO_SOLVER");
+    if (s == "AUTO")       Opt_params.intco_solver = OPT_PARAMS::AUTO;
+    else if (s == "DENSE") Opt_params.intco_solver = OPT_PARAMS::DENSE;
+    else if (s == "PCG")   Opt_params.intco_solver = OPT_PARAMS::PCG;
+
 // do stupid, linear scaling of internal coordinates to step limit (not RS-RFO);
     Opt_params.simple_step_scaling = options.get_bool("SIMPLE_STEP_SCALING");
 
@@ -246,6 +253,9 @@ void set_params(void)
 //  How many previous steps' data to use in Hessian update; 0=use them all ; {integer}
 //  Opt_params.H_update_use_last = 6;
     Opt_params.H_update_use_last = options.get_int("HESS_UPDATE_USE_LAST");
+    // The L-BFGS step has no other curvature information, so keep more pairs
+    if (Opt_params.step_type == OPT_PARAMS::LBFGS && !options["HESS_UPDATE_USE_LAST"].has_changed())
+      Opt_params.H_update_use_last = 10;
 
 // Whether to limit the magnitutde of changes caused by the Hessian update {true, false}
 //  Opt_params.H_update_limit = true;
@@ -577,6 +587,9 @@ void set_params(void)
 // previous steps to use ; (0=all) ; default (6)
   Opt_params.H_update_use_last = rem_read(REM_GEOM_OPT2_H_UPDATE_USE_LAST);
 
+// sparse B and conjugate gradients for large molecules
+  Opt_params.intco_solver = OPT_PARAMS::AUTO;
+
 // limit hessian changes (default true)
   Opt_params.H_update_limit = rem_read(REM_GEOM_OPT2_H_UPDATE_LIMIT);
 
@@ -758,6 +771,11 @@ void set_params(void)
   Opt_params.bt_max_iter = 25;
   Opt_params.bt_dx_conv = 1.0e-6;
   Opt_params.bt_dx_conv_rms_change = 1.0e-12;
+
+// Parameters that control the conjugate-gradient solves with the sparse B matrix
+  Opt_params.intco_solver_min_coords = 1000;
+  Opt_params.intco_solver_conv = 1.0e-10;
+  Opt_params.intco_solver_maxiter = 1000;
   //Opt_params.bt_dx_conv = 1.0e-10;
   //Opt_params.bt_dx_conv_rms_change = 1.0e-14;
 
@@ -959,6 +977,10 @@ void print_params_out() {
   oprintf_out( "step_type              = %18s\n", "RFO");
   else if (Opt_params.step_type == OPT_PARAMS::P_RFO)
   oprintf_out( "step_type              = %18s\n", "P_RFO");
+  else if (Opt_params.step_type == OPT_PARAMS::SD)
+  oprintf_out( "step_type              = %18s\n", "SD");
+  else if (Opt_params.step_type == OPT_PARAMS::LBFGS)
+  oprintf_out( "step_type              = %18s\n", "L-BFGS");
   else if (Opt_params.step_type == OPT_PARAMS::LINESEARCH_STATIC)
   oprintf_out( "step_type              = %18s\n", "Static linesearch");
 
@@ -1008,6 +1030,13 @@ void print_params_out() {
 
   oprintf_out( "H_update_use_last      = %18d\n", Opt_params.H_update_use_last);
 
+  if (Opt_params.intco_solver == OPT_PARAMS::AUTO)
+  oprintf_out( "intco_solver           = %18s\n", "Auto");
+  else if (Opt_params.intco_solver == OPT_PARAMS::DENSE)
+  oprintf_out( "intco_solver           = %18s\n", "Dense");
+  else if (Opt_params.intco_solver == OPT_PARAMS::PCG)
+  oprintf_out( "intco_solver           = %18s\n", "PCG");
+
   oprintf_out( "freeze_intrafragment   = %18s\n", Opt_params.freeze_intrafragment ? "true" : "false");
 
   oprintf_out( "intrafragment_step_limit=%18.2e\n", Opt_params.intrafragment_step_limit);
@@ -0,0 +1,265 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file    sparse_b.cc
+    \ingroup optking
+    \brief   row-sparse B matrix and conjugate-gradient solvers for G = B B^t and B^t B
+*/
+
+#include "sparse_b.h"
+
+#include "linear_algebra.h"
+#include "mem.h"
+#include "print.h"
+#define EXTERN
+#include "globals.h"
+
+#if defined(OPTKING_PACKAGE_PSI)
+ #include <cmath>
+#elif defined (OPTKING_PACKAGE_QCHEM)
+ #include "qcmath.h"
+#endif
+
+namespace opt {
+
+bool use_sparse_B(int Nintco) {
+  if (Opt_params.intco_solver == OPT_PARAMS::PCG)
+    return true;
+  else if (Opt_params.intco_solver == OPT_PARAMS::AUTO)
+    return (Nintco >= Opt_params.intco_solver_min_coords);
+  return false;
+}
+
+SPARSE_B::SPARSE_B(int Nintco_in, int Ncart_in) : Nintco(Nintco_in), Ncart(Ncart_in),
+  col(Nintco_in), val(Nintco_in) { }
+
+std::size_t SPARSE_B::nnz() const {
+  std::size_t n = 0;
+  for (int i=0; i<Nintco; ++i)
+    n += col[i].size();
+  return n;
+}
+
+void SPARSE_B::add(int row, int cart, double value) {
+  if (value == 0.0) return;
+  for (std::size_t k=0; k<col[row].size(); ++k) {
+    if (col[row][k] == cart) {
+      val[row][k] += value;
+      return;
+    }
+  }
+  col[row].push_back(cart);
+  val[row].push_back(value);
+}
+
+void SPARSE_B::add_dense(double **B_block, int nr, int nc, int row_offset, int cart_offset) {
+  for (int i=0; i<nr; ++i)
+    for (int x=0; x<nc; ++x)
+      add(row_offset + i, cart_offset + x, B_block[i][x]);
+}
+
+double ** SPARSE_B::dense() const {
+  double **B = init_matrix(Nintco, Ncart);
+  for (int i=0; i<Nintco; ++i)
+    for (std::size_t k=0; k<col[i].size(); ++k)
+      B[i][col[i][k]] += val[i][k];
+  return B;
+}
+
+void SPARSE_B::mult(const double *x, double *Bx) const {
+  for (int i=0; i<Nintco; ++i) {
+    double tval = 0.0;
+    for (std::size_t k=0; k<col[i].size(); ++k)
+      tval += val[i][k] * x[col[i][k]];
+    Bx[i] = tval;
+  }
+}
+
+void SPARSE_B::mult_t(const double *q, double *Btq) const {
+  for (int x=0; x<Ncart; ++x)
+    Btq[x] = 0.0;
+  for (int i=0; i<Nintco; ++i)
+    for (std::size_t k=0; k<col[i].size(); ++k)
+      Btq[col[i][k]] += val[i][k] * q[i];
+}
+
+void SPARSE_B::G_mult(const double *q, double *Gq) const {
+  double *Btq = init_array(Ncart);
+  mult_t(q, Btq);
+  mult(Btq, Gq);
+  free_array(Btq);
+}
+
+void SPARSE_B::Gx_mult(const double *x, double *Gx) const {
+  double *Bx = init_array(Nintco);
+  mult(x, Bx);
+  mult_t(Bx, Gx);
+  free_array(Bx);
+}
+
+/*
+  Jacobi-preconditioned conjugate gradients.  G and B^t B are only
+  semidefinite, but for a right-hand side in their range the iterations
+  converge to a solution; its null-space component is removed by the caller
+  wherever it matters.
+*/
+int SPARSE_B::pcg(bool on_cartesians, const double *b, double *x) const {
+  int dim = on_cartesians ? Ncart : Nintco;
+
+  // diagonal of the matrix
+  double *M_inv = init_array(dim);
+  for (int i=0; i<Nintco; ++i)
+    for (std::size_t k=0; k<col[i].size(); ++k) {
+      if (on_cartesians)
+        M_inv[col[i][k]] += val[i][k] * val[i][k];
+      else
+        M_inv[i] += val[i][k] * val[i][k];
+    }
+  for (int i=0; i<dim; ++i)
+    M_inv[i] = (M_inv[i] > 1.0e-14) ? 1.0 / M_inv[i] : 0.0;
+
+  for (int i=0; i<dim; ++i)
+    x[i] = 0.0;
+
+  double b_norm = std::sqrt(array_dot(const_cast<double *>(b), const_cast<double *>(b), dim));
+  if (b_norm == 0.0) {
+    free_array(M_inv);
+    return 0;
+  }
+
+  double *r  = init_array(dim);
+  double *z  = init_array(dim);
+  double *p  = init_array(dim);
+  double *Ap = init_array(dim);
+
+  for (int i=0; i<dim; ++i) {
+    r[i] = b[i];
+    z[i] = M_inv[i] * r[i];
+    p[i] = z[i];
+  }
+  double rz = array_dot(r, z, dim);
+
+  double tol = Opt_params.intco_solver_conv * b_norm;
+  int maxiter = Opt_params.intco_solver_maxiter;
+  bool converged = false;
+  int iter = 0;
+
+  while (iter < maxiter) {
+    ++iter;
+    if (on_cartesians) Gx_mult(p, Ap);
+    else               G_mult(p, Ap);
+
+    double pAp = array_dot(p, Ap, dim);
+    if (pAp <= 0.0) {
+      converged = true; // p has no component left in the range
+      break;
+    }
+
+    double alpha = rz / pAp;
+    for (int i=0; i<dim; ++i) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * Ap[i];
+    }
+
+    if (std::sqrt(array_dot(r, r, dim)) < tol) {
+      converged = true;
+      break;
+    }
+
+    for (int i=0; i<dim; ++i)
+      z[i] = M_inv[i] * r[i];
+    double rz_new = array_dot(r, z, dim);
+    double beta = rz_new / rz;
+    rz = rz_new;
+    for (int i=0; i<dim; ++i)
+      p[i] = z[i] + beta * p[i];
+  }
+
+  if (!converged)
+    oprintf_out("\tWarning: conjugate gradients for %s did not converge in %d iterations.\n",
+      on_cartesians ? "B^t B" : "B B^t", maxiter);
+  else if (Opt_params.print_lvl >= 3)
+    oprintf_out("\tConjugate gradients for %s converged in %d iterations.\n",
+      on_cartesians ? "B^t B" : "B B^t", iter);
+
+  free_array(Ap);
+  free_array(p);
+  free_array(z);
+  free_array(r);
+  free_array(M_inv);
+  return iter;
+}
+
+// P v = B (B^t B)^-1 B^t v.  Any solution of the cartesian system gives the same B z.
+void SPARSE_B::project(const double *v, double *Pv) const {
+  double *Btv = init_array(Ncart);
+  double *z = init_array(Ncart);
+
+  mult_t(v, Btv);
+  solve_Gx(Btv, z);
+  mult(z, Pv);
+
+  for (int i=0; i<Nintco; ++i)
+    if (col[i].empty())
+      Pv[i] = v[i];
+
+  free_array(z);
+  free_array(Btv);
+}
+
+// With B z = P dq, B B^t x = B z gives B^t x = z less its null-space component of B.
+void SPARSE_B::pinv(const double *dq, double *dx) const {
+  double *Btdq = init_array(Ncart);
+  double *z = init_array(Ncart);
+  double *Bz = init_array(Nintco);
+  double *x = init_array(Nintco);
+
+  mult_t(dq, Btdq);
+  solve_Gx(Btdq, z);
+  mult(z, Bz);
+  solve_G(Bz, x);
+  mult_t(x, dx);
+
+  free_array(x);
+  free_array(Bz);
+  free_array(z);
+  free_array(Btdq);
+}
+
+// G^-1 b = P x for any solution of G x = b
+void SPARSE_B::G_inv_mult(const double *b, double *x) const {
+  double *x0 = init_array(Nintco);
+  solve_G(b, x0);
+  project(x0, x);
+  for (int i=0; i<Nintco; ++i)
+    if (col[i].empty())
+      x[i] = 0.0;
+  free_array(x0);
+}
+
+}
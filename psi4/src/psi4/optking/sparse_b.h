@@ -0,0 +1,115 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file sparse_b.h
+    \ingroup optking
+    \brief Row-sparse B matrix and iterative solvers for G = B B^t and B^t B
+*/
+
+#ifndef _opt_sparse_b_h_
+#define _opt_sparse_b_h_
+
+#include <cstddef>
+#include <vector>
+
+namespace opt {
+
+// Whether the internal/cartesian transformations for this many coordinates
+// use the sparse B matrix and PCG in place of dense generalized inverses.
+bool use_sparse_B(int Nintco);
+
+/*
+  B matrix (internals by cartesians) stored by rows.  A simple internal
+  coordinate depends on at most four atoms, so a row has at most 12 elements;
+  combinations and interfragment coordinates have more, but are few.
+
+  Instead of forming G = B B^t and diagonalizing it, the generalized inverses
+  needed by optking are applied with Jacobi-preconditioned conjugate gradients
+  on G or on B^t B.  Every system solved is consistent (its right-hand side lies
+  in the range of the matrix), so the redundancies never have to be removed
+  explicitly.
+
+  Rows without elements (EFP fixed-body coordinates) are left out of every
+  solve; project() passes them through unchanged.
+*/
+class SPARSE_B {
+
+  int Nintco;
+  int Ncart;
+  std::vector<std::vector<int> >    col;  // cartesian index of each element of a row
+  std::vector<std::vector<double> > val;  // value of each element of a row
+
+  // Conjugate gradients on G (on_cartesians = false) or on B^t B (true).
+  // Returns the number of iterations.
+  int pcg(bool on_cartesians, const double *b, double *x) const;
+
+ public:
+
+  SPARSE_B(int Nintco_in, int Ncart_in);
+
+  int g_Nintco() const { return Nintco; }
+  int g_Ncart() const { return Ncart; }
+  std::size_t nnz() const;
+
+  // B[row][cart] += value
+  void add(int row, int cart, double value);
+
+  // Add the nonzero elements of a dense (nr by nc) block at the given offsets
+  void add_dense(double **B_block, int nr, int nc, int row_offset, int cart_offset);
+
+  // Return dense copy, (Nintco by Ncart)
+  double ** dense() const;
+
+  // Bx = B x
+  void mult(const double *x, double *Bx) const;
+  // Btq = B^t q
+  void mult_t(const double *q, double *Btq) const;
+  // Gq = B B^t q
+  void G_mult(const double *q, double *Gq) const;
+  // Gx = B^t B x
+  void Gx_mult(const double *x, double *Gx) const;
+
+  // Solve (B B^t) x = b for b in the range of B
+  int solve_G(const double *b, double *x) const { return pcg(false, b, x); }
+  // Solve (B^t B) x = b for b in the range of B^t
+  int solve_Gx(const double *b, double *x) const { return pcg(true, b, x); }
+
+  // Pv = B (B^t B)^-1 B^t v = G G^-1 v; projects redundancies out of v
+  void project(const double *v, double *Pv) const;
+
+  // dx = B^-1 dq = B^t G^-1 dq, the least-squares cartesian displacement
+  // with no component along the null space of B
+  void pinv(const double *dq, double *dx) const;
+
+  // G^-1 b for b in the range of B, e.g. forces f_q = G^-1 B f_x
+  void G_inv_mult(const double *b, double *x) const;
+};
+
+}
+
+#endif
@@ -93,6 +93,7 @@ class CCBLAS {
     void append(std::string str);
     void append_zero_two_diagonal(const char* cstr);
     void compute();
+    void compute_concurrent();
     int compute_storage_strategy();
     // DIIS
     void diis_add(std::string amps, std::string delta_amps);
@@ -159,6 +160,9 @@ class CCBLAS {
     void solve_ref(std::string& str);
     int parse(std::string& str);
     void process_operations();
+    void release_operation(CCOperation& op);
+    bool operations_depend(CCOperation& earlier, CCOperation& later);
+    bool operation_in_core(CCOperation& op);
     void process_reduce_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     void process_expand_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     bool get_factor(const std::string& str, double& factor);
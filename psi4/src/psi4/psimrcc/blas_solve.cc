@@ -26,10 +26,22 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
+
 #include "psi4/libmoinfo/libmoinfo.h"
 
 #include "blas.h"
+#include "matrix.h"
 
 namespace psi {
 namespace psimrcc {
@@ -187,6 +199,10 @@ void CCBLAS::compute() {
             matrices_in_deque_source[it->get_C_Matrix()]++;
         }
     }
+    if (work.size() > 1 && operations.size() > 1) {
+        compute_concurrent();
+        return;
+    }
     while (!operations.empty()) {
         // Read the element
         CCOperation& op = operations.front();
@@ -194,20 +210,142 @@ void CCBLAS::compute() {
         op.compute();
 
         // Decrease the counters for the matrices to be processed
-        if (op.get_A_Matrix() != nullptr) {
-            matrices_in_deque[op.get_A_Matrix()]--;
-            matrices_in_deque_target[op.get_A_Matrix()]--;
+        release_operation(op);
+        // Eliminate the element
+        operations.pop_front();
+    }
+}
+
+/**
+ * Decrease the deque counters of the matrices used by an operation that has been computed
+ * @param op
+ */
+void CCBLAS::release_operation(CCOperation& op) {
+    if (op.get_A_Matrix() != nullptr) {
+        matrices_in_deque[op.get_A_Matrix()]--;
+        matrices_in_deque_target[op.get_A_Matrix()]--;
+    }
+    if (op.get_B_Matrix() != nullptr) {
+        matrices_in_deque[op.get_B_Matrix()]--;
+        matrices_in_deque_source[op.get_B_Matrix()]--;
+    }
+    if (op.get_C_Matrix() != nullptr) {
+        matrices_in_deque[op.get_C_Matrix()]--;
+        matrices_in_deque_source[op.get_C_Matrix()]--;
+    }
+}
+
+/**
+ * Returns true if the operation must wait for an earlier one to complete, that is if
+ * it reads or writes the target of the earlier operation or writes one of its sources
+ * @param earlier
+ * @param later
+ */
+bool CCBLAS::operations_depend(CCOperation& earlier, CCOperation& later) {
+    CCMatrix* target = earlier.get_A_Matrix();
+    if (target != nullptr) {
+        if (later.get_A_Matrix() == target || later.get_B_Matrix() == target || later.get_C_Matrix() == target)
+            return true;
+    }
+    CCMatrix* later_target = later.get_A_Matrix();
+    if (later_target != nullptr) {
+        if (earlier.get_B_Matrix() == later_target || earlier.get_C_Matrix() == later_target) return true;
+    }
+    return false;
+}
+
+/**
+ * Returns true if all the matrices used by the operation are in core. Such an operation
+ * neither reads from disk nor allocates memory, so it may run next to others.
+ * @param op
+ */
+bool CCBLAS::operation_in_core(CCOperation& op) {
+    if (op.get_A_Matrix() != nullptr && !op.get_A_Matrix()->is_allocated()) return false;
+    if (op.get_B_Matrix() != nullptr && !op.get_B_Matrix()->is_allocated()) return false;
+    if (op.get_C_Matrix() != nullptr && !op.get_C_Matrix()->is_allocated()) return false;
+    return true;
+}
+
+/**
+ * Flush the operation deque running independent operations at the same time.
+ * The operations are ordered in a dependency graph and executed level by level: all the
+ * operations in a level have had their predecessors computed and do not touch each other's
+ * matrices. Operations in core are distributed over CC_NUM_THREADS threads, each using its
+ * own work and buffer arrays; operations that must load blocks or read strips from disk
+ * are computed one at a time after them. Operations that write the same matrix keep the
+ * order in which they were appended, so the result does not depend on the number of threads.
+ */
+void CCBLAS::compute_concurrent() {
+    std::vector<CCOperation> ops(operations.begin(), operations.end());
+    operations.clear();
+    size_t nops = ops.size();
+
+    // Build the dependency graph
+    std::vector<std::vector<size_t>> successors(nops);
+    std::vector<int> npredecessors(nops, 0);
+    for (size_t j = 1; j < nops; ++j) {
+        for (size_t i = 0; i < j; ++i) {
+            if (operations_depend(ops[i], ops[j])) {
+                successors[i].push_back(j);
+                npredecessors[j]++;
+            }
+        }
+    }
+
+    int nthreads = static_cast<int>(work.size());
+#ifdef USING_LAPACK_MKL
+    int mkl_threads = mkl_get_max_threads();
+#endif
+
+    std::vector<size_t> ready;
+    for (size_t j = 0; j < nops; ++j)
+        if (npredecessors[j] == 0) ready.push_back(j);
+
+    while (!ready.empty()) {
+        std::vector<size_t> in_core;
+        std::vector<size_t> serial;
+        for (size_t j : ready) {
+            if (operation_in_core(ops[j]))
+                in_core.push_back(j);
+            else
+                serial.push_back(j);
+        }
+
+        if (in_core.size() > 1) {
+#ifdef USING_LAPACK_MKL
+            mkl_set_num_threads(1);
+#endif
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            for (size_t n = 0; n < in_core.size(); ++n) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                ops[in_core[n]].set_scratch(work[thread].data(), buffer[thread].data());
+                ops[in_core[n]].compute();
+            }
+#ifdef USING_LAPACK_MKL
+            mkl_set_num_threads(mkl_threads);
+#endif
+        } else {
+            serial.insert(serial.begin(), in_core.begin(), in_core.end());
         }
-        if (op.get_B_Matrix() != nullptr) {
-            matrices_in_deque[op.get_B_Matrix()]--;
-            matrices_in_deque_source[op.get_B_Matrix()]--;
+
+        // Operations that load or stream matrices run alone with the full BLAS
+        for (size_t j : serial) {
+            ops[j].set_scratch(work[0].data(), buffer[0].data());
+            ops[j].compute();
         }
-        if (op.get_C_Matrix() != nullptr) {
-            matrices_in_deque[op.get_C_Matrix()]--;
-            matrices_in_deque_source[op.get_C_Matrix()]--;
+
+        // Release the computed operations and collect the next level
+        std::vector<size_t> next;
+        for (size_t j : ready) {
+            release_operation(ops[j]);
+            for (size_t k : successors[j])
+                if (--npredecessors[k] == 0) next.push_back(k);
         }
-        // Eliminate the element
-        operations.pop_front();
+        std::sort(next.begin(), next.end());
+        ready.swap(next);
     }
 }
 
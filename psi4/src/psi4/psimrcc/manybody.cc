@@ -48,6 +48,7 @@
 #include "manybody.h"
 #include "matrix.h"
 #include "sort.h"
+#include "transform.h"
 
 namespace psi {
 
@@ -57,7 +58,8 @@ namespace psimrcc {
  * Allocate the effective Hamiltonian matrices and eigenvectors
  * @todo wrap the current operations in an init() function
  */
-CCManyBody::CCManyBody(std::shared_ptr<PSIMRCCWfn> wfn, Options& options) : wfn_(wfn), options_(options) {
+CCManyBody::CCManyBody(std::shared_ptr<PSIMRCCWfn> wfn, Options& options)
+    : wfn_(wfn), options_(options), direct_vvvv_(false) {
     // Allocate memory for the eigenvector and the effective Hamiltonian
     zeroth_order_eigenvector = std::vector<double>(wfn_->moinfo()->get_nrefs(), 0);
     right_eigenvector = std::vector<double>(wfn_->moinfo()->get_nrefs(), 0);
@@ -98,7 +100,12 @@ CCManyBody::~CCManyBody() {
 void CCManyBody::generate_integrals() {
     // CCSort reads the one and two electron integrals
     // and creates the Fock matrices
-    std::make_shared<CCSort>(wfn_, out_of_core_sort);
+    auto sort = std::make_shared<CCSort>(wfn_, options_.get_str("CC_TYPE") == "CONV" ? out_of_core_sort : df_sort);
+    // Keep B(ab|Q) for the <vv|vv> contractions and release the rest of the three-index integrals
+    if (direct_vvvv_) {
+        df_vvvv_ = sort->get_transform();
+        df_vvvv_->keep_df_virtuals();
+    }
     //   wfn_->blas()->show_storage();
     wfn_->blas()->compute_storage_strategy();
     //   wfn_->blas()->show_storage();
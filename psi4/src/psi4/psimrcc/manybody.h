@@ -63,6 +63,8 @@
 namespace psi {
 namespace psimrcc {
 
+class CCTransform;
+
 enum SpinCase { aaSpin, abSpin, bbSpin, aaaSpin, aabSpin, abbSpin, bbbSpin };
 enum TriplesType { pt2, ccsd, ccsd_t, ccsdt_1a, ccsdt_1b, ccsdt_2, ccsdt_3, ccsdt };
 enum TriplesCouplingType { nocoupling, linear, quadratic, cubic };
@@ -87,6 +89,9 @@ class CCManyBody {
    protected:
     Options& options_;
     std::shared_ptr<PSIMRCCWfn> wfn_;
+    // DF/CD integrals: contract the <vv|vv> integrals from B(ab|Q) instead of storing them
+    bool direct_vvvv_;
+    std::shared_ptr<CCTransform> df_vvvv_;
     // Effective Hamiltonian and the correpsonding eigenvectors
     void print_eigensystem(int ndets, double** Heff, std::vector<double>& eigenvector);
     double diagonalize_Heff(int root, int ndets, double** Heff, std::vector<double>& right_eigenvector,
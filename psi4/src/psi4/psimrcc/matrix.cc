@@ -123,7 +123,8 @@ void CCMatrix::add_numerical_factor(double factor) {
 void CCMatrix::add_numerical_factor(double factor, int h) {
     if (block_sizepi[h] > 0) {
         double* matrix_block = &matrix[h][0][0];
-        for (size_t i = 0; i != block_sizepi[h]; ++i) matrix_block[i] += factor;
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < block_sizepi[h]; ++i) matrix_block[i] += factor;
     }
 }
 
@@ -134,7 +135,8 @@ void CCMatrix::scale(double factor) {
 void CCMatrix::scale(double factor, int h) {
     if (block_sizepi[h] > 0) {
         double* matrix_block = &matrix[h][0][0];
-        for (size_t i = 0; i != block_sizepi[h]; ++i) matrix_block[i] *= factor;
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < block_sizepi[h]; ++i) matrix_block[i] *= factor;
     }
 }
 
@@ -214,6 +216,7 @@ void CCMatrix::element_by_element_product(double factor, CCMatrix* B_Matrix, CCM
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i] * C_matrix[i];
     }
 }
@@ -223,6 +226,7 @@ void CCMatrix::element_by_element_division(double factor, CCMatrix* B_Matrix, CC
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i] / C_matrix[i];
     }
 }
@@ -231,6 +235,7 @@ void CCMatrix::element_by_element_addition(double factor, CCMatrix* B_Matrix, in
     if (block_sizepi[h] > 0) {
         double* A_matrix = &(matrix[h][0][0]);
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static)
         for (size_t i = 0; i < block_sizepi[h]; i++) A_matrix[i] += factor * B_matrix[i];
     }
 }
@@ -284,6 +289,7 @@ double CCMatrix::dot_product(CCMatrix* B_Matrix, CCMatrix* C_Matrix, int h) {
         size_t i;
         double* B_matrix = &(B_Matrix->get_matrix()[h][0][0]);
         double* C_matrix = &(C_Matrix->get_matrix()[h][0][0]);
+#pragma omp parallel for schedule(static) reduction(+ : value)
         for (size_t i = 0; i < block_size; i++) value += B_matrix[i] * C_matrix[i];
     }
     return (value);
@@ -175,7 +175,7 @@ void MP2_CCSD::read_mp2_ccsd_integrals() {
 
     // CCSort reads the one and two electron integrals
     // and creates the Fock matrices
-    std::make_shared<CCSort>(wfn_, out_of_core_sort);
+    std::make_shared<CCSort>(wfn_, options_.get_str("CC_TYPE") == "CONV" ? out_of_core_sort : df_sort);
 
     END_TIMER("Reading the integrals required by MP2-CCSD");
 }
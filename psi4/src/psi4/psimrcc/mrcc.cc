@@ -61,6 +61,9 @@ CCMRCC::CCMRCC(std::shared_ptr<PSIMRCCWfn> wfn, Options &options)
         }
     }
 
+    // With DF/CD integrals the <vv|vv> terms are contracted from B(ab|Q), see build_t2_vvvv_df()
+    direct_vvvv_ = (options.get_str("CC_TYPE") != "CONV");
+
     // Add the matrices that will store the intermediates
     add_matrices();
 
@@ -112,6 +112,7 @@ class CCMRCC : public CCManyBody {
     void build_t2_ijab_amplitudes();
     void build_t2_iJaB_amplitudes();
     void build_t2_IJAB_amplitudes();
+    void build_t2_vvvv_df();
     void build_t2_amplitudes_triples();
     void build_t2_ijab_amplitudes_triples_diagram1();
     void build_t2_iJaB_amplitudes_triples_diagram1();
@@ -143,9 +143,11 @@ void CCMRCC::add_matrices() {
                                                 mrcc_w_int.cc:  wfn_->blas()->append("W_JBME[OV][OV]{o} += #2431# - ([vvo]|[v]) 2@2 t1[O][V]{o}");
                                               */
 
-    // V^4
-    wfn_->blas()->add_Matrix("<[v>v]:[v>v]>");
-    wfn_->blas()->add_Matrix("<[vv]|[v>=v]>");
+    // V^4, not stored with DF/CD integrals
+    if (!direct_vvvv_) {
+        wfn_->blas()->add_Matrix("<[v>v]:[v>v]>");
+        wfn_->blas()->add_Matrix("<[vv]|[v>=v]>");
+    }
 
     // Fock Matrix
     wfn_->blas()->add_Matrix("fock[o][o]{u}");
@@ -230,6 +232,7 @@ void CCMRCC::add_matrices() {
     wfn_->blas()->add_Matrix("t2_eqns[OO][VV]{u}");
     wfn_->blas()->add_Matrix("t2_eqns[oo][v>v]{u}");
     wfn_->blas()->add_Matrix("t2_eqns[OO][V>V]{u}");
+    if (direct_vvvv_) wfn_->blas()->add_Matrix("t2_vvvv[oO][vV]{u}");
 
     // F intermediates
     wfn_->blas()->add_Matrix("F_ae[v][v]{u}");
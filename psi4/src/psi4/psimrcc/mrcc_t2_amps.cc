@@ -31,13 +31,26 @@
  *  frank@ccc.uga.edu   andysim@ccc.uga.edu
  *  A multireference coupled cluster code
  ***************************************************************************/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
 #include "psi4/libmoinfo/libmoinfo.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
 
 #include "algebra_interface.h"
 #include "blas.h"
 #include "index.h"
 #include "matrix.h"
 #include "mrcc.h"
+#include "transform.h"
 
 namespace psi {
 namespace psimrcc {
@@ -47,6 +60,7 @@ namespace psimrcc {
 // Because the variables are local, updating the wfn memory count is unnecessary.
 
 void CCMRCC::build_t2_amplitudes() {
+    if (direct_vvvv_) build_t2_vvvv_df();
     build_t2_iJaB_amplitudes();
     build_t2_ijab_amplitudes();
     build_t2_IJAB_amplitudes();
@@ -68,7 +82,8 @@ void CCMRCC::build_t2_ijab_amplitudes() {
 
         wfn_->blas()->append("t2_eqns[oo][vv]{c} += 1/2  W_mnij[oo][oo]{c} 1@1 tau[oo][vv]{c}");
 
-        wfn_->blas()->append("t2_eqns[oo][v>v]{c} = tau[oo][v>v]{c} 2@2 <[v>v]:[v>v]>");
+        if (!direct_vvvv_)
+            wfn_->blas()->append("t2_eqns[oo][v>v]{c} = tau[oo][v>v]{c} 2@2 <[v>v]:[v>v]>");
 
         wfn_->blas()->append("t2_eqns[oo][vv]{c} +>= #1234# t2_eqns[oo][v>v]{c}");
 
@@ -112,7 +127,8 @@ void CCMRCC::build_t2_ijab_amplitudes() {
 
     wfn_->blas()->append("t2_eqns[oo][vv]{o} += 1/2  W_mnij[oo][oo]{o} 1@1 tau[oo][vv]{o}");
 
-    wfn_->blas()->append("t2_eqns[oo][v>v]{o} = tau[oo][v>v]{o} 2@2 <[v>v]:[v>v]>");
+    if (!direct_vvvv_)
+        wfn_->blas()->append("t2_eqns[oo][v>v]{o} = tau[oo][v>v]{o} 2@2 <[v>v]:[v>v]>");
 
     wfn_->blas()->append("t2_eqns[oo][vv]{o} +>= #1234# t2_eqns[oo][v>v]{o}");
 
@@ -157,8 +173,12 @@ void CCMRCC::build_t2_iJaB_amplitudes() {
 
     // wfn_->blas()->append("t2_eqns[oO][vV]{c} += tau[oO][vV]{c} 2@2 <[vv]|[vv]>");
 
-    wfn_->blas()->append("t2_eqns[oO][vV]{c} += tau[oO][v>=V]{c} 2@2 <[vv]|[v>=v]>");
-    wfn_->blas()->append("t2_eqns[oO][vV]{c} += #1243# tau[oO][V>=v]{c} 2@2 <[vv]|[v>=v]>");
+    if (direct_vvvv_) {
+        wfn_->blas()->append("t2_eqns[oO][vV]{c} += t2_vvvv[oO][vV]{c}");
+    } else {
+        wfn_->blas()->append("t2_eqns[oO][vV]{c} += tau[oO][v>=V]{c} 2@2 <[vv]|[v>=v]>");
+        wfn_->blas()->append("t2_eqns[oO][vV]{c} += #1243# tau[oO][V>=v]{c} 2@2 <[vv]|[v>=v]>");
+    }
 
     wfn_->blas()->append("t2_eqns[oO][vV]{c} += #1234#  - Z_iJaM[oOv][O]{c} 2@1 t1[O][V]{c}");
     wfn_->blas()->append("t2_eqns[oO][vV]{c} += #1243#    Z_iJAm[oOV][o]{c} 2@1 t1[o][v]{c}");
@@ -200,8 +220,12 @@ void CCMRCC::build_t2_iJaB_amplitudes() {
 
     // wfn_->blas()->append("t2_eqns[oO][vV]{o} += tau[oO][vV]{o} 2@2 <[vv]|[vv]>");
 
-    wfn_->blas()->append("t2_eqns[oO][vV]{o} += tau[oO][v>=V]{o} 2@2 <[vv]|[v>=v]>");
-    wfn_->blas()->append("t2_eqns[oO][vV]{o} += #1243# tau[oO][V>=v]{o} 2@2 <[vv]|[v>=v]>");
+    if (direct_vvvv_) {
+        wfn_->blas()->append("t2_eqns[oO][vV]{o} += t2_vvvv[oO][vV]{o}");
+    } else {
+        wfn_->blas()->append("t2_eqns[oO][vV]{o} += tau[oO][v>=V]{o} 2@2 <[vv]|[v>=v]>");
+        wfn_->blas()->append("t2_eqns[oO][vV]{o} += #1243# tau[oO][V>=v]{o} 2@2 <[vv]|[v>=v]>");
+    }
 
     wfn_->blas()->append("t2_eqns[oO][vV]{o} += #1234#  - Z_iJaM[oOv][O]{o} 2@1 t1[O][V]{o}");
     wfn_->blas()->append("t2_eqns[oO][vV]{o} += #1243#    Z_iJAm[oOV][o]{o} 2@1 t1[o][v]{o}");
@@ -246,7 +270,8 @@ void CCMRCC::build_t2_IJAB_amplitudes() {
 
     wfn_->blas()->append("t2_eqns[OO][VV]{o} += 1/2  W_MNIJ[OO][OO]{o} 1@1 tau[OO][VV]{o}");
 
-    wfn_->blas()->append("t2_eqns[OO][V>V]{o} = tau[OO][V>V]{o} 2@2 <[v>v]:[v>v]>");
+    if (!direct_vvvv_)
+        wfn_->blas()->append("t2_eqns[OO][V>V]{o} = tau[OO][V>V]{o} 2@2 <[v>v]:[v>v]>");
 
     wfn_->blas()->append("t2_eqns[OO][VV]{o} +>= #1234#  t2_eqns[OO][V>V]{o}");
 
@@ -1553,5 +1578,133 @@ void CCMRCC::build_t2_ijab_amplitudes_triples_diagram1()
 }
 */
 
+/**
+ * The <vv|vv> terms of the doubles equations with DF/CD integrals. The integrals are assembled from B(ab|Q)
+ * for a batch of (cd) columns at a time and contracted at once, so no V^4 matrix is ever stored:
+ *   t2_eqns[oo][v>v] = sum_{e>f} tau[oo][e>f] <cd||ef>      t2_vvvv[oO][vV] = sum_{ef} tau[oO][eF] <cD|eF>
+ * tau has been solved for already, so these are ready before the appended operations run.
+ */
+void CCMRCC::build_t2_vvvv_df() {
+    // The (tau, target) pairs needed by each reference
+    std::vector<std::pair<CCMatrix*, CCMatrix*>> anti;
+    std::vector<std::pair<CCMatrix*, CCMatrix*>> phys;
+    auto add = [&](std::vector<std::pair<CCMatrix*, CCMatrix*>>& list, const char* tau, const char* target, int ref) {
+        CCMatrix* tau_Matrix = wfn_->blas()->get_MatTmp(tau, ref, none).get_CCMatrix();
+        CCMatrix* target_Matrix = wfn_->blas()->get_MatTmp(target, ref, none).get_CCMatrix();
+        list.push_back(std::make_pair(tau_Matrix, target_Matrix));
+    };
+    bool open_shell = wfn_->moinfo()->get_ref_size(UniqueOpenShellRefs) > 0;
+    for (int n = 0; n < wfn_->moinfo()->get_ref_size(ClosedShellRefs); ++n) {
+        int ref = wfn_->moinfo()->get_ref_number(n, ClosedShellRefs);
+        add(phys, "tau[oO][vV]", "t2_vvvv[oO][vV]", ref);
+        if (open_shell) add(anti, "tau[oo][v>v]", "t2_eqns[oo][v>v]", ref);
+    }
+    for (int n = 0; n < wfn_->moinfo()->get_ref_size(UniqueOpenShellRefs); ++n) {
+        int ref = wfn_->moinfo()->get_ref_number(n, UniqueOpenShellRefs);
+        add(phys, "tau[oO][vV]", "t2_vvvv[oO][vV]", ref);
+        add(anti, "tau[oo][v>v]", "t2_eqns[oo][v>v]", ref);
+        add(anti, "tau[OO][V>V]", "t2_eqns[OO][V>V]", ref);
+    }
+
+    CCIndex* v_index = wfn_->blas()->get_index("[v]");
+    CCIndex* vv_index = wfn_->blas()->get_index("[vv]");
+    CCIndex* vgv_index = wfn_->blas()->get_index("[v>v]");
+    size_t nv = df_vvvv_->df_nmo();
+    size_t naux = df_vvvv_->naux();
+    int nirreps = wfn_->moinfo()->get_nirreps();
+    int nthreads = Process::environment.get_n_threads();
+
+    std::vector<std::vector<double>> Y(nthreads, std::vector<double>(nv * nv));
+
+    for (int h = 0; h < nirreps; ++h) {
+        size_t nvv = vv_index->get_pairpi(h);
+        size_t nvgv = vgv_index->get_pairpi(h);
+        if (nvv == 0) continue;
+        size_t nrows = 0;
+        for (auto& tau_target : phys) nrows = std::max(nrows, tau_target.first->get_left_pairpi(h));
+        for (auto& tau_target : anti) nrows = std::max(nrows, tau_target.first->get_left_pairpi(h));
+        if (nrows == 0) continue;
+
+        // The (e,f) of each column, as indices of the [v] space
+        std::vector<std::array<short, 2>> ef_vv(nvv), ef_vgv(nvgv);
+        for (size_t ef = 0; ef < nvv; ++ef) {
+            auto& tuple = vv_index->get_tuple(vv_index->get_first(h) + ef);
+            ef_vv[ef] = {tuple[0], tuple[1]};
+        }
+        for (size_t ef = 0; ef < nvgv; ++ef) {
+            auto& tuple = vgv_index->get_tuple(vgv_index->get_first(h) + ef);
+            ef_vgv[ef] = {tuple[0], tuple[1]};
+        }
+
+        // Size the batch of (cd) columns from the free memory
+        size_t per_column = sizeof(double) * (nvv + nvgv + nrows);
+        size_t batch = std::min(nvv, wfn_->free_memory_ / per_column);
+        if (batch == 0) throw PSIEXCEPTION("PSIMRCC: not enough memory to contract the <vv|vv> integrals.");
+
+        std::vector<double> V_phys(batch * nvv);
+        std::vector<double> V_anti(batch * nvgv);
+        std::vector<double> R(nrows * batch);
+
+        for (size_t cd0 = 0; cd0 < nvv; cd0 += batch) {
+            size_t ncd = std::min(batch, nvv - cd0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            for (size_t k = 0; k < ncd; ++k) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                auto& cd = vv_index->get_tuple(vv_index->get_first(h) + cd0 + k);
+                short c = cd[0];
+                short d = cd[1];
+                // Y(e,f) = (ce|df) = <cd|ef>, only for the irreps with e x f = h
+                double* Yp = Y[thread].data();
+                for (int he = 0; he < nirreps; ++he) {
+                    int hf = he ^ h;
+                    size_t ne = v_index->get_pairpi(he);
+                    size_t nf = v_index->get_pairpi(hf);
+                    if (ne == 0 || nf == 0) continue;
+                    size_t e0 = v_index->get_first(he);
+                    size_t f0 = v_index->get_first(hf);
+                    C_DGEMM('N', 'T', ne, nf, naux, 1.0, df_vvvv_->df_B(c) + e0 * naux, naux,
+                            df_vvvv_->df_B(d) + f0 * naux, naux, 0.0, &Yp[e0 * nv + f0], nv);
+                }
+                for (size_t ef = 0; ef < nvv; ++ef) V_phys[k * nvv + ef] = Yp[ef_vv[ef][0] * nv + ef_vv[ef][1]];
+                if (c > d) {
+                    for (size_t ef = 0; ef < nvgv; ++ef) {
+                        short e = ef_vgv[ef][0];
+                        short f = ef_vgv[ef][1];
+                        V_anti[k * nvgv + ef] = Yp[e * nv + f] - Yp[f * nv + e];
+                    }
+                }
+            }
+
+            // t2_vvvv[ij][cd] = sum_ef tau[ij][ef] <cd|ef>, straight into the columns of this batch
+            for (auto& tau_target : phys) {
+                size_t nij = tau_target.first->get_left_pairpi(h);
+                if (nij == 0) continue;
+                C_DGEMM('N', 'T', nij, ncd, nvv, 1.0, (*tau_target.first)[h][0], nvv, V_phys.data(), nvv, 0.0,
+                        &((*tau_target.second)[h][0][cd0]), nvv);
+            }
+
+            // t2_eqns[ij][c>d] = sum_{e>f} tau[ij][e>f] <cd||ef>, scattered to the c > d columns
+            if (nvgv == 0) continue;
+            for (auto& tau_target : anti) {
+                size_t nij = tau_target.first->get_left_pairpi(h);
+                if (nij == 0) continue;
+                C_DGEMM('N', 'T', nij, ncd, nvgv, 1.0, (*tau_target.first)[h][0], nvgv, V_anti.data(), nvgv, 0.0,
+                        R.data(), ncd);
+                double** target = (*tau_target.second)[h];
+                for (size_t k = 0; k < ncd; ++k) {
+                    auto& cd = vv_index->get_tuple(vv_index->get_first(h) + cd0 + k);
+                    if (cd[0] <= cd[1]) continue;
+                    size_t cd_vgv = vgv_index->get_tuple_rel_index(cd[0], cd[1]);
+                    for (size_t ij = 0; ij < nij; ++ij) target[ij][cd_vgv] = R[ij * ncd + k];
+                }
+            }
+        }
+    }
+}
+
 }  // namespace psimrcc
 }  // namespace psi
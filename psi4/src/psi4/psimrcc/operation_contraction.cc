@@ -81,6 +81,7 @@ void CCOperation::setup_contractions() {
         if (T_matrix_offset > 0) zero_arr(&(local_work[0]), T_matrix_offset);
     }
 
+#pragma omp atomic
     PartA_timing += PartA.get();
     Timer PartB;
 
@@ -129,6 +130,7 @@ void CCOperation::setup_contractions() {
             contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A, cols_B,
                              cols_C, offset);
             // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
             wfn_->moinfo()->add_dgemm_timing(timer.get());
         }
 
@@ -166,6 +168,7 @@ void CCOperation::setup_contractions() {
                     contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A,
                                      cols_B, cols_C, offset);
                     // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
                     wfn_->moinfo()->add_dgemm_timing(timer.get());
                     offset += strip_length;
                 }
@@ -207,6 +210,7 @@ void CCOperation::setup_contractions() {
                     contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A,
                                      cols_B, cols_C, offset);
                     // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
                     wfn_->moinfo()->add_dgemm_timing(timer.get());
                     offset += strip_length;
                 }
@@ -216,6 +220,7 @@ void CCOperation::setup_contractions() {
         }
     }  // end of for loop over irreps
 
+#pragma omp atomic
     PartB_timing += PartB.get();
     Timer PartC;
     if (need_sort) {
@@ -224,6 +229,7 @@ void CCOperation::setup_contractions() {
             //       if(T_left->get_pairpi(h)*T_right->get_pairpi(h)>0)
             delete[] T_matrix[h];
     }
+#pragma omp atomic
     PartC_timing += PartC.get();
 }
 
@@ -506,6 +506,7 @@ void CCOperation::sort(CCIndex* T_left, CCIndex* T_right, std::vector<double**>
     }
 
     delete[] reindexing_array;
+#pragma omp atomic
     sort_timing += sort_timer.get();
 }
 
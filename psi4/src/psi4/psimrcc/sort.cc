@@ -55,7 +55,7 @@ CCSort::CCSort(std::shared_ptr<PSIMRCCWfn> wfn, SortAlgorithm algorithm)
 
     trans = std::make_shared<CCTransform>(wfn_);
 
-    IntegralTransform* ints;
+    IntegralTransform* ints = nullptr;
     // Use libtrans to generate MO basis integrals in Pitzer order
     std::vector<std::shared_ptr<MOSpace> > spaces;
     spaces.push_back(MOSpace::all);
@@ -89,6 +89,11 @@ CCSort::CCSort(std::shared_ptr<PSIMRCCWfn> wfn, SortAlgorithm algorithm)
         ints->set_keep_dpd_so_ints(false);
         ints->transform_tei(aocc, aocc, avir, avir);
         build_integrals_mrpt2(ints);
+    } else if (algorithm == df_sort) {
+        // The MO integrals are assembled from DF/CD three-index tensors when the CCMatrix blocks
+        // are filled, so no four-index integral file is transformed or presorted
+        trans->read_integrals_df();
+        build_integrals_out_of_core();
     } else {
         ints = new IntegralTransform(wfn, spaces, IntegralTransform::TransformationType::Restricted,
                                      IntegralTransform::OutputType::IWLOnly, IntegralTransform::MOOrdering::PitzerOrder,
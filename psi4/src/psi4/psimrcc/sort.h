@@ -56,7 +56,7 @@ class CCMatrix;
 #endif
 #define four(i, j, k, l) INDEX(INDEX(i, j), INDEX(k, l))
 
-enum SortAlgorithm { out_of_core_sort, mrpt2_sort };
+enum SortAlgorithm { out_of_core_sort, mrpt2_sort, df_sort };
 
 /**
  *  @class CCSort
@@ -66,6 +66,7 @@ class CCSort {
    public:
     CCSort(std::shared_ptr<PSIMRCCWfn> wfn, SortAlgorithm algorithm);
     ~CCSort();
+    std::shared_ptr<CCTransform> get_transform() const { return trans; }
 
    private:
     void init();
@@ -85,6 +86,7 @@ class CCSort {
     void form_fock_one_out_of_core(MatrixBlks& to_be_processed);
     void form_fock_out_of_core(CCMatrix* Matrix, int h);
     void form_two_electron_integrals_out_of_core(CCMatrix* Matrix, int h);
+    void form_two_electron_integrals_df(CCMatrix* Matrix, int h);
     double add_fock_two_out_of_core(int p, int q, int k, bool exchange);
     void setup_out_of_core_list(MatMapIt& mat_it, int& mat_irrep, MatMapIt& mat_end, MatrixBlks& to_be_processed);
     void dump_integrals_to_disk(MatrixBlks& to_be_processed);
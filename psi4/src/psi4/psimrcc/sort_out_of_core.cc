@@ -31,10 +31,20 @@
  *  @ingroup (PSIMRCC)
  */
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <cstdio>
+#include <utility>
+#include <vector>
+
 #include "psi4/libmoinfo/libmoinfo.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
 
 #include "blas.h"
+#include "index.h"
 #include "matrix.h"
 #include "sort.h"
 #include "transform.h"
@@ -130,7 +140,10 @@ void CCSort::setup_out_of_core_list(MatMapIt& mat_it, int& mat_irrep, MatMapIt&
 void CCSort::sort_integrals_out_of_core(int first_irrep, int last_irrep, MatrixBlks& to_be_processed) {
     for (MatBlksIt block_it = to_be_processed.begin(); block_it != to_be_processed.end(); ++block_it) {
         form_fock_out_of_core(block_it->first, block_it->second);
-        form_two_electron_integrals_out_of_core(block_it->first, block_it->second);
+        if (trans->use_df())
+            form_two_electron_integrals_df(block_it->first, block_it->second);
+        else
+            form_two_electron_integrals_out_of_core(block_it->first, block_it->second);
     }
 }
 
@@ -159,7 +172,6 @@ void CCSort::form_fock_out_of_core(CCMatrix* Matrix, int h) {
     if (Matrix->is_fock()) {
         std::string label = Matrix->get_label();
         auto matrix = Matrix->get_matrix();
-        auto* pq = new short[2];
         const intvec& oa2p = wfn_->moinfo()->get_occ_to_mo();
 
         bool alpha = true;
@@ -172,7 +184,11 @@ void CCSort::form_fock_out_of_core(CCMatrix* Matrix, int h) {
         std::vector<int> aocc = wfn_->moinfo()->get_aocc(Matrix->get_reference(), AllRefs);
         std::vector<int> bocc = wfn_->moinfo()->get_bocc(Matrix->get_reference(), AllRefs);
 
-        for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i)
+        // The rows are independent, and tei_block() only reads
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i) {
+            short pq_buffer[2];
+            short* pq = pq_buffer;
             for (size_t j = 0; j < Matrix->get_right_pairpi(h); ++j) {
                 // Find p and q from the pairs
                 Matrix->get_two_indices_pitzer(pq, h, i, j);
@@ -197,17 +213,19 @@ void CCSort::form_fock_out_of_core(CCMatrix* Matrix, int h) {
                         matrix[h][i][j] += add_fock_two_out_of_core(pq[0], pq[1], kk, false);
                 }
             }
-        delete[] pq;
+        }
     }
 }
 
 void CCSort::form_two_electron_integrals_out_of_core(CCMatrix* Matrix, int h) {
     if (Matrix->is_integral()) {
-        auto* pqrs = new short[4];
         auto matrix = Matrix->get_matrix();
         bool antisymmetric = Matrix->is_antisymmetric();
         if (Matrix->is_chemist()) {
-            for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i)
+#pragma omp parallel for schedule(dynamic)
+            for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i) {
+                short pqrs_buffer[4];
+                short* pqrs = pqrs_buffer;
                 for (size_t j = 0; j < Matrix->get_right_pairpi(h); ++j) {
                     Matrix->get_four_indices_pitzer(pqrs, h, i, j);
                     // From (pq|rs) = <pr|qs> we define
@@ -219,8 +237,12 @@ void CCSort::form_two_electron_integrals_out_of_core(CCMatrix* Matrix, int h) {
                     // Add the -<pq|sr> = -(ps|qr) contribution
                     if (antisymmetric) matrix[h][i][j] -= trans->tei_block(pqrs[0], pqrs[3], pqrs[1], pqrs[2]);
                 }
+            }
         } else {
-            for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i)
+#pragma omp parallel for schedule(dynamic)
+            for (size_t i = 0; i < Matrix->get_left_pairpi(h); ++i) {
+                short pqrs_buffer[4];
+                short* pqrs = pqrs_buffer;
                 for (size_t j = 0; j < Matrix->get_right_pairpi(h); ++j) {
                     Matrix->get_four_indices_pitzer(pqrs, h, i, j);
                     // Add the +<pq|rs> = (pr|qs) contribution
@@ -229,8 +251,91 @@ void CCSort::form_two_electron_integrals_out_of_core(CCMatrix* Matrix, int h) {
                     // Add the -<pq|sr> = -(ps|qr) contribution
                     if (antisymmetric) matrix[h][i][j] -= trans->tei_block(pqrs[0], pqrs[3], pqrs[1], pqrs[2]);
                 }
+            }
+        }
+    }
+}
+
+/**
+ * Fill an integral block from the DF/CD three-index tensors with GEMMs over the auxiliary index.
+ * A chemist block with pair rows and columns is a single product of rows of B(pq|Q) and B(rs|Q).
+ * Every other element is read from X_pq(r,s) = (pr|qs) = sum_Q B(pr|Q) B(qs|Q), built with one GEMM for each
+ * (p,q) met along a row and reused for all the columns that share it.
+ */
+void CCSort::form_two_electron_integrals_df(CCMatrix* Matrix, int h) {
+    if (!Matrix->is_integral()) return;
+    size_t nleft = Matrix->get_left_pairpi(h);
+    size_t nright = Matrix->get_right_pairpi(h);
+    if (nleft == 0 || nright == 0) return;
+
+    auto matrix = Matrix->get_matrix();
+    bool antisymmetric = Matrix->is_antisymmetric();
+    bool chemist = Matrix->is_chemist();
+    size_t nmo = trans->df_nmo();
+    size_t naux = trans->naux();
+    int nthreads = Process::environment.get_n_threads();
+
+    bool pair_product = chemist && Matrix->get_left()->get_nelements() == 2;
+    if (pair_product) {
+        // (pq|rs) = sum_Q B(pq|Q) B(rs|Q)
+        std::vector<double> Bl(nleft * naux);
+        std::vector<double> Br(nright * naux);
+        short pqrs_buffer[4];
+        short* pqrs = pqrs_buffer;
+        for (size_t i = 0; i < nleft; ++i) {
+            Matrix->get_four_indices_pitzer(pqrs, h, i, 0);
+            C_DCOPY(naux, trans->df_B(pqrs[0]) + pqrs[1] * naux, 1, &Bl[i * naux], 1);
+        }
+        for (size_t j = 0; j < nright; ++j) {
+            Matrix->get_four_indices_pitzer(pqrs, h, 0, j);
+            C_DCOPY(naux, trans->df_B(pqrs[2]) + pqrs[3] * naux, 1, &Br[j * naux], 1);
+        }
+        C_DGEMM('N', 'T', nleft, nright, naux, 1.0, Bl.data(), naux, Br.data(), naux, 1.0, matrix[h][0], nright);
+        if (!antisymmetric) return;
+    }
+
+    std::vector<std::vector<double>> X_pq(nthreads, std::vector<double>(nmo * nmo));
+    std::vector<std::vector<double>> X_pr(nthreads, std::vector<double>(nmo * nmo));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t i = 0; i < nleft; ++i) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        short pqrs_buffer[4];
+        short* pqrs = pqrs_buffer;
+        double* Xpq = X_pq[thread].data();
+        double* Xpr = X_pr[thread].data();
+        std::pair<int, int> pq_in_X(-1, -1);
+        std::pair<int, int> pr_in_X(-1, -1);
+        auto build_X = [&](std::pair<int, int>& in_X, int p, int q, double* X) {
+            if (in_X.first == p && in_X.second == q) return;
+            C_DGEMM('N', 'T', nmo, nmo, naux, 1.0, trans->df_B(p), naux, trans->df_B(q), naux, 0.0, X, nmo);
+            in_X = std::make_pair(p, q);
+        };
+        for (size_t j = 0; j < nright; ++j) {
+            Matrix->get_four_indices_pitzer(pqrs, h, i, j);
+            int p = pqrs[0], q = pqrs[1], r = pqrs[2], s = pqrs[3];
+            double value = 0.0;
+            if (chemist) {
+                // (pq|rs) = X_pr(q,s), unless the pair product above already added it
+                if (!pair_product) {
+                    build_X(pr_in_X, p, r, Xpr);
+                    value += Xpr[q * nmo + s];
+                }
+            } else {
+                // <pq|rs> = (pr|qs) = X_pq(r,s)
+                build_X(pq_in_X, p, q, Xpq);
+                value += Xpq[r * nmo + s];
+            }
+            // -(ps|qr) = -X_pq(s,r)
+            if (antisymmetric) {
+                build_X(pq_in_X, p, q, Xpq);
+                value -= Xpq[s * nmo + r];
+            }
+            matrix[h][i][j] += value;
         }
-        delete[] pqrs;
     }
 }
 
@@ -54,7 +54,8 @@
 namespace psi {
 namespace psimrcc {
 
-CCTransform::CCTransform(std::shared_ptr<PSIMRCCWfn> wfn) : fraction_of_memory_for_presorting(0.75), wfn_(wfn) {
+CCTransform::CCTransform(std::shared_ptr<PSIMRCCWfn> wfn)
+    : wfn_(wfn), fraction_of_memory_for_presorting(0.75), use_df_(false), naux_(0), df_nmo_(0) {
     wfn_->blas()->add_index("[s>=s]");
     wfn_->blas()->add_index("[n>=n]");
     wfn_->blas()->add_index("[s]");
@@ -89,7 +90,15 @@ void CCTransform::read_oei_mo_integrals() {
 /**
  * Free all the memory allocated by CCTransform
  */
-void CCTransform::free_memory() { integral_map.clear(); }
+void CCTransform::free_memory() {
+    integral_map.clear();
+    if (use_df_) {
+        wfn_->free_memory_ += sizeof(double) * df_B_.size();
+        df_B_.clear();
+        df_B_.shrink_to_fit();
+        use_df_ = false;
+    }
+}
 
 /**
  * Allocate the oei_mo array
@@ -30,6 +30,7 @@
 #define _psi_src_bin_psimrcc_cctransform_h
 
 #include <map>
+#include <vector>
 
 #include "psimrcc_wfn.h"
 
@@ -51,8 +52,18 @@ class CCTransform {
     void print();
     // Presorting
     void presort_integrals();
-    void read_oei_from_transqt() { read_oei_mo_integrals(); }
+    void read_oei_from_transqt() {
+        if (!use_df_) read_oei_mo_integrals();
+    }
     void read_integrals_mrpt2(IntegralTransform* ints);
+    // Density-fitted/Cholesky integrals
+    void read_integrals_df();
+    void keep_df_virtuals();
+    bool use_df() const { return use_df_; }
+    size_t naux() const { return naux_; }
+    size_t df_nmo() const { return df_nmo_; }
+    // The df_nmo() x naux() block B(pr|Q), r = 0..df_nmo()-1
+    double* df_B(int p) { return &df_B_[static_cast<size_t>(p) * df_nmo_ * naux_]; }
     int read_tei_mo_integrals_block(int first_irrep);
     void free_memory();
     void free_tei_mo_block(int first_irrep, int last_irrep);
@@ -60,6 +71,7 @@ class CCTransform {
     double oei(int p, int q);
     double tei_block(int p, int q, int r, int s);
     double tei_mrpt2(int p, int q, int r, int s);
+    double tei_df(int p, int q, int r, int s);
 
    private:
     std::vector<std::vector<double>> oei_mo;
@@ -91,6 +103,12 @@ class CCTransform {
     void presort_blocks(int first_irrep, int last_irrep);
 
     double fraction_of_memory_for_presorting;
+
+    // DF/CD: B(pq|Q) for all Pitzer-ordered MOs (or only the [v] orbitals after keep_df_virtuals()), pq-major
+    bool use_df_;
+    size_t naux_;
+    size_t df_nmo_;
+    std::vector<double> df_B_;
 };
 
 }  // namespace psimrcc
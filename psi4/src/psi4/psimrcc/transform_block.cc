@@ -62,6 +62,13 @@ namespace psimrcc {
  * in the packed array tei_mo
  */
 int CCTransform::read_tei_mo_integrals_block(int first_irrep) {
+    // With DF/CD integrals every (pq|rs) is available from the three-index tensors
+    if (use_df_) {
+        first_irrep_in_core = 0;
+        last_irrep_in_core = wfn_->nirrep();
+        return (last_irrep_in_core);
+    }
+
     std::vector<size_t> pairpi = tei_mo_indexing->get_pairpi();
     int last_irrep = allocate_tei_mo_block(first_irrep);
 
@@ -120,6 +127,7 @@ int CCTransform::allocate_tei_mo_block(int first_irrep) {
 }
 
 void CCTransform::free_tei_mo_block(int first_irrep, int last_irrep) {
+    if (use_df_) return;
     for (auto h = first_irrep; h < last_irrep; h++) {
         wfn_->free_memory_ += sizeof(double) * tei_mo[h].size();
     }
@@ -127,6 +135,7 @@ void CCTransform::free_tei_mo_block(int first_irrep, int last_irrep) {
 }
 
 double CCTransform::tei_block(int p, int q, int r, int s) {
+    if (use_df_) return (tei_df(p, q, r, s));
     // Get the (pq|rs) integral
     int irrep(tei_mo_indexing->get_tuple_irrep(MAX(p, q), MIN(p, q)));
     if ((first_irrep_in_core <= irrep) && (irrep < last_irrep_in_core))
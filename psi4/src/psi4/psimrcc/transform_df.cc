@@ -0,0 +1,188 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2021 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/**
+ *  @file transform_df.cc
+ *  @ingroup (PSIMRCC)
+ *  @brief Builds the MO integrals from density-fitted or Cholesky three-index tensors
+ */
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/lib3index/cholesky.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/liboptions/liboptions.h"
+
+#include "blas.h"
+#include "index.h"
+#include "transform.h"
+
+namespace psi {
+namespace psimrcc {
+
+/**
+ * Build the three-index tensors B(pq|Q) in the Pitzer-ordered MO basis and the one-electron MO integrals.
+ * After this call tei_block() evaluates (pq|rs) = sum_Q B(pq|Q) B(rs|Q) on demand, so neither the
+ * four-index MO integral file nor the presorted blocks are ever written.
+ */
+void CCTransform::read_integrals_df() {
+    Options& options = wfn_->options();
+    bool do_cd = (options.get_str("CC_TYPE") == "CD");
+
+    int nirrep = wfn_->nirrep();
+    int nmo = wfn_->nmo();
+    auto primary = wfn_->basisset();
+    size_t nao = primary->nbf();
+    int nthreads = Process::environment.get_n_threads();
+
+    // One-electron integrals, H(pq) = C(mu p) H(mu nu) C(nu q) irrep by irrep
+    allocate_oei_mo();
+    auto H = linalg::triplet(wfn_->Ca(), wfn_->H(), wfn_->Ca(), true, false, false);
+    for (int h = 0, offset = 0; h < nirrep; offset += wfn_->nmopi()[h], ++h) {
+        for (int p = 0; p < wfn_->nmopi()[h]; ++p)
+            for (int q = 0; q < wfn_->nmopi()[h]; ++q) oei_mo[offset + p][offset + q] = H->get(h, p, q);
+    }
+
+    // The MO coefficients in the AO basis, columns in Pitzer order
+    auto Cpitzer = std::make_shared<Matrix>("C (AO x MO, Pitzer)", nao, nmo);
+    auto AO2SO = wfn_->aotoso();
+    for (int h = 0, offset = 0; h < nirrep; offset += wfn_->nmopi()[h], ++h) {
+        int nso = wfn_->nsopi()[h];
+        int nmoh = wfn_->nmopi()[h];
+        if (nso == 0 || nmoh == 0) continue;
+        C_DGEMM('N', 'N', nao, nmoh, nso, 1.0, AO2SO->pointer(h)[0], nso, wfn_->Ca()->pointer(h)[0], nmoh, 0.0,
+                &(Cpitzer->pointer()[0][offset]), nmo);
+    }
+
+    size_t memory = wfn_->free_memory_ / sizeof(double);
+
+    if (do_cd) {
+        double tol = options.get_double("CHOLESKY_TOLERANCE");
+        outfile->Printf("\n\n  Cholesky-decomposed integrals (tolerance = %.3e)", tol);
+
+        std::shared_ptr<TwoBodyAOInt> eri(IntegralFactory(primary).eri());
+        auto Ch = std::make_shared<CholeskyERI>(eri, 0.0, tol, memory);
+        Ch->choleskify();
+        naux_ = Ch->Q();
+        double** Lp = Ch->L()->pointer();
+        double** Cp = Cpitzer->pointer();
+
+        // B(pq|Q) is built while the Cholesky vectors are still held
+        size_t L_doubles = naux_ * nao * nao;
+        size_t B_doubles = static_cast<size_t>(nmo) * nmo * naux_;
+        if (B_doubles + L_doubles > memory)
+            throw PSIEXCEPTION("PSIMRCC: not enough memory to hold the three-index integrals in core.");
+        df_B_ = std::vector<double>(B_doubles, 0.0);
+
+        // B(pq|Q) = C(mu p) L(Q|mu nu) C(nu q), one Cholesky vector per task
+        std::vector<std::vector<double>> half(nthreads, std::vector<double>(nao * nmo));
+        std::vector<std::vector<double>> full(nthreads, std::vector<double>(static_cast<size_t>(nmo) * nmo));
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+        for (size_t Q = 0; Q < naux_; ++Q) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            C_DGEMM('N', 'N', nao, nmo, nao, 1.0, Lp[Q], nao, Cp[0], nmo, 0.0, half[thread].data(), nmo);
+            C_DGEMM('T', 'N', nmo, nmo, nao, 1.0, Cp[0], nmo, half[thread].data(), nmo, 0.0, full[thread].data(), nmo);
+            for (size_t pq = 0; pq < static_cast<size_t>(nmo) * nmo; ++pq) df_B_[pq * naux_ + Q] = full[thread][pq];
+        }
+    } else {
+        auto auxiliary = wfn_->get_basisset("DF_BASIS_CC");
+        outfile->Printf("\n\n  Density-fitted integrals (%s)", auxiliary->name().c_str());
+
+        // B(pq|Q) stays in core, so DFHelper gets only what is left after it
+        naux_ = auxiliary->nbf();
+        size_t B_doubles = static_cast<size_t>(nmo) * nmo * naux_;
+        if (B_doubles >= memory)
+            throw PSIEXCEPTION("PSIMRCC: not enough memory to hold the three-index integrals in core.");
+        df_B_ = std::vector<double>(B_doubles, 0.0);
+
+        auto dfh = std::make_shared<DFHelper>(primary, auxiliary);
+        dfh->set_memory(memory - B_doubles);
+        dfh->set_method("DIRECT_iaQ");
+        dfh->set_nthreads(nthreads);
+        dfh->set_MO_core(true);
+        dfh->set_print_lvl(0);
+        dfh->initialize();
+        dfh->add_space("p", Cpitzer);
+        dfh->add_transformation("B", "p", "p", "pqQ");
+        dfh->transform();
+
+        dfh->fill_tensor("B", df_B_.data());
+    }
+
+    size_t B_memory = sizeof(double) * df_B_.size();
+    wfn_->free_memory_ -= B_memory;
+    df_nmo_ = nmo;
+
+    outfile->Printf("\n    Number of auxiliary functions          = %14zu", naux_);
+    outfile->Printf("\n    Memory used by B(pq|Q)                 = %14zu bytes", B_memory);
+    use_df_ = true;
+}
+
+/**
+ * Keep only B(ab|Q) for the orbitals of the [v] space, indexed as in that space, and release the rest.
+ * This is all the <vv|vv> contractions of the amplitude equations need once the sort is done.
+ */
+void CCTransform::keep_df_virtuals() {
+    auto& v_to_pitzer = wfn_->blas()->get_index("[v]")->get_indices_to_pitzer()[0];
+    size_t nv = v_to_pitzer.size();
+    size_t nmo = df_nmo_;
+
+    size_t Bvv_memory = sizeof(double) * nv * nv * naux_;
+    if (Bvv_memory > wfn_->free_memory_)
+        throw PSIEXCEPTION("PSIMRCC: not enough memory to hold the virtual three-index integrals in core.");
+
+    std::vector<double> B_vv(nv * nv * naux_);
+    for (size_t a = 0; a < nv; ++a)
+        for (size_t b = 0; b < nv; ++b)
+            C_DCOPY(naux_, &df_B_[(v_to_pitzer[a] * nmo + v_to_pitzer[b]) * naux_], 1, &B_vv[(a * nv + b) * naux_], 1);
+
+    wfn_->free_memory_ += sizeof(double) * df_B_.size();
+    wfn_->free_memory_ -= Bvv_memory;
+    df_B_.swap(B_vv);
+    df_nmo_ = nv;
+}
+
+double CCTransform::tei_df(int p, int q, int r, int s) {
+    return C_DDOT(naux_, &df_B_[(p * df_nmo_ + q) * naux_], 1, &df_B_[(r * df_nmo_ + s) * naux_], 1);
+}
+
+}  // namespace psimrcc
+}  // namespace psi
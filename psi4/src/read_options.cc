@@ -196,6 +196,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     options.add_str("CI_TYPE", "CONV", "CONV");
     /*- Write all the MOs to the MOLDEN file (true) or discard the unoccupied MOs (false). -*/
     options.add_bool("MOLDEN_WITH_VIRTUAL", true);
+    /*- Values smaller in magnitude than this (two-electron integrals, two-particle densities) are
+    written to IWL files in single precision. The default keeps all of them in double precision. !expert -*/
+    options.add_double("IWL_FP32_CUTOFF", 0.0);
 
     // CDS-TODO: We should go through and check that the user hasn't done
     // something silly like specify frozen_docc in DETCI but not in TRANSQT.
@@ -993,6 +996,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Do force SAPT2 and higher to die if it thinks there isn't enough
         memory?  Turning this off is ill-advised. -*/
         options.add_bool("SAPT_MEM_CHECK", true);
+        /*- Do keep the DF integrals of SAPT2 and higher in core, rather than on disk? Each
+        tensor falls back to disk if it does not fit in the memory left over by the working arrays. -*/
+        options.add_bool("SAPT_DF_INTS_IN_CORE", false);
         /*- Primary basis set, describes the monomer molecular orbitals -*/
         options.add_str("BASIS", "");
         /*- Auxiliary basis set for SAPT density fitting computations.
@@ -1504,6 +1510,15 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("DF_INTS_IO", "NONE", "NONE SAVE LOAD");
         /*- Fitting Condition, i.e. eigenvalue threshold for RI basis. Analogous to S_TOLERANCE !expert -*/
         options.add_double("DF_FITTING_CONDITION", 1.0E-10);
+        /*- Fit the exchange of each occupied orbital only with the auxiliary functions on nearby atoms?
+            Makes K close to linear scaling for large systems. Requires |scf__scf_type| MEM_DF. -*/
+        options.add_bool("DF_LOCAL_K", false);
+        /*- Atoms carrying at least this fraction of an orbital's Mulliken charge are in its
+            local fitting domain (see |scf__df_local_k|) -*/
+        options.add_double("DF_LOCAL_K_CUTOFF", 1.0E-4);
+        /*- The local fitting domain of an orbital also holds all atoms within this distance
+            (bohr) of its atoms (see |scf__df_local_k|) -*/
+        options.add_double("DF_LOCAL_K_RADIUS", 4.0);
         /*- FastDF Fitting Metric -*/
         options.add_str("DF_METRIC", "COULOMB", "COULOMB EWALD OVERLAP");
         /*- FastDF SR Ewald metric range separation parameter -*/
@@ -1593,12 +1608,23 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BLOCK_MAX_RADIUS", 3.0);
         /*- The blocking scheme for DFT. !expert -*/
         options.add_str("DFT_BLOCK_SCHEME", "OCTREE", "NAIVE OCTREE");
+        /*- Keep the DFT grid for later geometries. While no atom has moved further than
+        |scf__dft_grid_reuse_threshold| from where the grid was built, its points move rigidly with their atoms
+        and only the nuclear partition weights and the blocks are updated. Holds the unpartitioned grid in
+        memory until the next ``psi4.core.clean()``. !expert -*/
+        options.add_bool("DFT_GRID_REUSE", false);
+        /*- The largest displacement of any atom [au] for which |scf__dft_grid_reuse| moves the previous
+        grid instead of building a new one. !expert -*/
+        options.add_double("DFT_GRID_REUSE_THRESHOLD", 0.1);
         /*- Parameters defining the dispersion correction. See Table
         :ref:`-D Functionals <table:dft_disp>` for default values and Table
         :ref:`Dispersion Corrections <table:dashd>` for the order in which
         parameters are to be specified in this array option.
         Unused for functionals constructed by user. -*/
         options.add("DFT_DISPERSION_PARAMETERS", new ArrayType());
+        /*- Atom pairs farther apart than this (bohr) are left out of dispersion corrections computed by
+        libdisp (-D1, -D2, -CHG, -DAS2009, -DAS2010). Zero keeps all pairs. !expert -*/
+        options.add_double("DFT_DISPERSION_CUTOFF", 0.0);
         /*- Parameters defining the -NL/-V dispersion correction. First b, then C -*/
         options.add("NL_DISPERSION_PARAMETERS", new ArrayType());
         /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>` number) for VV10 NL integration.
@@ -2402,7 +2428,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DAMPING_PERCENTAGE", 0.0);
         /*- Maximum number of error vectors stored for DIIS extrapolation -*/
         options.add_int("DIIS_MAX_VECS", 7);
-        /*- Number of threads -*/
+        /*- Number of threads used to compute independent CC operations at the same time -*/
         options.add_int("CC_NUM_THREADS", 1);
         /*- Which root of the effective hamiltonian is the target state? -*/
         options.add_int("FOLLOW_ROOT", 1);
@@ -2484,6 +2510,8 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("SMALL_CUTOFF", 0);
         /*- Do disregard updating single excitation amplitudes? -*/
         options.add_bool("NO_SINGLES", false);
+        /*- Tolerance for the Cholesky decomposition of the ERI tensor when |globals__cc_type| is CD -*/
+        options.add_double("CHOLESKY_TOLERANCE", 1.0e-4);
     }
     if (name == "OPTKING" || options.read_globals()) {
         /*- MODULEDESCRIPTION Performs geometry optimizations and vibrational frequency analyses. -*/
@@ -2496,8 +2524,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("PRINT_OPT_PARAMS", false);
         /*- Specifies minimum search, transition-state search, or IRC following -*/
         options.add_str("OPT_TYPE", "MIN", "MIN TS IRC");
-        /*- Geometry optimization step type, either Newton-Raphson or Rational Function Optimization -*/
-        options.add_str("STEP_TYPE", "RFO", "RFO NR SD LINESEARCH_STATIC");
+        /*- Geometry optimization step type, either Newton-Raphson or Rational Function Optimization.
+            LBFGS takes limited-memory BFGS steps from the last |optking__hess_update_use_last|
+            steps (default 10) and never diagonalizes or updates the full Hessian. -*/
+        options.add_str("STEP_TYPE", "RFO", "RFO NR SD LBFGS LINESEARCH_STATIC");
         /*- Geometry optimization coordinates to use.
             REDUNDANT and INTERNAL are synonyms and the default.
             DELOCALIZED are the coordinates of Baker.
@@ -2528,6 +2558,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Reduce step size as necessary to ensure back-transformation of internal
             coordinate step to cartesian coordinates. -*/
         options.add_bool("ENSURE_BT_CONVERGENCE", false);
+        /*- How the generalized inverse of G = B B^T is applied when transforming forces, Hessians,
+            and steps between internal and Cartesian coordinates. DENSE diagonalizes G; PCG solves with
+            conjugate gradients and a sparse B matrix. AUTO uses PCG for 1000 or more internal
+            coordinates. -*/
+        options.add_str("INTCO_SOLVER", "AUTO", "AUTO DENSE PCG");
         /*= Do stupid, linear scaling of internal coordinates to step limit (not RS-RFO) -*/
         options.add_bool("SIMPLE_STEP_SCALING", false);
         /*- Set number of consecutive backward steps allowed in optimization -*/
@@ -2951,6 +2986,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("PPL_TYPE", "AUTO", "LOW_MEM HIGH_MEM CD AUTO");
         /*- The algorithm to handle (ia|bc) type integrals that used for (T) correction. -*/
         options.add_str("TRIPLES_IABC_TYPE", "DISK", "INCORE AUTO DIRECT DISK");
+        /*- Minutes between checkpoints of the partial (T) energy; 0 writes no checkpoints. -*/
+        options.add_double("TRIPLES_CHECKPOINT_TIME", 0.0);
+        /*- Do continue an interrupted (T) computation from its checkpoint file? -*/
+        options.add_bool("TRIPLES_RESTART", false);
 
         /*- Do compute natural orbitals? -*/
         options.add_bool("NAT_ORBS", false);
@@ -2976,6 +3015,9 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_bool("REGULARIZATION", false);
         /*- Do read 3-index integrals from SCF files?  -*/
         options.add_bool("READ_SCF_3INDEX", true);
+        /*- Do keep the DF integrals in core, rather than on disk? The AO integrals of a MEM_DF SCF are
+        reused when its auxiliary basis matches. Each tensor falls back to disk if it does not fit in half of the memory. -*/
+        options.add_bool("DF_INTS_IN_CORE", false);
         /*- Do compute one electron properties?  -*/
         options.add_bool("OEPROP", false);
         /*- Do compute $\langle \hat{S}^2 \rangle$ for DF-OMP2/DF-MP2?  -*/
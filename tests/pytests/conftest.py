@@ -47,6 +47,35 @@ def set_up():
     psi4.set_output_file("pytest_output.dat", True)
 
 
+@pytest.fixture
+def psimrcc_o2():
+    """Singlet O2 in a two-determinant model space for the Mk-MRCCSD tests."""
+    import psi4
+
+    psi4.geometry("""
+    0 3
+    O
+    O 1 2.265122720724
+    units au
+    """)
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "e_convergence": 10,
+        "d_convergence": 10,
+        "r_convergence": 10,
+        "mcscf__reference": "rohf",
+        "mcscf__docc": [3, 0, 0, 0, 0, 2, 1, 1],
+        "mcscf__socc": [0, 0, 1, 1, 0, 0, 0, 0],
+        "psimrcc__corr_wfn": "ccsd",
+        "psimrcc__frozen_docc": [1, 0, 0, 0, 0, 1, 0, 0],
+        "psimrcc__restricted_docc": [2, 0, 0, 0, 0, 1, 1, 1],
+        "psimrcc__active": [0, 0, 1, 1, 0, 0, 0, 0],
+        "psimrcc__frozen_uocc": [0, 0, 0, 0, 0, 0, 0, 0],
+        "psimrcc__corr_multp": 1,
+        "psimrcc__wfn_sym": "B1g",
+    })
+
+
 def tear_down():
     import os
     import glob
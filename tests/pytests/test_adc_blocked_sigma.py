@@ -0,0 +1,54 @@
+"""ADC(2) poles from the blocked sigma construction against the reference of tests/adc1"""
+
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+# ADC(2)/6-31G** excitation energies of water, lowest twenty, from tests/adc1/output.ref
+_ref_poles = [
+    0.3149230, 0.3980537, 0.4136525, 0.5011960, 0.5632587, 0.6863816, 1.0012357, 1.0683908, 1.1065589, 1.1296934,
+    1.1549287, 1.1584773, 1.1914180, 1.2176390, 1.2456152, 1.2618632, 1.2886374, 1.3354908, 1.3485003, 1.3714929
+]
+
+# The same poles by irrep, from their leading 1h-1p amplitudes (occupied 1a1 2a1 1b2 3a1 1b1, virtual 4a1 2b2):
+# 1b1->4a1 (B1), 1b1->2b2 (A2), 3a1->4a1 (A1), 3a1->2b2 (B2) and 1b2->4a1 (B2)
+_ref_poles_c2v = {
+    "A1": [0.4136525],
+    "A2": [0.3980537],
+    "B1": [0.3149230],
+    "B2": [0.5011960, 0.5632587],
+}
+
+
+def _water(symmetry):
+    psi4.geometry("""
+    O
+    H 1 0.9584
+    H 1 0.9584 2 104.45
+    symmetry {}
+    """.format(symmetry))
+    psi4.set_options({"reference": "rhf", "basis": "6-31G**", "guess": "core"})
+
+
+def test_adc2_poles_c1():
+    _water("c1")
+    psi4.set_options({"roots_per_irrep": [5]})
+    psi4.energy("adc(2)")
+
+    for root in range(5):
+        pole = psi4.variable("ADC ROOT 0 -> ROOT {} EXCITATION ENERGY - A SYMMETRY".format(root + 1))
+        assert compare_values(_ref_poles[root], pole, 6, "ADC(2) pole {}".format(root + 1))
+
+
+def test_adc2_poles_c2v():
+    # The 2h-2p blocks are dense in the orbitals; the elements that symmetry forbids must stay out
+    _water("c2v")
+    psi4.set_options({"roots_per_irrep": [1, 1, 1, 2]})
+    psi4.energy("adc(2)")
+
+    for irrep, ref_poles in _ref_poles_c2v.items():
+        for root, ref in enumerate(ref_poles):
+            pole = psi4.variable("ADC ROOT 0 -> ROOT {} EXCITATION ENERGY - {} SYMMETRY".format(root + 1, irrep))
+            assert compare_values(ref, pole, 6, "ADC(2) {} pole {}".format(irrep, root + 1))
@@ -0,0 +1,34 @@
+"""
+Tests for the kernel benchmark suite
+"""
+
+import json
+
+import psi4
+import pytest
+
+pytestmark = pytest.mark.quick
+
+
+def test_benchmark_suite(tmp_path):
+    output = str(tmp_path / "benchmark.json")
+    results = psi4.benchmark_suite(systems=["water"], kernels=["JK", "DPD", "TENSOR_SORT", "PSIO"], threads=[1], min_time=0.0,
+                                   psio_dim=6, output_file=output)
+
+    with open(output) as fp:
+        assert json.load(fp) == results
+
+    kernels = {(rec["kernel"], rec["variant"]) for rec in results["results"]}
+    for jk_type in ["DIRECT", "MEM_DF", "DISK_DF", "PK"]:
+        assert ("JK", jk_type) in kernels
+    assert ("DPD", "CONTRACT444 (OO,OO x OO,VV)") in kernels
+    assert ("TENSOR_SORT", "SORT 1324") in kernels
+    assert ("TENSOR_SORT", "SORT 1324 (reference)") in kernels
+    assert ("PSIO", "READ (Continuous)") in kernels
+
+    for rec in results["results"]:
+        assert rec["time"] > 0.0
+        assert rec["speedup"] == pytest.approx(1.0)
+
+    # A result never regresses against itself
+    assert psi4.compare_benchmarks(results, output) == []
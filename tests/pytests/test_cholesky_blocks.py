@@ -0,0 +1,49 @@
+"""The blocked pivoted Cholesky decomposition reproduces the single-pivot one"""
+
+import numpy as np
+import psi4
+import pytest
+from .utils import compare_integers, compare_arrays
+
+pytestmark = pytest.mark.quick
+
+
+def _low_rank(n, rank, seed):
+    rng = np.random.RandomState(seed)
+    X = rng.normal(size=(n, rank))
+    # Repeated rows give exactly tied diagonal elements
+    X[n // 2:2 * (n // 2)] = X[:n // 2]
+    return psi4.core.Matrix.from_array(X.dot(X.T))
+
+
+def _choleskify(A, block_size, memory=100000000):
+    chol = psi4.core.CholeskyMatrix(A, 1.e-10, memory)
+    chol.set_block_size(block_size)
+    chol.choleskify()
+    return chol
+
+
+@pytest.mark.parametrize("block_size", [2, 7, 64])
+def test_cholesky_blocks(block_size):
+    A = _low_rank(60, 25, 1)
+    ref = _choleskify(A, 1)
+    chol = _choleskify(A, block_size)
+
+    assert compare_integers(25, ref.Q(), "rank, single pivot")
+    assert compare_integers(ref.Q(), chol.Q(), "rank, block of {}".format(block_size))
+    assert compare_arrays(ref.L().np, chol.L().np, 10, "Cholesky vectors, block of {}".format(block_size))
+
+
+def test_cholesky_blocks_last_rows():
+    # Room for exactly the 25 vectors: the block of 64 is cut to the rows that are left
+    n = 60
+    A = _low_rank(n, 25, 2)
+    ref = _choleskify(A, 1)
+    chol = _choleskify(A, 64, memory=n + 2 * n * 24)
+
+    assert compare_integers(ref.Q(), chol.Q(), "rank with the last rows")
+    assert compare_arrays(ref.L().np, chol.L().np, 10, "Cholesky vectors with the last rows")
+
+    # One row short of the rank
+    with pytest.raises(RuntimeError):
+        _choleskify(A, 64, memory=n + 2 * n * 23)
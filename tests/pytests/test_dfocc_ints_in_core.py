@@ -0,0 +1,35 @@
+#! DF-CCSD with the DF integrals held in core and taken from a MEM_DF SCF (DF_INTS_IN_CORE)
+
+import psi4
+import pytest
+from .utils import *
+
+
+@pytest.mark.quick
+def test_dfocc_ccsd_df_ints_in_core():
+    psi4.geometry("""
+    0 1
+    O
+    H 1 0.958
+    H 1 0.958 2 104.48
+    symmetry c1
+    """)
+    # with JKFIT as DF_BASIS_CC, the SCF integrals serve both parts of DFOCC
+    psi4.set_options({
+        "basis": "cc-pvdz",
+        "cc_type": "df",
+        "df_basis_cc": "cc-pvdz-jkfit",
+        "e_convergence": 1.e-10,
+        "d_convergence": 1.e-8,
+        "r_convergence": 1.e-8,
+    })
+
+    psi4.set_options({"df_ints_in_core": False})
+    e_disk = psi4.energy("ccsd")
+
+    psi4.set_options({"df_ints_in_core": True})
+    e_core = psi4.energy("ccsd")
+
+    assert compare_values(e_disk, e_core, 8, "DF-CCSD energy with in-core DF integrals")
+
+    psi4.set_options({"df_ints_in_core": False})
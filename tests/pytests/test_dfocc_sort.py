@@ -0,0 +1,17 @@
+#! Blocked dfocc Tensor2d sorts reproduce the element-by-element reference exactly
+
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+
+@pytest.mark.parametrize("nocc,nvir,naux", [(3, 5, 7), (5, 37, 41)])
+def test_dfocc_sort_exact(nocc, nvir, naux):
+    # benchmark_dfocc_sort throws if any sort differs from its reference; 37 and 41 leave partial 32 x 32 tiles
+    results = psi4.core.benchmark_dfocc_sort(nocc, nvir, naux, 0.0)
+
+    for label in ["SORT 1324", "SORT 1432", "SORT 2413", "SORT 1243", "SORT 1423", "SORT 3142", "SORT 2134",
+                  "SORT3A 132", "SORT3B 132"]:
+        assert label in results
@@ -0,0 +1,98 @@
+#! DF-CCSD(T): the (ia|bc) strategies of the ij task driver agree, and a run continues from a (T) checkpoint
+
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+
+def _water():
+    return psi4.geometry("""
+    0 1
+    O
+    H 1 0.958
+    H 1 0.958 2 104.48
+    symmetry c1
+    """)
+
+
+_options = {
+    "basis": "cc-pvdz",
+    "cc_type": "df",
+    "e_convergence": 1.e-10,
+    "d_convergence": 1.e-8,
+    "r_convergence": 1.e-8,
+}
+
+
+def test_dfocc_triples_iabc_types():
+    _water()
+    psi4.set_options(_options)
+
+    energies = {}
+    for iabc in ["INCORE", "DIRECT", "DISK"]:
+        psi4.set_options({"triples_iabc_type": iabc, "triples_checkpoint_time": 1.e-6})
+        psi4.energy("ccsd(t)")
+        energies[iabc] = psi4.variable("(T) CORRECTION ENERGY")
+
+    assert compare_values(energies["INCORE"], energies["DIRECT"], 10, "(T) energy, DIRECT (ia|bc)")
+    assert compare_values(energies["INCORE"], energies["DISK"], 10, "(T) energy, DISK (ia|bc)")
+
+
+def _write_checkpoint(mol, eccsd, energies):
+    # energies: {ij task: (T) contribution} of the tasks to be taken as done
+    nocc = 5
+    nvir = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pvdz").nbf() - nocc
+    naux = psi4.core.BasisSet.build(mol, "DF_BASIS_CC", "", "RIFIT", "cc-pvdz").nbf()
+    ntasks = nocc * (nocc + 1) // 2
+    chkname = psi4.core.get_writer_file_prefix(mol.name()) + ".dfocc_t.chk"
+    with open(chkname, "w") as fp:
+        fp.write("DFOCC (T) checkpoint\n")
+        fp.write("{} {} {} {}\n".format(nocc, nvir, naux, ntasks))
+        fp.write("{:.17g}\n".format(eccsd))
+        for t, value in sorted(energies.items()):
+            fp.write("{} {:.17g}\n".format(t, value))
+    return ntasks
+
+
+def test_dfocc_triples_restart():
+    mol = _water()
+    psi4.set_options(_options)
+    psi4.energy("ccsd(t)")
+    eccsd = psi4.variable("CCSD TOTAL ENERGY")
+
+    # A checkpoint in which every ij task is done; the restarted run only sums it
+    ntasks = _write_checkpoint(mol, eccsd, {t: -1.e-4 for t in range(15)})
+
+    psi4.set_options({"triples_restart": True, "triples_checkpoint_time": 1.e-6})
+    psi4.energy("ccsd(t)")
+    assert compare_values(-1.e-4 * ntasks, psi4.variable("(T) CORRECTION ENERGY"), 10, "(T) energy from checkpoint")
+
+
+def test_dfocc_triples_partial_restart():
+    mol = _water()
+    psi4.set_options(_options)
+    psi4.energy("ccsd(t)")
+    eccsd = psi4.variable("CCSD TOTAL ENERGY")
+    e_scratch = psi4.variable("(T) CORRECTION ENERGY")
+
+    # Take the even tasks as done with no energy: the restarted run computes only the odd ones
+    psi4.set_options({"triples_restart": True, "triples_checkpoint_time": 1.e-6})
+    _write_checkpoint(mol, eccsd, {t: 0.0 for t in range(0, 15, 2)})
+    psi4.energy("ccsd(t)")
+    e_odd = psi4.variable("(T) CORRECTION ENERGY")
+
+    # and the other way round
+    _write_checkpoint(mol, eccsd, {t: 0.0 for t in range(1, 15, 2)})
+    psi4.energy("ccsd(t)")
+    e_even = psi4.variable("(T) CORRECTION ENERGY")
+
+    assert abs(e_odd) > 1.e-6 and abs(e_even) > 1.e-6
+    assert compare_values(e_scratch, e_odd + e_even, 10, "(T) energy from partial checkpoints")
+
+    # A checkpoint holding the odd tasks' energy (summed on the first) restarts to the scratch energy
+    _write_checkpoint(mol, eccsd, {1: e_odd, **{t: 0.0 for t in range(3, 15, 2)}})
+    psi4.energy("ccsd(t)")
+    assert compare_values(e_scratch, psi4.variable("(T) CORRECTION ENERGY"), 10,
+                          "(T) energy restarted from the odd tasks")
@@ -0,0 +1,53 @@
+#! DFT grid reuse across nearby geometries (DFT_GRID_REUSE)
+
+import psi4
+import pytest
+from .utils import *
+
+
+def _water(roh):
+    return psi4.geometry("""
+    0 1
+    O
+    H 1 {0}
+    H 1 {0} 2 104.5
+    symmetry c1
+    no_reorient
+    no_com
+    """.format(roh))
+
+
+@pytest.mark.quick
+def test_dft_grid_reuse():
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "df", "e_convergence": 1.e-10, "d_convergence": 1.e-8})
+
+    # Reference energies from grids built at each geometry
+    psi4.set_options({"dft_grid_reuse": False})
+    _water(0.96)
+    e_near_ref = psi4.energy("b3lyp")
+    _water(1.20)
+    e_far_ref = psi4.energy("b3lyp")
+
+    psi4.set_options({"dft_grid_reuse": True, "dft_grid_reuse_threshold": 0.1})
+    _water(0.95)
+    psi4.energy("b3lyp")
+
+    # The hydrogens move by 0.019 au: the grid moves along with them
+    _water(0.96)
+    e_near = psi4.energy("b3lyp")
+    assert compare_values(e_near_ref, e_near, 5, "B3LYP energy on a moved grid")
+
+    # The hydrogens move by 0.47 au: the grid is rebuilt
+    _water(1.20)
+    e_far = psi4.energy("b3lyp")
+    assert compare_values(e_far_ref, e_far, 8, "B3LYP energy on a rebuilt grid")
+
+    # clean() drops the kept grids, so the next geometry builds its own
+    _water(0.95)
+    psi4.energy("b3lyp")
+    psi4.core.clean()
+    _water(0.96)
+    e_near = psi4.energy("b3lyp")
+    assert compare_values(e_near_ref, e_near, 8, "B3LYP energy on a new grid after clean()")
+
+    psi4.set_options({"dft_grid_reuse": False})
@@ -1,6 +1,7 @@
 import pytest
 import psi4
 import itertools
+import numpy as np
 from .utils import compare_integers, compare_values
 
 pytestmark = pytest.mark.quick
@@ -132,3 +133,44 @@ def test_schwarz_vs_csam_energy():
     e_csam = psi4.energy('hf/DZ')
 
     assert compare_values(e_schwarz, e_csam, 11, 'Schwarz vs CSAM Screening, Cutoff 1.0e-12')
+
+
+def test_compute_shell_batch():
+    """Checks that the batched shell quartet interface reproduces the full AO ERI tensor
+    for every angular momentum class, with quartets passed in scrambled order."""
+
+    mol = psi4.geometry("""
+        O
+        H 1 1.0
+        H 1 1.0 2 104.5
+        symmetry c1
+    """)
+    psi4.set_options({ "ints_tolerance" : 0.0 })
+
+    basis = psi4.core.BasisSet.build(mol, target='cc-pVDZ')
+    mints = psi4.core.MintsHelper(basis)
+    ref = np.asarray(mints.ao_eri())
+    eri = psi4.core.IntegralFactory(basis).eri(0)
+
+    batched = np.zeros_like(ref)
+    classes = {}
+    shell_inds = range(basis.nshell())
+    for quartet in itertools.product(shell_inds, shell_inds, shell_inds, shell_inds):
+        am = tuple(basis.shell(s).am for s in quartet)
+        classes.setdefault(am, []).append(quartet)
+
+    for am, quartets in classes.items():
+        quartets = quartets[::-1]
+        eri.compute_shell_batch(quartets)
+        buf = np.asarray(eri.batch_buffer())
+        offsets = eri.batch_offsets()
+        assert len(offsets) == len(quartets) + 1
+        for n, (P, Q, R, S) in enumerate(quartets):
+            sl = [slice(basis.shell_to_basis_function(s), basis.shell_to_basis_function(s) + basis.shell(s).nfunction)
+                  for s in (P, Q, R, S)]
+            batched[tuple(sl)] = buf[offsets[n]:offsets[n + 1]].reshape(batched[tuple(sl)].shape)
+
+    assert compare_values(ref, batched, 12, 'Batched ERIs')
+
+    with pytest.raises(Exception):
+        eri.compute_shell_batch([classes[(0, 0, 0, 0)][0], classes[(1, 1, 1, 1)][0]])
@@ -0,0 +1,59 @@
+#! Compact IWL buffers (multi-byte labels, single-precision values) and resized PK Yoshimine buckets
+
+import numpy as np
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+
+def _water():
+    psi4.geometry("""
+    0 1
+    O
+    H 1 0.958
+    H 1 0.958 2 104.48
+    symmetry c1
+    """)
+
+
+def _mp2_incore(wfn):
+    # Conventional MP2 from in-core MO integrals, with no IWL file involved
+    mints = psi4.core.MintsHelper(wfn.basisset())
+    Co = wfn.Ca_subset("AO", "OCC")
+    Cv = wfn.Ca_subset("AO", "VIR")
+    eo = wfn.epsilon_a_subset("AO", "OCC").to_array()
+    ev = wfn.epsilon_a_subset("AO", "VIR").to_array()
+    iajb = mints.mo_eri(Co, Cv, Co, Cv).to_array()
+    denom = eo[:, None, None, None] - ev[None, :, None, None] + eo[None, None, :, None] - ev[None, None, None, :]
+    return np.einsum("iajb,iajb,iajb->", iajb, 2.0 * iajb - iajb.swapaxes(1, 3), 1.0 / denom)
+
+
+@pytest.mark.parametrize("fp32_cutoff,atol", [(0.0, 1.e-9), (1.0, 1.e-6)])
+def test_iwl_compact_roundtrip(fp32_cutoff, atol):
+    # 92 basis functions: labels past 63 take two varint bytes
+    _water()
+    psi4.set_options({"basis": "aug-cc-pvtz", "scf_type": "pk", "mp2_type": "conv", "d_convergence": 1.e-10})
+    _, wfn = psi4.energy("scf", return_wfn=True)
+    e_ref = _mp2_incore(wfn)
+
+    # The SO integrals go through IWL on their way to libtrans
+    psi4.set_options({"iwl_fp32_cutoff": fp32_cutoff})
+    psi4.energy("mp2", ref_wfn=wfn)
+
+    assert compare_values(e_ref, psi4.variable("MP2 CORRELATION ENERGY"), "MP2 through IWL, fp32 cutoff {}".format(fp32_cutoff),
+                          atol=atol)
+
+
+def test_pk_yoshimine_buckets():
+    _water()
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "pk_no_incore": True, "d_convergence": 1.e-10})
+
+    psi4.set_options({"pk_algo": "reorder"})
+    e_reorder = psi4.energy("scf")
+
+    psi4.set_options({"pk_algo": "yoshimine"})
+    e_yoshimine = psi4.energy("scf")
+
+    assert compare_values(e_reorder, e_yoshimine, 10, "SCF energy, Yoshimine PK buckets")
@@ -0,0 +1,96 @@
+#! libdisp analytic dispersion gradients and Hessians against finite differences
+
+import numpy as np
+import psi4
+import pytest
+from .utils import *
+
+_dimer = """
+0 1
+O  -1.551007  -0.114520   0.000000
+H  -1.934259   0.762503   0.000000
+H  -0.599677   0.040712   0.000000
+--
+0 1
+O   1.350625   0.111469   0.000000
+H   1.680398  -0.373741  -0.758561
+H   1.680398  -0.373741   0.758561
+symmetry c1
+no_reorient
+no_com
+"""
+
+
+def _displaced(mol, k, step):
+    geom = mol.geometry().np.copy()
+    geom.flat[k] += step
+    clone = mol.clone()
+    clone.set_geometry(psi4.core.Matrix.from_array(geom))
+    clone.update_geometry()
+    return clone
+
+
+def _fd_gradient(disp, mol, step=1.e-4):
+    ref = np.zeros(3 * mol.natom())
+    for k in range(3 * mol.natom()):
+        ref[k] = (disp.compute_energy(_displaced(mol, k, step)) -
+                  disp.compute_energy(_displaced(mol, k, -step))) / (2 * step)
+    return ref.reshape(-1, 3)
+
+
+def _fd_hessian(disp, mol, step=1.e-4):
+    ref = np.zeros((3 * mol.natom(), 3 * mol.natom()))
+    for k in range(3 * mol.natom()):
+        ref[k] = (disp.compute_gradient(_displaced(mol, k, step)).np.ravel() -
+                  disp.compute_gradient(_displaced(mol, k, -step)).np.ravel()) / (2 * step)
+    return ref
+
+
+@pytest.mark.parametrize("dtype,params", [
+    pytest.param("d2", {"s6": 0.75, "alpha6": 20.0, "sr6": 1.1}, id="d2"),
+    pytest.param("chg", {"s6": 1.0}, id="chg"),
+    pytest.param("das2010", {"s6": 1.0}, id="das2010"),
+])
+def test_libdisp_derivatives(dtype, params):
+    mol = psi4.geometry(_dimer)
+    mol.update_geometry()
+    disp = psi4.core.Dispersion.build(dtype, **params)
+
+    G = disp.compute_gradient(mol)
+    assert compare_arrays(_fd_gradient(disp, mol), G.np, 7, f"{dtype} gradient")
+
+    H = disp.compute_hessian(mol)
+    assert compare_arrays(H.np, H.np.T, 10, f"{dtype} Hessian symmetric")
+    assert compare_arrays(_fd_hessian(disp, mol), H.np, 6, f"{dtype} Hessian")
+
+
+def test_libdisp_cutoff():
+    mol = psi4.geometry(_dimer)
+    mol.update_geometry()
+    disp = psi4.core.Dispersion.build("d2", s6=0.75, alpha6=20.0, sr6=1.1)
+    E = disp.compute_energy(mol)
+    G = disp.compute_gradient(mol)
+
+    # Every pair lies within 20 bohr
+    disp.set_cutoff(20.0)
+    assert compare_values(E, disp.compute_energy(mol), 12, "D2 energy, long cutoff")
+    assert compare_matrices(G, disp.compute_gradient(mol), 12, "D2 gradient, long cutoff")
+
+    # Beyond 7 bohr only a few intermolecular H-H and O-H pairs are dropped
+    disp.set_cutoff(7.0)
+    E_cut = disp.compute_energy(mol)
+    assert compare_values(E, E_cut, "D2 energy, 7 bohr cutoff", atol=5.e-5)
+    assert abs(E - E_cut) > 1.e-6
+
+
+def test_libdisp_cutoff_option():
+    mol = psi4.geometry(_dimer)
+    mol.update_geometry()
+    params = {"s6": 0.75, "alpha6": 20.0, "sr6": 1.1}
+    E = psi4.core.Dispersion.build("d2", **params).compute_energy(mol)
+
+    psi4.set_options({"dft_dispersion_cutoff": 7.0})
+    empirical_dispersion = psi4.driver.procrouting.empirical_dispersion
+    disp = empirical_dispersion.EmpiricalDispersion(name_hint="", level_hint="d2", param_tweaks=params)
+    assert compare_values(7.0, disp.disp.cutoff(), 12, "cutoff from DFT_DISPERSION_CUTOFF")
+    assert compare_values(E, disp.compute_energy(mol), "D2 energy, DFT_DISPERSION_CUTOFF 7 bohr", atol=5.e-5)
@@ -0,0 +1,38 @@
+#! Matrix storage from the pooled allocator: reuse, uninitialized copies, and caching switched off
+
+import numpy as np
+import psi4
+import pytest
+from .utils import *
+
+
+@pytest.mark.quick
+def test_matrix_pool():
+    limit = psi4.core.get_matrix_pool_limit()
+
+    a = psi4.core.Matrix.from_array(np.arange(1.0, 401.0).reshape(20, 20))
+    for _ in range(5):
+        b = a.clone()
+        assert compare_arrays(a, b, 14, "Clone of a pooled matrix")
+        del b
+
+    # A recycled block must come back zeroed
+    c = psi4.core.Matrix(20, 20)
+    assert compare_values(0.0, np.abs(c.np).max(), 14, "Fresh matrix from a recycled block is zero")
+
+    psi4.geometry("""
+    O
+    H 1 0.96
+    H 1 0.96 2 104.5
+    """)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 1.e-10, "d_convergence": 1.e-8})
+    e_pool = psi4.energy("scf")
+
+    psi4.core.set_matrix_pool_limit(0)
+    assert psi4.core.get_matrix_pool_limit() == 0
+    e_nopool = psi4.energy("scf")
+    psi4.core.print_matrix_pool_statistics()
+
+    assert compare_values(e_pool, e_nopool, 10, "SCF energy without matrix pooling")
+
+    psi4.core.set_matrix_pool_limit(limit)
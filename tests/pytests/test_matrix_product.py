@@ -0,0 +1,112 @@
+#! Lazily evaluated matrix chains (linalg::MatrixProduct) against numpy
+
+import numpy as np
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+
+def _random(rows, cols, seed):
+    rng = np.random.default_rng(seed)
+    return psi4.core.Matrix.from_array([rng.standard_normal((r, c)) for r, c in zip(rows, cols)])
+
+
+def _symmetric(dims, seed):
+    rng = np.random.default_rng(seed)
+    blocks = []
+    for d in dims:
+        a = rng.standard_normal((d, d))
+        blocks.append(a + a.T)
+    return psi4.core.Matrix.from_array(blocks)
+
+
+def test_chain_product_blocked():
+    nso = [7, 0, 3, 5]
+    nmo = [6, 0, 3, 4]
+    X = _random(nso, nmo, 1)
+    F = _symmetric(nso, 2)
+    D = _symmetric(nso, 3)
+    S = _symmetric(nso, 4)
+
+    # X^T F X with F flagged symmetric, against the existing triplet
+    ref = psi4.core.triplet(X, F, X, True, False, False)
+    val = psi4.core.chain_product([X, F, X], [True, False, False], [False, True, False])
+    assert compare_matrices(ref, val, 12, "X^T F X")
+
+    # Four symmetric factors and a congruence
+    for h in range(4):
+        if nso[h] == 0:
+            continue
+        ref = np.linalg.multi_dot([X.nph[h].T, F.nph[h], D.nph[h], S.nph[h], X.nph[h]])
+        val = psi4.core.chain_product([X, F, D, S, X], [True, False, False, False, False], [False, True, True, True])
+        assert compare_arrays(ref, val.nph[h], 12, "X^T F D S X block %d" % h)
+
+    # X^T X goes through DSYRK
+    ref = psi4.core.doublet(X, X, True, False)
+    val = psi4.core.chain_product([X, X], [True, False])
+    assert compare_matrices(ref, val, 12, "X^T X")
+    ref = psi4.core.doublet(X, X, False, True)
+    val = psi4.core.chain_product([X, X], [False, True])
+    assert compare_matrices(ref, val, 12, "X X^T")
+
+
+def test_chain_product_nonconforming():
+    A = psi4.core.Matrix(3, 4)
+    B = psi4.core.Matrix(5, 2)
+    with pytest.raises(Exception):
+        psi4.core.chain_product([A, B])
+
+
+def test_chain_product_symmetric_operands():
+    nso = [7, 0, 3, 5]
+    nmo = [6, 0, 3, 4]
+    X = _random(nso, nmo, 5)
+    Y = _random(nmo, nso, 6)
+    F = _symmetric(nso, 7)
+    D = _symmetric(nso, 8)
+
+    # DSYMM with the symmetric factor on the left, on the right and on both sides
+    cases = [
+        ([F, X], [False, False], [True, False], lambda h: F.nph[h] @ X.nph[h]),
+        ([Y, F], [False, False], [False, True], lambda h: Y.nph[h] @ F.nph[h]),
+        ([X, F], [True, False], [False, True], lambda h: X.nph[h].T @ F.nph[h]),
+        ([F, D], [False, False], [True, True], lambda h: F.nph[h] @ D.nph[h]),
+        ([F, D, F], [False, False, False], [True, True, True], lambda h: F.nph[h] @ D.nph[h] @ F.nph[h]),
+        ([Y, F, D, X], [False, False, False, False], [False, True, True, False],
+         lambda h: np.linalg.multi_dot([Y.nph[h], F.nph[h], D.nph[h], X.nph[h]])),
+    ]
+    for n, (mats, trans, sym, ref) in enumerate(cases):
+        val = psi4.core.chain_product(mats, trans, sym)
+        for h in range(4):
+            if nso[h] == 0:
+                continue
+            assert compare_arrays(ref(h), val.nph[h], 12, "symmetric operands, case %d block %d" % (n, h))
+
+    # Flagging a non-square factor as symmetric is an error
+    with pytest.raises(Exception):
+        psi4.core.chain_product([X, Y], [False, False], [True, False])
+
+
+def test_chain_product_accumulate():
+    nso = [7, 0, 3, 5]
+    nmo = [6, 0, 3, 4]
+    X = _random(nso, nmo, 9)
+    F = _symmetric(nso, 10)
+    R = _random(nmo, nmo, 11)
+    R0 = R.clone()
+
+    # result = alpha * X^T F X + beta * result, in place
+    psi4.core.chain_product([X, F, X], [True, False, False], [False, True, False], result=R, alpha=-0.5, beta=2.0)
+    for h in range(4):
+        if nso[h] == 0:
+            continue
+        ref = -0.5 * np.linalg.multi_dot([X.nph[h].T, F.nph[h], X.nph[h]]) + 2.0 * R0.nph[h]
+        assert compare_arrays(ref, R.nph[h], 12, "alpha X^T F X + beta R block %d" % h)
+
+    # beta = 0 overwrites; a result of the wrong shape is an error
+    psi4.core.chain_product([X, X], [True, False], result=R)
+    assert compare_matrices(psi4.core.doublet(X, X, True, False), R, 12, "X^T X into result")
+    with pytest.raises(Exception):
+        psi4.core.chain_product([X, X], [False, True], result=R)
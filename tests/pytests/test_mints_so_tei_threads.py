@@ -0,0 +1,26 @@
+#! Conventional SO integrals written by several threads feed the same CCSD energy
+
+import psi4
+import pytest
+from .utils import *
+
+
+@pytest.mark.quick
+def test_mints_so_tei_threads():
+    psi4.geometry("""
+    0 1
+    O
+    H 1 0.96
+    H 1 0.96 2 104.5
+    """)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "e_convergence": 1.e-10, "r_convergence": 1.e-9})
+
+    psi4.set_num_threads(1)
+    e_serial = psi4.energy("ccsd")
+
+    psi4.set_num_threads(4)
+    e_threaded = psi4.energy("ccsd")
+
+    assert compare_values(e_serial, e_threaded, 9, "CCSD energy from threaded SO integrals")
+
+    psi4.set_num_threads(1)
@@ -0,0 +1,68 @@
+#! optking with the conjugate-gradient internal-coordinate solver and limited-memory BFGS steps
+
+import numpy as np
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+# SCF/STO-3G water from a tightly converged QChem run (see opt1)
+_nucenergy = 8.9064890670
+_refenergy = -74.965901192
+_r_oh = 1.869713  # bohr
+_a_hoh = 100.0269  # degrees
+
+
+def _water():
+    return psi4.geometry("""
+    O
+    H 1 1.0
+    H 1 1.0 2 104.5
+    """)
+
+
+def _optimize(options):
+    mol = _water()
+    psi4.set_options({
+        "diis": False,
+        "basis": "sto-3g",
+        "e_convergence": 10,
+        "d_convergence": 10,
+        "scf_type": "pk",
+    })
+    psi4.set_options(options)
+    energy = psi4.optimize("scf")
+    return energy, mol
+
+
+def _internals(mol):
+    geom = mol.geometry().np
+    v1 = geom[1] - geom[0]
+    v2 = geom[2] - geom[0]
+    r1 = np.linalg.norm(v1)
+    r2 = np.linalg.norm(v2)
+    return np.array([r1, r2, np.degrees(np.arccos(np.dot(v1, v2) / (r1 * r2)))])
+
+
+def test_optking_intco_solver_pcg():
+    e_dense, mol_dense = _optimize({"intco_solver": "dense"})
+    e_pcg, mol_pcg = _optimize({"intco_solver": "pcg"})
+
+    # The PCG generalized inverse steps to the same geometry as the dense one
+    assert compare_values(e_dense, e_pcg, 8, "PCG energy against DENSE")
+    assert compare_values(mol_dense.nuclear_repulsion_energy(), mol_pcg.nuclear_repulsion_energy(), 6,
+                          "PCG nuclear repulsion energy against DENSE")
+    assert compare_arrays(_internals(mol_dense), _internals(mol_pcg), 5, "PCG internal coordinates against DENSE")
+    assert compare_values(_refenergy, e_pcg, 6, "PCG reference energy")
+
+
+def test_optking_lbfgs():
+    e_lbfgs, mol = _optimize({"step_type": "lbfgs"})
+
+    r1, r2, angle = _internals(mol)
+    assert compare_values(_refenergy, e_lbfgs, 6, "LBFGS reference energy")
+    assert compare_values(_nucenergy, mol.nuclear_repulsion_energy(), 3, "LBFGS nuclear repulsion energy")
+    assert compare_values(_r_oh, r1, 3, "LBFGS R(OH1)")
+    assert compare_values(_r_oh, r2, 3, "LBFGS R(OH2)")
+    assert compare_values(_a_hoh, angle, 1, "LBFGS A(HOH)")
@@ -0,0 +1,33 @@
+#! Mk-MRCCSD on Cholesky-decomposed (CC_TYPE CD) and density-fitted (CC_TYPE DF) integrals against conventional integrals
+
+import psi4
+import pytest
+from .utils import *
+
+pytestmark = pytest.mark.quick
+
+
+def test_psimrcc_cd(psimrcc_o2):
+    psi4.set_options({"cc_type": "conv"})
+    e_conv = psi4.energy("psimrcc")
+
+    # A tight decomposition reproduces the conventional integrals, <vv|vv> terms included
+    psi4.set_options({"cc_type": "cd", "psimrcc__cholesky_tolerance": 1.e-10})
+    e_cd = psi4.energy("psimrcc")
+
+    assert compare_values(e_conv, e_cd, 7, "Mk-MRCCSD energy with CD integrals")
+
+    psi4.set_options({"cc_type": "conv"})
+
+
+def test_psimrcc_df(psimrcc_o2):
+    psi4.set_options({"cc_type": "conv"})
+    e_conv = psi4.energy("psimrcc")
+
+    # The cc-pVDZ-RI fitting error in the correlation energy is well below a millihartree
+    psi4.set_options({"cc_type": "df"})
+    e_df = psi4.energy("psimrcc")
+
+    assert compare_values(e_conv, e_df, 3, "Mk-MRCCSD energy with DF integrals")
+
+    psi4.set_options({"cc_type": "conv"})
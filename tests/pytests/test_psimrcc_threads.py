@@ -0,0 +1,18 @@
+#! Mk-MRCCSD with independent CC operations computed concurrently (CC_NUM_THREADS)
+
+import psi4
+import pytest
+from .utils import *
+
+
+@pytest.mark.quick
+def test_psimrcc_threads(psimrcc_o2):
+    psi4.set_options({"psimrcc__cc_num_threads": 1})
+    e_serial = psi4.energy("psimrcc")
+
+    psi4.set_options({"psimrcc__cc_num_threads": 4})
+    e_concurrent = psi4.energy("psimrcc")
+
+    assert compare_values(e_serial, e_concurrent, 10, "Mk-MRCCSD energy with concurrent operations")
+
+    psi4.set_options({"psimrcc__cc_num_threads": 1})
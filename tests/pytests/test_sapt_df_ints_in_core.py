@@ -0,0 +1,37 @@
+#! SAPT2 with the DF integrals held in core (SAPT_DF_INTS_IN_CORE)
+
+import psi4
+import pytest
+from .utils import *
+
+
+@pytest.mark.quick
+def test_sapt2_df_ints_in_core():
+    psi4.geometry("""
+    0 1
+    O  -1.551007  -0.114520   0.000000
+    H  -1.934259   0.762503   0.000000
+    H  -0.599677   0.040712   0.000000
+    --
+    0 1
+    O   1.350625   0.111469   0.000000
+    H   1.680398  -0.373741  -0.758561
+    H   1.680398  -0.373741   0.758561
+    units angstrom
+    symmetry c1
+    no_reorient
+    no_com
+    """)
+    psi4.set_options({"basis": "cc-pvdz", "e_convergence": 1.e-10, "d_convergence": 1.e-8})
+
+    psi4.set_options({"sapt_df_ints_in_core": False})
+    psi4.energy("sapt2")
+    e_disk = psi4.variable("SAPT2 TOTAL ENERGY")
+
+    psi4.set_options({"sapt_df_ints_in_core": True})
+    psi4.energy("sapt2")
+    e_core = psi4.variable("SAPT2 TOTAL ENERGY")
+
+    assert compare_values(e_disk, e_core, 10, "SAPT2 energy with in-core DF integrals")
+
+    psi4.set_options({"sapt_df_ints_in_core": False})
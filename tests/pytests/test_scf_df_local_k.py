@@ -0,0 +1,55 @@
+#! DF-SCF with locally fitted exchange (DF_LOCAL_K)
+
+import psi4
+import pytest
+from .utils import *
+
+
+def _water_dimer():
+    psi4.geometry("""
+    0 1
+    O  -1.551007  -0.114520   0.000000
+    H  -1.934259   0.762503   0.000000
+    H  -0.599677   0.040712   0.000000
+    --
+    0 1
+    O   1.350625   0.111469   0.000000
+    H   1.680398  -0.373741  -0.758561
+    H   1.680398  -0.373741   0.758561
+    symmetry c1
+    no_reorient
+    no_com
+    """)
+    psi4.set_options({"basis": "cc-pvdz", "scf_type": "mem_df", "e_convergence": 1.e-10, "d_convergence": 1.e-8})
+
+
+@pytest.mark.quick
+def test_scf_df_local_k():
+    _water_dimer()
+
+    psi4.set_options({"df_local_k": False})
+    e_full = psi4.energy("scf")
+
+    # Domains spanning the whole dimer fit with the full auxiliary basis, as plain DF does
+    psi4.set_options({"df_local_k": True, "df_local_k_radius": 100.0})
+    e_local = psi4.energy("scf")
+
+    assert compare_values(e_full, e_local, 7, "DF-SCF energy with local K in molecule-wide domains")
+
+    psi4.set_options({"df_local_k": False})
+
+
+@pytest.mark.quick
+def test_scf_df_local_k_radius():
+    _water_dimer()
+
+    psi4.set_options({"df_local_k": False})
+    e_full = psi4.energy("scf")
+
+    # Domains of each water and its hydrogen-bond partner atoms; the truncation error stays small
+    psi4.set_options({"df_local_k": True, "df_local_k_radius": 4.0})
+    e_local = psi4.energy("scf")
+
+    assert compare_values(e_full, e_local, "DF-SCF energy with local K in 4 bohr domains", atol=1.e-4)
+
+    psi4.set_options({"df_local_k": False})